@@ -34,6 +34,8 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "EMMPMFilter.h"
 
+#include <limits>
+
 #include <QtCore/QTextStream>
 #include <QtGui/QColor>
 
@@ -137,6 +139,9 @@ EMMPMFilter::EMMPMFilter()
 , m_CurvatureBetaC(1.0f)
 , m_CurvatureRMax(15.0f)
 , m_CurvatureEMLoopDelay(1)
+, m_Use3DNeighborhood(false)
+, m_UseRandomSeed(false)
+, m_RandomSeed(0)
 , m_OutputDataArrayPath("", "", "")
 , m_EmmpmInitType(EMMPM_Basic)
 , m_Data(EMMPM_Data::New())
@@ -204,6 +209,13 @@ void EMMPMFilter::setupFilterParameters()
   parameters.push_back(SIMPL_NEW_CONSTRAINED_DOUBLE_FP("Beta C", CurvatureBetaC, FilterParameter::Parameter, EMMPMFilter));
   parameters.push_back(SIMPL_NEW_CONSTRAINED_DOUBLE_FP("R Max", CurvatureRMax, FilterParameter::Parameter, EMMPMFilter));
   parameters.push_back(SIMPL_NEW_CONSTRAINED_INT_FP("EM Loop Delay", CurvatureEMLoopDelay, FilterParameter::Parameter, EMMPMFilter));
+  parameters.push_back(SIMPL_NEW_BOOL_FP("Segment as Volume (3D Neighborhood)", Use3DNeighborhood, FilterParameter::Parameter, EMMPMFilter));
+  {
+    QStringList linkedProps;
+    linkedProps << "RandomSeed";
+    parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Use Random Seed", UseRandomSeed, FilterParameter::Parameter, EMMPMFilter, linkedProps));
+  }
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Random Seed", RandomSeed, FilterParameter::Parameter, EMMPMFilter));
 
   parameters.push_back(SeparatorFilterParameter::New("Cell Data", FilterParameter::RequiredArray));
   {
@@ -236,6 +248,9 @@ void EMMPMFilter::readFilterParameters(AbstractFilterParametersReader* reader, i
   setCurvatureBetaC(reader->readValue("CurvaturePenalty", getCurvatureBetaC()));
   setCurvatureRMax(reader->readValue("RMax", getCurvatureRMax()));
   setCurvatureEMLoopDelay(reader->readValue("EMLoopDelay", getCurvatureEMLoopDelay()));
+  setUse3DNeighborhood(reader->readValue("Use3DNeighborhood", getUse3DNeighborhood()));
+  setUseRandomSeed(reader->readValue("UseRandomSeed", getUseRandomSeed()));
+  setRandomSeed(reader->readValue("RandomSeed", getRandomSeed()));
   setOutputDataArrayPath(reader->readDataArrayPath("OutputDataArrayPath", getOutputDataArrayPath()));
   reader->closeFilterGroup();
 }
@@ -272,7 +287,7 @@ void EMMPMFilter::dataCheck()
   clearErrorCode();
   clearWarningCode();
 
-  getDataContainerArray()->getPrereqGeometryFromDataContainer<ImageGeom>(this, getInputDataArrayPath().getDataContainerName());
+  ImageGeom::Pointer image = getDataContainerArray()->getPrereqGeometryFromDataContainer<ImageGeom>(this, getInputDataArrayPath().getDataContainerName());
 
   std::vector<size_t> cDims(1, 1); // We need a single component, gray scale image
   m_InputImagePtr = getDataContainerArray()->getPrereqArrayFromPath<DataArray<uint8_t>>(this, getInputDataArrayPath(), cDims);
@@ -297,6 +312,16 @@ void EMMPMFilter::dataCheck()
     QString ss = QObject::tr("The minimum number of classes is 2");
     setErrorCondition(-89101, ss);
   }
+  // A volume stacks the rows of all its slices, and the EM/MPM library indexes those rows with 32 bit integers
+  if(getUse3DNeighborhood() && nullptr != image.get())
+  {
+    SizeVec3Type dims = image->getDimensions();
+    if(dims[1] * dims[2] > static_cast<size_t>(std::numeric_limits<int32_t>::max()))
+    {
+      QString ss = QObject::tr("The volume has %1 rows over all of its slices. At most %2 rows can be segmented as a volume").arg(dims[1] * dims[2]).arg(std::numeric_limits<int32_t>::max());
+      setErrorCondition(-89102, ss);
+    }
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -332,14 +357,31 @@ void EMMPMFilter::execute()
 //
 // -----------------------------------------------------------------------------
 void EMMPMFilter::segment(EMMPM_InitializationType initType)
+{
+  DataArrayPath dap = getInputDataArrayPath();
+  AttributeMatrix::Pointer am = getDataContainerArray()->getAttributeMatrix(dap);
+  std::vector<size_t> tDims = am->getTupleDimensions();
+  IDataArray::Pointer iDataArray = am->getAttributeArray(getInputDataArrayPath().getDataArrayName());
+  std::vector<size_t> cDims = iDataArray->getComponentDimensions();
+
+  m_Data->inputImageChannels = cDims[0];
+
+  segmentImage(m_Data, tDims, m_InputImage, m_OutputImage, initType, m_PreviousMu, m_PreviousSigma, true);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void EMMPMFilter::segmentImage(const EMMPM_Data::Pointer& data, const std::vector<size_t>& tDims, uint8_t* inputImage, uint8_t* outputImage, EMMPM_InitializationType initType,
+                               std::vector<float>& previousMu, std::vector<float>& previousSigma, bool reportMessages)
 {
   // Copy all the variables from the filter into the EMmpm Data structure.
-  m_Data->initType = initType;
+  data->initType = initType;
 
   InitializationFunction::Pointer initFunction = BasicInitialization::New();
 
   // Set the initialization function based on the parameters
-  switch(m_Data->initType)
+  switch(data->initType)
   {
   case EMMPM_ManualInit:
     initFunction = InitializationFunction::New();
@@ -352,59 +394,64 @@ void EMMPMFilter::segment(EMMPM_InitializationType initType)
     break;
   }
 
-  m_Data->classes = getNumClasses();
-  m_Data->in_beta = getExchangeEnergy();
-  m_Data->emIterations = getHistogramLoops();
-  m_Data->mpmIterations = getSegmentationLoops();
+  data->classes = getNumClasses();
+  data->in_beta = getExchangeEnergy();
+  data->emIterations = getHistogramLoops();
+  data->mpmIterations = getSegmentationLoops();
 
   DynamicTableData tableDataObj = getEMMPMTableData();
   std::vector<std::vector<double>> tableData = tableDataObj.getTableData();
-  for(int32_t i = 0; i < m_Data->classes; i++)
+  for(int32_t i = 0; i < data->classes; i++)
   {
-    int32_t gray = 255 / (m_Data->classes - 1);
+    int32_t gray = 255 / (data->classes - 1);
     // Generate a Gray Scale Color Table
-    m_Data->colorTable[i] = qRgb(i * gray, i * gray, i * gray);
+    data->colorTable[i] = qRgb(i * gray, i * gray, i * gray);
     // Hard code the minimum variance to 4.5; This could be a user option.
-    m_Data->min_variance[i] = tableData[i][1];
+    data->min_variance[i] = tableData[i][1];
     // Do we know what w_gamma is?
-    m_Data->w_gamma[i] = tableData[i][0];
+    data->w_gamma[i] = tableData[i][0];
   }
 
-  DataArrayPath dap = getInputDataArrayPath();
-  AttributeMatrix::Pointer am = getDataContainerArray()->getAttributeMatrix(dap);
-  std::vector<size_t> tDims = am->getTupleDimensions();
-  IDataArray::Pointer iDataArray = am->getAttributeArray(getInputDataArrayPath().getDataArrayName());
-  std::vector<size_t> cDims = iDataArray->getComponentDimensions();
-
-  m_Data->columns = tDims[0];
-  m_Data->rows = tDims[1];
-  m_Data->inputImageChannels = cDims[0];
+  data->columns = tDims[0];
+  data->rows = tDims[1];
+  data->slices = 1;
+  // A volume is segmented as a whole by stacking the rows of all its slices
+  if(getUse3DNeighborhood() && tDims.size() > 2 && tDims[2] > 1)
+  {
+    data->slices = tDims[2];
+    data->rows = tDims[1] * tDims[2];
+  }
+  // A fixed seed reproduces the same segmentation regardless of the number of threads
+  if(getUseRandomSeed())
+  {
+    data->rngSeed = static_cast<uint64_t>(getRandomSeed());
+  }
 
-  m_Data->simulatedAnnealing = (char)(getUseSimulatedAnnealing());
-  m_Data->useGradientPenalty = static_cast<char>(getUseGradientPenalty());
-  m_Data->beta_e = getGradientBetaE();
-  m_Data->useCurvaturePenalty = static_cast<char>(getUseCurvaturePenalty());
-  m_Data->beta_c = getCurvatureBetaC();
-  m_Data->r_max = getCurvatureRMax();
-  m_Data->ccostLoopDelay = getCurvatureEMLoopDelay();
+  data->simulatedAnnealing = (char)(getUseSimulatedAnnealing());
+  data->useGradientPenalty = static_cast<char>(getUseGradientPenalty());
+  data->beta_e = getGradientBetaE();
+  data->useCurvaturePenalty = static_cast<char>(getUseCurvaturePenalty());
+  data->beta_c = getCurvatureBetaC();
+  data->r_max = getCurvatureRMax();
+  data->ccostLoopDelay = getCurvatureEMLoopDelay();
 
   // Assign our Data array allocated input and output images into the EMMPData class
-  m_Data->inputImage = m_InputImage;
-  m_Data->xt = m_OutputImage;
+  data->inputImage = inputImage;
+  data->xt = outputImage;
 
-  // Allocate all the memory here
-  m_Data->allocateDataStructureMemory();
+  // Allocate all the memory here. A reused Data structure keeps the buffers it already has
+  data->allocateDataStructureMemory();
 
   // If we are using the "Feedback" loop then we copy the previous Mu/Sigma values into the Mean/Variance
   // variables
-  if(m_Data->initType == EMMPM_ManualInit)
+  if(data->initType == EMMPM_ManualInit)
   {
-    for(int32_t i = 0; i < m_Data->classes; i++)
+    for(int32_t i = 0; i < data->classes; i++)
     {
-      for(uint32_t d = 0; d < m_Data->dims; d++)
+      for(uint32_t d = 0; d < data->dims; d++)
       {
-        m_Data->mean[i * m_Data->dims + d] = m_PreviousMu[i * m_Data->dims + d];
-        m_Data->variance[i * m_Data->dims + d] = m_PreviousSigma[i * m_Data->dims + d];
+        data->mean[i * data->dims + d] = previousMu[i * data->dims + d];
+        data->variance[i * data->dims + d] = previousSigma[i * data->dims + d];
       }
     }
   }
@@ -415,23 +462,31 @@ void EMMPMFilter::segment(EMMPM_InitializationType initType)
   // Start the EM/MPM process going
   EMMPM::Pointer emmpm = EMMPM::New();
 
-  emmpm->setData(m_Data);
+  emmpm->setData(data);
   emmpm->setStatsDelegate(statsDelegate.get());
   emmpm->setInitializationFunction(initFunction);
 
   // Connect up the Error/Warning/Progress object so the filter can report those things
-  connect(emmpm.get(), SIGNAL(messageGenerated(const AbstractMessage::Pointer&)), this, SLOT(handleEmmpmMessage(const AbstractMessage::Pointer&)));
+  if(reportMessages)
+  {
+    connect(emmpm.get(), SIGNAL(messageGenerated(const AbstractMessage::Pointer&)), this, SLOT(handleEmmpmMessage(const AbstractMessage::Pointer&)));
+  }
 
   emmpm->execute();
 
   // We manually set the pointers to nullptr so that the EMMPData class does not try to free the memory
-  m_Data->inputImage = nullptr;
-  m_Data->xt = nullptr;
+  data->inputImage = nullptr;
+  data->xt = nullptr;
 
   // Grab the Mu/Sigma values from the current finished segmented image and use those as inputs
   // into the initialization of the next Image to be Segmented
-  m_PreviousMu.resize(getNumClasses() * m_Data->dims);
-  m_PreviousSigma.resize(getNumClasses() * m_Data->dims);
+  previousMu.resize(getNumClasses() * data->dims);
+  previousSigma.resize(getNumClasses() * data->dims);
+  for(size_t i = 0; i < previousMu.size(); i++)
+  {
+    previousMu[i] = static_cast<float>(data->mean[i]);
+    previousSigma[i] = static_cast<float>(data->variance[i]);
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -743,6 +798,42 @@ int EMMPMFilter::getCurvatureEMLoopDelay() const
   return m_CurvatureEMLoopDelay;
 }
 
+// -----------------------------------------------------------------------------
+void EMMPMFilter::setUse3DNeighborhood(bool value)
+{
+  m_Use3DNeighborhood = value;
+}
+
+// -----------------------------------------------------------------------------
+bool EMMPMFilter::getUse3DNeighborhood() const
+{
+  return m_Use3DNeighborhood;
+}
+
+// -----------------------------------------------------------------------------
+void EMMPMFilter::setUseRandomSeed(bool value)
+{
+  m_UseRandomSeed = value;
+}
+
+// -----------------------------------------------------------------------------
+bool EMMPMFilter::getUseRandomSeed() const
+{
+  return m_UseRandomSeed;
+}
+
+// -----------------------------------------------------------------------------
+void EMMPMFilter::setRandomSeed(int value)
+{
+  m_RandomSeed = value;
+}
+
+// -----------------------------------------------------------------------------
+int EMMPMFilter::getRandomSeed() const
+{
+  return m_RandomSeed;
+}
+
 // -----------------------------------------------------------------------------
 void EMMPMFilter::setOutputDataArrayPath(const DataArrayPath& value)
 {
@@ -76,6 +76,9 @@ class EMMPM_EXPORT EMMPMFilter : public AbstractFilter
   PYB11_PROPERTY(double CurvatureRMax READ getCurvatureRMax WRITE setCurvatureRMax)
   PYB11_PROPERTY(int CurvatureEMLoopDelay READ getCurvatureEMLoopDelay WRITE setCurvatureEMLoopDelay)
   PYB11_PROPERTY(DataArrayPath OutputDataArrayPath READ getOutputDataArrayPath WRITE setOutputDataArrayPath)
+  PYB11_PROPERTY(bool Use3DNeighborhood READ getUse3DNeighborhood WRITE setUse3DNeighborhood)
+  PYB11_PROPERTY(bool UseRandomSeed READ getUseRandomSeed WRITE setUseRandomSeed)
+  PYB11_PROPERTY(int RandomSeed READ getRandomSeed WRITE setRandomSeed)
   PYB11_END_BINDINGS()
   // End Python bindings declarations
 
@@ -265,6 +268,39 @@ public:
   int getCurvatureEMLoopDelay() const;
   Q_PROPERTY(int CurvatureEMLoopDelay READ getCurvatureEMLoopDelay WRITE setCurvatureEMLoopDelay)
 
+  /**
+   * @brief Setter property for Use3DNeighborhood
+   */
+  void setUse3DNeighborhood(bool value);
+  /**
+   * @brief Getter property for Use3DNeighborhood
+   * @return Value of Use3DNeighborhood
+   */
+  bool getUse3DNeighborhood() const;
+  Q_PROPERTY(bool Use3DNeighborhood READ getUse3DNeighborhood WRITE setUse3DNeighborhood)
+
+  /**
+   * @brief Setter property for UseRandomSeed
+   */
+  void setUseRandomSeed(bool value);
+  /**
+   * @brief Getter property for UseRandomSeed
+   * @return Value of UseRandomSeed
+   */
+  bool getUseRandomSeed() const;
+  Q_PROPERTY(bool UseRandomSeed READ getUseRandomSeed WRITE setUseRandomSeed)
+
+  /**
+   * @brief Setter property for RandomSeed
+   */
+  void setRandomSeed(int value);
+  /**
+   * @brief Getter property for RandomSeed
+   * @return Value of RandomSeed
+   */
+  int getRandomSeed() const;
+  Q_PROPERTY(int RandomSeed READ getRandomSeed WRITE setRandomSeed)
+
   /**
    * @brief Setter property for OutputDataArrayPath
    */
@@ -364,6 +400,21 @@ protected:
    */
   virtual void segment(EMMPM_InitializationType initType);
 
+  /**
+   * @brief segmentImage Segments a single image with the current filter parameters. The Data structure
+   * may be reused between images of the same size, in which case its working buffers are not reallocated.
+   * @param data The EMMPM Data structure to segment with. Its dims and inputImageChannels must already be set
+   * @param tDims The tuple dimensions of the image
+   * @param inputImage The gray scale input image
+   * @param outputImage The class labels written by the segmentation
+   * @param initType Enumeration of EMMPM initialization types
+   * @param previousMu The Mu values used by EMMPM_ManualInit. Receives the converged Mu values
+   * @param previousSigma The Sigma values used by EMMPM_ManualInit. Receives the converged Sigma values
+   * @param reportMessages Whether the messages of the EMMPM object are forwarded by this filter
+   */
+  void segmentImage(const EMMPM_Data::Pointer& data, const std::vector<size_t>& tDims, uint8_t* inputImage, uint8_t* outputImage, EMMPM_InitializationType initType, std::vector<float>& previousMu,
+                    std::vector<float>& previousSigma, bool reportMessages);
+
   /**
    * @brief getPreviousMu
    * @return
@@ -414,6 +465,9 @@ private:
   double m_CurvatureBetaC = {};
   double m_CurvatureRMax = {};
   int m_CurvatureEMLoopDelay = {};
+  bool m_Use3DNeighborhood = {};
+  bool m_UseRandomSeed = {};
+  int m_RandomSeed = {};
   DataArrayPath m_OutputDataArrayPath = {};
   EMMPM_InitializationType m_EmmpmInitType = {};
 
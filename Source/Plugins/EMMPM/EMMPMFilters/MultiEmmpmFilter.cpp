@@ -33,6 +33,10 @@
  *
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
+#include <algorithm>
+#include <limits>
+#include <thread>
+
 #include <QtCore/QTextStream>
 
 #include "MultiEmmpmFilter.h"
@@ -61,6 +65,12 @@
 
 #include "EMMPM/EMMPMVersion.h"
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
 /**
  * @brief This message handler is used by MultiEmmpmFilter instances to re-emit incoming generic messages from the
  * EMMPM observable object as its own filter messages.  It also prepends the current Array number to the prefix of
@@ -112,6 +122,82 @@ private:
   MultiEmmpmFilter* m_Filter = nullptr;
 };
 
+/**
+ * @brief The MultiEmmpmSegmentImpl class segments one Attribute Array of each chain of neighboring Attribute Arrays.
+ * Every chain owns an EMMPM_Data workspace that is reused for all of its Attribute Arrays, along with the Mu/Sigma
+ * values of the last Attribute Array it segmented, which warm start the next one.
+ */
+class MultiEmmpmSegmentImpl
+{
+public:
+  MultiEmmpmSegmentImpl(MultiEmmpmFilter* filter, const std::vector<size_t>& tDims, const std::vector<uint8_t*>& inputImages, const std::vector<uint8_t*>& outputImages,
+                        const std::vector<size_t>& chainStart, std::vector<EMMPM_Data::Pointer>& workspaces, std::vector<std::vector<float>>& previousMu,
+                        std::vector<std::vector<float>>& previousSigma, size_t round)
+  : m_Filter(filter)
+  , m_TupleDims(tDims)
+  , m_InputImages(inputImages)
+  , m_OutputImages(outputImages)
+  , m_ChainStart(chainStart)
+  , m_Workspaces(workspaces)
+  , m_PreviousMu(previousMu)
+  , m_PreviousSigma(previousSigma)
+  , m_Round(round)
+  {
+  }
+  virtual ~MultiEmmpmSegmentImpl() = default;
+
+  void convert(size_t start, size_t end) const
+  {
+    // Only a single chain runs on the thread of the filter, so only then are the EMMPM messages forwarded
+    bool reportMessages = (m_ChainStart.size() == 2);
+    size_t numTuples = m_TupleDims[0] * m_TupleDims[1] * (m_TupleDims.size() > 2 ? m_TupleDims[2] : 1);
+
+    for(size_t c = start; c < end; c++)
+    {
+      size_t arrayIndex = m_ChainStart[c] + m_Round;
+      if(arrayIndex >= m_ChainStart[c + 1])
+      {
+        continue;
+      }
+
+      EMMPM_InitializationType initType = EMMPM_Basic;
+      if(m_Round > 0 && m_Filter->getUsePreviousMuSigma())
+      {
+        initType = EMMPM_ManualInit;
+      }
+
+      m_Filter->segmentImage(m_Workspaces[c], m_TupleDims, m_InputImages[arrayIndex], m_OutputImages[arrayIndex], initType, m_PreviousMu[c], m_PreviousSigma[c], reportMessages);
+
+      if(m_Filter->getUseOneBasedValues())
+      {
+        uint8_t* outputImage = m_OutputImages[arrayIndex];
+        for(size_t i = 0; i < numTuples; i++)
+        {
+          outputImage[i]++;
+        }
+      }
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+
+private:
+  MultiEmmpmFilter* m_Filter;
+  const std::vector<size_t>& m_TupleDims;
+  const std::vector<uint8_t*>& m_InputImages;
+  const std::vector<uint8_t*>& m_OutputImages;
+  const std::vector<size_t>& m_ChainStart;
+  std::vector<EMMPM_Data::Pointer>& m_Workspaces;
+  std::vector<std::vector<float>>& m_PreviousMu;
+  std::vector<std::vector<float>>& m_PreviousSigma;
+  size_t m_Round;
+};
+
 /* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
 enum createdPathID : RenameDataPath::DataID_t
 {
@@ -129,6 +215,7 @@ MultiEmmpmFilter::MultiEmmpmFilter()
 : m_OutputAttributeMatrixName("MultiArrayEMMPMOutput")
 , m_OutputArrayPrefix("Segmented_")
 , m_UsePreviousMuSigma(true)
+, m_SegmentArraysInParallel(false)
 {
 }
 
@@ -146,6 +233,7 @@ void MultiEmmpmFilter::setupFilterParameters()
   FilterParameterVectorType parameters = getFilterParameters();
 
   parameters.push_back(SIMPL_NEW_BOOL_FP("Use Mu/Sigma from Previous Image as Initialization for Current Image", UsePreviousMuSigma, FilterParameter::Parameter, MultiEmmpmFilter));
+  parameters.push_back(SIMPL_NEW_BOOL_FP("Segment Arrays in Parallel", SegmentArraysInParallel, FilterParameter::Parameter, MultiEmmpmFilter));
   parameters.push_back(SIMPL_NEW_STRING_FP("Output Array Prefix", OutputArrayPrefix, FilterParameter::Parameter, MultiEmmpmFilter));
 
   for(qint32 i = 0; i < parameters.size(); i++)
@@ -193,8 +281,12 @@ void MultiEmmpmFilter::readFilterParameters(AbstractFilterParametersReader* read
   setCurvatureBetaC(reader->readValue("CurvaturePenalty", getCurvatureBetaC()));
   setCurvatureRMax(reader->readValue("RMax", getCurvatureRMax()));
   setCurvatureEMLoopDelay(reader->readValue("EMLoopDelay", getCurvatureEMLoopDelay()));
+  setUse3DNeighborhood(reader->readValue("Use3DNeighborhood", getUse3DNeighborhood()));
+  setUseRandomSeed(reader->readValue("UseRandomSeed", getUseRandomSeed()));
+  setRandomSeed(reader->readValue("RandomSeed", getRandomSeed()));
   setOutputAttributeMatrixName(reader->readString("OutputAttributeMatrixName", getOutputAttributeMatrixName()));
   setUsePreviousMuSigma(reader->readValue("UsePreviousMuSigma", getUsePreviousMuSigma()));
+  setSegmentArraysInParallel(reader->readValue("SegmentArraysInParallel", getSegmentArraysInParallel()));
   setOutputArrayPrefix(reader->readString("OutputArrayPrefix", getOutputArrayPrefix()));
   reader->closeFilterGroup();
 }
@@ -306,6 +398,12 @@ void MultiEmmpmFilter::dataCheck()
     QString ss = QObject::tr("The minimum number of classes is 2");
     setErrorCondition(-89001, ss);
   }
+  // A volume stacks the rows of all its slices, and the EM/MPM library indexes those rows with 32 bit integers
+  if(getUse3DNeighborhood() && tDims.size() > 2 && tDims[1] * tDims[2] > static_cast<size_t>(std::numeric_limits<int32_t>::max()))
+  {
+    QString ss = QObject::tr("The volume has %1 rows over all of its slices. At most %2 rows can be segmented as a volume").arg(tDims[1] * tDims[2]).arg(std::numeric_limits<int32_t>::max());
+    setErrorCondition(-89005, ss);
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -323,44 +421,85 @@ void MultiEmmpmFilter::execute()
   initialize();
 
   DataArrayPath inputAMPath = DataArrayPath::GetAttributeMatrixPath(getInputDataArrayVector());
+  DataArrayPath outputAMPath = inputAMPath;
+  outputAMPath.setAttributeMatrixName(getOutputAttributeMatrixName());
+  AttributeMatrix::Pointer inAM = getDataContainerArray()->getAttributeMatrix(inputAMPath);
+  AttributeMatrix::Pointer outAM = getDataContainerArray()->getAttributeMatrix(outputAMPath);
+  std::vector<size_t> tDims = inAM->getTupleDimensions();
 
   QList<QString> arrayNames = DataArrayPath::GetDataArrayNames(getInputDataArrayVector());
-  QListIterator<QString> iter(arrayNames);
-
   m_ArrayCount = arrayNames.size();
 
-  // This is the routine that sets up the EM/MPM to segment the image
-  while(iter.hasNext())
+  std::vector<uint8_t*> inputImages(m_ArrayCount, nullptr);
+  std::vector<uint8_t*> outputImages(m_ArrayCount, nullptr);
+  for(int32_t i = 0; i < m_ArrayCount; i++)
+  {
+    inputImages[i] = inAM->getAttributeArrayAs<UInt8ArrayType>(arrayNames.at(i))->getPointer(0);
+    outputImages[i] = outAM->getAttributeArrayAs<UInt8ArrayType>(getOutputArrayPrefix() + arrayNames.at(i))->getPointer(0);
+  }
+
+  // The Attribute Arrays are split into contiguous chains. Each chain is segmented in order so that every
+  // Attribute Array can warm start from its neighbor, and the chains are segmented in parallel.
+  size_t numArrays = static_cast<size_t>(m_ArrayCount);
+  size_t numChains = 1;
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  if(getSegmentArraysInParallel())
+  {
+    numChains = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), numArrays));
+  }
+#endif
+  std::vector<size_t> chainStart(numChains + 1, 0);
+  for(size_t c = 0; c <= numChains; c++)
   {
-    DataArrayPath arrayPath = inputAMPath;
-    QString name = iter.next();
+    chainStart[c] = (numArrays * c) / numChains;
+  }
+  size_t chainLength = (numArrays + numChains - 1) / numChains;
 
-    arrayPath.setDataArrayName(name);
-    setInputDataArrayPath(arrayPath);
+  // Every chain segments with its own workspace so the working buffers are only allocated once per chain
+  std::vector<EMMPM_Data::Pointer> workspaces(numChains);
+  std::vector<std::vector<float>> previousMu(numChains, getPreviousMu());
+  std::vector<std::vector<float>> previousSigma(numChains, getPreviousSigma());
+  for(size_t c = 0; c < numChains; c++)
+  {
+    workspaces[c] = EMMPM_Data::New();
+    workspaces[c]->initVariables();
+    workspaces[c]->dims = 1;
+    workspaces[c]->inputImageChannels = 1;
+  }
 
-    // Change the output AttributeMatrix
-    arrayPath.setAttributeMatrixName(getOutputAttributeMatrixName());
-    QString outName = getOutputArrayPrefix() + arrayPath.getDataArrayName();
-    arrayPath.setDataArrayName(outName);
-    // Remove the array if it already exists ; this would be very strange but check for it anyway
-    getDataContainerArray()->getAttributeMatrix(arrayPath)->removeAttributeArray(outName);
-    setOutputDataArrayPath(arrayPath);
+  // This is the routine that sets up the EM/MPM to segment the images
+  for(size_t round = 0; round < chainLength; round++)
+  {
+    m_CurrentArrayIndex = static_cast<int>(round);
 
-    if(m_CurrentArrayIndex == 2 && getUsePreviousMuSigma())
+    MultiEmmpmSegmentImpl impl(this, tDims, inputImages, outputImages, chainStart, workspaces, previousMu, previousSigma, round);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    if(numChains > 1)
     {
-      setEmmpmInitType(EMMPM_ManualInit);
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, numChains, 1), impl, tbb::simple_partitioner());
     }
     else
     {
-      setEmmpmInitType(EMMPM_Basic);
+      impl.convert(0, numChains);
     }
-
-    EMMPMFilter::execute();
+#else
+    impl.convert(0, numChains);
+#endif
     if(getErrorCode() < 0)
     {
       break;
     }
-    m_CurrentArrayIndex++;
+
+    if(numChains > 1)
+    {
+      size_t segmented = 0;
+      for(size_t c = 0; c < numChains; c++)
+      {
+        segmented += std::min(round + 1, chainStart[c + 1] - chainStart[c]);
+      }
+      QString ss = QObject::tr("Segmented %1 of %2 Attribute Arrays").arg(segmented).arg(numArrays);
+      notifyStatusMessage(ss);
+    }
 
     if(getCancel())
     {
@@ -405,7 +544,11 @@ AbstractFilter::Pointer MultiEmmpmFilter::newFilterInstance(bool copyFilterParam
     filter->setCurvatureBetaC(getCurvatureBetaC());
     filter->setCurvatureRMax(getCurvatureRMax());
     filter->setCurvatureEMLoopDelay(getCurvatureEMLoopDelay());
+    filter->setUse3DNeighborhood(getUse3DNeighborhood());
+    filter->setUseRandomSeed(getUseRandomSeed());
+    filter->setRandomSeed(getRandomSeed());
     filter->setOutputAttributeMatrixName(getOutputAttributeMatrixName());
+    filter->setSegmentArraysInParallel(getSegmentArraysInParallel());
   }
   return filter;
 }
@@ -544,3 +687,15 @@ bool MultiEmmpmFilter::getUsePreviousMuSigma() const
 {
   return m_UsePreviousMuSigma;
 }
+
+// -----------------------------------------------------------------------------
+void MultiEmmpmFilter::setSegmentArraysInParallel(bool value)
+{
+  m_SegmentArraysInParallel = value;
+}
+
+// -----------------------------------------------------------------------------
+bool MultiEmmpmFilter::getSegmentArraysInParallel() const
+{
+  return m_SegmentArraysInParallel;
+}
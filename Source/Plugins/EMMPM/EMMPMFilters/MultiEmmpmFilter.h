@@ -46,6 +46,7 @@
 #include "EMMPM/EMMPMDLLExport.h"
 
 class MultiEmmpmFilterMessageHandler;
+class MultiEmmpmSegmentImpl;
 
 /**
  * @brief The MultiEmmpmFilter class. See [Filter documentation](@ref multiemmpmfilter) for details.
@@ -63,6 +64,7 @@ class EMMPM_EXPORT MultiEmmpmFilter : public EMMPMFilter
   PYB11_PROPERTY(QString OutputAttributeMatrixName READ getOutputAttributeMatrixName WRITE setOutputAttributeMatrixName)
   PYB11_PROPERTY(QString OutputArrayPrefix READ getOutputArrayPrefix WRITE setOutputArrayPrefix)
   PYB11_PROPERTY(bool UsePreviousMuSigma READ getUsePreviousMuSigma WRITE setUsePreviousMuSigma)
+  PYB11_PROPERTY(bool SegmentArraysInParallel READ getSegmentArraysInParallel WRITE setSegmentArraysInParallel)
   PYB11_END_BINDINGS()
   // End Python bindings declarations
 
@@ -97,6 +99,7 @@ public:
   virtual ~MultiEmmpmFilter();
 
   friend MultiEmmpmFilterMessageHandler;
+  friend MultiEmmpmSegmentImpl;
 
   /**
    * @brief Setter property for InputDataArrayVector
@@ -142,6 +145,17 @@ public:
   bool getUsePreviousMuSigma() const;
   Q_PROPERTY(bool UsePreviousMuSigma READ getUsePreviousMuSigma WRITE setUsePreviousMuSigma)
 
+  /**
+   * @brief Setter property for SegmentArraysInParallel
+   */
+  void setSegmentArraysInParallel(bool value);
+  /**
+   * @brief Getter property for SegmentArraysInParallel
+   * @return Value of SegmentArraysInParallel
+   */
+  bool getSegmentArraysInParallel() const;
+  Q_PROPERTY(bool SegmentArraysInParallel READ getSegmentArraysInParallel WRITE setSegmentArraysInParallel)
+
   /**
    * @brief getCompiledLibraryName Reimplemented from @see AbstractFilter class
    */
@@ -231,6 +245,7 @@ private:
   QString m_OutputAttributeMatrixName = {};
   QString m_OutputArrayPrefix = {};
   bool m_UsePreviousMuSigma = {};
+  bool m_SegmentArraysInParallel = {};
 
   int m_ArrayCount;
   int m_CurrentArrayIndex = 1;
@@ -251,7 +251,6 @@ void EMMPM::execute()
   }
 
   /* Initialize the Curvature Penalty variables:  */
-  data->ccost = nullptr;
   if(data->useCurvaturePenalty != 0)
   {
     CurvatureInitialization::Pointer curvatureInit = CurvatureInitialization::New();
@@ -265,10 +264,6 @@ void EMMPM::execute()
   }
 
   /* Initialize the Edge Gradient Penalty variables */
-  data->nw = nullptr;
-  data->ew = nullptr;
-  data->sw = nullptr;
-  data->nw = nullptr;
   if(data->useGradientPenalty != 0)
   {
     GradientVariablesInitialization::Pointer gradientInit = GradientVariablesInitialization::New();
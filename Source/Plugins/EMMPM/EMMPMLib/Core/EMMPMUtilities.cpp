@@ -124,15 +124,15 @@ void EMMPMUtilities::ConvertXtToOutputImage(EMMPM_Data::Pointer data)
   }
   raster = data->outputImage;
   index = 0;
-  totalPixels = data->rows * data->columns;
+  totalPixels = static_cast<size_t>(data->rows) * data->columns;
   unsigned int rows = data->rows;
   unsigned int columns = data->columns;
-  unsigned int ixCol = 0;
+  size_t ixCol = 0;
   unsigned int* colorTable = data->colorTable;
 
   for(i = 0; i < rows; i++)
   {
-    ixCol = i * columns;
+    ixCol = static_cast<size_t>(i) * columns;
     for(j = 0; j < columns; j++)
     {
       gtindex = data->xt[ixCol + j];
@@ -245,9 +245,10 @@ public:
   void calc(int rowStart, int rowEnd, int colStart, int colEnd) const
   {
     int dims = data->dims;
-    int rows = data->rows;
-    int cols = data->columns;
-    int32_t k_, k2_, lij, ld, ijd, k_temp, k2_temp;
+    size_t rows = data->rows;
+    size_t cols = data->columns;
+    size_t k_, k2_, lij, ijd, k_temp, k2_temp;
+    int32_t ld;
     real_t* m = data->mean;
     unsigned char* y = data->y;
     real_t* probs = data->probs;
@@ -302,9 +303,10 @@ public:
   void calc(int rowStart, int rowEnd, int colStart, int colEnd) const
   {
     int dims = data->dims;
-    int rows = data->rows;
-    int cols = data->columns;
-    int32_t k_, k2_, lij, ld, ijd, k_temp, k2_temp;
+    size_t rows = data->rows;
+    size_t cols = data->columns;
+    size_t k_, k2_, lij, ijd, k_temp, k2_temp;
+    int32_t ld;
     real_t* m = data->mean;
     unsigned char* y = data->y;
     real_t* probs = data->probs;
@@ -482,3 +484,21 @@ void EMMPMUtilities::ComputeEntropy(real_t*** probs, unsigned char** output, uns
     }
   }
 }
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+double EMMPMUtilities::CounterUniform(uint64_t seed, uint64_t stream, uint64_t counter)
+{
+  // SplitMix64 finalizer applied to the key and the counter
+  uint64_t z = seed + 0x9E3779B97F4A7C15ULL * (stream + 1);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z ^= (z >> 31);
+  z += 0x9E3779B97F4A7C15ULL * (counter + 1);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z ^= (z >> 31);
+  // Use the upper 53 bits for the mantissa of the double
+  return static_cast<double>(z >> 11) * (1.0 / 9007199254740992.0);
+}
@@ -120,6 +120,16 @@ public:
    */
   static void ComputeEntropy(real_t*** probs, unsigned char** output, unsigned int rows, unsigned int cols, unsigned int classes);
 
+  /**
+   * @brief Returns a uniform random number in [0, 1) that only depends on its arguments, so any pixel can
+   * draw its number independently of the order in which the pixels are visited
+   * @param seed The seed of the random sequence
+   * @param stream Selects an independent sequence, e.g. one per MPM loop
+   * @param counter The index of the number in the sequence, e.g. the pixel index
+   * @return
+   */
+  static double CounterUniform(uint64_t seed, uint64_t stream, uint64_t counter);
+
 protected:
   EMMPMUtilities() = default;
 
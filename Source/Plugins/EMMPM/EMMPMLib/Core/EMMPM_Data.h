@@ -39,6 +39,7 @@
 #include <memory>
 
 #include <cstddef>
+#include <cstdint>
 
 // C++ Includes
 #include <vector>
@@ -110,8 +111,9 @@ public:
   int mpmIterations;                             /**<  */
   real_t in_beta;                                /**<  */
   int classes;                                   /**<  */
-  unsigned int rows;                             /**< The height of the image.  Applicable for both input and output images */
+  unsigned int rows;                             /**< The height of the image.  Applicable for both input and output images. A volume stacks the rows of all its slices */
   unsigned int columns;                          /**< The width of the image. Applicable for both input and output images */
+  unsigned int slices;                           /**< The number of slices stacked in rows. More than one slice segments a volume with a 26 neighbor clique */
   unsigned int dims;                             /**< The number of vector elements in the image.*/
   enum EMMPM_InitializationType initType;        /**< The type of initialization algorithm to use  */
   unsigned int initCoords[EMMPM_MAX_CLASSES][4]; /**<  MAX_CLASSES rows x 4 Columns  */
@@ -119,6 +121,7 @@ public:
   unsigned int colorTable[EMMPM_MAX_CLASSES];
   real_t min_variance[EMMPM_MAX_CLASSES]; /**< The minimum value that the variance can be for each class */
   char simulatedAnnealing;                /**<  */
+  uint64_t rngSeed;                       /**< Seed of the counter based random numbers used to initialize and sample the classes */
   char verbose;                           /**<  */
 
   // -----------------------------------------------------------------------------
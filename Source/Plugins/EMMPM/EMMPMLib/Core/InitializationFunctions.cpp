@@ -39,14 +39,11 @@
 #include <cstdlib>
 #include <cstring>
 
-//-- C++ includes
-#include <chrono>
-#include <random>
-
 //-- EMMMPM Lib Includes
 #include "EMMPMLib/Common/EMMPM_Math.h"
 #include "EMMPMLib/Common/MSVCDefines.h"
 #include "EMMPMLib/Core/EMMPM.h"
+#include "EMMPMLib/Core/EMMPMUtilities.h"
 
 // -----------------------------------------------------------------------------
 //
@@ -81,7 +78,7 @@ BasicInitialization::~BasicInitialization() = default;
 void BasicInitialization::initialize(EMMPM_Data::Pointer data)
 {
   // FIXME: This needs to be adapted for vector images (dims > 1)
-  unsigned int i, k, l;
+  unsigned int k, l;
   real_t mu, sigma;
   char msgbuff[256];
   unsigned int rows = data->rows;
@@ -90,26 +87,26 @@ void BasicInitialization::initialize(EMMPM_Data::Pointer data)
   unsigned char* y = data->y;
   size_t total;
 
-  total = rows * cols;
+  total = static_cast<size_t>(rows) * cols;
 
   memset(msgbuff, 0, 256);
 
   /* Initialization of parameter estimation */
   mu = 0;
   sigma = 0;
-  for(i = 0; i < total; i++)
+  for(size_t p = 0; p < total; p++)
   {
-    mu += y[i];
+    mu += y[p];
   }
 
-  mu /= (rows * cols);
+  mu /= total;
 
-  for(i = 0; i < total; i++)
+  for(size_t p = 0; p < total; p++)
   {
-    sigma += (y[i] - mu) * (y[i] - mu);
+    sigma += (y[p] - mu) * (y[p] - mu);
   }
 
-  sigma /= (rows * cols);
+  sigma /= total;
   sigma = sqrt((real_t)sigma);
 
   if(classes % 2 == 0)
@@ -213,21 +210,13 @@ void XtArrayInitialization::initialize(EMMPM_Data::Pointer data)
 {
   size_t total;
 
-  total = data->rows * data->columns;
-
-  const double rangeMin = 0.0;
-  const double rangeMax = 1.0;
-
-  std::random_device randomDevice;           // Will be used to obtain a seed for the random number engine
-  std::mt19937_64 generator(randomDevice()); // Standard mersenne_twister_engine seeded with rd()
-  std::mt19937_64::result_type seed = static_cast<std::mt19937_64::result_type>(std::chrono::steady_clock::now().time_since_epoch().count());
-  generator.seed(seed);
-  std::uniform_real_distribution<> distribution(rangeMin, rangeMax);
+  total = static_cast<size_t>(data->rows) * data->columns;
 
-  /* Initialize classification of each pixel randomly with a uniform disribution */
+  /* Initialize classification of each pixel randomly with a uniform disribution. Stream 0 is reserved for
+   * the initialization, the MPM loops draw from the streams after it. */
   for(size_t i = 0; i < total; i++)
   {
-    data->xt[i] = distribution(generator) * data->classes;
+    data->xt[i] = EMMPMUtilities::CounterUniform(data->rngSeed, 0, i) * data->classes;
   }
 }
 
@@ -260,24 +249,35 @@ void GradientVariablesInitialization::initialize(EMMPM_Data::Pointer data)
   int dims = data->dims;
   real_t x;
 
-  /* Allocate for edge images */
-
-  data->ns = new real_t[nsCols * nsRows]();
+  /* Allocate for edge images. A reused Data structure keeps the edge images it already has */
+  if(data->ns == nullptr)
+  {
+    data->ns = new real_t[nsCols * nsRows]();
+  }
   if(data->ns == nullptr)
   {
     return;
   }
-  data->ew = new real_t[ewCols * ewRows]();
+  if(data->ew == nullptr)
+  {
+    data->ew = new real_t[ewCols * ewRows]();
+  }
   if(data->ew == nullptr)
   {
     return;
   }
-  data->sw = new real_t[swCols * swRows]();
+  if(data->sw == nullptr)
+  {
+    data->sw = new real_t[swCols * swRows]();
+  }
   if(data->sw == nullptr)
   {
     return;
   }
-  data->nw = new real_t[nwCols * nwRows]();
+  if(data->nw == nullptr)
+  {
+    data->nw = new real_t[nwCols * nwRows]();
+  }
   if(data->nw == nullptr)
   {
     return;
@@ -306,8 +306,8 @@ void GradientVariablesInitialization::initialize(EMMPM_Data::Pointer data)
       x = 0;
       for(int32_t d = 0; d < dims; d++)
       {
-        ijd = (dims * data->columns * i) + (dims * j) + d;
-        ijd1 = (dims * data->columns * (i + 1)) + (dims * (j)) + d;
+        ijd = (static_cast<size_t>(dims) * data->columns * i) + (dims * j) + d;
+        ijd1 = (static_cast<size_t>(dims) * data->columns * (i + 1)) + (dims * (j)) + d;
         x += (data->y[ijd] - data->y[ijd1]) * (data->y[ijd] - data->y[ijd1]);
       }
       ij = (data->columns * i) + j;
@@ -323,8 +323,8 @@ void GradientVariablesInitialization::initialize(EMMPM_Data::Pointer data)
       x = 0;
       for(uint32_t d = 0; d < data->dims; d++)
       {
-        ijd = (dims * data->columns * i) + (dims * j) + d;
-        ijd1 = (dims * data->columns * (i + 1)) + (dims * (j + 1)) + d;
+        ijd = (static_cast<size_t>(dims) * data->columns * i) + (dims * j) + d;
+        ijd1 = (static_cast<size_t>(dims) * data->columns * (i + 1)) + (dims * (j + 1)) + d;
         x += (data->y[ijd] - data->y[ijd1]) * (data->y[ijd] - data->y[ijd1]);
       }
       ij = (nwCols * i) + j;
@@ -332,8 +332,8 @@ void GradientVariablesInitialization::initialize(EMMPM_Data::Pointer data)
       x = 0;
       for(uint32_t d = 0; d < data->dims; d++)
       {
-        ijd = (dims * data->columns * (i + 1)) + (dims * (j)) + d;
-        ijd1 = (dims * data->columns * (i)) + (dims * (j + 1)) + d;
+        ijd = (static_cast<size_t>(dims) * data->columns * (i + 1)) + (dims * (j)) + d;
+        ijd1 = (static_cast<size_t>(dims) * data->columns * (i)) + (dims * (j + 1)) + d;
         x += (data->y[ijd] - data->y[ijd1]) * (data->y[ijd] - data->y[ijd1]);
       }
       ij = (nwCols * i) + j;
@@ -364,10 +364,14 @@ void CurvatureInitialization::initialize(EMMPM_Data::Pointer data)
 // -----------------------------------------------------------------------------
 void CurvatureInitialization::initCurvatureVariables(EMMPM_Data::Pointer data)
 {
-  int l, lij;
+  int l;
+  size_t lij;
   unsigned int i, j;
 
-  data->ccost = new real_t[data->classes * data->rows * data->columns]();
+  if(data->ccost == nullptr)
+  {
+    data->ccost = new real_t[static_cast<size_t>(data->classes) * data->rows * data->columns]();
+  }
   if(data->ccost == nullptr)
   {
     return;
@@ -381,7 +385,7 @@ void CurvatureInitialization::initCurvatureVariables(EMMPM_Data::Pointer data)
       for(j = 0; j < data->columns; j++)
       {
         {
-          lij = (data->columns * data->rows * l) + (data->columns * i) + j;
+          lij = (static_cast<size_t>(data->columns) * data->rows * l) + (static_cast<size_t>(data->columns) * i) + j;
           data->ccost[lij] = 0;
         }
       }
@@ -50,40 +50,34 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cstdlib>
 #include <cstring>
 
-//-- C++ includes
-#include <chrono>
-#include <random>
-#include <sstream>
-#include <thread>
-
 #include "EMMPMLib/Common/EMMPM_Math.h"
 #include "EMMPMLib/Common/MSVCDefines.h"
 #include "EMMPMLib/Core/EMMPM.h"
 #include "EMMPMLib/Core/EMMPMUtilities.h"
 
-#define USE_TBB_TASK_GROUP 0
 #ifdef EMMPM_USE_PARALLEL_ALGORITHMS
-#include <tbb/blocked_range2d.h>
+#include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
 #include <tbb/partitioner.h>
-#include <tbb/task_group.h>
-
 #endif
 
 #define COMPUTE_C_CLIQUE(C, x, y, ci, cj)                                                                                                                                                              \
-  if((x) < 0 || (x) >= colEnd || (y) < 0 || (y) >= rowEnd)                                                                                                                                             \
+  if((x) < 0 || (x) >= cols || (y) < 0 || (y) >= sliceRows)                                                                                                                                            \
   {                                                                                                                                                                                                    \
     C[ci][cj] = classes;                                                                                                                                                                               \
   }                                                                                                                                                                                                    \
   else                                                                                                                                                                                                 \
   {                                                                                                                                                                                                    \
-    ij = (cols * (y)) + (x);                                                                                                                                                                           \
+    ij = (sliceSize * sliceIndex) + (static_cast<size_t>(cols) * (y)) + (x);                                                                                                                           \
     C[ci][cj] = xt[ij];                                                                                                                                                                                \
   }
 
 /**
- * @class ParallelCalcLoop ParallelCalcLoop.h EMMPM/Curvature/ParallelCalcLoop.h
- * @brief This class can calculate the parts of the MPM loop in parallel
+ * @class ParallelMPMLoop ParallelMPMLoop.h EMMPM/Curvature/ParallelMPMLoop.h
+ * @brief This class can calculate one color of the MPM loop in parallel. The pixels are colored by the
+ * parity of their x, y (and z for a volume) coordinates, so no pixel in the clique of a pixel has the same
+ * color as that pixel. All pixels of one color can then be updated at the same time and the result does
+ * not depend on how the rows are split between the threads.
  *
  * @date March 11, 2012
  * @version 1.0
@@ -91,34 +85,32 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 class ParallelMPMLoop
 {
 public:
-#if USE_TBB_TASK_GROUP
-  ParallelCalcLoop(EMMPM_Data* dPtr, real_t* ykPtr, real_t* rnd, int rowStart, int rowEnd, int colStart, int colEnd)
-  : m_RowStart(rowStart)
-  , m_RowEnd(rowEnd)
-  , m_ColStart(colStart)
-  , m_ColEnd(colEnd)
-  ,
-#else
-  ParallelMPMLoop(EMMPM_Data* dPtr, real_t* ykPtr, real_t* rnd)
-  :
-#endif
-
-  data(dPtr)
+  ParallelMPMLoop(EMMPM_Data* dPtr, real_t* ykPtr, uint64_t stream, int color)
+  : data(dPtr)
   , yk(ykPtr)
-  , rnd(rnd)
+  , stream(stream)
+  , color(color)
   {
   }
   virtual ~ParallelMPMLoop() = default;
 
-  void calc(int rowStart, int rowEnd, int colStart, int colEnd) const
+  /**
+   * @brief Updates the pixels of the current color in the (stacked) rows [rowStart, rowEnd)
+   */
+  void calc(int rowStart, int rowEnd) const
   {
     // uint64_t millis = EMMPM_getMilliSeconds();
     //  int l;
     real_t prior;
-    int32_t ij, lij;
+    size_t ij, lij;
     int rows = data->rows;
     int cols = data->columns;
     int classes = data->classes;
+    int slices = data->slices;
+    int sliceRows = rows / slices;
+    // The class planes of a volume can hold more than 2^31 values, so all flat indices are size_t
+    const size_t sliceSize = static_cast<size_t>(cols) * sliceRows;
+    const size_t planeSize = sliceSize * slices;
 
     real_t xrnd, current;
     real_t post[EMMPM_MAX_CLASSES], sum, edge;
@@ -151,13 +143,28 @@ public:
                  // the clique would be off the image then a value = number of classes is
                  // used for the C[i][j]. That way we can figure out if we are off the image
 
-    std::stringstream ss;
+    int CZ[18]; // The neighbors in the slices above and below the pixel when a volume is segmented
+    int numCZ = 0;
+
     unsigned int cSize = classes + 1;
     real_t* coupling = data->couplingBeta;
 
-    for(int32_t y = rowStart; y < rowEnd; y++)
+    const int xParity = color & 1;
+    const int yParity = (color >> 1) & 1;
+    const int zParity = (color >> 2) & 1;
+
+    for(int32_t row = rowStart; row < rowEnd; row++)
     {
-      for(int32_t x = colStart; x < colEnd; x++)
+      int32_t z = row / sliceRows;
+      int32_t y = row - (z * sliceRows);
+      if((y & 1) != yParity || (slices > 1 && (z & 1) != zParity))
+      {
+        continue;
+      }
+      int32_t sliceOffset = z * sliceRows;
+      size_t sliceIndex = z;
+
+      for(int32_t x = xParity; x < cols; x += 2)
       {
 
         /* -------------  */
@@ -170,19 +177,32 @@ public:
         COMPUTE_C_CLIQUE(C, x, y + 1, 1, 2);
         COMPUTE_C_CLIQUE(C, x + 1, y + 1, 2, 2);
 
-#if 0
-          if (y == rowStart + 1 && x == colStart + 1)
+        numCZ = 0;
+        if(slices > 1)
+        {
+          for(int32_t dz = -1; dz <= 1; dz += 2)
           {
-            ss << "------------------------------" << std::endl;
-            ss << "|" << C[0][0] << "\t" << C[1][0] << "\t" << C[2][0] << std::endl;
-            ss << "|" << C[0][1] << "\t" << C[1][1] << "\t" << C[2][1] << std::endl;
-            ss << "|" << C[0][2] << "\t" << C[1][2] << "\t" << C[2][2] << std::endl;
-            ss << "------------------------------" << std::endl;
-            std::cout << ss.str() << std::endl;
+            for(int32_t dy = -1; dy <= 1; dy++)
+            {
+              for(int32_t dx = -1; dx <= 1; dx++)
+              {
+                int32_t nx = x + dx;
+                int32_t ny = y + dy;
+                int32_t nz = z + dz;
+                if(nx < 0 || nx >= cols || ny < 0 || ny >= sliceRows || nz < 0 || nz >= slices)
+                {
+                  CZ[numCZ++] = classes;
+                }
+                else
+                {
+                  CZ[numCZ++] = xt[(sliceSize * nz) + (static_cast<size_t>(cols) * ny) + nx];
+                }
+              }
+            }
           }
-#endif
+        }
 
-        ij = (cols * y) + x;
+        ij = (sliceSize * sliceIndex) + (static_cast<size_t>(cols) * y) + x;
         sum = 0;
         for(int l = 0; l < classes; ++l)
         {
@@ -197,54 +217,53 @@ public:
           prior += coupling[(cSize * l) + C[0][2]];
           prior += coupling[(cSize * l) + C[1][2]];
           prior += coupling[(cSize * l) + C[2][2]];
-
-#if 0
-            if (y == rowStart + 1 && x == colStart + 1)
-            {
-              std::cout << "Class: " << l << "\t prior: " << prior << std::endl;
-            }
-#endif
+          for(int n = 0; n < numCZ; n++)
+          {
+            prior += coupling[(cSize * l) + CZ[n]];
+          }
 
           // now check for the gradient penalty. If our current class is NOT equal
           // to the class at index[i][j] AND the value of C[i][j] does NOT equal
-          // to the Number of Classes then add in the gradient penalty.
+          // to the Number of Classes then add in the gradient penalty. The gradient
+          // penalty is only defined between pixels of the same slice.
           if(data->useGradientPenalty != 0)
           {
+            int32_t gy = sliceOffset + y;
             if(C[0][0] != l && C[0][0] != classes)
             {
-              edge += sw[(swCols * (y - 1)) + x - 1];
+              edge += sw[(swCols * (gy - 1)) + x - 1];
             }
             if(C[1][0] != l && C[1][0] != classes)
             {
-              edge += ew[(ewCols * (y - 1)) + x];
+              edge += ew[(ewCols * (gy - 1)) + x];
             }
             if(C[2][0] != l && C[2][0] != classes)
             {
-              edge += nw[(nwCols * (y - 1)) + x];
+              edge += nw[(nwCols * (gy - 1)) + x];
             }
             if(C[0][1] != l && C[0][1] != classes)
             {
-              edge += ns[(nsCols * y) + x - 1];
+              edge += ns[(nsCols * gy) + x - 1];
             }
             if(C[2][1] != l && C[2][1] != classes)
             {
-              edge += ns[(nsCols * y) + x];
+              edge += ns[(nsCols * gy) + x];
             }
             if(C[0][2] != l && C[0][2] != classes)
             {
-              edge += nw[(nwCols * y) + x - 1];
+              edge += nw[(nwCols * gy) + x - 1];
             }
             if(C[1][2] != l && C[1][2] != classes)
             {
-              edge += ew[(ewCols * y) + x];
+              edge += ew[(ewCols * gy) + x];
             }
             if(C[2][2] != l && C[2][2] != classes)
             {
-              edge += sw[(swCols * y) + x];
+              edge += sw[(swCols * gy) + x];
             }
           }
 
-          lij = (cols * rows * l) + (cols * y) + x;
+          lij = (planeSize * l) + ij;
           curvature_value = 0.0;
           if(data->useCurvaturePenalty != 0)
           {
@@ -255,12 +274,12 @@ public:
           sum += post[l];
         }
 
-        xrnd = rnd[ij];
+        xrnd = EMMPMUtilities::CounterUniform(data->rngSeed, stream, ij);
         current = 0.0;
 
         for(int l = 0; l < classes; l++)
         {
-          lij = (cols * rows * l) + ij;
+          lij = (planeSize * l) + ij;
           real_t arg = post[l] / sum;
           if((xrnd >= current) && (xrnd <= (current + arg)))
           {
@@ -269,54 +288,23 @@ public:
           }
           current += arg;
         }
-#if 0
-          Dont even THINK about using this code...
-          This classifys the pixel based on the largest
-          in magnitude  probability
-          real_t max = 0.0;
-          int maxClass = 0;
-          for (int l = 0; l < classes; l++)
-          {
-            lij = (cols * rows * l) + ij;
-            //real_t arg = post[l] / sum;
-            if (probs[lij] > max)
-            {
-              max = probs[lij];
-              maxClass = l;
-            }
-          }
-          //Assign class based on Maximum probability
-          xt[ij] = maxClass;
-#endif
       }
     }
     //  std::cout << "     --" << EMMPM_getMilliSeconds() - millis << "--" << std::endl;
   }
 
 #if EMMPM_USE_PARALLEL_ALGORITHMS
-#if USE_TBB_TASK_GROUP
-  void operator()() const
-  {
-    calc(m_RowStart, m_RowEnd, m_ColStart, m_ColEnd);
-  }
-#else
-  void operator()(const tbb::blocked_range2d<int>& r) const
+  void operator()(const tbb::blocked_range<int>& r) const
   {
-    calc(r.rows().begin(), r.rows().end(), r.cols().begin(), r.cols().end());
+    calc(r.begin(), r.end());
   }
 #endif
-#endif
 
 private:
-#if USE_TBB_TASK_GROUP
-  int m_RowStart;
-  int m_RowEnd;
-  int m_ColStart;
-  int m_ColEnd;
-#endif
   const EMMPM_Data* data;
   const real_t* yk;
-  const real_t* rnd;
+  uint64_t stream;
+  int color;
 };
 
 // -----------------------------------------------------------------------------
@@ -371,7 +359,7 @@ void MPMCalculation::execute()
   memset(msgbuff, 0, 256);
   data->progress++;
 
-  yk = new real_t[cols * rows * classes]();
+  yk = new real_t[static_cast<size_t>(cols) * rows * classes]();
 
   sqrt2pi = sqrt(2.0 * M_PI);
 
@@ -391,40 +379,23 @@ void MPMCalculation::execute()
     {
       for(uint32_t l = 0; l < classes; l++)
       {
-        lij = (cols * rows * l) + (cols * i) + j;
+        lij = (static_cast<size_t>(cols) * rows * l) + (static_cast<size_t>(cols) * i) + j;
         probs[lij] = 0;
         yk[lij] = con[l];
         for(uint32_t d = 0; d < dims; d++)
         {
           ld = dims * l + d;
-          ijd = (dims * cols * i) + (dims * j) + d;
+          ijd = (static_cast<size_t>(dims) * cols * i) + (dims * j) + d;
           yk[lij] += ((y[ijd] - m[ld]) * (y[ijd] - m[ld]) / (-2.0 * v[ld]));
         }
       }
     }
   }
 
-  const double rangeMin = 0.0;
-  const double rangeMax = 1.0;
-
-  std::random_device randomDevice;           // Will be used to obtain a seed for the random number engine
-  std::mt19937_64 generator(randomDevice()); // Standard mersenne_twister_engine seeded with rd()
-  std::mt19937_64::result_type seed = static_cast<std::mt19937_64::result_type>(std::chrono::steady_clock::now().time_since_epoch().count());
-  generator.seed(seed);
-  std::uniform_real_distribution<> distribution(rangeMin, rangeMax);
-
-  // Generate all the numbers up front
-  size_t total = rows * cols;
-  std::vector<real_t> rndNumbers(total);
-  real_t* rndNumbersPtr = &(rndNumbers.front());
-  for(size_t i = 0; i < total; ++i)
-  {
-    rndNumbersPtr[i] = distribution(generator); // Work directly with the pointer for speed.
-  }
-
   // unsigned long long int millis = EMMPM_getMilliSeconds();
   // std::cout << "------------------------------------------------" << std::endl;
-  /* Perform the MPM loops */
+  /* Perform the MPM loops. Every loop sweeps all colors of the 2x2 (2x2x2 for a volume) checkerboard one after the other */
+  const int numColors = (data->slices > 1) ? 8 : 4;
   for(int32_t k = 0; k < data->mpmIterations; k++)
   {
 
@@ -436,33 +407,17 @@ void MPMCalculation::execute()
     }
     data->inside_mpm_loop = 1;
 
-#if EMMPM_USE_PARALLEL_ALGORITHMS
-    int threads = std::thread::hardware_concurrency();
-#if USE_TBB_TASK_GROUP
-    std::shared_ptr<tbb::task_group> g(new tbb::task_group);
-    unsigned int rowIncrement = rows / threads;
-    unsigned int rowStop = 0 + rowIncrement;
-    unsigned int rowStart = 0;
-    for(int t = 0; t < threads; ++t)
+    // Every MPM loop of every EM loop draws from its own random stream; stream 0 initialized xt
+    uint64_t stream = 1 + static_cast<uint64_t>(data->currentEMLoop) * data->mpmIterations + k;
+    for(int color = 0; color < numColors; color++)
     {
-      g->run(ParallelCalcLoop(data, yk, &(rndNumbers.front()), rowStart, rowStop, 0, cols));
-      rowStart = rowStop;
-      rowStop = rowStop + rowIncrement;
-      if(rowStop >= rows)
-      {
-        rowStop = rows;
-      }
-    }
-    g->wait();
-
-#else
-    tbb::parallel_for(tbb::blocked_range2d<int>(0, rows, rows / threads, 0, cols, cols), ParallelMPMLoop(data, yk, &(rndNumbers.front())), tbb::simple_partitioner());
-#endif
-
+      ParallelMPMLoop pcl(data, yk, stream, color);
+#if EMMPM_USE_PARALLEL_ALGORITHMS
+      tbb::parallel_for(tbb::blocked_range<int>(0, static_cast<int>(rows)), pcl, tbb::auto_partitioner());
 #else
-    ParallelMPMLoop pcl(data, yk, &(rndNumbers.front()));
-    pcl.calc(0, rows, 0, cols);
+      pcl.calc(0, static_cast<int>(rows));
 #endif
+    }
 
     // std::cout << "Counter: " << counter << std::endl;
     EMMPMUtilities::ConvertXtToOutputImage(getData());
@@ -500,7 +455,7 @@ void MPMCalculation::execute()
       {
         for(uint32_t l = 0; l < classes; l++)
         {
-          lij = (cols * rows * l) + (cols * i) + j;
+          lij = (static_cast<size_t>(cols) * rows * l) + (static_cast<size_t>(cols) * i) + j;
           data->probs[lij] = data->probs[lij] / (real_t)data->mpmIterations;
         }
       }
@@ -0,0 +1,363 @@
+/* ============================================================================
+ * Copyright (c) 2020 BlueQuartz Software, LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the BlueQuartz Software contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#include "EbsdTextParser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "SIMPLib/SIMPLib.h"
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
+namespace
+{
+bool isDelimiter(char c)
+{
+  return c == ' ' || c == '\t' || c == ',' || c == '\r';
+}
+
+const char* skipDelimiters(const char* pos, const char* end)
+{
+  while(pos < end && isDelimiter(*pos))
+  {
+    ++pos;
+  }
+  return pos;
+}
+
+const char* tokenEnd(const char* pos, const char* end)
+{
+  while(pos < end && !isDelimiter(*pos))
+  {
+    ++pos;
+  }
+  return pos;
+}
+
+const char* lineEnd(const char* pos, const char* end)
+{
+  const char* newline = static_cast<const char*>(std::memchr(pos, '\n', static_cast<size_t>(end - pos)));
+  return newline == nullptr ? end : newline;
+}
+
+// Powers of ten that are exactly representable as a float
+const float k_PowersOfTen[] = {1.0e0f, 1.0e1f, 1.0e2f, 1.0e3f, 1.0e4f, 1.0e5f, 1.0e6f, 1.0e7f, 1.0e8f, 1.0e9f, 1.0e10f};
+const int32_t k_MaxFastFractionDigits = 10;
+const uint64_t k_MaxFastMantissa = 1ULL << 24;
+} // namespace
+
+/**
+ * @brief The EbsdTextParserImpl class counts or parses the data lines of chunks of the mapped file. Each chunk
+ * starts at the beginning of a line and ends after a line ending.
+ */
+class EbsdTextParserImpl
+{
+public:
+  EbsdTextParserImpl(const std::vector<const char*>& chunkStart, std::vector<size_t>& chunkLines, const std::vector<size_t>* lineOffsets, size_t maxLines,
+                     const EbsdTextParser::LineParser* parseLine, std::atomic<bool>& failed)
+  : m_ChunkStart(chunkStart)
+  , m_ChunkLines(chunkLines)
+  , m_LineOffsets(lineOffsets)
+  , m_MaxLines(maxLines)
+  , m_ParseLine(parseLine)
+  , m_Failed(failed)
+  {
+  }
+  virtual ~EbsdTextParserImpl() = default;
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t chunk = start; chunk < end; chunk++)
+    {
+      size_t index = (m_LineOffsets != nullptr) ? (*m_LineOffsets)[chunk] : 0;
+      size_t numLines = 0;
+      const char* pos = m_ChunkStart[chunk];
+      const char* chunkEnd = m_ChunkStart[chunk + 1];
+      while(pos < chunkEnd)
+      {
+        const char* eol = lineEnd(pos, chunkEnd);
+        if(!EbsdTextParser::IsBlank(pos, eol))
+        {
+          if(m_ParseLine != nullptr && index < m_MaxLines && !(*m_ParseLine)(index, pos, eol))
+          {
+            m_Failed = true;
+            return;
+          }
+          index++;
+          numLines++;
+        }
+        pos = (eol < chunkEnd) ? eol + 1 : chunkEnd;
+      }
+      m_ChunkLines[chunk] = numLines;
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+
+private:
+  const std::vector<const char*>& m_ChunkStart;
+  std::vector<size_t>& m_ChunkLines;
+  const std::vector<size_t>* m_LineOffsets;
+  size_t m_MaxLines;
+  const EbsdTextParser::LineParser* m_ParseLine;
+  std::atomic<bool>& m_Failed;
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+EbsdTextParser::EbsdTextParser(const QString& filePath)
+: m_File(filePath)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+EbsdTextParser::~EbsdTextParser() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EbsdTextParser::map()
+{
+  if(!m_File.open(QIODevice::ReadOnly) || m_File.size() == 0)
+  {
+    return false;
+  }
+  uchar* data = m_File.map(0, m_File.size());
+  if(nullptr == data)
+  {
+    return false;
+  }
+  m_Begin = reinterpret_cast<const char*>(data);
+  m_End = m_Begin + m_File.size();
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const char* EbsdTextParser::begin() const
+{
+  return m_Begin;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const char* EbsdTextParser::end() const
+{
+  return m_End;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int64_t EbsdTextParser::parseLines(const char* dataStart, size_t maxLines, const LineParser& parseLine) const
+{
+  // Split the data into chunks of roughly equal size and move every boundary to the start of the next line
+  size_t numChunks = 1;
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  numChunks = std::max<size_t>(1, std::thread::hardware_concurrency() * 4);
+#endif
+  size_t dataSize = static_cast<size_t>(m_End - dataStart);
+  std::vector<const char*> chunkStart(numChunks + 1, m_End);
+  chunkStart[0] = dataStart;
+  for(size_t c = 1; c < numChunks; c++)
+  {
+    const char* pos = std::max(dataStart + (dataSize * c) / numChunks, chunkStart[c - 1]);
+    chunkStart[c] = (pos == dataStart) ? dataStart : NextLine(pos - 1, m_End);
+  }
+
+  // First count the data lines of every chunk so that each chunk knows the index of its first line
+  std::atomic<bool> failed(false);
+  std::vector<size_t> chunkLines(numChunks, 0);
+  {
+    EbsdTextParserImpl countImpl(chunkStart, chunkLines, nullptr, maxLines, nullptr, failed);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numChunks, 1), countImpl, tbb::simple_partitioner());
+#else
+    countImpl.convert(0, numChunks);
+#endif
+  }
+  std::vector<size_t> lineOffsets(numChunks + 1, 0);
+  for(size_t c = 0; c < numChunks; c++)
+  {
+    lineOffsets[c + 1] = lineOffsets[c] + chunkLines[c];
+  }
+
+  // Then parse every line straight into its place
+  EbsdTextParserImpl parseImpl(chunkStart, chunkLines, &lineOffsets, maxLines, &parseLine, failed);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, numChunks, 1), parseImpl, tbb::simple_partitioner());
+#else
+  parseImpl.convert(0, numChunks);
+#endif
+  if(failed)
+  {
+    return -1;
+  }
+  return static_cast<int64_t>(lineOffsets[numChunks]);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const char* EbsdTextParser::NextLine(const char* pos, const char* end)
+{
+  const char* eol = lineEnd(pos, end);
+  return (eol < end) ? eol + 1 : end;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EbsdTextParser::IsBlank(const char* pos, const char* end)
+{
+  return skipDelimiters(pos, end) == end;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const char* EbsdTextParser::ParseFloat(const char* pos, const char* end, float& value)
+{
+  const char* start = skipDelimiters(pos, end);
+  const char* stop = tokenEnd(start, end);
+  if(start == stop)
+  {
+    return nullptr;
+  }
+
+  // Plain decimals with few digits are converted with a single correctly rounded float division
+  const char* cur = start;
+  bool negative = (*cur == '-');
+  if(*cur == '-' || *cur == '+')
+  {
+    ++cur;
+  }
+  uint64_t mantissa = 0;
+  int32_t numDigits = 0;
+  int32_t fractionDigits = 0;
+  bool seenPoint = false;
+  bool fast = (cur < stop);
+  for(; cur < stop && fast; ++cur)
+  {
+    if(*cur >= '0' && *cur <= '9')
+    {
+      mantissa = mantissa * 10 + static_cast<uint64_t>(*cur - '0');
+      numDigits++;
+      fractionDigits += seenPoint ? 1 : 0;
+      fast = (numDigits <= 18);
+    }
+    else if(*cur == '.' && !seenPoint)
+    {
+      seenPoint = true;
+    }
+    else
+    {
+      fast = false;
+    }
+  }
+  if(fast && numDigits > 0 && mantissa <= k_MaxFastMantissa && fractionDigits <= k_MaxFastFractionDigits)
+  {
+    float result = static_cast<float>(mantissa) / k_PowersOfTen[fractionDigits];
+    value = negative ? -result : result;
+    return stop;
+  }
+
+  // Everything else (exponents, long mantissas, nan, inf) goes through strtof
+  char buffer[64];
+  size_t length = static_cast<size_t>(stop - start);
+  if(length >= sizeof(buffer))
+  {
+    return nullptr;
+  }
+  std::memcpy(buffer, start, length);
+  buffer[length] = '\0';
+  char* parsedEnd = nullptr;
+  value = std::strtof(buffer, &parsedEnd);
+  if(parsedEnd != buffer + length)
+  {
+    return nullptr;
+  }
+  return stop;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+const char* EbsdTextParser::ParseInt(const char* pos, const char* end, int32_t& value)
+{
+  const char* start = skipDelimiters(pos, end);
+  const char* stop = tokenEnd(start, end);
+  const char* cur = start;
+  bool negative = (cur < stop && *cur == '-');
+  if(cur < stop && (*cur == '-' || *cur == '+'))
+  {
+    ++cur;
+  }
+  if(cur == stop || stop - cur > 10)
+  {
+    return nullptr;
+  }
+  int64_t result = 0;
+  for(; cur < stop; ++cur)
+  {
+    if(*cur < '0' || *cur > '9')
+    {
+      return nullptr;
+    }
+    result = result * 10 + (*cur - '0');
+  }
+  result = negative ? -result : result;
+  if(result < INT32_MIN || result > INT32_MAX)
+  {
+    return nullptr;
+  }
+  value = static_cast<int32_t>(result);
+  return stop;
+}
@@ -0,0 +1,119 @@
+/* ============================================================================
+ * Copyright (c) 2020 BlueQuartz Software, LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the BlueQuartz Software contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+#include "OrientationAnalysis/OrientationAnalysisDLLExport.h"
+
+/**
+ * @brief The EbsdTextParser class parses the data lines of a text EBSD file (.ang or .ctf) in parallel. The file
+ * is memory mapped and split into chunks of whole lines. Every data line is handed to a line parser along with its
+ * index so that the values can be written straight into their final arrays.
+ */
+class OrientationAnalysis_EXPORT EbsdTextParser
+{
+public:
+  /**
+   * @brief The LineParser is called with the index of a data line and the characters of the line without its
+   * line ending. It returns false if the line could not be parsed. Line parsers are called from several threads at
+   * once, so they may only write to the elements that belong to their line.
+   */
+  using LineParser = std::function<bool(size_t, const char*, const char*)>;
+
+  explicit EbsdTextParser(const QString& filePath);
+  virtual ~EbsdTextParser();
+
+  /**
+   * @brief Memory maps the file.
+   * @return false if the file could not be opened or mapped
+   */
+  bool map();
+
+  /**
+   * @brief Returns the first character of the mapped file
+   */
+  const char* begin() const;
+
+  /**
+   * @brief Returns one past the last character of the mapped file
+   */
+  const char* end() const;
+
+  /**
+   * @brief Parses the data lines from dataStart to the end of the file. Blank lines are skipped and lines past
+   * maxLines are ignored.
+   * @param dataStart The first character of the first data line
+   * @param maxLines The number of data lines that are parsed
+   * @param parseLine The parser for a single data line
+   * @return The number of data lines in the file, or -1 if a line could not be parsed
+   */
+  int64_t parseLines(const char* dataStart, size_t maxLines, const LineParser& parseLine) const;
+
+  /**
+   * @brief Returns the first character of the line following pos, or end if there is none
+   */
+  static const char* NextLine(const char* pos, const char* end);
+
+  /**
+   * @brief Returns true if the characters between pos and end are all delimiters
+   */
+  static bool IsBlank(const char* pos, const char* end);
+
+  /**
+   * @brief Parses the next delimited token as a float. Tokens are separated by spaces, tabs or commas.
+   * @return One past the end of the token, or nullptr if there is no token or it is not a number
+   */
+  static const char* ParseFloat(const char* pos, const char* end, float& value);
+
+  /**
+   * @brief Parses the next delimited token as an integer. Tokens are separated by spaces, tabs or commas.
+   * @return One past the end of the token, or nullptr if there is no token or it is not an integer
+   */
+  static const char* ParseInt(const char* pos, const char* end, int32_t& value);
+
+private:
+  QFile m_File;
+  const char* m_Begin = nullptr;
+  const char* m_End = nullptr;
+
+public:
+  EbsdTextParser(const EbsdTextParser&) = delete;            // Copy Constructor Not Implemented
+  EbsdTextParser(EbsdTextParser&&) = delete;                 // Move Constructor Not Implemented
+  EbsdTextParser& operator=(const EbsdTextParser&) = delete; // Copy Assignment Not Implemented
+  EbsdTextParser& operator=(EbsdTextParser&&) = delete;      // Move Assignment Not Implemented
+};
@@ -34,7 +34,13 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "EbsdToH5Ebsd.h"
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
 #include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 #include <QtCore/QTextStream>
 
 #include "H5Support/H5ScopedSentinel.h"
@@ -52,6 +58,102 @@
 #include "OrientationAnalysis/OrientationAnalysisConstants.h"
 #include "OrientationAnalysis/OrientationAnalysisVersion.h"
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/task_group.h>
+#endif
+
+namespace
+{
+// Upper bounds on the files read ahead of the one being imported
+constexpr int32_t k_MaxFilesAhead = 8;
+constexpr qint64 k_MaxBytesAhead = 256LL * 1024 * 1024;
+} // namespace
+
+/**
+ * @brief The EbsdFilePrefetcher class reads the EBSD files of the stack on background tasks ahead of the importer,
+ * so the operating system already caches a file by the time the importer parses it and writes it to the HDF5 file.
+ * The files read ahead of the one being imported never add up to more than a byte budget, and their number is
+ * capped as well. Without the parallel algorithms nothing is read ahead.
+ */
+class EbsdFilePrefetcher
+{
+public:
+  EbsdFilePrefetcher(const QVector<QString>& fileList, int32_t maxFilesAhead, qint64 maxBytesAhead)
+  : m_FileList(fileList)
+  , m_MaxFilesAhead(maxFilesAhead)
+  , m_MaxBytesAhead(maxBytesAhead)
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  , m_TaskGroup(new tbb::task_group)
+#endif
+  {
+    m_FileSizes.reserve(fileList.size());
+    for(const QString& filePath : fileList)
+    {
+      m_FileSizes.push_back(QFileInfo(filePath).size());
+    }
+  }
+  virtual ~EbsdFilePrefetcher()
+  {
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    m_Cancel = true;
+    m_TaskGroup->wait();
+#endif
+  }
+
+  /**
+   * @brief Starts reading the files that follow the given file in the list, as long as the files ahead of it stay
+   * within the maximum number of files and bytes. A file larger than the byte budget is never read ahead.
+   * @param index The index of the file that is about to be imported
+   */
+  void prefetchAfter(int32_t index)
+  {
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    m_NextFile = std::max(m_NextFile, index + 1);
+    qint64 bytesAhead = 0;
+    for(int32_t i = index + 1; i < m_NextFile; i++)
+    {
+      bytesAhead += m_FileSizes[i];
+    }
+    int32_t last = std::min(index + m_MaxFilesAhead, m_FileList.size() - 1);
+    for(; m_NextFile <= last; m_NextFile++)
+    {
+      if(bytesAhead + m_FileSizes[m_NextFile] > m_MaxBytesAhead)
+      {
+        break;
+      }
+      bytesAhead += m_FileSizes[m_NextFile];
+      QString filePath = m_FileList[m_NextFile];
+      std::atomic<bool>* cancel = &m_Cancel;
+      m_TaskGroup->run([filePath, cancel]() { readFile(filePath, *cancel); });
+    }
+#endif
+  }
+
+private:
+  QVector<QString> m_FileList;
+  int32_t m_MaxFilesAhead = 0;
+  qint64 m_MaxBytesAhead = 0;
+  std::vector<qint64> m_FileSizes;
+  int32_t m_NextFile = 0;
+  std::atomic<bool> m_Cancel = {false};
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  std::shared_ptr<tbb::task_group> m_TaskGroup;
+#endif
+
+  static void readFile(const QString& filePath, const std::atomic<bool>& cancel)
+  {
+    QFile file(filePath);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+      return;
+    }
+    std::vector<char> buffer(1024 * 1024);
+    while(!cancel && file.read(buffer.data(), static_cast<qint64>(buffer.size())) > 0)
+    {
+    }
+  }
+};
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -389,9 +491,13 @@ void EbsdToH5Ebsd::execute()
   int64_t biggestxDim = 0;
   int64_t biggestyDim = 0;
   int32_t totalSlicesImported = 0;
-  for(QVector<QString>::iterator filepath = fileList.begin(); filepath != fileList.end(); ++filepath)
+  // Parsing and writing a slice both happen inside the importer, so the files that come next are read from disk meanwhile
+  EbsdFilePrefetcher prefetcher(fileList, k_MaxFilesAhead, k_MaxBytesAhead);
+  int32_t fileIndex = 0;
+  for(QVector<QString>::iterator filepath = fileList.begin(); filepath != fileList.end(); ++filepath, ++fileIndex)
   {
     QString ebsdFName = *filepath;
+    prefetcher.prefetchAfter(fileIndex);
     progress = static_cast<int32_t>(z - m_ZStartIndex);
     progress = (int32_t)(100.0f * (float)(progress) / total);
     QString msg = "Converting File: " + ebsdFName;
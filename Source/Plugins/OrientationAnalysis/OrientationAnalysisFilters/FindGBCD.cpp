@@ -34,7 +34,9 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "FindGBCD.h"
 
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include <QtCore/QDateTime>
 #include <QtCore/QTextStream>
@@ -65,6 +67,7 @@
 #include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
 #include <tbb/partitioner.h>
+#include <tbb/pipeline.h>
 #endif
 
 using LaueOpsShPtrType = std::shared_ptr<LaueOps>;
@@ -79,61 +82,105 @@ enum createdPathID : RenameDataPath::DataID_t
   DataArrayID31 = 31,
 };
 
+namespace
+{
+// Faces are handed out to the threads in chunks of this many faces
+constexpr size_t k_FacesPerChunk = 1024;
+// Upper bound on the number of chunks whose GBCD entries are held in memory at the same time
+constexpr size_t k_MaxChunksInFlight = 32;
+// Number of disjoint bin ranges the GBCD histogram is split into
+constexpr size_t k_NumBinShards = 64;
+
+/**
+ * @brief The GBCDEntry struct holds the area one face adds to one GBCD bin
+ */
+struct GBCDEntry
+{
+  size_t bin;
+  double area;
+};
+
+using ShardEntries = std::vector<std::vector<GBCDEntry>>;
+} // namespace
+
 /**
  * @brief The CalculateGBCDImpl class implements a threaded algorithm that calculates the
- * grain boundary character distribution (GBCD) for a surface mesh
+ * grain boundary character distribution (GBCD) for a surface mesh. Each chunk of faces sorts the
+ * areas it adds to the GBCD by the bin shard they fall in, so that AccumulateGBCDShardsImpl can add them up
+ * with one thread per shard.
  */
 class CalculateGBCDImpl
 {
-  size_t startOffset;
-  size_t numEntriesPerTri;
+  size_t m_TotalFaces;
+  size_t m_BinsPerShard;
+  size_t m_TotalGBCDBins;
   Int32ArrayType::Pointer m_LabelsArray;
   DoubleArrayType::Pointer m_NormalsArray;
+  DoubleArrayType::Pointer m_AreasArray;
   Int32ArrayType::Pointer m_PhasesArray;
   FloatArrayType::Pointer m_EulersArray;
 
   FloatArrayType::Pointer m_GbcdDeltasArray;
   FloatArrayType::Pointer m_GbcdLimitsArray;
   Int32ArrayType::Pointer m_GbcdSizesArray;
-  Int32ArrayType::Pointer m_GbcdBinsArray;
-  BoolArrayType::Pointer m_GbcdHemiCheckArray;
+  std::vector<ShardEntries>& m_ChunkEntries;
+  std::vector<std::vector<double>>& m_ChunkFaceArea;
 
   UInt32ArrayType::Pointer m_CrystalStructuresArray;
   LaueOpsContainer m_OrientationOps;
 
 public:
-  CalculateGBCDImpl(size_t i, size_t numMisoReps, Int32ArrayType::Pointer labels, DoubleArrayType::Pointer normals, FloatArrayType::Pointer eulers, Int32ArrayType::Pointer phases,
-                    UInt32ArrayType::Pointer crystalStructures, Int32ArrayType::Pointer bins, BoolArrayType::Pointer hemiCheck, FloatArrayType::Pointer gbcdDeltas, Int32ArrayType::Pointer gbcdSizes,
-                    FloatArrayType::Pointer gbcdLimits)
-  : startOffset(i)
-  , numEntriesPerTri(numMisoReps)
+  CalculateGBCDImpl(size_t totalFaces, size_t totalGBCDBins, Int32ArrayType::Pointer labels, DoubleArrayType::Pointer normals, DoubleArrayType::Pointer areas,
+                    FloatArrayType::Pointer eulers, Int32ArrayType::Pointer phases, UInt32ArrayType::Pointer crystalStructures, FloatArrayType::Pointer gbcdDeltas, Int32ArrayType::Pointer gbcdSizes,
+                    FloatArrayType::Pointer gbcdLimits, size_t binsPerShard, std::vector<ShardEntries>& chunkEntries, std::vector<std::vector<double>>& chunkFaceArea)
+  : m_TotalFaces(totalFaces)
+  , m_BinsPerShard(binsPerShard)
+  , m_TotalGBCDBins(totalGBCDBins)
   , m_LabelsArray(std::move(labels))
   , m_NormalsArray(std::move(normals))
+  , m_AreasArray(std::move(areas))
   , m_PhasesArray(std::move(phases))
   , m_EulersArray(std::move(eulers))
   , m_GbcdDeltasArray(std::move(gbcdDeltas))
   , m_GbcdLimitsArray(std::move(gbcdLimits))
   , m_GbcdSizesArray(std::move(gbcdSizes))
-  , m_GbcdBinsArray(std::move(bins))
-  , m_GbcdHemiCheckArray(std::move(hemiCheck))
+  , m_ChunkEntries(chunkEntries)
+  , m_ChunkFaceArea(chunkFaceArea)
   , m_CrystalStructuresArray(std::move(crystalStructures))
   {
     m_OrientationOps = LaueOps::GetAllOrientationOps();
   }
   virtual ~CalculateGBCDImpl() = default;
 
-  void generate(size_t start, size_t end) const
+  /**
+   * @brief generate Sorts the GBCD entries of one chunk of faces into the buffers of the given slot
+   * @param chunk Index of the chunk of faces
+   * @param slot Index of the buffers that receive the entries and face areas
+   */
+  void generate(size_t chunk, size_t slot) const
+  {
+    size_t start = chunk * k_FacesPerChunk;
+    size_t end = std::min(start + k_FacesPerChunk, m_TotalFaces);
+    ShardEntries& entries = m_ChunkEntries[slot];
+    for(std::vector<GBCDEntry>& shard : entries)
+    {
+      shard.clear();
+    }
+    std::fill(m_ChunkFaceArea[slot].begin(), m_ChunkFaceArea[slot].end(), 0.0);
+    accumulateFaces(start, end, entries, m_ChunkFaceArea[slot].data());
+  }
+
+  void accumulateFaces(size_t start, size_t end, ShardEntries& entries, double* totalFaceArea) const
   {
 
     // We want to work with the raw pointers for speed so get those pointers.
     float* gbcdDeltas = m_GbcdDeltasArray->getPointer(0);
     float* gbcdLimits = m_GbcdLimitsArray->getPointer(0);
     int* gbcdSizes = m_GbcdSizesArray->getPointer(0);
-    int32_t* bins = m_GbcdBinsArray->getPointer(0);
-    bool* hemiCheck = m_GbcdHemiCheckArray->getPointer(0);
 
     int32_t* labels = m_LabelsArray->getPointer(0);
     double* normals = m_NormalsArray->getPointer(0);
+    double* areas = m_AreasArray->getPointer(0);
     int32_t* phases = m_PhasesArray->getPointer(0);
     float* eulers = m_EulersArray->getPointer(0);
     uint32_t* crystalStructures = m_CrystalStructuresArray->getPointer(0);
@@ -156,13 +203,11 @@ public:
     int32_t gbcd_index = 0;
     float sqCoord[2] = {0.0f, 0.0f}, sqCoordInv[2] = {0.0f, 0.0f};
     bool nhCheck = false, nhCheckInv = true;
-    int32_t SYMcounter = 0;
-    auto TRIcounter = static_cast<int64_t>(start - startOffset);
-    int64_t TRIcounterShift = 0;
+    double area = 0.0;
+    size_t phaseShift = 0;
 
     for(size_t i = start; i < end; i++)
     {
-      SYMcounter = 0;
       feature1 = labels[2 * i];
       feature2 = labels[2 * i + 1];
       normal[0] = normals[3 * i];
@@ -176,7 +221,8 @@ public:
 
       if(phases[feature1] == phases[feature2] && phases[feature1] > 0)
       {
-        TRIcounterShift = (TRIcounter * numEntriesPerTri);
+        area = areas[i];
+        phaseShift = phases[feature1] * m_TotalGBCDBins;
         uint32_t cryst = crystalStructures[phases[feature1]];
         for(int32_t q = 0; q < 2; q++)
         {
@@ -240,40 +286,29 @@ public:
                 gbcd_index = GBCDIndex(gbcdDeltas, gbcdSizes, gbcdLimits, euler_mis, sqCoord);
                 if(gbcd_index != -1)
                 {
-                  hemiCheck[TRIcounterShift + SYMcounter] = nhCheck;
-                  bins[TRIcounterShift + SYMcounter] = gbcd_index;
+                  // the second hemisphere slot holds the southern hemisphere of the square projection
+                  size_t bin = phaseShift + 2 * gbcd_index + (nhCheck ? 0 : 1);
+                  entries[bin / m_BinsPerShard].push_back({bin, area});
+                  totalFaceArea[phases[feature1]] += area;
                 }
-                SYMcounter++;
                 if(inversion == 1)
                 {
                   gbcd_index = GBCDIndex(gbcdDeltas, gbcdSizes, gbcdLimits, euler_mis, sqCoordInv);
                   if(gbcd_index != -1)
                   {
-                    hemiCheck[TRIcounterShift + SYMcounter] = nhCheckInv;
-                    bins[TRIcounterShift + SYMcounter] = gbcd_index;
+                    size_t bin = phaseShift + 2 * gbcd_index + (nhCheckInv ? 0 : 1);
+                    entries[bin / m_BinsPerShard].push_back({bin, area});
+                    totalFaceArea[phases[feature1]] += area;
                   }
-                  SYMcounter++;
                 }
               }
-              else
-              {
-                SYMcounter += 2;
-              }
             }
           }
         }
       }
-      TRIcounter++;
     }
   }
 
-#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-  void operator()(const tbb::blocked_range<size_t>& r) const
-  {
-    generate(r.begin(), r.end());
-  }
-#endif
-
   int32_t GBCDIndex(const float* gbcddelta, const int32_t* gbcdsz, const float* gbcdlimits, const float* eulerN, const float* sqCoord) const
   {
     int32_t gbcd_index;
@@ -357,6 +392,43 @@ public:
   }
 };
 
+/**
+ * @brief The AccumulateGBCDShardsImpl class adds the areas one chunk of faces collected in CalculateGBCDImpl into
+ * the GBCD. Every shard owns a disjoint range of bins and adds its areas in face order. Chunks are added in order,
+ * so the sums do not depend on the threads.
+ */
+class AccumulateGBCDShardsImpl
+{
+  double* m_GBCD;
+  const ShardEntries& m_Entries;
+
+public:
+  AccumulateGBCDShardsImpl(double* gbcd, const ShardEntries& entries)
+  : m_GBCD(gbcd)
+  , m_Entries(entries)
+  {
+  }
+  virtual ~AccumulateGBCDShardsImpl() = default;
+
+  void convert(size_t shardStart, size_t shardEnd) const
+  {
+    for(size_t s = shardStart; s < shardEnd; s++)
+    {
+      for(const GBCDEntry& entry : m_Entries[s])
+      {
+        m_GBCD[entry.bin] += entry.area;
+      }
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+};
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -374,8 +446,6 @@ FindGBCD::FindGBCD()
   m_GbcdDeltasArray = FloatArrayType::NullPointer();
   m_GbcdSizesArray = Int32ArrayType::NullPointer();
   m_GbcdLimitsArray = FloatArrayType::NullPointer();
-  m_GbcdBinsArray = Int32ArrayType::NullPointer();
-  m_GbcdHemiCheckArray = BoolArrayType::NullPointer();
 }
 
 // -----------------------------------------------------------------------------
@@ -455,14 +525,10 @@ void FindGBCD::initialize()
   m_GbcdDeltasArray = FloatArrayType::NullPointer();
   m_GbcdSizesArray = Int32ArrayType::NullPointer();
   m_GbcdLimitsArray = FloatArrayType::NullPointer();
-  m_GbcdBinsArray = Int32ArrayType::NullPointer();
-  m_GbcdHemiCheckArray = BoolArrayType::NullPointer();
 
   m_GbcdDeltas = nullptr;
   m_GbcdSizes = nullptr;
   m_GbcdLimits = nullptr;
-  m_GbcdBins = nullptr;
-  m_HemiCheck = nullptr;
 }
 
 // -----------------------------------------------------------------------------
@@ -508,8 +574,8 @@ void FindGBCD::dataCheckSurfaceMesh()
     m_SurfaceMeshFaceAreas = m_SurfaceMeshFaceAreasPtr.lock()->getPointer(0);
   } /* Now assign the raw pointer to data from the DataArray<T> object */
 
-  // call the sizeGBCD function to get the GBCD ranges, dimensions, etc.  Note that the input parameters do not affect the size and can be dummy values here;
-  sizeGBCD(0, 0);
+  // call the sizeGBCD function to get the GBCD ranges, dimensions, etc.
+  sizeGBCD();
   cDims.resize(6);
   cDims[0] = m_GbcdSizes[0];
   cDims[1] = m_GbcdSizes[1];
@@ -585,96 +651,96 @@ void FindGBCD::execute()
 
   size_t totalPhases = m_CrystalStructuresPtr.lock()->getNumberOfTuples();
   size_t totalFaces = m_SurfaceMeshFaceLabelsPtr.lock()->getNumberOfTuples();
-  size_t faceChunkSize = 50000;
-  size_t numMisoReps = 576 * 4;
-  if(totalFaces < faceChunkSize)
-  {
-    faceChunkSize = totalFaces;
-  }
-  // call the sizeGBCD function with proper chunkSize and numMisoReps to get Bins array set up properly
-  sizeGBCD(faceChunkSize, numMisoReps);
+  // call the sizeGBCD function to get the GBCD ranges, dimensions, etc.
+  sizeGBCD();
   int32_t totalGBCDBins = m_GbcdSizes[0] * m_GbcdSizes[1] * m_GbcdSizes[2] * m_GbcdSizes[3] * m_GbcdSizes[4] * 2;
 
+  // The bins are split into a fixed number of shards. Each chunk of faces sorts the areas it adds by shard,
+  // then every shard adds its areas straight into the GBCD, so no thread needs a histogram of its own.
+  // The chunks stream through a pipeline: later chunks are computed while earlier ones are added to the
+  // GBCD, which happens strictly in chunk order. At most k_MaxChunksInFlight chunks are held in memory.
+  size_t totalBins = totalPhases * static_cast<size_t>(totalGBCDBins);
+  size_t binsPerShard = std::max<size_t>(1, (totalBins + k_NumBinShards - 1) / k_NumBinShards);
+  size_t numShards = (totalBins + binsPerShard - 1) / binsPerShard;
+  size_t totalChunks = (totalFaces + k_FacesPerChunk - 1) / k_FacesPerChunk;
+  size_t numSlots = std::max<size_t>(1, std::min(totalChunks, k_MaxChunksInFlight));
+  std::vector<ShardEntries> chunkEntries(numSlots, ShardEntries(numShards));
+  std::vector<std::vector<double>> chunkFaceArea(numSlots, std::vector<double>(totalPhases, 0.0));
+  std::vector<double> totalFaceArea(totalPhases, 0.0);
+
   uint64_t millis = QDateTime::currentMSecsSinceEpoch();
   uint64_t currentMillis = millis;
   uint64_t startMillis = millis;
   uint64_t estimatedTime = 0;
   float timeDiff = 0.0f;
   startMillis = QDateTime::currentMSecsSinceEpoch();
-  int32_t hemisphere = 0;
 
-  // create an array to hold the total face area for each phase and initialize the array to 0.0
-  DoubleArrayType::Pointer totalFaceAreaPtr = DoubleArrayType::CreateArray(totalPhases, std::string("totalFaceArea"), true);
-  totalFaceAreaPtr->initializeWithValue(0.0);
-  double* totalFaceArea = totalFaceAreaPtr->getPointer(0);
+  CalculateGBCDImpl calculateImpl(totalFaces, totalGBCDBins, m_SurfaceMeshFaceLabelsPtr.lock(), m_SurfaceMeshFaceNormalsPtr.lock(), m_SurfaceMeshFaceAreasPtr.lock(), m_FeatureEulerAnglesPtr.lock(),
+                                  m_FeaturePhasesPtr.lock(), m_CrystalStructuresPtr.lock(), m_GbcdDeltasArray, m_GbcdSizesArray, m_GbcdLimitsArray, binsPerShard, chunkEntries, chunkFaceArea);
 
-  QString ss = QObject::tr("Calculating GBCD || 0/%1 Completed").arg(totalFaces);
-  for(size_t i = 0; i < totalFaces; i = i + faceChunkSize)
-  {
-    if(getCancel())
-    {
-      return;
-    }
-    if(i + faceChunkSize >= totalFaces)
-    {
-      faceChunkSize = totalFaces - i;
-    }
-    m_GbcdBinsArray->initializeWithValue(-1);
+  // Adds the entries of a finished chunk to the GBCD. Must be called in chunk order.
+  auto addChunk = [&](size_t chunk, size_t slot) {
+    AccumulateGBCDShardsImpl accumulateImpl(m_GBCD, chunkEntries[slot]);
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-    tbb::parallel_for(tbb::blocked_range<size_t>(i, i + faceChunkSize),
-                      CalculateGBCDImpl(i, numMisoReps, m_SurfaceMeshFaceLabelsPtr.lock(), m_SurfaceMeshFaceNormalsPtr.lock(), m_FeatureEulerAnglesPtr.lock(), m_FeaturePhasesPtr.lock(),
-                                        m_CrystalStructuresPtr.lock(), m_GbcdBinsArray, m_GbcdHemiCheckArray, m_GbcdDeltasArray, m_GbcdSizesArray, m_GbcdLimitsArray),
-                      tbb::auto_partitioner());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numShards, 1), accumulateImpl, tbb::simple_partitioner());
 #else
-    CalculateGBCDImpl serial(i, numMisoReps, m_SurfaceMeshFaceLabelsPtr.lock(), m_SurfaceMeshFaceNormalsPtr.lock(), m_FeatureEulerAnglesPtr.lock(), m_FeaturePhasesPtr.lock(),
-                             m_CrystalStructuresPtr.lock(), m_GbcdBinsArray, m_GbcdHemiCheckArray, m_GbcdDeltasArray, m_GbcdSizesArray, m_GbcdLimitsArray);
-    serial.generate(i, i + faceChunkSize);
+    accumulateImpl.convert(0, numShards);
 #endif
+    for(size_t j = 0; j < totalPhases; j++)
+    {
+      totalFaceArea[j] += chunkFaceArea[slot][j];
+    }
 
+    size_t facesCompleted = std::min((chunk + 1) * k_FacesPerChunk, totalFaces);
     currentMillis = QDateTime::currentMSecsSinceEpoch();
     if(currentMillis - millis > 1000)
     {
-      QString ss = QObject::tr("Calculating GBCD || Triangles %1/%2 Completed").arg(i).arg(totalFaces);
-      timeDiff = ((float)i / (float)(currentMillis - startMillis));
-      estimatedTime = (float)(totalFaces - i) / timeDiff;
+      QString ss = QObject::tr("Calculating GBCD || Triangles %1/%2 Completed").arg(facesCompleted).arg(totalFaces);
+      timeDiff = ((float)facesCompleted / (float)(currentMillis - startMillis));
+      estimatedTime = (float)(totalFaces - facesCompleted) / timeDiff;
       ss = ss + QObject::tr(" || Est. Time Remain: %1").arg(DREAM3D::convertMillisToHrsMinSecs(estimatedTime));
       millis = QDateTime::currentMSecsSinceEpoch();
       notifyStatusMessage(ss);
     }
+  };
 
+  QString ss = QObject::tr("Calculating GBCD || 0/%1 Completed").arg(totalFaces);
+  notifyStatusMessage(ss);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  // A chunk occupies its slot from the input stage until the ordered output stage is done with it. The output
+  // stage finishes the chunks in order, so chunk c + numSlots can only start once chunk c has left its slot.
+  size_t nextChunk = 0;
+  tbb::parallel_pipeline(numSlots,
+                         tbb::make_filter<void, size_t>(tbb::filter::serial_in_order,
+                                                        [&](tbb::flow_control& fc) -> size_t {
+                                                          if(nextChunk >= totalChunks || getCancel())
+                                                          {
+                                                            fc.stop();
+                                                            return 0;
+                                                          }
+                                                          return nextChunk++;
+                                                        }) &
+                             tbb::make_filter<size_t, size_t>(tbb::filter::parallel,
+                                                              [&](size_t chunk) -> size_t {
+                                                                calculateImpl.generate(chunk, chunk % numSlots);
+                                                                return chunk;
+                                                              }) &
+                             tbb::make_filter<size_t, void>(tbb::filter::serial_in_order, [&](size_t chunk) { addChunk(chunk, chunk % numSlots); }));
+#else
+  for(size_t chunk = 0; chunk < totalChunks; chunk++)
+  {
     if(getCancel())
     {
       return;
     }
+    calculateImpl.generate(chunk, 0);
+    addChunk(chunk, 0);
+  }
+#endif
 
-    int32_t phase = 0;
-    int32_t feature = 0;
-    double area = 0.0;
-    for(size_t j = 0; j < faceChunkSize; j++)
-    {
-      area = m_SurfaceMeshFaceAreas[i + j];
-      feature = m_SurfaceMeshFaceLabels[2 * (i + j)];
-      if(feature < 0)
-      {
-        continue;
-      }
-      phase = m_FeaturePhases[feature];
-      for(size_t k = 0; k < numMisoReps; k++)
-      {
-        if(m_GbcdBins[(j * numMisoReps) + (k)] >= 0)
-        {
-          hemisphere = 0;
-          if(!m_HemiCheck[(j * numMisoReps) + k])
-          {
-            hemisphere = 1;
-          }
-          size_t gbcdBinIdx = (j * numMisoReps) + k;
-          size_t gbcdIdx = (phase * totalGBCDBins) + (2 * m_GbcdBins[gbcdBinIdx] + hemisphere);
-          m_GBCD[gbcdIdx] += area;
-          totalFaceArea[phase] += area;
-        }
-      }
-    }
+  if(getCancel())
+  {
+    return;
   }
 
   ss = QObject::tr("Starting GBCD Normalization");
@@ -694,7 +760,7 @@ void FindGBCD::execute()
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void FindGBCD::sizeGBCD(size_t faceChunkSize, size_t numMisoReps)
+void FindGBCD::sizeGBCD()
 {
   m_GbcdDeltasArray = FloatArrayType::CreateArray(5, std::string("GBCDDeltas"), true);
   m_GbcdDeltasArray->initializeWithZeros();
@@ -702,17 +768,10 @@ void FindGBCD::sizeGBCD(size_t faceChunkSize, size_t numMisoReps)
   m_GbcdLimitsArray->initializeWithZeros();
   m_GbcdSizesArray = Int32ArrayType::CreateArray(5, std::string("GBCDSizes"), true);
   m_GbcdSizesArray->initializeWithZeros();
-  std::vector<size_t> cDims(1, numMisoReps);
-  m_GbcdBinsArray = Int32ArrayType::CreateArray(faceChunkSize, cDims, "GBCDBins", true);
-  m_GbcdBinsArray->initializeWithZeros();
-  m_GbcdHemiCheckArray = BoolArrayType::CreateArray(faceChunkSize, cDims, "GBCDHemiCheck", true);
-  m_GbcdHemiCheckArray->initializeWithValue(false);
 
   m_GbcdDeltas = m_GbcdDeltasArray->getPointer(0);
   m_GbcdSizes = m_GbcdSizesArray->getPointer(0);
   m_GbcdLimits = m_GbcdLimitsArray->getPointer(0);
-  m_GbcdBins = m_GbcdBinsArray->getPointer(0);
-  m_HemiCheck = m_GbcdHemiCheckArray->getPointer(0);
 
   // Original Ranges from Dave R.
   // m_GBCDlimits[0] = 0.0f;
@@ -35,6 +35,11 @@
 
 #include "FindKernelAvgMisorientations.h"
 
+#include <algorithm>
+#include <array>
+#include <thread>
+#include <vector>
+
 #include <QtCore/QTextStream>
 
 #include "SIMPLib/Common/Constants.h"
@@ -57,6 +62,203 @@
 #include "OrientationAnalysis/OrientationAnalysisConstants.h"
 #include "OrientationAnalysis/OrientationAnalysisVersion.h"
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
+/**
+ * @brief The FindKernelAvgMisorientationsImpl class computes the kernel average misorientations of slabs of
+ * whole rows of the volume. The misorientation of a pair of Cells is only computed once when both Cells
+ * lie in the same slab and is added to the kernel sums of both Cells. Pairs that cross the boundary of a slab
+ * are computed by each of the two slabs for its own Cell, so no two slabs ever write to the same Cell.
+ */
+class FindKernelAvgMisorientationsImpl
+{
+public:
+  FindKernelAvgMisorientationsImpl(int32_t* featureIds, int32_t* cellPhases, uint32_t* crystalStructures, float* quats, float* kernelAverageMisorientations, const IntVec3Type& kernelSize,
+                                   int64_t xPoints, int64_t yPoints, int64_t zPoints, const std::vector<int64_t>& slabStart)
+  : m_FeatureIds(featureIds)
+  , m_CellPhases(cellPhases)
+  , m_CrystalStructures(crystalStructures)
+  , m_Quats(quats)
+  , m_KernelAverageMisorientations(kernelAverageMisorientations)
+  , m_XPoints(xPoints)
+  , m_YPoints(yPoints)
+  , m_ZPoints(zPoints)
+  , m_SlabStart(slabStart)
+  , m_KernelRows(kernelSize[2] * yPoints + kernelSize[1])
+  , m_OrientationOps(LaueOps::GetAllOrientationOps())
+  {
+    // Keep only the half of the kernel that comes after the center Cell in memory. Every other offset
+    // of the kernel is the negative of one of these.
+    for(int32_t j = 0; j < kernelSize[2] + 1; j++)
+    {
+      for(int32_t k = -kernelSize[1]; k < kernelSize[1] + 1; k++)
+      {
+        for(int32_t l = -kernelSize[0]; l < kernelSize[0] + 1; l++)
+        {
+          if(j > 0 || k > 0 || (k == 0 && l > 0))
+          {
+            m_ForwardOffsets.push_back({l, k, j});
+          }
+        }
+      }
+    }
+  }
+  virtual ~FindKernelAvgMisorientationsImpl() = default;
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t slab = start; slab < end; slab++)
+    {
+      convertSlab(m_SlabStart[slab], m_SlabStart[slab + 1]);
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+
+private:
+  int32_t* m_FeatureIds;
+  int32_t* m_CellPhases;
+  uint32_t* m_CrystalStructures;
+  float* m_Quats;
+  float* m_KernelAverageMisorientations;
+  int64_t m_XPoints;
+  int64_t m_YPoints;
+  int64_t m_ZPoints;
+  const std::vector<int64_t>& m_SlabStart;
+  int64_t m_KernelRows;
+  std::vector<LaueOps::Pointer> m_OrientationOps;
+  std::vector<std::array<int32_t, 3>> m_ForwardOffsets;
+
+  bool isKernelCenter(int64_t point) const
+  {
+    return m_FeatureIds[point] > 0 && m_CellPhases[point] > 0;
+  }
+
+  float misorientation(int64_t point, int64_t neighbor) const
+  {
+    const float* quat1 = m_Quats + point * 4;
+    const float* quat2 = m_Quats + neighbor * 4;
+    QuatF q1(quat1[0], quat1[1], quat1[2], quat1[3]);
+    QuatF q2(quat2[0], quat2[1], quat2[2], quat2[3]);
+    uint32_t phase1 = m_CrystalStructures[m_CellPhases[point]];
+    OrientationF axisAngle = m_OrientationOps[phase1]->calculateMisorientation(q1, q2);
+    return static_cast<float>(axisAngle[3] * SIMPLib::Constants::k_180OverPiD);
+  }
+
+  /**
+   * @brief Returns the index of the Cell at the given offset from the Cell at (col, row, plane), or -1 if
+   * the offset Cell lies outside of the volume or belongs to a different Feature
+   */
+  int64_t kernelNeighbor(int64_t point, int64_t col, int64_t row, int64_t plane, int32_t l, int32_t k, int32_t j) const
+  {
+    if(plane + j < 0 || plane + j > m_ZPoints - 1 || row + k < 0 || row + k > m_YPoints - 1 || col + l < 0 || col + l > m_XPoints - 1)
+    {
+      return -1;
+    }
+    int64_t neighbor = point + (j * m_XPoints * m_YPoints) + (k * m_XPoints) + l;
+    return m_FeatureIds[point] == m_FeatureIds[neighbor] ? neighbor : -1;
+  }
+
+  void convertSlab(int64_t rowStart, int64_t rowEnd) const
+  {
+    int64_t slabStartPoint = rowStart * m_XPoints;
+    int64_t slabEndPoint = rowEnd * m_XPoints;
+    std::fill(m_KernelAverageMisorientations + slabStartPoint, m_KernelAverageMisorientations + slabEndPoint, 0.0f);
+
+    // Sum the misorientations of the kernel of every Cell in the slab, walking the slab with x innermost
+    for(int64_t r = rowStart; r < rowEnd; r++)
+    {
+      int64_t plane = r / m_YPoints;
+      int64_t row = r % m_YPoints;
+      for(int64_t col = 0; col < m_XPoints; col++)
+      {
+        int64_t point = r * m_XPoints + col;
+        if(m_FeatureIds[point] == 0)
+        {
+          continue;
+        }
+        // A Cell that is not a kernel center still lies in the kernels of its neighbors
+        bool pointIsCenter = isKernelCenter(point);
+        float* pointSum = m_KernelAverageMisorientations + point;
+        if(pointIsCenter)
+        {
+          *pointSum += misorientation(point, point);
+        }
+
+        uint32_t phase1 = m_CrystalStructures[m_CellPhases[point]];
+        for(const std::array<int32_t, 3>& offset : m_ForwardOffsets)
+        {
+          int64_t neighbor = kernelNeighbor(point, col, row, plane, offset[0], offset[1], offset[2]);
+          if(neighbor < 0)
+          {
+            continue;
+          }
+          // The neighbor always comes after the point, so it belongs to this slab or to a later one
+          bool neighborIsCenter = neighbor < slabEndPoint && isKernelCenter(neighbor);
+          if(pointIsCenter)
+          {
+            float value = misorientation(point, neighbor);
+            *pointSum += value;
+            if(neighborIsCenter)
+            {
+              uint32_t phase2 = m_CrystalStructures[m_CellPhases[neighbor]];
+              m_KernelAverageMisorientations[neighbor] += (phase1 == phase2) ? value : misorientation(neighbor, point);
+            }
+          }
+          else if(neighborIsCenter)
+          {
+            m_KernelAverageMisorientations[neighbor] += misorientation(neighbor, point);
+          }
+        }
+
+        // Pairs with a neighbor in an earlier slab were only counted for the neighbor there
+        if(pointIsCenter && r - m_KernelRows < rowStart)
+        {
+          for(const std::array<int32_t, 3>& offset : m_ForwardOffsets)
+          {
+            int64_t neighbor = kernelNeighbor(point, col, row, plane, -offset[0], -offset[1], -offset[2]);
+            if(neighbor >= 0 && neighbor < slabStartPoint)
+            {
+              *pointSum += misorientation(point, neighbor);
+            }
+          }
+        }
+      }
+    }
+
+    // Turn the sums into averages over the kernel Cells that belong to the same Feature
+    for(int64_t r = rowStart; r < rowEnd; r++)
+    {
+      int64_t plane = r / m_YPoints;
+      int64_t row = r % m_YPoints;
+      for(int64_t col = 0; col < m_XPoints; col++)
+      {
+        int64_t point = r * m_XPoints + col;
+        if(!isKernelCenter(point))
+        {
+          continue;
+        }
+        int32_t numVoxel = 1;
+        for(const std::array<int32_t, 3>& offset : m_ForwardOffsets)
+        {
+          numVoxel += (kernelNeighbor(point, col, row, plane, offset[0], offset[1], offset[2]) >= 0) ? 1 : 0;
+          numVoxel += (kernelNeighbor(point, col, row, plane, -offset[0], -offset[1], -offset[2]) >= 0) ? 1 : 0;
+        }
+        m_KernelAverageMisorientations[point] /= static_cast<float>(numVoxel);
+      }
+    }
+  }
+};
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -206,102 +408,33 @@ void FindKernelAvgMisorientations::execute()
 
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(m_FeatureIdsArrayPath.getDataContainerName());
 
-  std::vector<LaueOps::Pointer> m_OrientationOps = LaueOps::GetAllOrientationOps();
-  FloatArrayType::Pointer quatPtr = m_QuatsPtr.lock();
-
-  int32_t numVoxel = 0; // number of voxels in the feature...
-  bool good = false;
-
-  float totalmisorientation = 0.0f;
-
-  uint32_t phase1 = EbsdLib::CrystalStructure::UnknownCrystalStructure;
-  uint32_t phase2 = EbsdLib::CrystalStructure::UnknownCrystalStructure;
   SizeVec3Type udims = m->getGeometryAs<ImageGeom>()->getDimensions();
 
   int64_t xPoints = static_cast<int64_t>(udims[0]);
   int64_t yPoints = static_cast<int64_t>(udims[1]);
   int64_t zPoints = static_cast<int64_t>(udims[2]);
-  int64_t point = 0;
-  size_t neighbor = 0;
-  int64_t jStride = 0;
-  int64_t kStride = 0;
-  float* currentQuatPtr = nullptr;
-  for(int64_t col = 0; col < xPoints; col++)
+  int64_t totalRows = yPoints * zPoints;
+
+  // Split the volume into slabs of whole rows. Pairs that cross a slab boundary are computed twice, so
+  // every slab is kept several kernels thick.
+  size_t numSlabs = 1;
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  int64_t kernelRows = m_KernelSize[2] * yPoints + m_KernelSize[1] + 1;
+  int64_t maxSlabs = static_cast<int64_t>(std::thread::hardware_concurrency()) * 4;
+  numSlabs = static_cast<size_t>(std::max<int64_t>(1, std::min<int64_t>(maxSlabs, totalRows / (kernelRows * 4))));
+#endif
+  std::vector<int64_t> slabStart(numSlabs + 1, 0);
+  for(size_t s = 0; s <= numSlabs; s++)
   {
-    for(int64_t row = 0; row < yPoints; row++)
-    {
-      for(int64_t plane = 0; plane < zPoints; plane++)
-      {
-        point = (plane * xPoints * yPoints) + (row * xPoints) + col;
-        if(m_FeatureIds[point] > 0 && m_CellPhases[point] > 0)
-        {
-          totalmisorientation = 0.0f;
-          numVoxel = 0;
-          currentQuatPtr = quatPtr->getTuplePointer(point);
-          QuatF q1(currentQuatPtr[0], currentQuatPtr[1], currentQuatPtr[2], currentQuatPtr[3]);
-
-          phase1 = m_CrystalStructures[m_CellPhases[point]];
-          for(int32_t j = -m_KernelSize[2]; j < m_KernelSize[2] + 1; j++)
-          {
-            jStride = j * xPoints * yPoints;
-            for(int32_t k = -m_KernelSize[1]; k < m_KernelSize[1] + 1; k++)
-            {
-              kStride = k * xPoints;
-              for(int32_t l = -m_KernelSize[0]; l < m_KernelSize[0] + 1; l++)
-              {
-                good = true;
-                neighbor = point + (jStride) + (kStride) + (l);
-                if(plane + j < 0)
-                {
-                  good = false;
-                }
-                else if(plane + j > zPoints - 1)
-                {
-                  good = false;
-                }
-                else if(row + k < 0)
-                {
-                  good = false;
-                }
-                else if(row + k > yPoints - 1)
-                {
-                  good = false;
-                }
-                else if(col + l < 0)
-                {
-                  good = false;
-                }
-                else if(col + l > xPoints - 1)
-                {
-                  good = false;
-                }
-                if(good && m_FeatureIds[point] == m_FeatureIds[neighbor])
-                {
-                  currentQuatPtr = quatPtr->getTuplePointer(neighbor);
-
-                  QuatF q2(currentQuatPtr[0], currentQuatPtr[1], currentQuatPtr[2], currentQuatPtr[3]);
-                  phase2 = m_CrystalStructures[m_CellPhases[neighbor]];
-                  OrientationF axisAngle = m_OrientationOps[phase1]->calculateMisorientation(q1, q2);
-
-                  totalmisorientation = totalmisorientation + (axisAngle[3] * SIMPLib::Constants::k_180OverPiD);
-                  numVoxel++;
-                }
-              }
-            }
-          }
-          m_KernelAverageMisorientations[point] = totalmisorientation / (float)numVoxel;
-          if(numVoxel == 0)
-          {
-            m_KernelAverageMisorientations[point] = 0.0f;
-          }
-        }
-        if(m_FeatureIds[point] == 0 || m_CellPhases[point] == 0)
-        {
-          m_KernelAverageMisorientations[point] = 0.0f;
-        }
-      }
-    }
+    slabStart[s] = (totalRows * static_cast<int64_t>(s)) / static_cast<int64_t>(numSlabs);
   }
+
+  FindKernelAvgMisorientationsImpl impl(m_FeatureIds, m_CellPhases, m_CrystalStructures, m_Quats, m_KernelAverageMisorientations, getKernelSize(), xPoints, yPoints, zPoints, slabStart);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, numSlabs, 1), impl, tbb::simple_partitioner());
+#else
+  impl.convert(0, numSlabs);
+#endif
 }
 
 // -----------------------------------------------------------------------------
@@ -54,6 +54,7 @@
 #include "EbsdLib/IO/TSL/AngFields.h"
 
 #include "OrientationAnalysis/OrientationAnalysisConstants.h"
+#include "OrientationAnalysis/OrientationAnalysisFilters/EbsdTextHelpers/EbsdTextParser.h"
 #include "OrientationAnalysis/OrientationAnalysisVersion.h"
 
 enum createdPathID : RenameDataPath::DataID_t
@@ -366,7 +367,8 @@ void ReadAngData::readDataFile(AngReader* reader, DataContainer* m, std::vector<
     }
     else
     {
-      int32_t err = reader->readFile();
+      // The data lines are parsed afterwards, straight into the Cell arrays
+      int32_t err = reader->readHeaderOnly();
       if(err < 0)
       {
         setErrorCondition(err, S2Q(reader->getErrorMessage()));
@@ -616,6 +618,107 @@ void ReadAngData::copyRawEbsdData(AngReader* reader, std::vector<size_t>& tDims,
   }
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ReadAngData::parseRawEbsdData(std::vector<size_t>& tDims, std::vector<size_t>& cDims)
+{
+  EbsdTextParser parser(m_InputFile);
+  if(!parser.map())
+  {
+    return false;
+  }
+
+  // The header lines all start with a '#'
+  const char* dataStart = parser.begin();
+  while(dataStart < parser.end())
+  {
+    const char* next = EbsdTextParser::NextLine(dataStart, parser.end());
+    const char* first = dataStart;
+    while(first < next && (*first == ' ' || *first == '\t'))
+    {
+      ++first;
+    }
+    if(first < next && *first != '#' && !EbsdTextParser::IsBlank(first, next - (next[-1] == '\n' ? 1 : 0)))
+    {
+      break;
+    }
+    dataStart = next;
+  }
+
+  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getDataContainerName());
+  AttributeMatrix::Pointer ebsdAttrMat = m->getAttributeMatrix(getCellAttributeMatrixName());
+
+  size_t totalPoints = m->getGeometryAs<ImageGeom>()->getNumberOfElements();
+
+  tDims.resize(3);
+  tDims[0] = m->getGeometryAs<ImageGeom>()->getXPoints();
+  tDims[1] = m->getGeometryAs<ImageGeom>()->getYPoints();
+  tDims[2] = m->getGeometryAs<ImageGeom>()->getZPoints();
+
+  // Parse straight into the Cell arrays that dataCheck() created. If one of them is missing the AngReader path
+  // is used instead, which creates every array itself.
+  ebsdAttrMat->resizeAttributeArrays(tDims);
+  Int32ArrayType::Pointer phaseArray = ebsdAttrMat->getAttributeArrayAs<Int32ArrayType>(SIMPL::CellData::Phases);
+  FloatArrayType::Pointer eulerArray = ebsdAttrMat->getAttributeArrayAs<FloatArrayType>(SIMPL::CellData::EulerAngles);
+  FloatArrayType::Pointer iqArray = ebsdAttrMat->getAttributeArrayAs<FloatArrayType>(S2Q(EbsdLib::Ang::ImageQuality));
+  FloatArrayType::Pointer ciArray = ebsdAttrMat->getAttributeArrayAs<FloatArrayType>(S2Q(EbsdLib::Ang::ConfidenceIndex));
+  FloatArrayType::Pointer semArray = ebsdAttrMat->getAttributeArrayAs<FloatArrayType>(S2Q(EbsdLib::Ang::SEMSignal));
+  FloatArrayType::Pointer fitArray = ebsdAttrMat->getAttributeArrayAs<FloatArrayType>(S2Q(EbsdLib::Ang::Fit));
+  FloatArrayType::Pointer xArray = ebsdAttrMat->getAttributeArrayAs<FloatArrayType>(S2Q(EbsdLib::Ang::XPosition));
+  FloatArrayType::Pointer yArray = ebsdAttrMat->getAttributeArrayAs<FloatArrayType>(S2Q(EbsdLib::Ang::YPosition));
+  if(nullptr == phaseArray || nullptr == eulerArray || eulerArray->getNumberOfComponents() != 3 || nullptr == iqArray || nullptr == ciArray || nullptr == semArray || nullptr == fitArray ||
+     nullptr == xArray || nullptr == yArray)
+  {
+    return false;
+  }
+
+  int32_t* phases = phaseArray->getPointer(0);
+  float* eulers = eulerArray->getPointer(0);
+  float* iq = iqArray->getPointer(0);
+  float* ci = ciArray->getPointer(0);
+  float* sem = semArray->getPointer(0);
+  float* fit = fitArray->getPointer(0);
+  float* xPos = xArray->getPointer(0);
+  float* yPos = yArray->getPointer(0);
+
+  // The columns are phi1, Phi, phi2, x, y, IQ, CI, Phase and optionally SEM Signal and Fit. Any further columns are ignored
+  EbsdTextParser::LineParser parseLine = [&](size_t index, const char* pos, const char* end) -> bool {
+    float values[10] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    int32_t numValues = 0;
+    while(numValues < 10)
+    {
+      const char* next = EbsdTextParser::ParseFloat(pos, end, values[numValues]);
+      if(nullptr == next)
+      {
+        break;
+      }
+      pos = next;
+      numValues++;
+    }
+    if(numValues < 8 || (numValues < 10 && !EbsdTextParser::IsBlank(pos, end)))
+    {
+      return false;
+    }
+    eulers[3 * index] = values[0];
+    eulers[3 * index + 1] = values[1];
+    eulers[3 * index + 2] = values[2];
+    xPos[index] = values[3];
+    yPos[index] = values[4];
+    iq[index] = values[5];
+    ci[index] = values[6];
+    // Adjust the values of the 'phase' data to correct for invalid values
+    int32_t phase = static_cast<int32_t>(values[7]);
+    phases[index] = (phase < 1) ? 1 : phase;
+    sem[index] = values[8];
+    fit[index] = values[9];
+    return true;
+  };
+
+  int64_t numLines = parser.parseLines(dataStart, totalPoints, parseLine);
+  return numLines >= static_cast<int64_t>(totalPoints);
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -641,7 +744,21 @@ void ReadAngData::execute()
   {
     return;
   }
-  copyRawEbsdData(reader.get(), tDims, cDims);
+
+  // Files with a layout the parallel parser does not recognize are read with the AngReader instead
+  if(!parseRawEbsdData(tDims, cDims))
+  {
+    reader = std::shared_ptr<AngReader>(new AngReader());
+    reader->setFileName(m_InputFile.toStdString());
+    int32_t err = reader->readFile();
+    if(err < 0)
+    {
+      setErrorCondition(err, S2Q(reader->getErrorMessage()));
+      setErrorCondition(getErrorCode(), "AngReader could not read the .ang file.");
+      return;
+    }
+    copyRawEbsdData(reader.get(), tDims, cDims);
+  }
 
   // Set the file name and time stamp into the cache, if we are reading from the file and after all the reading has been done
   {
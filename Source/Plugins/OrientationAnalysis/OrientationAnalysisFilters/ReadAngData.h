@@ -315,6 +315,15 @@ protected:
    */
   void copyRawEbsdData(AngReader* reader, std::vector<size_t>& tDims, std::vector<size_t>& cDims);
 
+  /**
+   * @brief parseRawEbsdData Memory maps the Ang file and parses its data lines in parallel straight into
+   * the Cell arrays that dataCheck() created
+   * @param tDims Tuple dimensions
+   * @param cDims Component dimensions
+   * @return false if the data lines could not be parsed. The AngReader path then overwrites every Cell array.
+   */
+  bool parseRawEbsdData(std::vector<size_t>& tDims, std::vector<size_t>& cDims);
+
   /**
    * @brief loadMaterialInfo Reads the values for the phase type, crystal structure
    * and precipitate fractions from the EBSD file
@@ -34,6 +34,8 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "ReadCtfData.h"
 
+#include <algorithm>
+
 #include <QtCore/QDateTime>
 #include <QtCore/QFileInfo>
 #include <QtCore/QTextStream>
@@ -56,6 +58,7 @@
 
 #include "OrientationAnalysis/OrientationAnalysisConstants.h"
 #include "OrientationAnalysis/OrientationAnalysisFilters/ChangeAngleRepresentation.h"
+#include "OrientationAnalysis/OrientationAnalysisFilters/EbsdTextHelpers/EbsdTextParser.h"
 #include "OrientationAnalysis/OrientationAnalysisVersion.h"
 
 enum createdPathID : RenameDataPath::DataID_t
@@ -362,7 +365,8 @@ void ReadCtfData::readDataFile(CtfReader* reader, DataContainer* m, std::vector<
     }
     else
     {
-      int32_t err = reader->readFile();
+      // The data lines are parsed afterwards, straight into the Cell arrays
+      int32_t err = reader->readHeaderOnly();
       if(err < 0)
       {
         setErrorCondition(err, S2Q(reader->getErrorMessage()));
@@ -627,6 +631,185 @@ void ReadCtfData::copyRawEbsdData(CtfReader* reader, std::vector<size_t>& tDims,
   }
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ReadCtfData::parseRawEbsdData(std::vector<size_t>& tDims, std::vector<size_t>& cDims)
+{
+  EbsdTextParser parser(m_InputFile);
+  if(!parser.map())
+  {
+    return false;
+  }
+
+  enum CtfColumn
+  {
+    PhaseColumn,
+    XColumn,
+    YColumn,
+    BandsColumn,
+    ErrorColumn,
+    Euler1Column,
+    Euler2Column,
+    Euler3Column,
+    MADColumn,
+    BCColumn,
+    BSColumn,
+    UnusedColumn
+  };
+  const std::vector<std::string> columnNames = {EbsdLib::Ctf::Phase,  EbsdLib::Ctf::X,      EbsdLib::Ctf::Y,   EbsdLib::Ctf::Bands, EbsdLib::Ctf::Error, EbsdLib::Ctf::Euler1,
+                                                EbsdLib::Ctf::Euler2, EbsdLib::Ctf::Euler3, EbsdLib::Ctf::MAD, EbsdLib::Ctf::BC,    EbsdLib::Ctf::BS};
+
+  // The data lines follow the line with the column names, which starts with the Phase column
+  const char* dataStart = parser.end();
+  std::vector<int32_t> columns;
+  for(const char* pos = parser.begin(); pos < parser.end();)
+  {
+    const char* next = EbsdTextParser::NextLine(pos, parser.end());
+    const char* lineEnd = (next > pos && next[-1] == '\n') ? next - 1 : next;
+    std::vector<std::string> tokens;
+    const char* tokenStart = pos;
+    for(const char* c = pos; c <= lineEnd; c++)
+    {
+      if(c == lineEnd || *c == ' ' || *c == '\t' || *c == ',' || *c == '\r')
+      {
+        if(c > tokenStart)
+        {
+          tokens.emplace_back(tokenStart, c);
+        }
+        tokenStart = c + 1;
+      }
+    }
+    if(!tokens.empty() && tokens[0] == EbsdLib::Ctf::Phase)
+    {
+      for(const auto& token : tokens)
+      {
+        auto iter = std::find(columnNames.begin(), columnNames.end(), token);
+        columns.push_back(iter == columnNames.end() ? UnusedColumn : static_cast<int32_t>(iter - columnNames.begin()));
+      }
+      dataStart = next;
+      break;
+    }
+    pos = next;
+  }
+  for(int32_t column = PhaseColumn; column < UnusedColumn; column++)
+  {
+    if(std::count(columns.begin(), columns.end(), column) != 1)
+    {
+      return false;
+    }
+  }
+
+  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getDataContainerName());
+  AttributeMatrix::Pointer ebsdAttrMat = m->getAttributeMatrix(getCellAttributeMatrixName());
+
+  size_t totalPoints = m->getGeometryAs<ImageGeom>()->getNumberOfElements();
+
+  tDims.resize(3);
+  tDims[0] = m->getGeometryAs<ImageGeom>()->getXPoints();
+  tDims[1] = m->getGeometryAs<ImageGeom>()->getYPoints();
+  tDims[2] = m->getGeometryAs<ImageGeom>()->getZPoints();
+
+  // Parse straight into the Cell arrays that dataCheck() created. If one of them is missing the CtfReader path
+  // is used instead, which creates every array itself.
+  ebsdAttrMat->resizeAttributeArrays(tDims);
+  Int32ArrayType::Pointer phaseArray = ebsdAttrMat->getAttributeArrayAs<Int32ArrayType>(SIMPL::CellData::Phases);
+  FloatArrayType::Pointer eulerArray = ebsdAttrMat->getAttributeArrayAs<FloatArrayType>(SIMPL::CellData::EulerAngles);
+  Int32ArrayType::Pointer bandsArray = ebsdAttrMat->getAttributeArrayAs<Int32ArrayType>(S2Q(EbsdLib::Ctf::Bands));
+  Int32ArrayType::Pointer errorArray = ebsdAttrMat->getAttributeArrayAs<Int32ArrayType>(S2Q(EbsdLib::Ctf::Error));
+  FloatArrayType::Pointer madArray = ebsdAttrMat->getAttributeArrayAs<FloatArrayType>(S2Q(EbsdLib::Ctf::MAD));
+  Int32ArrayType::Pointer bcArray = ebsdAttrMat->getAttributeArrayAs<Int32ArrayType>(S2Q(EbsdLib::Ctf::BC));
+  Int32ArrayType::Pointer bsArray = ebsdAttrMat->getAttributeArrayAs<Int32ArrayType>(S2Q(EbsdLib::Ctf::BS));
+  FloatArrayType::Pointer xArray = ebsdAttrMat->getAttributeArrayAs<FloatArrayType>(S2Q(EbsdLib::Ctf::X));
+  FloatArrayType::Pointer yArray = ebsdAttrMat->getAttributeArrayAs<FloatArrayType>(S2Q(EbsdLib::Ctf::Y));
+  if(nullptr == phaseArray || nullptr == eulerArray || eulerArray->getNumberOfComponents() != 3 || nullptr == bandsArray || nullptr == errorArray || nullptr == madArray || nullptr == bcArray ||
+     nullptr == bsArray || nullptr == xArray || nullptr == yArray)
+  {
+    return false;
+  }
+
+  int32_t* phases = phaseArray->getPointer(0);
+  float* eulers = eulerArray->getPointer(0);
+  float* xPos = xArray->getPointer(0);
+  float* yPos = yArray->getPointer(0);
+  float* mad = madArray->getPointer(0);
+  int32_t* intColumns[UnusedColumn] = {nullptr};
+  intColumns[BandsColumn] = bandsArray->getPointer(0);
+  intColumns[ErrorColumn] = errorArray->getPointer(0);
+  intColumns[BCColumn] = bcArray->getPointer(0);
+  intColumns[BSColumn] = bsArray->getPointer(0);
+  size_t numCrystalStructures = m_CrystalStructuresPtr.lock()->getNumberOfTuples();
+
+  EbsdTextParser::LineParser parseLine = [&](size_t index, const char* pos, const char* end) -> bool {
+    float* euler = eulers + 3 * index;
+    int32_t phase = 0;
+    for(int32_t column : columns)
+    {
+      switch(column)
+      {
+      case PhaseColumn:
+        pos = EbsdTextParser::ParseInt(pos, end, phase);
+        break;
+      case BandsColumn:
+      case ErrorColumn:
+      case BCColumn:
+      case BSColumn:
+        pos = EbsdTextParser::ParseInt(pos, end, intColumns[column][index]);
+        break;
+      case XColumn:
+        pos = EbsdTextParser::ParseFloat(pos, end, xPos[index]);
+        break;
+      case YColumn:
+        pos = EbsdTextParser::ParseFloat(pos, end, yPos[index]);
+        break;
+      case Euler1Column:
+      case Euler2Column:
+      case Euler3Column:
+        pos = EbsdTextParser::ParseFloat(pos, end, euler[column - Euler1Column]);
+        break;
+      case MADColumn:
+        pos = EbsdTextParser::ParseFloat(pos, end, mad[index]);
+        break;
+      default:
+      {
+        float unused = 0.0f;
+        pos = EbsdTextParser::ParseFloat(pos, end, unused);
+        break;
+      }
+      }
+      if(nullptr == pos)
+      {
+        return false;
+      }
+    }
+    // Zero solutions are assigned a phase of one, see copyRawEbsdData()
+    if(phase < 1)
+    {
+      phase = 1;
+    }
+    if(static_cast<size_t>(phase) >= numCrystalStructures)
+    {
+      return false;
+    }
+    phases[index] = phase;
+    if(m_CrystalStructures[phase] == EbsdLib::CrystalStructure::Hexagonal_High && m_EdaxHexagonalAlignment)
+    {
+      euler[2] = euler[2] + (30.0); // See the documentation for this correction factor
+    }
+    // Now convert to radians if requested by the user
+    if(m_DegreesToRadians)
+    {
+      euler[0] = euler[0] * SIMPLib::Constants::k_PiOver180D;
+      euler[1] = euler[1] * SIMPLib::Constants::k_PiOver180D;
+      euler[2] = euler[2] * SIMPLib::Constants::k_PiOver180D;
+    }
+    return true;
+  };
+
+  int64_t numLines = parser.parseLines(dataStart, totalPoints, parseLine);
+  return numLines >= static_cast<int64_t>(totalPoints);
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -653,7 +836,20 @@ void ReadCtfData::execute()
     return;
   }
 
-  copyRawEbsdData(reader.get(), tDims, cDims);
+  // Files with a layout the parallel parser does not recognize are read with the CtfReader instead
+  if(!parseRawEbsdData(tDims, cDims))
+  {
+    reader = std::shared_ptr<CtfReader>(new CtfReader());
+    reader->setFileName(m_InputFile.toStdString());
+    int32_t err = reader->readFile();
+    if(err < 0)
+    {
+      setErrorCondition(err, S2Q(reader->getErrorMessage()));
+      setErrorCondition(getErrorCode(), "CtfReader could not read the .ctf file.");
+      return;
+    }
+    copyRawEbsdData(reader.get(), tDims, cDims);
+  }
 
   // Set the file name and time stamp into the cache, if we are reading from the file and after all the reading has been done
   {
@@ -128,6 +128,9 @@ if(1)
   addIpfHelper(Tetragonal)
   addIpfHelper(TrigonalLow)
   addIpfHelper(Trigonal)
+
+  ADD_SIMPL_SUPPORT_HEADER(${${PLUGIN_NAME}_SOURCE_DIR} ${_filterGroupName} EbsdTextHelpers/EbsdTextParser.h)
+  ADD_SIMPL_SUPPORT_SOURCE(${${PLUGIN_NAME}_SOURCE_DIR} ${_filterGroupName} EbsdTextHelpers/EbsdTextParser.cpp)
 endif()
 
 
@@ -0,0 +1,434 @@
+/* ============================================================================
+ * Copyright (c) 2020 BlueQuartz Software, LLC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the names of any of the BlueQuartz Software contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+
+#include "SIMPLib/SIMPLib.h"
+
+#include "UnitTestSupport.hpp"
+
+#include "EbsdLib/IO/HKL/CtfReader.h"
+#include "EbsdLib/IO/TSL/AngReader.h"
+
+#include "OrientationAnalysis/OrientationAnalysisFilters/EbsdTextHelpers/EbsdTextParser.h"
+
+#include "OrientationAnalysisTestFileLocations.h"
+
+namespace EbsdTextParserTestConsts
+{
+// Tokens for the ParseFloat checks. They cover the fast path, exponents, mantissas above 2^24, more than ten
+// fraction digits, a leading sign or point and the float limits, all of which have to round like strtof.
+const std::vector<std::string> k_FloatTokens = {"0",
+                                                "-0",
+                                                "0.5",
+                                                "-1.25",
+                                                "12.000",
+                                                "+7.5",
+                                                "1.5e-3",
+                                                "2.5E+01",
+                                                "-3e2",
+                                                "4.0e-05",
+                                                "0.123456789012",
+                                                "3.14159265358979",
+                                                "16777216",
+                                                "16777217",
+                                                "0.1",
+                                                "0.7",
+                                                "123456789.123",
+                                                "0.00000000001234",
+                                                "-0.000001",
+                                                "359.99999",
+                                                "1.",
+                                                "-.5",
+                                                "1e-45",
+                                                "3.4028235e38",
+                                                "179.876543210987654",
+                                                "12345.6789",
+                                                "0.30000001192092896"};
+
+// Values written to the float columns of the test files, cycled over the Cells
+const std::vector<std::string> k_ColumnTokens = {"0.5",       "1.5e-3",           "-3e2",                "2.5E+01", "0.123456789012", "3.14159265358979", "16777217", "12.000", "-0.000001",
+                                                 "359.99999", "0.00000000001234", "179.876543210987654", "0.1",     "4.0e-05",        "12345.6789",       "-1.25",    "123456789.123"};
+
+const size_t k_NumColumns = 4;
+const size_t k_NumRows = 3;
+const size_t k_NumPoints = k_NumColumns * k_NumRows;
+} // namespace EbsdTextParserTestConsts
+
+class EbsdTextParserTest
+{
+
+public:
+  EbsdTextParserTest() = default;
+  ~EbsdTextParserTest() = default;
+
+  /**
+   * @brief Returns the name of the class for EbsdTextParserTest
+   */
+  QString getNameOfClass() const
+  {
+    return QString("EbsdTextParserTest");
+  }
+
+  /**
+   * @brief Returns the name of the class for EbsdTextParserTest
+   */
+  QString ClassName()
+  {
+    return QString("EbsdTextParserTest");
+  }
+
+  EbsdTextParserTest(const EbsdTextParserTest&) = delete;            // Copy Constructor Not Implemented
+  EbsdTextParserTest(EbsdTextParserTest&&) = delete;                 // Move Constructor Not Implemented
+  EbsdTextParserTest& operator=(const EbsdTextParserTest&) = delete; // Copy Assignment Not Implemented
+  EbsdTextParserTest& operator=(EbsdTextParserTest&&) = delete;      // Move Assignment Not Implemented
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void RemoveTestFiles()
+  {
+#if REMOVE_TEST_FILES
+    QFile::remove(UnitTest::EbsdTextParserTest::AngFile);
+    QFile::remove(UnitTest::EbsdTextParserTest::AngCrlfFile);
+    QFile::remove(UnitTest::EbsdTextParserTest::CtfFile);
+    QFile::remove(UnitTest::EbsdTextParserTest::CtfCrlfFile);
+#endif
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  bool sameBits(float a, float b)
+  {
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  QString columnToken(size_t point, size_t column)
+  {
+    const std::vector<std::string>& tokens = EbsdTextParserTestConsts::k_ColumnTokens;
+    return QString::fromStdString(tokens[(point * 7 + column) % tokens.size()]);
+  }
+
+  // -----------------------------------------------------------------------------
+  // Every token has to give the same bits as strtof and end exactly at the token end
+  // -----------------------------------------------------------------------------
+  int TestParseFloat()
+  {
+    for(const std::string& token : EbsdTextParserTestConsts::k_FloatTokens)
+    {
+      float value = 0.0f;
+      const char* end = token.c_str() + token.size();
+      const char* next = EbsdTextParser::ParseFloat(token.c_str(), end, value);
+      DREAM3D_REQUIRE(next == end)
+      DREAM3D_REQUIRE(sameBits(value, std::strtof(token.c_str(), nullptr)))
+    }
+
+    // Tokens are separated by spaces, tabs and commas, and a trailing carriage return is a delimiter
+    std::string line = "  1.5,\t-2.5e1 ,0.125\r";
+    const char* pos = line.c_str();
+    const char* end = line.c_str() + line.size();
+    float values[3] = {0.0f, 0.0f, 0.0f};
+    for(float& value : values)
+    {
+      pos = EbsdTextParser::ParseFloat(pos, end, value);
+      DREAM3D_REQUIRE(pos != nullptr)
+    }
+    DREAM3D_REQUIRE_EQUAL(values[0], 1.5f)
+    DREAM3D_REQUIRE_EQUAL(values[1], -25.0f)
+    DREAM3D_REQUIRE_EQUAL(values[2], 0.125f)
+    float value = 0.0f;
+    DREAM3D_REQUIRE(EbsdTextParser::ParseFloat(pos, end, value) == nullptr)
+    DREAM3D_REQUIRE(EbsdTextParser::IsBlank(pos, end))
+
+    for(const std::string& token : {std::string("1.2.3"), std::string("abc"), std::string("1.5x"), std::string("-")})
+    {
+      DREAM3D_REQUIRE(EbsdTextParser::ParseFloat(token.c_str(), token.c_str() + token.size(), value) == nullptr)
+    }
+
+    int32_t intValue = 0;
+    for(const std::string& token : {std::string("1.5"), std::string("2147483648"), std::string("12a"), std::string("+")})
+    {
+      DREAM3D_REQUIRE(EbsdTextParser::ParseInt(token.c_str(), token.c_str() + token.size(), intValue) == nullptr)
+    }
+    std::string ints = "42 -7\t+3";
+    pos = ints.c_str();
+    end = ints.c_str() + ints.size();
+    int32_t expected[3] = {42, -7, 3};
+    for(int32_t e : expected)
+    {
+      pos = EbsdTextParser::ParseInt(pos, end, intValue);
+      DREAM3D_REQUIRE(pos != nullptr)
+      DREAM3D_REQUIRE_EQUAL(intValue, e)
+    }
+
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void writeFile(const QString& filePath, const QStringList& lines, const QString& lineEnding)
+  {
+    QFile file(filePath);
+    DREAM3D_REQUIRE(file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    QTextStream out(&file);
+    for(const QString& line : lines)
+    {
+      out << line << lineEnding;
+    }
+  }
+
+  // -----------------------------------------------------------------------------
+  // A single phase square grid .ang file. The columns are phi1, Phi, phi2, x, y, IQ, CI, Phase, SEM Signal and Fit.
+  // -----------------------------------------------------------------------------
+  void writeAngFile(const QString& filePath, const QString& lineEnding)
+  {
+    QStringList lines = {"# TEM_PIXperUM          1.000000",
+                         "# x-star                0.500000",
+                         "# y-star                0.500000",
+                         "# z-star                0.500000",
+                         "# WorkingDistance       15.000000",
+                         "#",
+                         "# Phase 1",
+                         "# MaterialName  \tNickel",
+                         "# Formula     \tNi",
+                         "# Info",
+                         "# Symmetry              43",
+                         "# LatticeConstants      3.560 3.560 3.560  90.000  90.000  90.000",
+                         "# NumberFamilies        0",
+                         "# Categories 0 0 0 0 0",
+                         "#",
+                         "# GRID: SqrGrid",
+                         "# XSTEP: 0.500000",
+                         "# YSTEP: 0.500000",
+                         QString("# NCOLS_ODD: %1").arg(EbsdTextParserTestConsts::k_NumColumns),
+                         QString("# NCOLS_EVEN: %1").arg(EbsdTextParserTestConsts::k_NumColumns),
+                         QString("# NROWS: %1").arg(EbsdTextParserTestConsts::k_NumRows),
+                         "#",
+                         "# OPERATOR: \t",
+                         "# SAMPLEID: \t",
+                         "# SCANID: \t",
+                         "#"};
+    for(size_t i = 0; i < EbsdTextParserTestConsts::k_NumPoints; i++)
+    {
+      QStringList columns;
+      for(size_t c = 0; c < 10; c++)
+      {
+        columns << ((c == 7) ? QString::number(i % 3 == 0 ? 0 : 1) : columnToken(i, c));
+      }
+      lines << QString("  ") + columns.join("  ");
+    }
+    writeFile(filePath, lines, lineEnding);
+  }
+
+  // -----------------------------------------------------------------------------
+  // A single phase .ctf file with tab separated columns Phase, X, Y, Bands, Error, Euler1-3, MAD, BC and BS
+  // -----------------------------------------------------------------------------
+  void writeCtfFile(const QString& filePath, const QString& lineEnding)
+  {
+    QStringList lines = {"Channel Text File",
+                         "Prj\tEbsdTextParserTest",
+                         "Author\t[Unknown]",
+                         "JobMode\tGrid",
+                         QString("XCells\t%1").arg(EbsdTextParserTestConsts::k_NumColumns),
+                         QString("YCells\t%1").arg(EbsdTextParserTestConsts::k_NumRows),
+                         "XStep\t0.5",
+                         "YStep\t0.5",
+                         "AcqE1\t0",
+                         "AcqE2\t0",
+                         "AcqE3\t0",
+                         "Euler angles refer to Sample Coordinate system (CS0)!\tMag\t100\tCoverage\t100\tDevice\t0\tKV\t20\tTiltAngle\t70\tTiltAxis\t0",
+                         "Phases\t1",
+                         "3.524;3.524;3.524\t90;90;90\tNickel\t11\t225",
+                         "Phase\tX\tY\tBands\tError\tEuler1\tEuler2\tEuler3\tMAD\tBC\tBS"};
+    for(size_t i = 0; i < EbsdTextParserTestConsts::k_NumPoints; i++)
+    {
+      QStringList columns;
+      columns << QString::number(i % 3 == 0 ? 0 : 1) << columnToken(i, 0) << columnToken(i, 1) << QString::number(5 + i % 4) << QString::number(i % 2 == 0 ? 0 : 3) << columnToken(i, 2)
+              << columnToken(i, 3) << columnToken(i, 4) << columnToken(i, 5) << QString::number(100 + i) << QString::number(200 + 7 * i);
+      lines << columns.join("\t");
+    }
+    writeFile(filePath, lines, lineEnding);
+  }
+
+  // -----------------------------------------------------------------------------
+  // Parses the data lines that follow the header of a mapped file. Every line is split into numColumns floats, or
+  // into integers for the columns flagged in intColumns, stored column by column.
+  // -----------------------------------------------------------------------------
+  int parseData(const QString& filePath, bool ctf, size_t numColumns, const std::vector<bool>& intColumns, std::vector<std::vector<float>>& floats, std::vector<std::vector<int32_t>>& ints)
+  {
+    EbsdTextParser parser(filePath);
+    DREAM3D_REQUIRE(parser.map())
+
+    // The .ang header lines start with a '#' and the .ctf data follows the line with the column names
+    const char* dataStart = parser.begin();
+    while(dataStart < parser.end())
+    {
+      const char* next = EbsdTextParser::NextLine(dataStart, parser.end());
+      if(ctf && std::strncmp(dataStart, "Phase\t", 6) == 0)
+      {
+        dataStart = next;
+        break;
+      }
+      if(!ctf && *dataStart != '#')
+      {
+        break;
+      }
+      dataStart = next;
+    }
+
+    floats.assign(numColumns, std::vector<float>(EbsdTextParserTestConsts::k_NumPoints, 0.0f));
+    ints.assign(numColumns, std::vector<int32_t>(EbsdTextParserTestConsts::k_NumPoints, 0));
+    EbsdTextParser::LineParser parseLine = [&](size_t index, const char* pos, const char* end) -> bool {
+      for(size_t c = 0; c < numColumns && nullptr != pos; c++)
+      {
+        pos = intColumns[c] ? EbsdTextParser::ParseInt(pos, end, ints[c][index]) : EbsdTextParser::ParseFloat(pos, end, floats[c][index]);
+      }
+      return nullptr != pos && EbsdTextParser::IsBlank(pos, end);
+    };
+    int64_t numLines = parser.parseLines(dataStart, EbsdTextParserTestConsts::k_NumPoints, parseLine);
+    DREAM3D_REQUIRE_EQUAL(numLines, static_cast<int64_t>(EbsdTextParserTestConsts::k_NumPoints))
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  // The .ang data parsed with EbsdTextParser from LF and CRLF files has to match the AngReader bit for bit
+  // -----------------------------------------------------------------------------
+  int TestAngFile()
+  {
+    writeAngFile(UnitTest::EbsdTextParserTest::AngFile, "\n");
+    writeAngFile(UnitTest::EbsdTextParserTest::AngCrlfFile, "\r\n");
+
+    AngReader reader;
+    reader.setFileName(UnitTest::EbsdTextParserTest::AngFile.toStdString());
+    DREAM3D_REQUIRED(reader.readFile(), >=, 0)
+
+    const std::vector<std::string> names = {EbsdLib::Ang::Phi1,         EbsdLib::Ang::Phi,             EbsdLib::Ang::Phi2,      EbsdLib::Ang::XPosition, EbsdLib::Ang::YPosition,
+                                            EbsdLib::Ang::ImageQuality, EbsdLib::Ang::ConfidenceIndex, EbsdLib::Ang::PhaseData, EbsdLib::Ang::SEMSignal, EbsdLib::Ang::Fit};
+    std::vector<bool> intColumns(names.size(), false);
+    intColumns[7] = true;
+
+    for(const QString& filePath : {UnitTest::EbsdTextParserTest::AngFile, UnitTest::EbsdTextParserTest::AngCrlfFile})
+    {
+      std::vector<std::vector<float>> floats;
+      std::vector<std::vector<int32_t>> ints;
+      parseData(filePath, false, names.size(), intColumns, floats, ints);
+      for(size_t c = 0; c < names.size(); c++)
+      {
+        void* column = reader.getPointerByName(names[c]);
+        DREAM3D_REQUIRE_VALID_POINTER(column)
+        for(size_t i = 0; i < EbsdTextParserTestConsts::k_NumPoints; i++)
+        {
+          if(intColumns[c])
+          {
+            DREAM3D_REQUIRE_EQUAL(ints[c][i], static_cast<int32_t*>(column)[i])
+          }
+          else
+          {
+            DREAM3D_REQUIRE(sameBits(floats[c][i], static_cast<float*>(column)[i]))
+          }
+        }
+      }
+    }
+
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  // The .ctf data parsed with EbsdTextParser from LF and CRLF files has to match the CtfReader bit for bit
+  // -----------------------------------------------------------------------------
+  int TestCtfFile()
+  {
+    writeCtfFile(UnitTest::EbsdTextParserTest::CtfFile, "\n");
+    writeCtfFile(UnitTest::EbsdTextParserTest::CtfCrlfFile, "\r\n");
+
+    CtfReader reader;
+    reader.setFileName(UnitTest::EbsdTextParserTest::CtfFile.toStdString());
+    DREAM3D_REQUIRED(reader.readFile(), >=, 0)
+
+    const std::vector<std::string> names = {EbsdLib::Ctf::Phase,  EbsdLib::Ctf::X,      EbsdLib::Ctf::Y,   EbsdLib::Ctf::Bands, EbsdLib::Ctf::Error, EbsdLib::Ctf::Euler1,
+                                            EbsdLib::Ctf::Euler2, EbsdLib::Ctf::Euler3, EbsdLib::Ctf::MAD, EbsdLib::Ctf::BC,    EbsdLib::Ctf::BS};
+    const std::vector<bool> intColumns = {true, false, false, true, true, false, false, false, false, true, true};
+
+    for(const QString& filePath : {UnitTest::EbsdTextParserTest::CtfFile, UnitTest::EbsdTextParserTest::CtfCrlfFile})
+    {
+      std::vector<std::vector<float>> floats;
+      std::vector<std::vector<int32_t>> ints;
+      parseData(filePath, true, names.size(), intColumns, floats, ints);
+      for(size_t c = 0; c < names.size(); c++)
+      {
+        void* column = reader.getPointerByName(names[c]);
+        DREAM3D_REQUIRE_VALID_POINTER(column)
+        for(size_t i = 0; i < EbsdTextParserTestConsts::k_NumPoints; i++)
+        {
+          if(intColumns[c])
+          {
+            DREAM3D_REQUIRE_EQUAL(ints[c][i], static_cast<int32_t*>(column)[i])
+          }
+          else
+          {
+            DREAM3D_REQUIRE(sameBits(floats[c][i], static_cast<float*>(column)[i]))
+          }
+        }
+      }
+    }
+
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    int err = EXIT_SUCCESS;
+    std::cout << "---- " << getNameOfClass().toStdString() << " ----" << std::endl;
+
+    DREAM3D_REGISTER_TEST(TestParseFloat())
+    DREAM3D_REGISTER_TEST(TestAngFile())
+    DREAM3D_REGISTER_TEST(TestCtfFile())
+
+    DREAM3D_REGISTER_TEST(RemoveTestFiles())
+  }
+
+private:
+};
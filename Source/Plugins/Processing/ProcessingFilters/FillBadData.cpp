@@ -34,9 +34,12 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "FillBadData.h"
 
+#include <algorithm>
+
 #include <QtCore/QTextStream>
 
 #include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/Common/TemplateHelpers.h"
 #include "SIMPLib/DataContainers/DataContainer.h"
 #include "SIMPLib/DataContainers/DataContainerArray.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
@@ -51,6 +54,113 @@
 #include "Processing/ProcessingConstants.h"
 #include "Processing/ProcessingVersion.h"
 
+namespace
+{
+/**
+ * @brief The FillPair struct is one Cell of the fill front and the Cell it copies its data from
+ */
+struct FillPair
+{
+  int64_t cell;
+  int64_t source;
+};
+
+/**
+ * @brief isNeighborInBounds Returns whether face neighbor j (-z, -y, -x, +x, +y, +z) of the Cell at
+ * (column, row, plane) lies inside the volume
+ */
+inline bool isNeighborInBounds(const int64_t dims[3], int64_t column, int64_t row, int64_t plane, int32_t j)
+{
+  switch(j)
+  {
+  case 0:
+    return plane > 0;
+  case 1:
+    return row > 0;
+  case 2:
+    return column > 0;
+  case 3:
+    return column < dims[0] - 1;
+  case 4:
+    return row < dims[1] - 1;
+  default:
+    return plane < dims[2] - 1;
+  }
+}
+
+template <typename T>
+void copyTypedFillTuples(const IDataArray::Pointer& dataArray, const std::vector<FillPair>& fills)
+{
+  typename DataArray<T>::Pointer array = std::dynamic_pointer_cast<DataArray<T>>(dataArray);
+  const size_t numComps = static_cast<size_t>(array->getNumberOfComponents());
+  T* data = array->getPointer(0);
+  for(const auto& fill : fills)
+  {
+    const T* src = data + static_cast<size_t>(fill.source) * numComps;
+    std::copy(src, src + numComps, data + static_cast<size_t>(fill.cell) * numComps);
+  }
+}
+
+/**
+ * @brief copyFillTuples Copies the source tuple onto every Cell of the fill front. Numeric arrays are copied
+ * through their typed pointer; any other array falls back to IDataArray::copyTuple.
+ */
+void copyFillTuples(const IDataArray::Pointer& dataArray, const std::vector<FillPair>& fills)
+{
+  if(TemplateHelpers::CanDynamicCast<Int8ArrayType>()(dataArray))
+  {
+    copyTypedFillTuples<int8_t>(dataArray, fills);
+  }
+  else if(TemplateHelpers::CanDynamicCast<UInt8ArrayType>()(dataArray))
+  {
+    copyTypedFillTuples<uint8_t>(dataArray, fills);
+  }
+  else if(TemplateHelpers::CanDynamicCast<Int16ArrayType>()(dataArray))
+  {
+    copyTypedFillTuples<int16_t>(dataArray, fills);
+  }
+  else if(TemplateHelpers::CanDynamicCast<UInt16ArrayType>()(dataArray))
+  {
+    copyTypedFillTuples<uint16_t>(dataArray, fills);
+  }
+  else if(TemplateHelpers::CanDynamicCast<Int32ArrayType>()(dataArray))
+  {
+    copyTypedFillTuples<int32_t>(dataArray, fills);
+  }
+  else if(TemplateHelpers::CanDynamicCast<UInt32ArrayType>()(dataArray))
+  {
+    copyTypedFillTuples<uint32_t>(dataArray, fills);
+  }
+  else if(TemplateHelpers::CanDynamicCast<Int64ArrayType>()(dataArray))
+  {
+    copyTypedFillTuples<int64_t>(dataArray, fills);
+  }
+  else if(TemplateHelpers::CanDynamicCast<UInt64ArrayType>()(dataArray))
+  {
+    copyTypedFillTuples<uint64_t>(dataArray, fills);
+  }
+  else if(TemplateHelpers::CanDynamicCast<FloatArrayType>()(dataArray))
+  {
+    copyTypedFillTuples<float>(dataArray, fills);
+  }
+  else if(TemplateHelpers::CanDynamicCast<DoubleArrayType>()(dataArray))
+  {
+    copyTypedFillTuples<double>(dataArray, fills);
+  }
+  else if(TemplateHelpers::CanDynamicCast<BoolArrayType>()(dataArray))
+  {
+    copyTypedFillTuples<bool>(dataArray, fills);
+  }
+  else
+  {
+    for(const auto& fill : fills)
+    {
+      dataArray->copyTuple(static_cast<size_t>(fill.source), static_cast<size_t>(fill.cell));
+    }
+  }
+}
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -112,7 +222,6 @@ void FillBadData::readFilterParameters(AbstractFilterParametersReader* reader, i
 void FillBadData::initialize()
 {
   m_AlreadyChecked = nullptr;
-  m_Neighbors = nullptr;
 }
 
 // -----------------------------------------------------------------------------
@@ -171,10 +280,6 @@ void FillBadData::execute()
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(m_FeatureIdsArrayPath.getDataContainerName());
   size_t totalPoints = m_FeatureIdsPtr.lock()->getNumberOfTuples();
 
-  Int32ArrayType::Pointer neighborsPtr = Int32ArrayType::CreateArray(totalPoints, std::string("_INTERNAL_USE_ONLY_Neighbors"), true);
-  m_Neighbors = neighborsPtr->getPointer(0);
-  neighborsPtr->initializeWithValue(-1);
-
   BoolArrayType::Pointer alreadCheckedPtr = BoolArrayType::CreateArray(totalPoints, std::string("_INTERNAL_USE_ONLY_AlreadyChecked"), true);
   m_AlreadyChecked = alreadCheckedPtr->getPointer(0);
   alreadCheckedPtr->initializeWithZeros();
@@ -191,22 +296,11 @@ void FillBadData::execute()
   int32_t good = 1;
   int64_t neighbor;
   int64_t index = 0;
-  float x = 0.0f, y = 0.0f, z = 0.0f;
   int64_t column = 0, row = 0, plane = 0;
   int64_t neighpoint = 0;
-  int32_t featurename = 0, feature = 0;
-  size_t numfeatures = 0;
+  int32_t feature = 0;
   size_t maxPhase = 0;
 
-  for(size_t i = 0; i < totalPoints; i++)
-  {
-    featurename = m_FeatureIds[i];
-    if(featurename > numfeatures)
-    {
-      numfeatures = featurename;
-    }
-  }
-
   if(m_StoreAsNewPhase)
   {
     for(size_t i = 0; i < totalPoints; i++)
@@ -306,123 +400,125 @@ void FillBadData::execute()
     }
   }
 
+  // Fill the small defects (Feature Id -1) from the outside in. Only the Cells on the current fill front
+  // are visited, and the front of the next iteration is built from the neighbors of the Cells just filled.
+  std::vector<int64_t> front;
+  std::vector<int64_t> nextFront;
+  std::vector<FillPair> fills;
+  for(size_t i = 0; i < totalPoints; i++)
+  {
+    m_AlreadyChecked[i] = false;
+    if(m_FeatureIds[i] >= 0)
+    {
+      continue;
+    }
+    index = static_cast<int64_t>(i);
+    column = index % dims[0];
+    row = (index / dims[0]) % dims[1];
+    plane = index / (dims[0] * dims[1]);
+    for(int32_t j = 0; j < 6; j++)
+    {
+      if(isNeighborInBounds(dims, column, row, plane, j) && m_FeatureIds[index + neighpoints[j]] > 0)
+      {
+        front.push_back(index);
+        m_AlreadyChecked[i] = true;
+        break;
+      }
+    }
+  }
+
+  AttributeMatrix::Pointer cellAttrMat = m->getAttributeMatrix(m_FeatureIdsArrayPath.getAttributeMatrixName());
+  std::vector<IDataArray::Pointer> cellArrays;
+  for(const auto& arrayName : cellAttrMat->getAttributeArrayNames())
+  {
+    cellArrays.push_back(cellAttrMat->getAttributeArray(arrayName));
+  }
+
+  int32_t votedFeatures[6] = {0, 0, 0, 0, 0, 0};
+  int32_t votes[6] = {0, 0, 0, 0, 0, 0};
+  int32_t numVoted = 0;
   int32_t current = 0;
   int32_t most = 0;
-  std::vector<int32_t> n(numfeatures + 1, 0);
 
-  while(count != 0)
+  while(!front.empty())
   {
-    count = 0;
-    for(size_t i = 0; i < totalPoints; i++)
+    if(getCancel())
+    {
+      return;
+    }
+
+    // Every front Cell takes the Feature that owns most of its face neighbors; on a tie the neighbor that
+    // reached the count first wins
+    fills.clear();
+    for(int64_t cell : front)
     {
-      featurename = m_FeatureIds[i];
-      if(featurename < 0)
+      column = cell % dims[0];
+      row = (cell / dims[0]) % dims[1];
+      plane = cell / (dims[0] * dims[1]);
+      numVoted = 0;
+      most = 0;
+      neighbor = -1;
+      for(int32_t j = 0; j < 6; j++)
       {
-        count++;
-        current = 0;
-        most = 0;
-        x = static_cast<float>(i % dims[0]);
-        y = static_cast<float>((i / dims[0]) % dims[1]);
-        z = static_cast<float>(i / (dims[0] * dims[1]));
-        for(int32_t j = 0; j < 6; j++)
+        if(!isNeighborInBounds(dims, column, row, plane, j))
         {
-          good = 1;
-          neighpoint = static_cast<int64_t>(i + neighpoints[j]);
-          if(j == 0 && z == 0)
-          {
-            good = 0;
-          }
-          if(j == 5 && z == (dims[2] - 1))
-          {
-            good = 0;
-          }
-          if(j == 1 && y == 0)
-          {
-            good = 0;
-          }
-          if(j == 4 && y == (dims[1] - 1))
-          {
-            good = 0;
-          }
-          if(j == 2 && x == 0)
-          {
-            good = 0;
-          }
-          if(j == 3 && x == (dims[0] - 1))
-          {
-            good = 0;
-          }
-          if(good == 1)
-          {
-            feature = m_FeatureIds[neighpoint];
-            if(feature > 0)
-            {
-              n[feature]++;
-              current = n[feature];
-              if(current > most)
-              {
-                most = current;
-                m_Neighbors[i] = neighpoint;
-              }
-            }
-          }
+          continue;
         }
-        for(int32_t l = 0; l < 6; l++)
+        neighpoint = cell + neighpoints[j];
+        feature = m_FeatureIds[neighpoint];
+        if(feature <= 0)
         {
-          good = 1;
-          neighpoint = i + neighpoints[l];
-          if(l == 0 && z == 0)
-          {
-            good = 0;
-          }
-          if(l == 5 && z == (dims[2] - 1))
-          {
-            good = 0;
-          }
-          if(l == 1 && y == 0)
-          {
-            good = 0;
-          }
-          if(l == 4 && y == (dims[1] - 1))
-          {
-            good = 0;
-          }
-          if(l == 2 && x == 0)
-          {
-            good = 0;
-          }
-          if(l == 3 && x == (dims[0] - 1))
-          {
-            good = 0;
-          }
-          if(good == 1)
-          {
-            feature = m_FeatureIds[neighpoint];
-            if(feature > 0)
-            {
-              n[feature] = 0;
-            }
-          }
+          continue;
+        }
+        int32_t k = 0;
+        while(k < numVoted && votedFeatures[k] != feature)
+        {
+          k++;
+        }
+        if(k == numVoted)
+        {
+          votedFeatures[k] = feature;
+          votes[k] = 0;
+          numVoted++;
+        }
+        votes[k]++;
+        current = votes[k];
+        if(current > most)
+        {
+          most = current;
+          neighbor = neighpoint;
         }
       }
+      fills.push_back({cell, neighbor});
     }
 
-    QString attrMatName = m_FeatureIdsArrayPath.getAttributeMatrixName();
-    QList<QString> voxelArrayNames = m->getAttributeMatrix(attrMatName)->getAttributeArrayNames();
+    // The sources all belong to Features, so they are never overwritten while the front is copied
+    for(const auto& cellArray : cellArrays)
+    {
+      copyFillTuples(cellArray, fills);
+    }
 
-    for(size_t j = 0; j < totalPoints; j++)
+    nextFront.clear();
+    for(const auto& fill : fills)
     {
-      featurename = m_FeatureIds[j];
-      neighbor = m_Neighbors[j];
-      if(featurename < 0 && neighbor != -1 && m_FeatureIds[neighbor] > 0)
+      column = fill.cell % dims[0];
+      row = (fill.cell / dims[0]) % dims[1];
+      plane = fill.cell / (dims[0] * dims[1]);
+      for(int32_t j = 0; j < 6; j++)
       {
-        for(const auto& arrayName : voxelArrayNames)
+        if(!isNeighborInBounds(dims, column, row, plane, j))
+        {
+          continue;
+        }
+        neighpoint = fill.cell + neighpoints[j];
+        if(m_FeatureIds[neighpoint] < 0 && !m_AlreadyChecked[neighpoint])
         {
-          IDataArray::Pointer p = m->getAttributeMatrix(attrMatName)->getAttributeArray(arrayName);
-          p->copyTuple(neighbor, j);
+          nextFront.push_back(neighpoint);
+          m_AlreadyChecked[neighpoint] = true;
         }
       }
     }
+    front.swap(nextFront);
   }
 }
 
@@ -231,8 +231,7 @@ private:
   DataArrayPath m_CellPhasesArrayPath = {};
   QVector<DataArrayPath> m_IgnoredDataArrayPaths = {};
 
-  bool* m_AlreadyChecked;
-  int32_t* m_Neighbors;
+  bool* m_AlreadyChecked = nullptr;
 
 public:
   FillBadData(const FillBadData&) = delete;            // Copy Constructor Not Implemented
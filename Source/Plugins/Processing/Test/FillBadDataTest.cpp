@@ -0,0 +1,294 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <QtCore/QDebug>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterFactory.hpp"
+#include "SIMPLib/Filtering/FilterManager.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#include "UnitTestSupport.hpp"
+
+#include "ProcessingTestFileLocations.h"
+
+namespace FillBadDataTestArrays
+{
+const QString k_FeatureIdsName("FeatureIds");
+const QString k_PhasesName("Phases");
+const QString k_SourceName("Source");
+
+const size_t k_Dims[3] = {6, 6, 3};
+const int32_t k_MinAllowedDefectSize = 6;
+
+// Feature Ids of the input volume. The 0 Cells form islands of 1, 2, 2, 3, 5 and 8 Cells.
+const std::vector<int32_t> k_InputFeatureIds = {
+    1, 2, 4, 1, 3, 4,
+    1, 3, 5, 2, 0, 5,
+    2, 4, 1, 2, 4, 1,
+    3, 5, 1, 3, 5, 2,
+    4, 5, 0, 0, 1, 2,
+    4, 1, 3, 5, 1, 0,
+    2, 4, 5, 2, 4, 1,
+    3, 0, 1, 3, 0, 1,
+    3, 5, 2, 4, 5, 2,
+    4, 1, 3, 4, 1, 3,
+    0, 0, 3, 5, 2, 4,
+    0, 0, 4, 1, 3, 0,
+    3, 5, 0, 0, 5, 2,
+    4, 1, 2, 4, 0, 3,
+    5, 1, 3, 5, 2, 3,
+    5, 2, 4, 1, 2, 4,
+    0, 0, 5, 1, 3, 0,
+    0, 0, 5, 2, 0, 0,
+};
+
+// Feature Ids the filter produced before the fill front was introduced. The 8 Cell island is at
+// least k_MinAllowedDefectSize and keeps Feature Id 0, every smaller island is filled.
+const std::vector<int32_t> k_FilledFeatureIds = {
+    1, 2, 4, 1, 3, 4,
+    1, 3, 5, 2, 3, 5,
+    2, 4, 1, 2, 4, 1,
+    3, 5, 1, 3, 5, 2,
+    4, 5, 3, 5, 1, 2,
+    4, 1, 3, 5, 1, 2,
+    2, 4, 5, 2, 4, 1,
+    3, 3, 1, 3, 4, 1,
+    3, 5, 2, 4, 5, 2,
+    4, 1, 3, 4, 1, 3,
+    0, 0, 3, 5, 2, 4,
+    0, 0, 4, 1, 3, 4,
+    3, 5, 5, 2, 5, 2,
+    4, 1, 2, 4, 5, 3,
+    5, 1, 3, 5, 2, 3,
+    5, 2, 4, 1, 2, 4,
+    0, 0, 5, 1, 3, 4,
+    0, 0, 5, 2, 3, 4,
+};
+
+// Index of the input Cell every Cell copied its arrays from, or -1 for the Cells that stay bad data
+const std::vector<int32_t> k_FilledSources = {
+    0, 1, 2, 3, 4, 5,
+    6, 7, 8, 9, 4, 11,
+    12, 13, 14, 15, 16, 17,
+    18, 19, 20, 21, 22, 23,
+    24, 25, 62, 63, 28, 29,
+    30, 31, 32, 33, 34, 29,
+    36, 37, 38, 39, 40, 41,
+    42, 42, 44, 45, 40, 47,
+    48, 49, 50, 51, 52, 53,
+    54, 55, 56, 57, 58, 59,
+    -1, -1, 62, 63, 64, 65,
+    -1, -1, 68, 69, 70, 65,
+    72, 73, 73, 39, 76, 77,
+    78, 79, 80, 81, 76, 83,
+    84, 85, 86, 87, 88, 89,
+    90, 91, 92, 93, 94, 95,
+    -1, -1, 98, 99, 100, 95,
+    -1, -1, 104, 105, 100, 95,
+};
+} // namespace FillBadDataTestArrays
+
+class FillBadDataTest
+{
+
+public:
+  FillBadDataTest() = default;
+  ~FillBadDataTest() = default;
+
+  /**
+   * @brief Returns the name of the class for FillBadDataTest
+   */
+  QString getNameOfClass() const
+  {
+    return QString("FillBadDataTest");
+  }
+
+  /**
+   * @brief Returns the name of the class for FillBadDataTest
+   */
+  QString ClassName()
+  {
+    return QString("FillBadDataTest");
+  }
+
+  FillBadDataTest(const FillBadDataTest&) = delete;            // Copy Constructor Not Implemented
+  FillBadDataTest(FillBadDataTest&&) = delete;                 // Move Constructor Not Implemented
+  FillBadDataTest& operator=(const FillBadDataTest&) = delete; // Copy Assignment Not Implemented
+  FillBadDataTest& operator=(FillBadDataTest&&) = delete;      // Move Assignment Not Implemented
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestFilterAvailability()
+  {
+    // Now instantiate the FillBadData Filter from the FilterManager
+    QString filtName = "FillBadData";
+    FilterManager* fm = FilterManager::Instance();
+    IFilterFactory::Pointer filterFactory = fm->getFactoryFromClassName(filtName);
+    if(nullptr == filterFactory.get())
+    {
+      std::stringstream ss;
+      ss << "The FillBadDataTest Requires the use of the " << filtName.toStdString() << " filter which is found in the Processing Plugin";
+      DREAM3D_TEST_THROW_EXCEPTION(ss.str())
+    }
+    return 0;
+  }
+
+  // -----------------------------------------------------------------------------
+  // Phases is 1 or 2 on the Features and 0 on the bad data. Source holds the index of every good Cell and -1 on
+  // the bad data, so the Cell that a filled Cell copied its arrays from can be read back from it.
+  // -----------------------------------------------------------------------------
+  DataContainerArray::Pointer createVolume()
+  {
+    std::vector<size_t> tDims = {FillBadDataTestArrays::k_Dims[0], FillBadDataTestArrays::k_Dims[1], FillBadDataTestArrays::k_Dims[2]};
+
+    DataContainerArray::Pointer dca = DataContainerArray::New();
+    DataContainer::Pointer dc = DataContainer::New(SIMPL::Defaults::ImageDataContainerName);
+    ImageGeom::Pointer image = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+    image->setDimensions(SizeVec3Type(tDims[0], tDims[1], tDims[2]));
+    image->setSpacing(FloatVec3Type(1.0f, 1.0f, 1.0f));
+    image->setOrigin(FloatVec3Type(0.0f, 0.0f, 0.0f));
+    dc->setGeometry(image);
+
+    AttributeMatrix::Pointer cellAttrMat = AttributeMatrix::New(tDims, SIMPL::Defaults::CellAttributeMatrixName, AttributeMatrix::Type::Cell);
+    std::vector<size_t> cDims(1, 1);
+    Int32ArrayType::Pointer ids = Int32ArrayType::CreateArray(tDims, cDims, FillBadDataTestArrays::k_FeatureIdsName, true);
+    Int32ArrayType::Pointer phases = Int32ArrayType::CreateArray(tDims, cDims, FillBadDataTestArrays::k_PhasesName, true);
+    FloatArrayType::Pointer source = FloatArrayType::CreateArray(tDims, cDims, FillBadDataTestArrays::k_SourceName, true);
+    for(size_t i = 0; i < FillBadDataTestArrays::k_InputFeatureIds.size(); i++)
+    {
+      int32_t featureId = FillBadDataTestArrays::k_InputFeatureIds[i];
+      ids->setValue(i, featureId);
+      phases->setValue(i, featureId > 0 ? 1 + featureId % 2 : 0);
+      source->setValue(i, featureId > 0 ? static_cast<float>(i) : -1.0f);
+    }
+    cellAttrMat->insertOrAssign(ids);
+    cellAttrMat->insertOrAssign(phases);
+    cellAttrMat->insertOrAssign(source);
+    dc->addOrReplaceAttributeMatrix(cellAttrMat);
+    dca->addOrReplaceDataContainer(dc);
+    return dca;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename T>
+  typename DataArray<T>::Pointer getCellArray(const DataContainerArray::Pointer& dca, const QString& name)
+  {
+    DataArrayPath path(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellAttributeMatrixName, name);
+    return dca->getAttributeMatrix(path)->getAttributeArrayAs<DataArray<T>>(name);
+  }
+
+  // -----------------------------------------------------------------------------
+  // Islands below the minimum size are eroded from the outside in and take every array from the neighbor the
+  // vote picked. The island above the minimum keeps Feature Id 0 and is stored as a new phase.
+  // -----------------------------------------------------------------------------
+  int TestFillBadData()
+  {
+    DataContainerArray::Pointer dca = createVolume();
+
+    QString filtName = "FillBadData";
+    FilterManager* fm = FilterManager::Instance();
+    IFilterFactory::Pointer factory = fm->getFactoryFromClassName(filtName);
+    DREAM3D_REQUIRE(factory.get() != nullptr)
+
+    AbstractFilter::Pointer filter = factory->create();
+    DREAM3D_REQUIRE(filter.get() != nullptr)
+    filter->setDataContainerArray(dca);
+
+    QVariant var;
+    var.setValue(FillBadDataTestArrays::k_MinAllowedDefectSize);
+    bool propWasSet = filter->setProperty("MinAllowedDefectSize", var);
+    DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+
+    var.setValue(true);
+    propWasSet = filter->setProperty("StoreAsNewPhase", var);
+    DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+
+    var.setValue(DataArrayPath(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellAttributeMatrixName, FillBadDataTestArrays::k_FeatureIdsName));
+    propWasSet = filter->setProperty("FeatureIdsArrayPath", var);
+    DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+
+    var.setValue(DataArrayPath(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellAttributeMatrixName, FillBadDataTestArrays::k_PhasesName));
+    propWasSet = filter->setProperty("CellPhasesArrayPath", var);
+    DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+
+    filter->execute();
+    DREAM3D_REQUIRE_EQUAL(filter->getErrorCode(), 0)
+
+    Int32ArrayType::Pointer ids = getCellArray<int32_t>(dca, FillBadDataTestArrays::k_FeatureIdsName);
+    Int32ArrayType::Pointer phases = getCellArray<int32_t>(dca, FillBadDataTestArrays::k_PhasesName);
+    FloatArrayType::Pointer source = getCellArray<float>(dca, FillBadDataTestArrays::k_SourceName);
+    for(size_t i = 0; i < FillBadDataTestArrays::k_FilledFeatureIds.size(); i++)
+    {
+      int32_t sourceIndex = FillBadDataTestArrays::k_FilledSources[i];
+      DREAM3D_REQUIRE_EQUAL(ids->getValue(i), FillBadDataTestArrays::k_FilledFeatureIds[i])
+      DREAM3D_REQUIRE_EQUAL(source->getValue(i), static_cast<float>(sourceIndex))
+      if(sourceIndex >= 0)
+      {
+        int32_t sourceFeatureId = FillBadDataTestArrays::k_InputFeatureIds[sourceIndex];
+        DREAM3D_REQUIRE_EQUAL(ids->getValue(i), sourceFeatureId)
+        DREAM3D_REQUIRE_EQUAL(phases->getValue(i), 1 + sourceFeatureId % 2)
+      }
+      else
+      {
+        // The largest input phase is 2, so the large island is stored as phase 3
+        DREAM3D_REQUIRE_EQUAL(phases->getValue(i), 3)
+      }
+    }
+
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    int err = EXIT_SUCCESS;
+    std::cout << "---- " << getNameOfClass().toStdString() << " ----" << std::endl;
+
+    DREAM3D_REGISTER_TEST(TestFilterAvailability());
+
+    DREAM3D_REGISTER_TEST(TestFillBadData())
+  }
+
+private:
+};
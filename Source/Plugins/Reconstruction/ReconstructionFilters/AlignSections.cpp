@@ -34,6 +34,9 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "AlignSections.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include <QtCore/QTextStream>
 
 #include "SIMPLib/Common/Constants.h"
@@ -51,28 +54,53 @@
 #include "Reconstruction/ReconstructionVersion.h"
 
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-
 #include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
-#include <tbb/task_group.h>
-#include <tbb/tick_count.h>
+#include <tbb/partitioner.h>
 #endif
 
 // -----------------------------------------------------------------------------
-//
+// Shifts one slice of an array by whole rows. Rows are visited in the order that
+// reads every source row before it is overwritten, so the shift is done in place.
+// Cells whose source lies outside of the slice are set to zero.
 // -----------------------------------------------------------------------------
 template <typename T>
-void initializeArrayValues(IDataArray::Pointer p, size_t index)
+void shiftSliceRows(IDataArray::Pointer p, const size_t* dims, size_t slice, int64_t xshift, int64_t yshift)
 {
-
   typename DataArray<T>::Pointer ptr = std::dynamic_pointer_cast<DataArray<T>>(p);
-  T var = static_cast<T>(0);
-  ptr->initializeTuple(index, &var);
+  const int64_t xDim = static_cast<int64_t>(dims[0]);
+  const int64_t yDim = static_cast<int64_t>(dims[1]);
+  const size_t numComps = static_cast<size_t>(ptr->getNumberOfComponents());
+  const size_t rowLength = dims[0] * numComps;
+  T* sliceData = ptr->getPointer(slice * dims[0] * dims[1] * numComps);
+
+  // Range of x positions that receive a value from inside the row
+  const int64_t xStart = std::min(xDim, std::max<int64_t>(0, -xshift));
+  const int64_t xEnd = std::max(xStart, std::min(xDim, xDim - xshift));
+  const size_t copyStart = static_cast<size_t>(xStart) * numComps;
+  const size_t copyEnd = static_cast<size_t>(xEnd) * numComps;
+
+  for(int64_t l = 0; l < yDim; l++)
+  {
+    const int64_t yspot = (yshift >= 0) ? l : (yDim - 1 - l);
+    const int64_t ysource = yspot + yshift;
+    T* row = sliceData + static_cast<size_t>(yspot) * rowLength;
+    if(ysource < 0 || ysource > yDim - 1 || copyEnd == copyStart)
+    {
+      std::fill(row, row + rowLength, static_cast<T>(0));
+      continue;
+    }
+    const T* sourceRow = sliceData + static_cast<size_t>(ysource) * rowLength;
+    std::memmove(row + copyStart, sourceRow + static_cast<size_t>(xStart + xshift) * numComps, (copyEnd - copyStart) * sizeof(T));
+    std::fill(row, row + copyStart, static_cast<T>(0));
+    std::fill(row + copyEnd, row + rowLength, static_cast<T>(0));
+  }
 }
 
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
+/**
+ * @brief The AlignSectionsTransferDataImpl class applies the shifts to a block of slices of every
+ * transferred array. Each unit of work is one slice of one array, numbered slice by slice.
+ */
 class AlignSectionsTransferDataImpl
 {
 public:
@@ -80,12 +108,12 @@ public:
   AlignSectionsTransferDataImpl(const AlignSectionsTransferDataImpl&) = default; // Copy Constructor Default Implemented
   AlignSectionsTransferDataImpl(AlignSectionsTransferDataImpl&&) = default;      // Move Constructor Default Implemented
 
-  AlignSectionsTransferDataImpl(AlignSections* filter, size_t* dims, const std::vector<int64_t>& xshifts, const std::vector<int64_t>& yshifts, IDataArray::Pointer dataArrayPtr)
+  AlignSectionsTransferDataImpl(AlignSections* filter, const size_t* dims, const std::vector<int64_t>& xshifts, const std::vector<int64_t>& yshifts, const std::vector<IDataArray::Pointer>& dataArrays)
   : m_Filter(filter)
   , m_Dims(dims)
   , m_xshifts(xshifts)
   , m_yshifts(yshifts)
-  , m_DataArrayPtr(dataArrayPtr)
+  , m_DataArrays(dataArrays)
   {
   }
 
@@ -94,69 +122,35 @@ public:
   AlignSectionsTransferDataImpl& operator=(const AlignSectionsTransferDataImpl&) = delete; // Copy Assignment Not Implemented
   AlignSectionsTransferDataImpl& operator=(AlignSectionsTransferDataImpl&&) = delete;      // Move Assignment Not Implemented
 
-  void operator()() const
+  /**
+   * @brief convert Shifts the work units [start, end). Unit u is array u % numArrays of the
+   * slice that uses shift index 1 + u / numArrays.
+   */
+  void convert(size_t start, size_t end) const
   {
-    size_t progIncrement = m_Dims[2] / 50;
-    size_t prog = 1;
-    size_t slice = 0;
-
-    for(size_t i = 1; i < m_Dims[2]; i++)
+    const size_t numArrays = m_DataArrays.size();
+    for(size_t u = start; u < end; u++)
     {
-      if(i > prog)
-      {
-        prog = prog + progIncrement;
-        m_Filter->updateProgress(progIncrement);
-      }
-      if(m_Filter->getCancel())
-      {
-        return;
-      }
-      slice = (m_Dims[2] - 1) - i;
-      for(size_t l = 0; l < m_Dims[1]; l++)
-      {
-        for(size_t n = 0; n < m_Dims[0]; n++)
-        {
-          int64_t xspot = 0, yspot = 0;
-          int64_t newPosition = 0;
-          int64_t currentPosition = 0;
-          if(m_yshifts[i] >= 0)
-          {
-            yspot = static_cast<int64_t>(l);
-          }
-          else if(m_yshifts[i] < 0)
-          {
-            yspot = static_cast<int64_t>(m_Dims[1]) - 1 - static_cast<int64_t>(l);
-          }
-          if(m_xshifts[i] >= 0)
-          {
-            xspot = static_cast<int64_t>(n);
-          }
-          else if(m_xshifts[i] < 0)
-          {
-            xspot = static_cast<int64_t>(m_Dims[0]) - 1 - static_cast<int64_t>(n);
-          }
-          newPosition = (slice * m_Dims[0] * m_Dims[1]) + (yspot * m_Dims[0]) + xspot;
-          currentPosition = (slice * m_Dims[0] * m_Dims[1]) + ((yspot + m_yshifts[i]) * m_Dims[0]) + (xspot + m_xshifts[i]);
-          if((yspot + m_yshifts[i]) >= 0 && (yspot + m_yshifts[i]) <= static_cast<int64_t>(m_Dims[1]) - 1 && (xspot + m_xshifts[i]) >= 0 &&
-             (xspot + m_xshifts[i]) <= static_cast<int64_t>(m_Dims[0]) - 1)
-          {
-            m_DataArrayPtr->copyTuple(static_cast<size_t>(currentPosition), static_cast<size_t>(newPosition));
-          }
-          if((yspot + m_yshifts[i]) < 0 || (yspot + m_yshifts[i]) > static_cast<int64_t>(m_Dims[1] - 1) || (xspot + m_xshifts[i]) < 0 || (xspot + m_xshifts[i]) > static_cast<int64_t>(m_Dims[0]) - 1)
-          {
-            EXECUTE_FUNCTION_TEMPLATE(m_Filter, initializeArrayValues, m_DataArrayPtr, m_DataArrayPtr, newPosition)
-          }
-        }
-      }
+      size_t i = 1 + u / numArrays;
+      size_t slice = (m_Dims[2] - 1) - i;
+      const IDataArray::Pointer& dataArrayPtr = m_DataArrays[u % numArrays];
+      EXECUTE_FUNCTION_TEMPLATE(m_Filter, shiftSliceRows, dataArrayPtr, dataArrayPtr, m_Dims, slice, m_xshifts[i], m_yshifts[i])
     }
   }
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+
 private:
   AlignSections* m_Filter = nullptr;
-  size_t* m_Dims = nullptr;
-  std::vector<int64_t> m_xshifts;
-  std::vector<int64_t> m_yshifts;
-  IDataArray::Pointer m_DataArrayPtr;
+  const size_t* m_Dims = nullptr;
+  const std::vector<int64_t>& m_xshifts;
+  const std::vector<int64_t>& m_yshifts;
+  const std::vector<IDataArray::Pointer>& m_DataArrays;
 };
 
 // -----------------------------------------------------------------------------
@@ -243,6 +237,22 @@ void AlignSections::find_shifts(std::vector<int64_t>& xshifts, std::vector<int64
 {
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int32_t AlignSections::findPyramidLevels(const int64_t* dims)
+{
+  // A level is only used if it still compares at least 8 cells along each row and column of the slice
+  const int32_t maxLevel = 3;
+  const int64_t minSliceDim = std::min(dims[0], dims[1]);
+  int32_t level = 0;
+  while(level < maxLevel && minSliceDim >= (int64_t(32) << (level + 1)))
+  {
+    level++;
+  }
+  return level;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -279,93 +289,42 @@ void AlignSections::execute()
 
   find_shifts(xshifts, yshifts);
 
-#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-  // The idea for this parallel section is to parallelize over each Data Array that
-  // will need it's data adjusted. This should go faster than before by about 2x.
-  // Better speed up could be achieved if we had better data locality.
-
-  std::shared_ptr<tbb::task_group> taskGroup(new tbb::task_group);
   QList<QString> voxelArrayNames = m->getAttributeMatrix(getCellAttributeMatrixName())->getAttributeArrayNames();
   for(const auto& dataArrayPath : m_IgnoredDataArrayPaths)
   {
     voxelArrayNames.removeAll(dataArrayPath.getDataArrayName());
   }
-  m_TotalProgress = voxelArrayNames.size() * dims[2]; // Total number of slices to update
-  // Create all the tasks
+  std::vector<IDataArray::Pointer> dataArrays;
+  dataArrays.reserve(voxelArrayNames.size());
   for(const auto& arrayName : voxelArrayNames)
   {
-    IDataArray::Pointer dataArrayPtr = m->getAttributeMatrix(getCellAttributeMatrixName())->getAttributeArray(arrayName);
-    taskGroup->run(AlignSectionsTransferDataImpl(this, dims.data(), xshifts, yshifts, dataArrayPtr));
+    dataArrays.push_back(m->getAttributeMatrix(getCellAttributeMatrixName())->getAttributeArray(arrayName));
+  }
+  if(dataArrays.empty())
+  {
+    return;
   }
-  // Wait for them to complete.
-  taskGroup->wait();
-#else
-
-  QList<QString> voxelArrayNames = m->getAttributeMatrix(getCellAttributeMatrixName())->getAttributeArrayNames();
-  size_t progIncrement = dims[2] / 100;
-  size_t prog = 1;
-  size_t progressInt = 0;
-  size_t slice = 0;
 
-  for(size_t i = 1; i < dims[2]; i++)
+  // Every slice of every array is shifted independently of the others by moving whole rows, so the work is
+  // split over slices and arrays together. The slices are handed out in blocks to report progress in between.
+  AlignSectionsTransferDataImpl transferImpl(this, dims.data(), xshifts, yshifts, dataArrays);
+  const size_t numShiftedSlices = dims[2] - 1;
+  const size_t slicesPerBlock = std::max<size_t>(1, numShiftedSlices / 50);
+  m_TotalProgress = numShiftedSlices;
+  for(size_t blockStart = 0; blockStart < numShiftedSlices; blockStart += slicesPerBlock)
   {
-    if(i > prog)
-    {
-      progressInt = static_cast<int>((static_cast<float>(i) / static_cast<float>(dims[2])) * 100.0f);
-      QString ss = QObject::tr("Transferring Cell Data %1%").arg(progressInt);
-      notifyStatusMessage(ss);
-      prog = prog + progIncrement;
-    }
     if(getCancel())
     {
       return;
     }
-    slice = (dims[2] - 1) - i;
-    for(size_t l = 0; l < dims[1]; l++)
-    {
-      for(size_t n = 0; n < dims[0]; n++)
-      {
-        int64_t xspot = 0, yspot = 0;
-        int64_t newPosition = 0;
-        int64_t currentPosition = 0;
-        if(yshifts[i] >= 0)
-        {
-          yspot = static_cast<int64_t>(l);
-        }
-        else if(yshifts[i] < 0)
-        {
-          yspot = static_cast<int64_t>(dims[1]) - 1 - static_cast<int64_t>(l);
-        }
-        if(xshifts[i] >= 0)
-        {
-          xspot = static_cast<int64_t>(n);
-        }
-        else if(xshifts[i] < 0)
-        {
-          xspot = static_cast<int64_t>(dims[0]) - 1 - static_cast<int64_t>(n);
-        }
-        newPosition = (slice * dims[0] * dims[1]) + (yspot * dims[0]) + xspot;
-        currentPosition = (slice * dims[0] * dims[1]) + ((yspot + yshifts[i]) * dims[0]) + (xspot + xshifts[i]);
-        if((yspot + yshifts[i]) >= 0 && (yspot + yshifts[i]) <= static_cast<int64_t>(dims[1]) - 1 && (xspot + xshifts[i]) >= 0 && (xspot + xshifts[i]) <= static_cast<int64_t>(dims[0]) - 1)
-        {
-          for(const auto& arrayName : voxelArrayNames)
-          {
-            IDataArray::Pointer p = m->getAttributeMatrix(getCellAttributeMatrixName())->getAttributeArray(arrayName);
-            p->copyTuple(static_cast<size_t>(currentPosition), static_cast<size_t>(newPosition));
-          }
-        }
-        if((yspot + yshifts[i]) < 0 || (yspot + yshifts[i]) > static_cast<int64_t>(dims[1] - 1) || (xspot + xshifts[i]) < 0 || (xspot + xshifts[i]) > static_cast<int64_t>(dims[0]) - 1)
-        {
-          for(const auto& arrayName : voxelArrayNames)
-          {
-            IDataArray::Pointer p = m->getAttributeMatrix(getCellAttributeMatrixName())->getAttributeArray(arrayName);
-            EXECUTE_FUNCTION_TEMPLATE(this, initializeArrayValues, p, p, newPosition)
-          }
-        }
-      }
-    }
-  }
+    size_t blockEnd = std::min(blockStart + slicesPerBlock, numShiftedSlices);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    tbb::parallel_for(tbb::blocked_range<size_t>(blockStart * dataArrays.size(), blockEnd * dataArrays.size()), transferImpl, tbb::auto_partitioner());
+#else
+    transferImpl.convert(blockStart * dataArrays.size(), blockEnd * dataArrays.size());
 #endif
+    updateProgress(blockEnd - blockStart);
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -227,6 +227,15 @@ protected:
    */
   virtual void find_shifts(std::vector<int64_t>& xshifts, std::vector<int64_t>& yshifts);
 
+  /**
+   * @brief findPyramidLevels Determines how many coarse levels a coarse-to-fine shift search can use for the
+   * slices of the volume. Level L tries shifts that are 2^L cells apart and compares every (4 * 2^L)th cell,
+   * level 0 is the full resolution search.
+   * @param dims Dimensions of the volume
+   * @return Coarsest level of the search
+   */
+  static int32_t findPyramidLevels(const int64_t* dims);
+
 private:
   DataArrayPath m_DataContainerName = {};
   QString m_CellAttributeMatrixName = {};
@@ -35,6 +35,8 @@
 
 #include "AlignSectionsMisorientation.h"
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 
 #include <QtCore/QDateTime>
@@ -57,6 +59,69 @@
 #include "Reconstruction/ReconstructionConstants.h"
 #include "Reconstruction/ReconstructionVersion.h"
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
+namespace
+{
+/**
+ * @brief The SliceOrientations struct keeps the quaternion components, crystal structures and mask of one slice in
+ * separate flat arrays, so that comparing a row of cells with a shifted row is a loop the compiler can vectorize.
+ */
+struct SliceOrientations
+{
+  std::vector<float> q0;
+  std::vector<float> q1;
+  std::vector<float> q2;
+  std::vector<float> q3;
+  std::vector<float> normSq;
+  std::vector<int32_t> structure; // -1 for cells without a phase or with a crystal structure that has no LaueOps
+  std::vector<uint8_t> good;
+};
+} // namespace
+
+/**
+ * @brief The AlignSectionsMisorientationShiftsImpl class finds the shift between each slice and the slice above it
+ * for a range of slice pairs. The pairs do not depend on each other, the shifts are only accumulated afterwards.
+ */
+class AlignSectionsMisorientationShiftsImpl
+{
+public:
+  AlignSectionsMisorientationShiftsImpl(const AlignSectionsMisorientation* filter, const int64_t* dims, const LaueOpsContainer& orientationOps, std::vector<int64_t>& xshifts,
+                                        std::vector<int64_t>& yshifts)
+  : m_Filter(filter)
+  , m_Dims(dims)
+  , m_OrientationOps(orientationOps)
+  , m_XShifts(xshifts)
+  , m_YShifts(yshifts)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t iter = start; iter < end; iter++)
+    {
+      m_Filter->findSlicePairShift(m_Dims, static_cast<int64_t>(iter), m_OrientationOps, m_XShifts[iter], m_YShifts[iter]);
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+private:
+  const AlignSectionsMisorientation* m_Filter;
+  const int64_t* m_Dims;
+  const LaueOpsContainer& m_OrientationOps;
+  std::vector<int64_t>& m_XShifts;
+  std::vector<int64_t>& m_YShifts;
+};
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -224,57 +289,171 @@ void AlignSectionsMisorientation::find_shifts(std::vector<int64_t>& xshifts, std
 
   std::vector<LaueOps::Pointer> m_OrientationOps = LaueOps::GetAllOrientationOps();
 
-  float disorientation = 0.0f;
-  float mindisorientation = std::numeric_limits<float>::max();
-  int64_t newxshift = 0;
-  int64_t newyshift = 0;
-  int64_t oldxshift = 0;
-  int64_t oldyshift = 0;
-  float count = 0.0f;
-  int64_t slice = 0;
-  float w = 0.0f;
-
-  int64_t refposition = 0;
-  int64_t curposition = 0;
-
-  uint32_t phase1 = 0, phase2 = 0;
-  int64_t progInt = 0;
-
-  // Allocate a 2D Array which will be reused from slice to slice
-  BoolArrayType::Pointer misorientsPtr = BoolArrayType::CreateArray(dims[0] * dims[1], std::string("_INTERNAL_USE_ONLY_Misorients"), true);
-  misorientsPtr->initializeWithValue(false);
-  bool* misorients = misorientsPtr->getPointer(0); // Get the raw pointer to use in our calculations for speed.
-
-  int64_t idx = 0; // This will be used to compute the index into the flat array
-  int64_t xIdx = 0;
-  int64_t yIdx = 0;
-
-  const int64_t halfDim0 = static_cast<int64_t>(dims[0] * 0.5f);
-  const int64_t halfDim1 = static_cast<int64_t>(dims[1] * 0.5f);
-
-  // Loop over the Z Direction
-  for(int64_t iter = 1; iter < dims[2]; iter++)
+  // Find the shift of every slice relative to the slice above it. The slice pairs are handed out in blocks so
+  // that the progress can be reported in between.
+  std::vector<int64_t> newxshifts(dims[2], 0);
+  std::vector<int64_t> newyshifts(dims[2], 0);
+  AlignSectionsMisorientationShiftsImpl shiftsImpl(this, dims, m_OrientationOps, newxshifts, newyshifts);
+  const int64_t pairsPerBlock = std::max<int64_t>(1, (dims[2] - 1) / 20);
+  for(int64_t blockStart = 1; blockStart < dims[2]; blockStart += pairsPerBlock)
   {
-    progInt = ((float)iter / dims[2]) * 100.0f;
+    int64_t progInt = ((float)blockStart / dims[2]) * 100.0f;
     QString ss = QObject::tr("Aligning Sections || Determining Shifts || %1% Complete").arg(progInt);
     notifyStatusMessage(ss);
     if(getCancel())
     {
       return;
     }
-    mindisorientation = std::numeric_limits<float>::max();
-    slice = (dims[2] - 1) - iter;
-    oldxshift = -1;
-    oldyshift = -1;
-    newxshift = 0;
-    newyshift = 0;
+    int64_t blockEnd = std::min(blockStart + pairsPerBlock, dims[2]);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    tbb::parallel_for(tbb::blocked_range<size_t>(blockStart, blockEnd, 1), shiftsImpl, tbb::auto_partitioner());
+#else
+    shiftsImpl.convert(blockStart, blockEnd);
+#endif
+  }
 
-    misorientsPtr->initializeWithValue(false); // Initialize everything to false
+  for(int64_t iter = 1; iter < dims[2]; iter++)
+  {
+    int64_t slice = (dims[2] - 1) - iter;
+    xshifts[iter] = xshifts[iter - 1] + newxshifts[iter];
+    yshifts[iter] = yshifts[iter - 1] + newyshifts[iter];
+    if(getWriteAlignmentShifts())
+    {
+      outFile << slice << "	" << slice + 1 << "	" << newxshifts[iter] << "	" << newyshifts[iter] << "	" << xshifts[iter] << "	" << yshifts[iter] << "\n";
+    }
+  }
+  if(getWriteAlignmentShifts())
+  {
+    outFile.close();
+  }
+}
 
-    float misorientationTolerance = m_MisorientationTolerance * SIMPLib::Constants::k_PiOver180D;
-    float* currentQuatPtr = nullptr;
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void AlignSectionsMisorientation::findSlicePairShift(const int64_t* dims, int64_t iter, const LaueOpsContainer& orientationOps, int64_t& newxshift, int64_t& newyshift) const
+{
+  const int64_t slice = (dims[2] - 1) - iter;
+  const int64_t sliceSize = dims[0] * dims[1];
+  const uint32_t numOps = static_cast<uint32_t>(orientationOps.size());
+  const float misorientationTolerance = m_MisorientationTolerance * SIMPLib::Constants::k_PiOver180D;
+
+  // Two quaternions that are closer than the tolerance (less a small margin for rounding) are also closer than the
+  // tolerance under any crystal symmetry, so only the remaining cell pairs need the LaueOps misorientation.
+  float nearCosSq = 2.0f;
+  if(misorientationTolerance < SIMPLib::Constants::k_PiF)
+  {
+    const float nearCos = std::cos(0.5f * 0.999f * misorientationTolerance);
+    nearCosSq = nearCos * nearCos;
+  }
+
+  auto gatherSlice = [&](int64_t z, SliceOrientations& data) {
+    data.q0.resize(sliceSize);
+    data.q1.resize(sliceSize);
+    data.q2.resize(sliceSize);
+    data.q3.resize(sliceSize);
+    data.normSq.resize(sliceSize);
+    data.structure.resize(sliceSize);
+    data.good.resize(sliceSize);
+    for(int64_t i = 0; i < sliceSize; i++)
+    {
+      const int64_t point = z * sliceSize + i;
+      const float* quat = m_Quats + point * 4;
+      data.q0[i] = quat[0];
+      data.q1[i] = quat[1];
+      data.q2[i] = quat[2];
+      data.q3[i] = quat[3];
+      data.normSq[i] = quat[0] * quat[0] + quat[1] * quat[1] + quat[2] * quat[2] + quat[3] * quat[3];
+      int32_t structure = -1;
+      if(m_CellPhases[point] > 0 && m_CrystalStructures[m_CellPhases[point]] < numOps)
+      {
+        structure = static_cast<int32_t>(m_CrystalStructures[m_CellPhases[point]]);
+      }
+      data.structure[i] = structure;
+      data.good[i] = (!m_UseGoodVoxels || m_GoodVoxels[point]) ? 1 : 0;
+    }
+  };
+
+  SliceOrientations ref;
+  SliceOrientations cur;
+  gatherSlice(slice + 1, ref);
+  gatherSlice(slice, cur);
+
+  // Flags the sampled cells of a row that still need the LaueOps misorientation
+  std::vector<uint8_t> needsOps(dims[0] + 1, 0);
+
+  // Fraction of the sampled cells of the reference slice that do not match the cell they are shifted onto
+  auto scoreShift = [&](int64_t xshift, int64_t yshift, int64_t sampleStep) {
+    const int64_t nStart = ((std::max<int64_t>(0, -xshift) + sampleStep - 1) / sampleStep) * sampleStep;
+    const int64_t nEnd = std::min(dims[0], dims[0] - xshift);
+    float disorientation = 0.0f;
+    float count = 0.0f;
+    for(int64_t l = 0; l < dims[1]; l = l + sampleStep)
+    {
+      if((l + yshift) < 0 || (l + yshift) >= dims[1])
+      {
+        continue;
+      }
+      const int64_t refRow = l * dims[0];
+      const int64_t curRow = (l + yshift) * dims[0] + xshift;
+      int32_t rowMismatches = 0;
+      int64_t numSamples = 0;
+      for(int64_t n = nStart; n < nEnd; n = n + sampleStep)
+      {
+        const int64_t r = refRow + n;
+        const int64_t c = curRow + n;
+        const int32_t bothGood = ref.good[r] & cur.good[c];
+        const int32_t sameStructure = static_cast<int32_t>(ref.structure[r] == cur.structure[c]) & static_cast<int32_t>(ref.structure[r] >= 0);
+        const float dot = ref.q0[r] * cur.q0[c] + ref.q1[r] * cur.q1[c] + ref.q2[r] * cur.q2[c] + ref.q3[r] * cur.q3[c];
+        const float normSq = ref.normSq[r] * cur.normSq[c];
+        const int32_t near = static_cast<int32_t>(dot * dot >= nearCosSq * normSq) & static_cast<int32_t>(normSq > 0.0f);
+        // A good cell over a masked cell, or two good cells of different crystal structures, always mismatch
+        rowMismatches += (ref.good[r] ^ cur.good[c]) + (bothGood & (1 - sameStructure));
+        needsOps[numSamples] = static_cast<uint8_t>(bothGood & sameStructure & (1 - near));
+        numSamples++;
+      }
+      for(int64_t s = 0; s < numSamples; s++)
+      {
+        if(needsOps[s] == 0)
+        {
+          continue;
+        }
+        const int64_t r = refRow + nStart + s * sampleStep;
+        const int64_t c = curRow + nStart + s * sampleStep;
+        QuatF q1(ref.q0[r], ref.q1[r], ref.q2[r], ref.q3[r]);
+        QuatF q2(cur.q0[c], cur.q1[c], cur.q2[c], cur.q3[c]);
+        OrientationF axisAngle = orientationOps[ref.structure[r]]->calculateMisorientation(q1, q2);
+        if(axisAngle[3] > misorientationTolerance)
+        {
+          rowMismatches++;
+        }
+      }
+      disorientation += static_cast<float>(rowMismatches);
+      count += static_cast<float>(numSamples);
+    }
+    return disorientation / count;
+  };
+
+  // A 2D array of the shifts that were already tried on the current level
+  std::vector<uint8_t> misorients(dims[0] * dims[1], 0);
+
+  const int64_t halfDim0 = static_cast<int64_t>(dims[0] * 0.5f);
+  const int64_t halfDim1 = static_cast<int64_t>(dims[1] * 0.5f);
 
-    while(newxshift != oldxshift || newyshift != oldyshift)
+  newxshift = 0;
+  newyshift = 0;
+
+  // Greedy 7x7 search on every level, starting from the best shift of the coarser level. The scores of different
+  // levels sample different cells, so each level starts with a fresh minimum.
+  for(int32_t level = findPyramidLevels(dims); level >= 0; level--)
+  {
+    const int64_t shiftStep = int64_t(1) << level;
+    const int64_t sampleStep = 4 * shiftStep;
+    std::fill(misorients.begin(), misorients.end(), 0);
+    float mindisorientation = std::numeric_limits<float>::max();
+    int64_t oldxshift = 0;
+    int64_t oldyshift = 0;
+    do
     {
       oldxshift = newxshift;
       oldyshift = newyshift;
@@ -282,87 +461,29 @@ void AlignSectionsMisorientation::find_shifts(std::vector<int64_t>& xshifts, std
       {
         for(int32_t k = -3; k < 4; k++)
         {
-          disorientation = 0.0f;
-          count = 0.0f;
-          xIdx = k + oldxshift + halfDim0;
-          yIdx = j + oldyshift + halfDim1;
-          idx = (dims[0] * yIdx) + xIdx;
-          if(!misorients[idx] && llabs(k + oldxshift) < halfDim0 && llabs(j + oldyshift) < halfDim1)
+          const int64_t xshift = k * shiftStep + oldxshift;
+          const int64_t yshift = j * shiftStep + oldyshift;
+          if(llabs(xshift) >= halfDim0 || llabs(yshift) >= halfDim1)
+          {
+            continue;
+          }
+          const int64_t idx = (dims[0] * (yshift + halfDim1)) + (xshift + halfDim0);
+          if(misorients[idx] != 0)
+          {
+            continue;
+          }
+          misorients[idx] = 1;
+
+          const float disorientation = scoreShift(xshift, yshift, sampleStep);
+          if(disorientation < mindisorientation || (disorientation == mindisorientation && ((llabs(xshift) < llabs(newxshift)) || (llabs(yshift) < llabs(newyshift)))))
           {
-            for(int64_t l = 0; l < dims[1]; l = l + 4)
-            {
-              for(int64_t n = 0; n < dims[0]; n = n + 4)
-              {
-                if((l + j + oldyshift) >= 0 && (l + j + oldyshift) < dims[1] && (n + k + oldxshift) >= 0 && (n + k + oldxshift) < dims[0])
-                {
-                  count++;
-                  refposition = ((slice + 1) * dims[0] * dims[1]) + (l * dims[0]) + n;
-                  curposition = (slice * dims[0] * dims[1]) + ((l + j + oldyshift) * dims[0]) + (n + k + oldxshift);
-                  if(!m_UseGoodVoxels || (m_GoodVoxels[refposition] && m_GoodVoxels[curposition]))
-                  {
-                    w = std::numeric_limits<float>::max();
-                    if(m_CellPhases[refposition] > 0 && m_CellPhases[curposition] > 0)
-                    {
-
-                      currentQuatPtr = m_Quats + refposition * 4;
-                      QuatF q1(currentQuatPtr[0], currentQuatPtr[1], currentQuatPtr[2], currentQuatPtr[3]);
-                      phase1 = m_CrystalStructures[m_CellPhases[refposition]];
-                      currentQuatPtr = m_Quats + curposition * 4;
-                      QuatF q2(currentQuatPtr[0], currentQuatPtr[1], currentQuatPtr[2], currentQuatPtr[3]);
-                      phase2 = m_CrystalStructures[m_CellPhases[curposition]];
-                      if(phase1 == phase2 && phase1 < static_cast<uint32_t>(m_OrientationOps.size()))
-                      {
-                        OrientationF axisAngle = m_OrientationOps[phase1]->calculateMisorientation(q1, q2);
-                        w = axisAngle[3];
-                      }
-                    }
-                    if(w > misorientationTolerance)
-                    {
-                      disorientation++;
-                    }
-                  }
-                  if(m_UseGoodVoxels)
-                  {
-                    if(m_GoodVoxels[refposition] && !m_GoodVoxels[curposition])
-                    {
-                      disorientation++;
-                    }
-                    if(!m_GoodVoxels[refposition] && m_GoodVoxels[curposition])
-                    {
-                      disorientation++;
-                    }
-                  }
-                }
-                else
-                {
-                }
-              }
-            }
-            disorientation = disorientation / count;
-            xIdx = k + oldxshift + halfDim0;
-            yIdx = j + oldyshift + halfDim1;
-            idx = (dims[0] * yIdx) + xIdx;
-            misorients[idx] = true;
-            if(disorientation < mindisorientation || (disorientation == mindisorientation && ((llabs(k + oldxshift) < llabs(newxshift)) || (llabs(j + oldyshift) < llabs(newyshift)))))
-            {
-              newxshift = k + oldxshift;
-              newyshift = j + oldyshift;
-              mindisorientation = disorientation;
-            }
+            newxshift = xshift;
+            newyshift = yshift;
+            mindisorientation = disorientation;
           }
         }
       }
-    }
-    xshifts[iter] = xshifts[iter - 1] + newxshift;
-    yshifts[iter] = yshifts[iter - 1] + newyshift;
-    if(getWriteAlignmentShifts())
-    {
-      outFile << slice << "	" << slice + 1 << "	" << newxshift << "	" << newyshift << "	" << xshifts[iter] << "	" << yshifts[iter] << "\n";
-    }
-  }
-  if(getWriteAlignmentShifts())
-  {
-    outFile.close();
+    } while(newxshift != oldxshift || newyshift != oldyshift);
   }
 }
 
@@ -36,6 +36,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "SIMPLib/SIMPLib.h"
 #include "SIMPLib/DataArrays/DataArray.hpp"
@@ -45,6 +46,10 @@
 
 #include "Reconstruction/ReconstructionDLLExport.h"
 
+class LaueOps;
+using LaueOpsShPtrType = std::shared_ptr<LaueOps>;
+using LaueOpsContainer = std::vector<LaueOpsShPtrType>;
+
 /**
  * @brief The AlignSectionsMisorientation class. See [Filter documentation](@ref alignsectionsmisorientation) for details.
  */
@@ -239,6 +244,19 @@ protected:
    */
   void find_shifts(std::vector<int64_t>& xshifts, std::vector<int64_t>& yshifts) override;
 
+  friend class AlignSectionsMisorientationShiftsImpl;
+
+  /**
+   * @brief findSlicePairShift Determines the x and y shift that best registers a slice to the slice above it,
+   * refining the shift from the coarsest level of @see findPyramidLevels down to single cells
+   * @param dims Dimensions of the volume
+   * @param iter Index of the slice pair, the slice is (dims[2] - 1) - iter
+   * @param orientationOps Orientation operators for each crystal structure
+   * @param newxshift Shift in x direction
+   * @param newyshift Shift in y direction
+   */
+  void findSlicePairShift(const int64_t* dims, int64_t iter, const LaueOpsContainer& orientationOps, int64_t& newxshift, int64_t& newyshift) const;
+
 private:
   std::weak_ptr<DataArray<float>> m_QuatsPtr;
   float* m_Quats = nullptr;
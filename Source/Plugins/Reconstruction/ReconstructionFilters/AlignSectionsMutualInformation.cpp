@@ -34,6 +34,7 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "AlignSectionsMutualInformation.h"
 
+#include <algorithm>
 #include <fstream>
 
 #include <QtCore/QTextStream>
@@ -55,6 +56,50 @@
 #include "Reconstruction/ReconstructionConstants.h"
 #include "Reconstruction/ReconstructionVersion.h"
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
+/**
+ * @brief The AlignSectionsMutualInformationShiftsImpl class finds the shift between each slice and the slice above
+ * it for a range of slice pairs. Each pair only reads the feature ids of its own two slices.
+ */
+class AlignSectionsMutualInformationShiftsImpl
+{
+public:
+  AlignSectionsMutualInformationShiftsImpl(const AlignSectionsMutualInformation* filter, const int64_t* dims, const int32_t* miFeatureIds, std::vector<int64_t>& xshifts, std::vector<int64_t>& yshifts)
+  : m_Filter(filter)
+  , m_Dims(dims)
+  , m_MIFeatureIds(miFeatureIds)
+  , m_XShifts(xshifts)
+  , m_YShifts(yshifts)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t iter = start; iter < end; iter++)
+    {
+      m_Filter->findSlicePairShift(m_Dims, static_cast<int64_t>(iter), m_MIFeatureIds, m_XShifts[iter], m_YShifts[iter]);
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+private:
+  const AlignSectionsMutualInformation* m_Filter;
+  const int64_t* m_Dims;
+  const int32_t* m_MIFeatureIds;
+  std::vector<int64_t>& m_XShifts;
+  std::vector<int64_t>& m_YShifts;
+};
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -230,187 +275,192 @@ void AlignSectionsMutualInformation::find_shifts(std::vector<int64_t>& xshifts,
       static_cast<int64_t>(udims[2]),
   };
 
-  float disorientation = 0.0f;
-  float mindisorientation = std::numeric_limits<float>::max();
-  float** mutualinfo12 = nullptr;
-  float* mutualinfo1 = nullptr;
-  float* mutualinfo2 = nullptr;
-  int32_t featurecount1 = 0, featurecount2 = 0;
-  int64_t newxshift = 0;
-  int64_t newyshift = 0;
-  int64_t oldxshift = 0;
-  int64_t oldyshift = 0;
-  float count = 0.0f;
-  int64_t slice = 0;
-
-  int32_t refgnum = 0, curgnum = 0;
-  int64_t refposition = 0;
-  int64_t curposition = 0;
-
   form_features_sections();
 
-  std::vector<std::vector<float>> misorients;
-  misorients.resize(dims[0]);
-  for(int64_t a = 0; a < dims[0]; a++)
+  // Find the shift of every slice relative to the slice above it, handing the slice pairs out in blocks
+  // so that the progress can be reported in between.
+  std::vector<int64_t> newxshifts(dims[2], 0);
+  std::vector<int64_t> newyshifts(dims[2], 0);
+  AlignSectionsMutualInformationShiftsImpl shiftsImpl(this, dims, miFeatureIds, newxshifts, newyshifts);
+  const int64_t pairsPerBlock = std::max<int64_t>(1, (dims[2] - 1) / 20);
+  for(int64_t blockStart = 1; blockStart < dims[2]; blockStart += pairsPerBlock)
   {
-    misorients[a].assign(dims[1], 0.0f);
+    float prog = ((float)blockStart / dims[2]) * 100;
+    QString ss = QObject::tr("Aligning Sections || Determining Shifts || %1% Complete").arg(QString::number(prog, 'f', 0));
+    notifyStatusMessage(ss);
+    int64_t blockEnd = std::min(blockStart + pairsPerBlock, dims[2]);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    tbb::parallel_for(tbb::blocked_range<size_t>(blockStart, blockEnd, 1), shiftsImpl, tbb::auto_partitioner());
+#else
+    shiftsImpl.convert(blockStart, blockEnd);
+#endif
   }
 
   for(int64_t iter = 1; iter < dims[2]; iter++)
   {
-    float prog = ((float)iter / dims[2]) * 100;
-    QString ss = QObject::tr("Aligning Sections || Determining Shifts || %1% Complete").arg(QString::number(prog, 'f', 0));
-    notifyStatusMessage(ss);
-    mindisorientation = std::numeric_limits<float>::max();
-    slice = (dims[2] - 1) - iter;
-    featurecount1 = featurecounts[slice];
-    featurecount2 = featurecounts[slice + 1];
-    mutualinfo12 = new float*[featurecount1];
-    mutualinfo1 = new float[featurecount1];
-    mutualinfo2 = new float[featurecount2];
-
-    for(int32_t a = 0; a < featurecount1; a++)
+    int64_t slice = (dims[2] - 1) - iter;
+    xshifts[iter] = xshifts[iter - 1] + newxshifts[iter];
+    yshifts[iter] = yshifts[iter - 1] + newyshifts[iter];
+    if(getWriteAlignmentShifts())
     {
-      mutualinfo1[a] = 0.0f;
-      mutualinfo12[a] = new float[featurecount2];
-      for(int32_t b = 0; b < featurecount2; b++)
-      {
-        mutualinfo12[a][b] = 0.0f;
-        mutualinfo2[b] = 0.0f;
-      }
+      outFile << slice << "	" << slice + 1 << "	" << newxshifts[iter] << "	" << newyshifts[iter] << "	" << xshifts[iter] << "	" << yshifts[iter] << "\n";
     }
-    oldxshift = -1;
-    oldyshift = -1;
-    newxshift = 0;
-    newyshift = 0;
-    for(int64_t a = 0; a < dims[0]; a++)
+  }
+
+  m->getAttributeMatrix(getCellAttributeMatrixName())->removeAttributeArray(SIMPL::CellData::FeatureIds);
+
+  if(getWriteAlignmentShifts())
+  {
+    outFile.close();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void AlignSectionsMutualInformation::findSlicePairShift(const int64_t* dims, int64_t iter, const int32_t* miFeatureIds, int64_t& newxshift, int64_t& newyshift) const
+{
+  const int64_t slice = (dims[2] - 1) - iter;
+  const int32_t featurecount1 = featurecounts[slice];
+  const int32_t featurecount2 = featurecounts[slice + 1];
+  const int32_t* refFeatureIds = miFeatureIds + (slice + 1) * dims[0] * dims[1];
+  const int32_t* curFeatureIds = miFeatureIds + slice * dims[0] * dims[1];
+
+  // Joint and marginal histograms of the feature ids of the two slices, the joint one stored row by row. Only
+  // the joint bins that a shift filled are visited and cleared again, in ascending order so that the sum is the
+  // same as over the full table.
+  std::vector<float> mutualinfo12(static_cast<size_t>(featurecount1) * featurecount2, 0.0f);
+  std::vector<float> mutualinfo1(featurecount1, 0.0f);
+  std::vector<float> mutualinfo2(featurecount2, 0.0f);
+  std::vector<size_t> filledBins;
+
+  // Inverse of the mutual information of the sampled cells of the reference slice and the cells they are shifted onto
+  auto scoreShift = [&](int64_t xshift, int64_t yshift, int64_t sampleStep) {
+    const int64_t nStart = ((std::max<int64_t>(0, -xshift) + sampleStep - 1) / sampleStep) * sampleStep;
+    const int64_t nEnd = std::min(dims[0], dims[0] - xshift);
+    const int64_t samplesPerRow = (dims[0] + sampleStep - 1) / sampleStep;
+    const int64_t inRangePerRow = std::max<int64_t>(0, (nEnd - nStart + sampleStep - 1) / sampleStep);
+    float count = 0.0f;
+    int64_t outOfRange = 0;
+    for(int64_t l = 0; l < dims[1]; l = l + sampleStep)
     {
-      for(int64_t b = 0; b < dims[1]; b++)
+      if((l + yshift) < 0 || (l + yshift) >= dims[1])
       {
-        misorients[a][b] = 0;
+        outOfRange += samplesPerRow;
+        continue;
       }
-    }
-    while(newxshift != oldxshift || newyshift != oldyshift)
-    {
-      oldxshift = newxshift;
-      oldyshift = newyshift;
-      for(int32_t j = -3; j < 4; j++)
+      outOfRange += samplesPerRow - inRangePerRow;
+      const int32_t* refRow = refFeatureIds + l * dims[0];
+      const int32_t* curRow = curFeatureIds + (l + yshift) * dims[0] + xshift;
+      for(int64_t n = nStart; n < nEnd; n = n + sampleStep)
       {
-        for(int32_t k = -3; k < 4; k++)
+        const int32_t refgnum = refRow[n];
+        const int32_t curgnum = curRow[n];
+        if(curgnum >= 0 && refgnum >= 0)
         {
-          disorientation = 0;
-          count = 0;
-          if(misorients[k + oldxshift + dims[0] / 2][j + oldyshift + dims[1] / 2] == 0 && llabs(k + oldxshift) < (dims[0] / 2) && (j + oldyshift) < (dims[1] / 2))
+          const size_t bin = static_cast<size_t>(curgnum) * featurecount2 + refgnum;
+          if(mutualinfo12[bin] == 0.0f)
           {
-            for(int64_t l = 0; l < dims[1]; l = l + 4)
-            {
-              for(int64_t n = 0; n < dims[0]; n = n + 4)
-              {
-                if((l + j + oldyshift) >= 0 && (l + j + oldyshift) < dims[1] && (n + k + oldxshift) >= 0 && (n + k + oldxshift) < dims[0])
-                {
-                  refposition = ((slice + 1) * dims[0] * dims[1]) + (l * dims[0]) + n;
-                  curposition = (slice * dims[0] * dims[1]) + ((l + j + oldyshift) * dims[0]) + (n + k + oldxshift);
-                  refgnum = miFeatureIds[refposition];
-                  curgnum = miFeatureIds[curposition];
-                  if(curgnum >= 0 && refgnum >= 0)
-                  {
-                    mutualinfo12[curgnum][refgnum]++;
-                    mutualinfo1[curgnum]++;
-                    mutualinfo2[refgnum]++;
-                    count++;
-                  }
-                }
-                else
-                {
-                  mutualinfo12[0][0]++;
-                  mutualinfo1[0]++;
-                  mutualinfo2[0]++;
-                }
-              }
-            }
-            float ha = 0.0f;
-            float hb = 0.0f;
-            float hab = 0.0f;
-            for(int32_t b = 0; b < featurecount1; b++)
-            {
-              mutualinfo1[b] = mutualinfo1[b] / count;
-              if(mutualinfo1[b] != 0)
-              {
-                ha = ha + mutualinfo1[b] * logf(mutualinfo1[b]);
-              }
-            }
-            for(int32_t c = 0; c < featurecount2; c++)
-            {
-              mutualinfo2[c] = mutualinfo2[c] / float(count);
-              if(mutualinfo2[c] != 0)
-              {
-                hb = hb + mutualinfo2[c] * logf(mutualinfo2[c]);
-              }
-            }
-            for(int32_t b = 0; b < featurecount1; b++)
-            {
-              for(int32_t c = 0; c < featurecount2; c++)
-              {
-                mutualinfo12[b][c] = mutualinfo12[b][c] / count;
-                if(mutualinfo12[b][c] != 0)
-                {
-                  hab = hab + mutualinfo12[b][c] * logf(mutualinfo12[b][c]);
-                }
-                float value = 0.0f;
-                if(mutualinfo1[b] > 0 && mutualinfo2[c] > 0)
-                {
-                  value = (mutualinfo12[b][c] / (mutualinfo1[b] * mutualinfo2[c]));
-                }
-                if(value != 0)
-                {
-                  disorientation = disorientation + (mutualinfo12[b][c] * logf(value));
-                }
-              }
-            }
-            for(int32_t b = 0; b < featurecount1; b++)
-            {
-              for(int32_t c = 0; c < featurecount2; c++)
-              {
-                mutualinfo12[b][c] = 0.0f;
-                mutualinfo1[b] = 0.0f;
-                mutualinfo2[c] = 0.0f;
-              }
-            }
-            disorientation = 1.0f / disorientation;
-            misorients[k + oldxshift + dims[0] / 2][j + oldyshift + dims[1] / 2] = disorientation;
-            if(disorientation < mindisorientation)
-            {
-              newxshift = k + oldxshift;
-              newyshift = j + oldyshift;
-              mindisorientation = disorientation;
-            }
+            filledBins.push_back(bin);
           }
+          mutualinfo12[bin]++;
+          mutualinfo1[curgnum]++;
+          mutualinfo2[refgnum]++;
+          count++;
         }
       }
     }
-    xshifts[iter] = xshifts[iter - 1] + newxshift;
-    yshifts[iter] = yshifts[iter - 1] + newyshift;
-    if(getWriteAlignmentShifts())
+    // Samples that are shifted off the slice count towards the unassigned feature 0 without adding to the count
+    if(outOfRange > 0)
     {
-      outFile << slice << "	" << slice + 1 << "	" << newxshift << "	" << newyshift << "	" << xshifts[iter] << "	" << yshifts[iter] << "\n";
+      if(mutualinfo12[0] == 0.0f)
+      {
+        filledBins.push_back(0);
+      }
+      mutualinfo12[0] += static_cast<float>(outOfRange);
+      mutualinfo1[0] += static_cast<float>(outOfRange);
+      mutualinfo2[0] += static_cast<float>(outOfRange);
     }
-    delete[] mutualinfo1;
-    delete[] mutualinfo2;
-    for(int32_t i = 0; i < featurecount1; i++)
+
+    for(int32_t b = 0; b < featurecount1; b++)
     {
-      delete mutualinfo12[i];
+      mutualinfo1[b] = mutualinfo1[b] / count;
     }
-    delete[] mutualinfo12;
-    mutualinfo1 = nullptr;
-    mutualinfo2 = nullptr;
-    mutualinfo12 = nullptr;
-  }
+    for(int32_t c = 0; c < featurecount2; c++)
+    {
+      mutualinfo2[c] = mutualinfo2[c] / float(count);
+    }
+    std::sort(filledBins.begin(), filledBins.end());
+    float disorientation = 0.0f;
+    for(const size_t bin : filledBins)
+    {
+      const size_t b = bin / featurecount2;
+      const size_t c = bin % featurecount2;
+      const float p12 = mutualinfo12[bin] / count;
+      float value = 0.0f;
+      if(mutualinfo1[b] > 0 && mutualinfo2[c] > 0)
+      {
+        value = (p12 / (mutualinfo1[b] * mutualinfo2[c]));
+      }
+      if(value != 0)
+      {
+        disorientation = disorientation + (p12 * logf(value));
+      }
+      mutualinfo12[bin] = 0.0f;
+    }
+    filledBins.clear();
+    std::fill(mutualinfo1.begin(), mutualinfo1.end(), 0.0f);
+    std::fill(mutualinfo2.begin(), mutualinfo2.end(), 0.0f);
+    return 1.0f / disorientation;
+  };
 
-  m->getAttributeMatrix(getCellAttributeMatrixName())->removeAttributeArray(SIMPL::CellData::FeatureIds);
+  // The shifts that were already tried on the current level, stored column by column
+  std::vector<uint8_t> misorients(dims[0] * dims[1], 0);
 
-  if(getWriteAlignmentShifts())
+  newxshift = 0;
+  newyshift = 0;
+
+  // Greedy 7x7 search on every level, starting from the best shift of the coarser level. The coarse levels
+  // sample fewer cells, so their scores are not comparable with the finer ones.
+  for(int32_t level = findPyramidLevels(dims); level >= 0; level--)
   {
-    outFile.close();
+    const int64_t shiftStep = int64_t(1) << level;
+    const int64_t sampleStep = 4 * shiftStep;
+    std::fill(misorients.begin(), misorients.end(), 0);
+    float mindisorientation = std::numeric_limits<float>::max();
+    int64_t oldxshift = 0;
+    int64_t oldyshift = 0;
+    do
+    {
+      oldxshift = newxshift;
+      oldyshift = newyshift;
+      for(int32_t j = -3; j < 4; j++)
+      {
+        for(int32_t k = -3; k < 4; k++)
+        {
+          const int64_t xshift = k * shiftStep + oldxshift;
+          const int64_t yshift = j * shiftStep + oldyshift;
+          if(llabs(xshift) >= (dims[0] / 2) || llabs(yshift) >= (dims[1] / 2))
+          {
+            continue;
+          }
+          const int64_t misorientsIdx = (xshift + dims[0] / 2) * dims[1] + (yshift + dims[1] / 2);
+          if(misorients[misorientsIdx] != 0)
+          {
+            continue;
+          }
+          misorients[misorientsIdx] = 1;
+
+          const float disorientation = scoreShift(xshift, yshift, sampleStep);
+          if(disorientation < mindisorientation)
+          {
+            newxshift = xshift;
+            newyshift = yshift;
+            mindisorientation = disorientation;
+          }
+        }
+      }
+    } while(newxshift != oldxshift || newyshift != oldyshift);
   }
 }
 
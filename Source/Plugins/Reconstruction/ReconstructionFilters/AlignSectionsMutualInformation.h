@@ -257,6 +257,20 @@ protected:
    */
   void form_features_sections();
 
+  friend class AlignSectionsMutualInformationShiftsImpl;
+
+  /**
+   * @brief findSlicePairShift Determines the x and y shift that maximizes the mutual information between the
+   * features of a slice and the slice above it, refining the shift from the coarsest level of @see findPyramidLevels
+   * down to single cells
+   * @param dims Dimensions of the volume
+   * @param iter Index of the slice pair, the slice is (dims[2] - 1) - iter
+   * @param miFeatureIds Feature ids of the sections
+   * @param newxshift Shift in x direction
+   * @param newyshift Shift in y direction
+   */
+  void findSlicePairShift(const int64_t* dims, int64_t iter, const int32_t* miFeatureIds, int64_t& newxshift, int64_t& newyshift) const;
+
 private:
   std::shared_ptr<DataArray<int32_t>> m_FeatureCounts;
   int32_t* featurecounts = nullptr;
@@ -35,11 +35,13 @@
 
 #include "EBSDSegmentFeatures.h"
 
+#include <algorithm>
 #include <chrono>
 
 #include <QtCore/QTextStream>
 
 #include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/Common/SIMPLRange.h"
 #include "SIMPLib/DataContainers/DataContainer.h"
 #include "SIMPLib/DataContainers/DataContainerArray.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
@@ -51,6 +53,7 @@
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
 #include "SIMPLib/Geometry/ImageGeom.h"
 #include "SIMPLib/Math/SIMPLibMath.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 #include "EbsdLib/LaueOps/LaueOps.h"
 
@@ -66,6 +69,124 @@ enum createdPathID : RenameDataPath::DataID_t
   DataArrayID31 = 31,
 };
 
+namespace
+{
+// The edge mask stores one word per axis for every 64 consecutive Cells
+constexpr int64_t k_CellsPerWord = 64;
+constexpr int64_t k_PlusX = 0;
+constexpr int64_t k_PlusY = 1;
+constexpr int64_t k_PlusZ = 2;
+} // namespace
+
+/**
+ * @brief The EBSDSegmentFeaturesEdgeMaskImpl class computes, for a range of edge mask words, whether each Cell is
+ * within the misorientation tolerance of its +X, +Y and +Z neighbors. Every word is written by a single thread.
+ */
+class EBSDSegmentFeaturesEdgeMaskImpl
+{
+public:
+  EBSDSegmentFeaturesEdgeMaskImpl(const int64_t* dims, const float* quats, const int32_t* cellPhases, const uint32_t* crystalStructures, const bool* goodVoxels, const LaueOpsContainer& orientationOps,
+                                  float misoTolerance, uint64_t* edgeMask)
+  : m_Dims(dims)
+  , m_Quats(quats)
+  , m_CellPhases(cellPhases)
+  , m_CrystalStructures(crystalStructures)
+  , m_GoodVoxels(goodVoxels)
+  , m_OrientationOps(orientationOps)
+  , m_MisoTolerance(misoTolerance)
+  , m_EdgeMask(edgeMask)
+  {
+  }
+
+  bool isGrouped(int64_t referencepoint, int64_t neighborpoint) const
+  {
+    if(nullptr != m_GoodVoxels && !m_GoodVoxels[neighborpoint])
+    {
+      return false;
+    }
+    // Both Cells must belong to the same phase and that phase must have a valid crystal structure
+    if(m_CellPhases[referencepoint] != m_CellPhases[neighborpoint])
+    {
+      return false;
+    }
+    uint32_t phase = m_CrystalStructures[m_CellPhases[referencepoint]];
+    if(phase >= m_OrientationOps.size())
+    {
+      return false;
+    }
+
+    const float* currentQuatPtr = m_Quats + referencepoint * 4;
+    QuatF q1(currentQuatPtr[0], currentQuatPtr[1], currentQuatPtr[2], currentQuatPtr[3]);
+    currentQuatPtr = m_Quats + neighborpoint * 4;
+    QuatF q2(currentQuatPtr[0], currentQuatPtr[1], currentQuatPtr[2], currentQuatPtr[3]);
+
+    OrientationF axisAngle = m_OrientationOps[phase]->calculateMisorientation(q1, q2);
+    return axisAngle[3] < m_MisoTolerance;
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    const int64_t sliceSize = m_Dims[0] * m_Dims[1];
+    const int64_t totalPoints = sliceSize * m_Dims[2];
+    for(int64_t word = static_cast<int64_t>(start); word < static_cast<int64_t>(end); word++)
+    {
+      int64_t point = word * k_CellsPerWord;
+      int64_t lastPoint = std::min(point + k_CellsPerWord, totalPoints);
+      int64_t col = point % m_Dims[0];
+      int64_t row = (point / m_Dims[0]) % m_Dims[1];
+      int64_t plane = point / sliceSize;
+      uint64_t bitsX = 0;
+      uint64_t bitsY = 0;
+      uint64_t bitsZ = 0;
+      for(uint64_t bit = 1; point < lastPoint; point++, bit <<= 1)
+      {
+        if(nullptr == m_GoodVoxels || m_GoodVoxels[point])
+        {
+          if(col < m_Dims[0] - 1 && isGrouped(point, point + 1))
+          {
+            bitsX |= bit;
+          }
+          if(row < m_Dims[1] - 1 && isGrouped(point, point + m_Dims[0]))
+          {
+            bitsY |= bit;
+          }
+          if(plane < m_Dims[2] - 1 && isGrouped(point, point + sliceSize))
+          {
+            bitsZ |= bit;
+          }
+        }
+        if(++col == m_Dims[0])
+        {
+          col = 0;
+          if(++row == m_Dims[1])
+          {
+            row = 0;
+            plane++;
+          }
+        }
+      }
+      m_EdgeMask[3 * word + k_PlusX] = bitsX;
+      m_EdgeMask[3 * word + k_PlusY] = bitsY;
+      m_EdgeMask[3 * word + k_PlusZ] = bitsZ;
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    convert(range.min(), range.max());
+  }
+
+private:
+  const int64_t* m_Dims = nullptr;
+  const float* m_Quats = nullptr;
+  const int32_t* m_CellPhases = nullptr;
+  const uint32_t* m_CrystalStructures = nullptr;
+  const bool* m_GoodVoxels = nullptr;
+  const LaueOpsContainer& m_OrientationOps;
+  float m_MisoTolerance = 0.0f;
+  uint64_t* m_EdgeMask = nullptr;
+};
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -303,7 +424,7 @@ int64_t EBSDSegmentFeatures::getSeed(int32_t gnum, int64_t nextSeed)
   {
     if(m_FeatureIds[randpoint] == 0) // If the GrainId of the voxel is ZERO then we can use this as a seed point
     {
-      if((!m_UseGoodVoxels || m_GoodVoxels[randpoint]) && m_CellPhases[randpoint] > 0)
+      if(isValidSeed(randpoint))
       {
         seed = randpoint;
       }
@@ -332,38 +453,76 @@ int64_t EBSDSegmentFeatures::getSeed(int32_t gnum, int64_t nextSeed)
 // -----------------------------------------------------------------------------
 bool EBSDSegmentFeatures::determineGrouping(int64_t referencepoint, int64_t neighborpoint, int32_t gnum)
 {
-  bool group = false;
-
-  // Get the phases for each voxel
-  int32_t phase1 = m_CrystalStructures[m_CellPhases[referencepoint]];
-  int32_t phase2 = m_CrystalStructures[m_CellPhases[neighborpoint]];
-  // If either of the phases is 999 then we bail out now.
-  if(phase1 >= m_OrientationOps.size() || phase2 >= m_OrientationOps.size())
+  if(m_FeatureIds[neighborpoint] == 0 && isValidNeighbor(neighborpoint) && meetsGroupingCriteria(referencepoint, neighborpoint))
   {
-    return group;
+    m_FeatureIds[neighborpoint] = gnum;
+    return true;
   }
-  float* currentQuatPtr = nullptr;
+  return false;
+}
 
-  if(m_FeatureIds[neighborpoint] == 0 && (!m_UseGoodVoxels || m_GoodVoxels[neighborpoint]))
-  {
-    float w = std::numeric_limits<float>::max();
-    currentQuatPtr = m_Quats + referencepoint * 4;
-    QuatF q1(currentQuatPtr[0], currentQuatPtr[1], currentQuatPtr[2], currentQuatPtr[3]);
-    currentQuatPtr = m_Quats + neighborpoint * 4;
-    QuatF q2(currentQuatPtr[0], currentQuatPtr[1], currentQuatPtr[2], currentQuatPtr[3]);
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EBSDSegmentFeatures::supportsParallelSegmentation() const
+{
+  return true;
+}
 
-    if(m_CellPhases[referencepoint] == m_CellPhases[neighborpoint])
-    {
-      OrientationF axisAngle = m_OrientationOps[phase1]->calculateMisorientation(q1, q2);
-      w = axisAngle[3];
-    }
-    if(w < m_MisoTolerance)
-    {
-      group = true;
-      m_FeatureIds[neighborpoint] = gnum;
-    }
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int32_t* EBSDSegmentFeatures::getFeatureIdsPointer()
+{
+  return m_FeatureIds;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EBSDSegmentFeatures::isValidSeed(int64_t point) const
+{
+  return (!m_UseGoodVoxels || m_GoodVoxels[point]) && m_CellPhases[point] > 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EBSDSegmentFeatures::isValidNeighbor(int64_t point) const
+{
+  return !m_UseGoodVoxels || m_GoodVoxels[point];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool EBSDSegmentFeatures::meetsGroupingCriteria(int64_t referencepoint, int64_t neighborpoint) const
+{
+  // The edge mask stores each face once, on the Cell with the lower index
+  int64_t point = std::min(referencepoint, neighborpoint);
+  int64_t delta = std::max(referencepoint, neighborpoint) - point;
+  int64_t axis = k_PlusX;
+  if(delta == m_Dims[0] * m_Dims[1])
+  {
+    axis = k_PlusZ;
+  }
+  else if(delta == m_Dims[0])
+  {
+    axis = k_PlusY;
   }
-  return group;
+  uint64_t word = m_EdgeMask[3 * (point / k_CellsPerWord) + axis];
+  return ((word >> (point % k_CellsPerWord)) & 1) != 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void EBSDSegmentFeatures::setFeatureCount(int32_t numFeatures)
+{
+  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getDataContainerName());
+  std::vector<size_t> tDims(1, numFeatures + 1);
+  m->getAttributeMatrix(getCellFeatureAttributeMatrixName())->resizeAttributeArrays(tDims);
+  updateFeatureInstancePointers();
 }
 
 // -----------------------------------------------------------------------------
@@ -376,6 +535,26 @@ void EBSDSegmentFeatures::initializeVoxelSeedGenerator(const int64_t rangeMin, c
   m_Distribution = std::uniform_int_distribution<int64_t>(rangeMin, rangeMax);
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void EBSDSegmentFeatures::buildEdgeMask()
+{
+  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getDataContainerName());
+  SizeVec3Type udims = m->getGeometryAs<ImageGeom>()->getDimensions();
+  m_Dims[0] = static_cast<int64_t>(udims[0]);
+  m_Dims[1] = static_cast<int64_t>(udims[1]);
+  m_Dims[2] = static_cast<int64_t>(udims[2]);
+
+  size_t numWords = static_cast<size_t>((m_Dims[0] * m_Dims[1] * m_Dims[2] + k_CellsPerWord - 1) / k_CellsPerWord);
+  m_EdgeMask.assign(3 * numWords, 0);
+
+  ParallelDataAlgorithm dataAlg;
+  dataAlg.setRange(0, numWords);
+  dataAlg.execute(EBSDSegmentFeaturesEdgeMaskImpl(m_Dims, m_Quats, m_CellPhases, m_CrystalStructures, m_UseGoodVoxels ? m_GoodVoxels : nullptr, m_OrientationOps, m_MisoTolerance,
+                                                  m_EdgeMask.data()));
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -404,7 +583,16 @@ void EBSDSegmentFeatures::execute()
   const int64_t rangeMax = totalPoints - 1;
   initializeVoxelSeedGenerator(rangeMin, rangeMax);
 
+  // Compute every neighbor misorientation once up front so the burn only has to read bits
+  notifyStatusMessage("Computing neighbor misorientations");
+  buildEdgeMask();
+  if(getCancel())
+  {
+    return;
+  }
+
   SegmentFeatures::execute();
+  std::vector<uint64_t>().swap(m_EdgeMask);
 
   int64_t totalFeatures = static_cast<int64_t>(m_ActivePtr.lock()->getNumberOfTuples());
   if(totalFeatures < 2)
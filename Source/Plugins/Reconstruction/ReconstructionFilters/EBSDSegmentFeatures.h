@@ -64,6 +64,7 @@ class Reconstruction_EXPORT EBSDSegmentFeatures : public SegmentFeatures
   PYB11_FILTER_NEW_MACRO(EBSDSegmentFeatures)
   PYB11_PROPERTY(QString CellFeatureAttributeMatrixName READ getCellFeatureAttributeMatrixName WRITE setCellFeatureAttributeMatrixName)
   PYB11_PROPERTY(float MisorientationTolerance READ getMisorientationTolerance WRITE setMisorientationTolerance)
+  PYB11_PROPERTY(bool RandomizeFeatureIds READ getRandomizeFeatureIds WRITE setRandomizeFeatureIds)
   PYB11_PROPERTY(bool UseGoodVoxels READ getUseGoodVoxels WRITE setUseGoodVoxels)
   PYB11_PROPERTY(DataArrayPath GoodVoxelsArrayPath READ getGoodVoxelsArrayPath WRITE setGoodVoxelsArrayPath)
   PYB11_PROPERTY(DataArrayPath CellPhasesArrayPath READ getCellPhasesArrayPath WRITE setCellPhasesArrayPath)
@@ -135,6 +136,7 @@ public:
    * @return Value of RandomizeFeatureIds
    */
   bool getRandomizeFeatureIds() const;
+  Q_PROPERTY(bool RandomizeFeatureIds READ getRandomizeFeatureIds WRITE setRandomizeFeatureIds)
 
   /**
    * @brief Setter property for UseGoodVoxels
@@ -295,6 +297,36 @@ protected:
    */
   bool determineGrouping(int64_t referencepoint, int64_t neighborpoint, int32_t gnum) override;
 
+  /**
+   * @brief supportsParallelSegmentation Reimplemented from @see SegmentFeatures class
+   */
+  bool supportsParallelSegmentation() const override;
+
+  /**
+   * @brief getFeatureIdsPointer Reimplemented from @see SegmentFeatures class
+   */
+  int32_t* getFeatureIdsPointer() override;
+
+  /**
+   * @brief isValidSeed Reimplemented from @see SegmentFeatures class
+   */
+  bool isValidSeed(int64_t point) const override;
+
+  /**
+   * @brief isValidNeighbor Reimplemented from @see SegmentFeatures class
+   */
+  bool isValidNeighbor(int64_t point) const override;
+
+  /**
+   * @brief meetsGroupingCriteria Reimplemented from @see SegmentFeatures class
+   */
+  bool meetsGroupingCriteria(int64_t referencepoint, int64_t neighborpoint) const override;
+
+  /**
+   * @brief setFeatureCount Reimplemented from @see SegmentFeatures class
+   */
+  void setFeatureCount(int32_t numFeatures) override;
+
 private:
   std::weak_ptr<DataArray<float>> m_QuatsPtr;
   float* m_Quats = nullptr;
@@ -328,6 +360,19 @@ private:
 
   LaueOpsContainer m_OrientationOps;
 
+  /**
+   * @brief m_EdgeMask holds one bit per positive face (+X, +Y, +Z) of each Cell that is set when the Cell
+   * and its neighbor across that face are within the misorientation tolerance. Every 64 consecutive Cells
+   * share three words, one per axis. Only valid during execute().
+   */
+  std::vector<uint64_t> m_EdgeMask;
+  int64_t m_Dims[3] = {0, 0, 0};
+
+  /**
+   * @brief buildEdgeMask Computes m_EdgeMask for the whole volume in a single parallel pass
+   */
+  void buildEdgeMask();
+
   /**
    * @brief randomizeGrainIds Randomizes Feature Ids
    * @param totalPoints Size of Feature Ids array to randomize
@@ -76,6 +76,11 @@ public:
   {
     return false;
   }
+
+  virtual bool compare(int64_t index, int64_t neighIndex) const
+  {
+    return false;
+  }
 };
 
 /**
@@ -93,6 +98,16 @@ public:
   virtual ~TSpecificCompareFunctorBool() = default;
 
   bool operator()(int64_t referencepoint, int64_t neighborpoint, int32_t gnum) override
+  {
+    if(compare(referencepoint, neighborpoint))
+    {
+      m_FeatureIds[neighborpoint] = gnum;
+      return true;
+    }
+    return false;
+  }
+
+  bool compare(int64_t referencepoint, int64_t neighborpoint) const override
   {
     // Sanity check the indices that are being passed in.
     if(referencepoint >= m_Length || neighborpoint >= m_Length)
@@ -100,12 +115,7 @@ public:
       return false;
     }
 
-    if(m_Data[neighborpoint] == m_Data[referencepoint])
-    {
-      m_FeatureIds[neighborpoint] = gnum;
-      return true;
-    }
-    return false;
+    return m_Data[neighborpoint] == m_Data[referencepoint];
   }
 
 protected:
@@ -134,6 +144,16 @@ public:
   virtual ~TSpecificCompareFunctor() = default;
 
   bool operator()(int64_t referencepoint, int64_t neighborpoint, int32_t gnum) override
+  {
+    if(compare(referencepoint, neighborpoint))
+    {
+      m_FeatureIds[neighborpoint] = gnum;
+      return true;
+    }
+    return false;
+  }
+
+  bool compare(int64_t referencepoint, int64_t neighborpoint) const override
   {
     // Sanity check the indices that are being passed in.
     if(referencepoint >= m_Length || neighborpoint >= m_Length)
@@ -143,21 +163,9 @@ public:
 
     if(m_Data[referencepoint] >= m_Data[neighborpoint])
     {
-      if((m_Data[referencepoint] - m_Data[neighborpoint]) <= m_Tolerance)
-      {
-        m_FeatureIds[neighborpoint] = gnum;
-        return true;
-      }
-    }
-    else
-    {
-      if((m_Data[neighborpoint] - m_Data[referencepoint]) <= m_Tolerance)
-      {
-        m_FeatureIds[neighborpoint] = gnum;
-        return true;
-      }
+      return (m_Data[referencepoint] - m_Data[neighborpoint]) <= m_Tolerance;
     }
-    return false;
+    return (m_Data[neighborpoint] - m_Data[referencepoint]) <= m_Tolerance;
   }
 
 protected:
@@ -394,7 +402,7 @@ int64_t ScalarSegmentFeatures::getSeed(int32_t gnum, int64_t nextSeed)
   {
     if(m_FeatureIds[randpoint] == 0) // If the GrainId of the voxel is ZERO then we can use this as a seed point
     {
-      if(!m_UseGoodVoxels || m_GoodVoxels[randpoint])
+      if(isValidSeed(randpoint))
       {
         seed = randpoint;
       }
@@ -423,7 +431,7 @@ int64_t ScalarSegmentFeatures::getSeed(int32_t gnum, int64_t nextSeed)
 // -----------------------------------------------------------------------------
 bool ScalarSegmentFeatures::determineGrouping(int64_t referencepoint, int64_t neighborpoint, int32_t gnum)
 {
-  if(m_FeatureIds[neighborpoint] == 0 && (!m_UseGoodVoxels || m_GoodVoxels[neighborpoint]))
+  if(m_FeatureIds[neighborpoint] == 0 && isValidNeighbor(neighborpoint))
   {
     CompareFunctor* func = m_Compare.get();
     return (*func)((size_t)(referencepoint), (size_t)(neighborpoint), gnum);
@@ -433,6 +441,57 @@ bool ScalarSegmentFeatures::determineGrouping(int64_t referencepoint, int64_t ne
   return false;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ScalarSegmentFeatures::supportsParallelSegmentation() const
+{
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int32_t* ScalarSegmentFeatures::getFeatureIdsPointer()
+{
+  return m_FeatureIds;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ScalarSegmentFeatures::isValidSeed(int64_t point) const
+{
+  return !m_UseGoodVoxels || m_GoodVoxels[point];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ScalarSegmentFeatures::isValidNeighbor(int64_t point) const
+{
+  return !m_UseGoodVoxels || m_GoodVoxels[point];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool ScalarSegmentFeatures::meetsGroupingCriteria(int64_t referencepoint, int64_t neighborpoint) const
+{
+  return m_Compare->compare(referencepoint, neighborpoint);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ScalarSegmentFeatures::setFeatureCount(int32_t numFeatures)
+{
+  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getDataContainerName());
+  std::vector<size_t> tDims(1, numFeatures + 1);
+  m->getAttributeMatrix(getCellFeatureAttributeMatrixName())->resizeAttributeArrays(tDims);
+  updateFeatureInstancePointers();
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
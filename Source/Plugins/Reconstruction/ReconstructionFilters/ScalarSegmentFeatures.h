@@ -66,6 +66,7 @@ class Reconstruction_EXPORT ScalarSegmentFeatures : public SegmentFeatures
   PYB11_PROPERTY(QString CellFeatureAttributeMatrixName READ getCellFeatureAttributeMatrixName WRITE setCellFeatureAttributeMatrixName)
   PYB11_PROPERTY(DataArrayPath ScalarArrayPath READ getScalarArrayPath WRITE setScalarArrayPath)
   PYB11_PROPERTY(float ScalarTolerance READ getScalarTolerance WRITE setScalarTolerance)
+  PYB11_PROPERTY(bool RandomizeFeatureIds READ getRandomizeFeatureIds WRITE setRandomizeFeatureIds)
   PYB11_PROPERTY(bool UseGoodVoxels READ getUseGoodVoxels WRITE setUseGoodVoxels)
   PYB11_PROPERTY(DataArrayPath GoodVoxelsArrayPath READ getGoodVoxelsArrayPath WRITE setGoodVoxelsArrayPath)
   PYB11_PROPERTY(QString FeatureIdsArrayName READ getFeatureIdsArrayName WRITE setFeatureIdsArrayName)
@@ -145,6 +146,7 @@ public:
    * @return Value of RandomizeFeatureIds
    */
   bool getRandomizeFeatureIds() const;
+  Q_PROPERTY(bool RandomizeFeatureIds READ getRandomizeFeatureIds WRITE setRandomizeFeatureIds)
 
   /**
    * @brief Setter property for UseGoodVoxels
@@ -272,6 +274,36 @@ protected:
    */
   bool determineGrouping(int64_t referencepoint, int64_t neighborpoint, int32_t gnum) override;
 
+  /**
+   * @brief supportsParallelSegmentation Reimplemented from @see SegmentFeatures class
+   */
+  bool supportsParallelSegmentation() const override;
+
+  /**
+   * @brief getFeatureIdsPointer Reimplemented from @see SegmentFeatures class
+   */
+  int32_t* getFeatureIdsPointer() override;
+
+  /**
+   * @brief isValidSeed Reimplemented from @see SegmentFeatures class
+   */
+  bool isValidSeed(int64_t point) const override;
+
+  /**
+   * @brief isValidNeighbor Reimplemented from @see SegmentFeatures class
+   */
+  bool isValidNeighbor(int64_t point) const override;
+
+  /**
+   * @brief meetsGroupingCriteria Reimplemented from @see SegmentFeatures class
+   */
+  bool meetsGroupingCriteria(int64_t referencepoint, int64_t neighborpoint) const override;
+
+  /**
+   * @brief setFeatureCount Reimplemented from @see SegmentFeatures class
+   */
+  void setFeatureCount(int32_t numFeatures) override;
+
 private:
   IDataArrayWkPtrType m_InputDataPtr;
   void* m_InputData = nullptr;
@@ -34,6 +34,11 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "SegmentFeatures.h"
 
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <utility>
+
 #include <QtCore/QTextStream>
 
 #include "SIMPLib/Common/Constants.h"
@@ -45,6 +50,218 @@
 #include "Reconstruction/ReconstructionConstants.h"
 #include "Reconstruction/ReconstructionVersion.h"
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
+/**
+ * @brief The SegmentFeaturesSlabImpl class burns each z slab of the volume independently. Every slab
+ * numbers its own Features starting at 1 and records the smallest valid seed index of each of them.
+ */
+class SegmentFeaturesSlabImpl
+{
+public:
+  SegmentFeaturesSlabImpl(SegmentFeatures* filter, const int64_t* dims, int32_t* featureIds, const std::vector<int64_t>& slabStart, std::vector<std::vector<int64_t>>& slabMinSeeds)
+  : m_Filter(filter)
+  , m_Dims(dims)
+  , m_FeatureIds(featureIds)
+  , m_SlabStart(slabStart)
+  , m_SlabMinSeeds(slabMinSeeds)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    const int64_t sliceSize = m_Dims[0] * m_Dims[1];
+    const int64_t neighpoints[6] = {-sliceSize, -m_Dims[0], -1, 1, m_Dims[0], sliceSize};
+    std::vector<int64_t> voxelslist;
+
+    for(size_t slab = start; slab < end; slab++)
+    {
+      if(m_Filter->getCancel())
+      {
+        return;
+      }
+      const int64_t firstPlane = m_SlabStart[slab];
+      const int64_t lastPlane = m_SlabStart[slab + 1] - 1;
+      const int64_t firstPoint = firstPlane * sliceSize;
+      const int64_t endPoint = (lastPlane + 1) * sliceSize;
+      std::fill(m_FeatureIds + firstPoint, m_FeatureIds + endPoint, 0);
+
+      std::vector<int64_t>& minSeeds = m_SlabMinSeeds[slab];
+      minSeeds.assign(1, -1);
+      int32_t gnum = 0;
+
+      for(int64_t seed = firstPoint; seed < endPoint; seed++)
+      {
+        if(m_FeatureIds[seed] != 0 || !m_Filter->isValidNeighbor(seed))
+        {
+          continue;
+        }
+        gnum++;
+        m_FeatureIds[seed] = gnum;
+        minSeeds.push_back(m_Filter->isValidSeed(seed) ? seed : -1);
+        int64_t& minSeed = minSeeds.back();
+
+        voxelslist.clear();
+        voxelslist.push_back(seed);
+        while(!voxelslist.empty())
+        {
+          int64_t currentpoint = voxelslist.back();
+          voxelslist.pop_back();
+          int64_t col = currentpoint % m_Dims[0];
+          int64_t row = (currentpoint / m_Dims[0]) % m_Dims[1];
+          int64_t plane = currentpoint / sliceSize;
+          for(int32_t i = 0; i < 6; i++)
+          {
+            if((i == 0 && plane == firstPlane) || (i == 5 && plane == lastPlane) || (i == 1 && row == 0) || (i == 4 && row == (m_Dims[1] - 1)) || (i == 2 && col == 0) ||
+               (i == 3 && col == (m_Dims[0] - 1)))
+            {
+              continue;
+            }
+            int64_t neighbor = currentpoint + neighpoints[i];
+            if(m_FeatureIds[neighbor] == 0 && m_Filter->isValidNeighbor(neighbor) && m_Filter->meetsGroupingCriteria(currentpoint, neighbor))
+            {
+              m_FeatureIds[neighbor] = gnum;
+              voxelslist.push_back(neighbor);
+              if((minSeed < 0 || neighbor < minSeed) && m_Filter->isValidSeed(neighbor))
+              {
+                minSeed = neighbor;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+
+private:
+  SegmentFeatures* m_Filter = nullptr;
+  const int64_t* m_Dims = nullptr;
+  int32_t* m_FeatureIds = nullptr;
+  const std::vector<int64_t>& m_SlabStart;
+  std::vector<std::vector<int64_t>>& m_SlabMinSeeds;
+};
+
+/**
+ * @brief The SegmentFeaturesSeamImpl class finds the pairs of slab local Features that touch across the
+ * boundary between slab i and slab i + 1 and satisfy the grouping criteria there.
+ */
+class SegmentFeaturesSeamImpl
+{
+public:
+  SegmentFeaturesSeamImpl(SegmentFeatures* filter, const int64_t* dims, const int32_t* featureIds, const std::vector<int64_t>& slabStart, const std::vector<int64_t>& labelOffsets,
+                          std::vector<std::vector<std::pair<int64_t, int64_t>>>& seamPairs)
+  : m_Filter(filter)
+  , m_Dims(dims)
+  , m_FeatureIds(featureIds)
+  , m_SlabStart(slabStart)
+  , m_LabelOffsets(labelOffsets)
+  , m_SeamPairs(seamPairs)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    const int64_t sliceSize = m_Dims[0] * m_Dims[1];
+    for(size_t seam = start; seam < end; seam++)
+    {
+      std::vector<std::pair<int64_t, int64_t>>& pairs = m_SeamPairs[seam];
+      pairs.clear();
+      const int64_t lowerStart = (m_SlabStart[seam + 1] - 1) * sliceSize;
+      for(int64_t i = 0; i < sliceSize; i++)
+      {
+        int64_t lower = lowerStart + i;
+        int64_t upper = lower + sliceSize;
+        if(m_FeatureIds[lower] == 0 || m_FeatureIds[upper] == 0)
+        {
+          continue;
+        }
+        std::pair<int64_t, int64_t> pair(m_LabelOffsets[seam] + m_FeatureIds[lower], m_LabelOffsets[seam + 1] + m_FeatureIds[upper]);
+        if(!pairs.empty() && pairs.back() == pair)
+        {
+          continue;
+        }
+        if(m_Filter->meetsGroupingCriteria(lower, upper))
+        {
+          pairs.push_back(pair);
+        }
+      }
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+
+private:
+  SegmentFeatures* m_Filter = nullptr;
+  const int64_t* m_Dims = nullptr;
+  const int32_t* m_FeatureIds = nullptr;
+  const std::vector<int64_t>& m_SlabStart;
+  const std::vector<int64_t>& m_LabelOffsets;
+  std::vector<std::vector<std::pair<int64_t, int64_t>>>& m_SeamPairs;
+};
+
+/**
+ * @brief The SegmentFeaturesRelabelImpl class replaces the slab local labels with the final Feature Ids
+ */
+class SegmentFeaturesRelabelImpl
+{
+public:
+  SegmentFeaturesRelabelImpl(const int64_t* dims, int32_t* featureIds, const std::vector<int64_t>& slabStart, const std::vector<int64_t>& labelOffsets, const std::vector<int32_t>& finalIds)
+  : m_Dims(dims)
+  , m_FeatureIds(featureIds)
+  , m_SlabStart(slabStart)
+  , m_LabelOffsets(labelOffsets)
+  , m_FinalIds(finalIds)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    const int64_t sliceSize = m_Dims[0] * m_Dims[1];
+    for(size_t slab = start; slab < end; slab++)
+    {
+      const int64_t offset = m_LabelOffsets[slab];
+      const int64_t endPoint = m_SlabStart[slab + 1] * sliceSize;
+      for(int64_t i = m_SlabStart[slab] * sliceSize; i < endPoint; i++)
+      {
+        if(m_FeatureIds[i] > 0)
+        {
+          m_FeatureIds[i] = m_FinalIds[offset + m_FeatureIds[i]];
+        }
+      }
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+
+private:
+  const int64_t* m_Dims = nullptr;
+  int32_t* m_FeatureIds = nullptr;
+  const std::vector<int64_t>& m_SlabStart;
+  const std::vector<int64_t>& m_LabelOffsets;
+  const std::vector<int32_t>& m_FinalIds;
+};
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -101,6 +318,192 @@ bool SegmentFeatures::determineGrouping(int64_t referencepoint, int64_t neighbor
   return false;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SegmentFeatures::supportsParallelSegmentation() const
+{
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int32_t* SegmentFeatures::getFeatureIdsPointer()
+{
+  return nullptr;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SegmentFeatures::isValidSeed(int64_t point) const
+{
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SegmentFeatures::isValidNeighbor(int64_t point) const
+{
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SegmentFeatures::meetsGroupingCriteria(int64_t referencepoint, int64_t neighborpoint) const
+{
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SegmentFeatures::setFeatureCount(int32_t numFeatures)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SegmentFeatures::executeParallel(const int64_t dims[3])
+{
+  int32_t* featureIds = getFeatureIdsPointer();
+  if(nullptr == featureIds)
+  {
+    return false;
+  }
+
+  const size_t numSlabs = static_cast<size_t>(std::min<int64_t>(dims[2], std::max<int64_t>(2, static_cast<int64_t>(std::thread::hardware_concurrency()) * 4)));
+  if(numSlabs < 2)
+  {
+    return false;
+  }
+
+  std::vector<int64_t> slabStart(numSlabs + 1, 0);
+  for(size_t s = 0; s <= numSlabs; s++)
+  {
+    slabStart[s] = (dims[2] * static_cast<int64_t>(s)) / static_cast<int64_t>(numSlabs);
+  }
+
+  // Burn every slab on its own. Each slab numbers its Features from 1 and remembers the smallest
+  // voxel index in each of them that the serial algorithm would have used as a seed.
+  std::vector<std::vector<int64_t>> slabMinSeeds(numSlabs);
+  notifyStatusMessage(QObject::tr("Segmenting %1 slabs").arg(numSlabs));
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, numSlabs, 1), SegmentFeaturesSlabImpl(this, dims, featureIds, slabStart, slabMinSeeds), tbb::simple_partitioner());
+#else
+  SegmentFeaturesSlabImpl(this, dims, featureIds, slabStart, slabMinSeeds).convert(0, numSlabs);
+#endif
+  if(getCancel())
+  {
+    return true;
+  }
+
+  // Give every slab local label a unique global label; label 0 stays "unassigned"
+  std::vector<int64_t> labelOffsets(numSlabs + 1, 0);
+  for(size_t s = 0; s < numSlabs; s++)
+  {
+    labelOffsets[s + 1] = labelOffsets[s] + static_cast<int64_t>(slabMinSeeds[s].size()) - 1;
+  }
+  const int64_t totalLabels = labelOffsets[numSlabs];
+  std::vector<int64_t> parents(totalLabels + 1, 0);
+  std::vector<int64_t> minSeeds(totalLabels + 1, -1);
+  for(size_t s = 0; s < numSlabs; s++)
+  {
+    for(size_t l = 1; l < slabMinSeeds[s].size(); l++)
+    {
+      minSeeds[labelOffsets[s] + l] = slabMinSeeds[s][l];
+    }
+    std::vector<int64_t>().swap(slabMinSeeds[s]);
+  }
+  for(int64_t l = 0; l <= totalLabels; l++)
+  {
+    parents[l] = l;
+  }
+
+  // Collect the label pairs that are grouped across each slab boundary
+  std::vector<std::vector<std::pair<int64_t, int64_t>>> seamPairs(numSlabs - 1);
+  notifyStatusMessage(QObject::tr("Merging Features across %1 slab boundaries").arg(numSlabs - 1));
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, numSlabs - 1, 1), SegmentFeaturesSeamImpl(this, dims, featureIds, slabStart, labelOffsets, seamPairs), tbb::simple_partitioner());
+#else
+  SegmentFeaturesSeamImpl(this, dims, featureIds, slabStart, labelOffsets, seamPairs).convert(0, numSlabs - 1);
+#endif
+
+  auto findRoot = [&parents](int64_t label) {
+    while(parents[label] != label)
+    {
+      parents[label] = parents[parents[label]];
+      label = parents[label];
+    }
+    return label;
+  };
+
+  for(const auto& pairs : seamPairs)
+  {
+    for(const auto& pair : pairs)
+    {
+      int64_t root1 = findRoot(pair.first);
+      int64_t root2 = findRoot(pair.second);
+      if(root1 == root2)
+      {
+        continue;
+      }
+      if(root1 > root2)
+      {
+        std::swap(root1, root2);
+      }
+      parents[root2] = root1;
+      if(minSeeds[root2] >= 0 && (minSeeds[root1] < 0 || minSeeds[root2] < minSeeds[root1]))
+      {
+        minSeeds[root1] = minSeeds[root2];
+      }
+    }
+  }
+  std::vector<std::vector<std::pair<int64_t, int64_t>>>().swap(seamPairs);
+
+  // The serial burn always seeds at the lowest unassigned valid seed, so numbering the merged Features
+  // by their smallest valid seed index reproduces its Feature Ids exactly. Merged groups without any
+  // valid seed are never reached by the serial burn and are returned to 0.
+  std::vector<std::pair<int64_t, int64_t>> roots;
+  for(int64_t l = 1; l <= totalLabels; l++)
+  {
+    if(parents[l] == l && minSeeds[l] >= 0)
+    {
+      roots.emplace_back(minSeeds[l], l);
+    }
+  }
+  std::sort(roots.begin(), roots.end());
+  if(roots.size() >= static_cast<size_t>(std::numeric_limits<int32_t>::max()))
+  {
+    setErrorCondition(-87001, "The number of Features found exceeds the range of the 32 bit Feature Ids");
+    return true;
+  }
+
+  std::vector<int32_t> finalIds(totalLabels + 1, 0);
+  for(size_t r = 0; r < roots.size(); r++)
+  {
+    finalIds[roots[r].second] = static_cast<int32_t>(r + 1);
+  }
+  for(int64_t l = 1; l <= totalLabels; l++)
+  {
+    finalIds[l] = finalIds[findRoot(l)];
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, numSlabs, 1), SegmentFeaturesRelabelImpl(dims, featureIds, slabStart, labelOffsets, finalIds), tbb::simple_partitioner());
+#else
+  SegmentFeaturesRelabelImpl(dims, featureIds, slabStart, labelOffsets, finalIds).convert(0, numSlabs);
+#endif
+
+  setFeatureCount(static_cast<int32_t>(roots.size()));
+  notifyStatusMessage(QObject::tr("Total Features: %1").arg(roots.size()));
+  return true;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -124,6 +527,13 @@ void SegmentFeatures::execute()
       static_cast<int64_t>(udims[2]),
   };
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  if(getUseParallelSegmentation() && supportsParallelSegmentation() && executeParallel(dims))
+  {
+    return;
+  }
+#endif
+
   int32_t gnum = 1;
   int64_t seed = 0;
   int64_t neighbor = 0;
@@ -335,3 +745,15 @@ QString SegmentFeatures::getDataContainerName() const
 {
   return m_DataContainerName;
 }
+
+// -----------------------------------------------------------------------------
+void SegmentFeatures::setUseParallelSegmentation(bool value)
+{
+  m_UseParallelSegmentation = value;
+}
+
+// -----------------------------------------------------------------------------
+bool SegmentFeatures::getUseParallelSegmentation() const
+{
+  return m_UseParallelSegmentation;
+}
@@ -53,12 +53,16 @@ class Reconstruction_EXPORT SegmentFeatures : public AbstractFilter
 {
   Q_OBJECT
 
+  friend class SegmentFeaturesSlabImpl;
+  friend class SegmentFeaturesSeamImpl;
+
   // Start Python bindings declarations
   PYB11_BEGIN_BINDINGS(SegmentFeatures SUPERCLASS AbstractFilter)
   PYB11_FILTER()
   PYB11_SHARED_POINTERS(SegmentFeatures)
   PYB11_FILTER_NEW_MACRO(SegmentFeatures)
   PYB11_PROPERTY(QString DataContainerName READ getDataContainerName WRITE setDataContainerName)
+  PYB11_PROPERTY(bool UseParallelSegmentation READ getUseParallelSegmentation WRITE setUseParallelSegmentation)
   PYB11_END_BINDINGS()
   // End Python bindings declarations
 
@@ -104,6 +108,19 @@ public:
 
   Q_PROPERTY(QString DataContainerName READ getDataContainerName WRITE setDataContainerName)
 
+  /**
+   * @brief Setter property for UseParallelSegmentation. When false the volume is always segmented
+   * with the serial burn, which is used to check the multi-threaded engine against it
+   */
+  void setUseParallelSegmentation(bool value);
+  /**
+   * @brief Getter property for UseParallelSegmentation
+   * @return Value of UseParallelSegmentation
+   */
+  bool getUseParallelSegmentation() const;
+
+  Q_PROPERTY(bool UseParallelSegmentation READ getUseParallelSegmentation WRITE setUseParallelSegmentation)
+
   /**
    * @brief getCompiledLibraryName Reimplemented from @see AbstractFilter class
    */
@@ -188,6 +205,48 @@ protected:
    */
   virtual bool determineGrouping(int64_t referencepoint, int64_t neighborpoint, int32_t gnum);
 
+  /**
+   * @brief supportsParallelSegmentation Returns whether the subclass implements the side effect free
+   * grouping interface below, which allows the volume to be segmented with the multi-threaded engine
+   * @return Boolean check for whether the parallel engine may be used
+   */
+  virtual bool supportsParallelSegmentation() const;
+
+  /**
+   * @brief getFeatureIdsPointer Returns the raw Feature Ids array that the segmentation writes into
+   * @return Pointer to the Feature Ids
+   */
+  virtual int32_t* getFeatureIdsPointer();
+
+  /**
+   * @brief isValidSeed Determines if a voxel is allowed to start a new Feature
+   * @param point Index of the voxel
+   * @return Boolean check for whether the voxel may seed a Feature
+   */
+  virtual bool isValidSeed(int64_t point) const;
+
+  /**
+   * @brief isValidNeighbor Determines if a voxel is allowed to join a growing Feature
+   * @param point Index of the voxel
+   * @return Boolean check for whether the voxel may be grouped
+   */
+  virtual bool isValidNeighbor(int64_t point) const;
+
+  /**
+   * @brief meetsGroupingCriteria Determines if two face adjacent voxels belong to the same Feature. This
+   * must not modify any state since it is called concurrently from several threads
+   * @param referencepoint Point of growing seed
+   * @param neighborpoint Point to be compared for adding
+   * @return Boolean check for whether the two voxels are grouped
+   */
+  virtual bool meetsGroupingCriteria(int64_t referencepoint, int64_t neighborpoint) const;
+
+  /**
+   * @brief setFeatureCount Resizes the Feature Attribute Matrix once the parallel engine has numbered the Features
+   * @param numFeatures Number of Features found, not counting Feature 0
+   */
+  virtual void setFeatureCount(int32_t numFeatures);
+
 public:
   SegmentFeatures(const SegmentFeatures&) = delete;            // Copy Constructor Not Implemented
   SegmentFeatures(SegmentFeatures&&) = delete;                 // Move Constructor Not Implemented
@@ -196,4 +255,13 @@ public:
 
 private:
   QString m_DataContainerName = {};
+  bool m_UseParallelSegmentation = {true};
+
+  /**
+   * @brief executeParallel Labels the volume in independent z slabs and merges the slab labels across the
+   * slab boundaries with a union-find. Produces the same Feature partition and numbering as the serial burn.
+   * @param dims Dimensions of the geometry
+   * @return Boolean check for whether the parallel engine ran to completion
+   */
+  bool executeParallel(const int64_t dims[3]);
 };
@@ -330,7 +330,7 @@ int64_t SineParamsSegmentFeatures::getSeed(int32_t gnum, int64_t nextSeed)
   {
     if(m_FeatureIds[randpoint] == 0) // If the GrainId of the voxel is ZERO then we can use this as a seed point
     {
-      if(!m_UseGoodVoxels || m_GoodVoxels[randpoint])
+      if(isValidSeed(randpoint))
       {
         seed = randpoint;
       }
@@ -359,30 +359,76 @@ int64_t SineParamsSegmentFeatures::getSeed(int32_t gnum, int64_t nextSeed)
 // -----------------------------------------------------------------------------
 bool SineParamsSegmentFeatures::determineGrouping(int64_t referencepoint, int64_t neighborpoint, int32_t gnum)
 {
-  bool group = false;
-  float v1;
-  float v2;
-  float shift;
+  if(m_FeatureIds[neighborpoint] == 0 && isValidNeighbor(neighborpoint) && meetsGroupingCriteria(referencepoint, neighborpoint))
+  {
+    m_FeatureIds[neighborpoint] = gnum;
+    return true;
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SineParamsSegmentFeatures::supportsParallelSegmentation() const
+{
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int32_t* SineParamsSegmentFeatures::getFeatureIdsPointer()
+{
+  return m_FeatureIds;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SineParamsSegmentFeatures::isValidSeed(int64_t point) const
+{
+  return !m_UseGoodVoxels || m_GoodVoxels[point];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SineParamsSegmentFeatures::isValidNeighbor(int64_t point) const
+{
+  return !m_UseGoodVoxels || m_GoodVoxels[point];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool SineParamsSegmentFeatures::meetsGroupingCriteria(int64_t referencepoint, int64_t neighborpoint) const
+{
+  float v1 = 0.0f;
+  float v2 = 0.0f;
+  float shift = 0.0f;
   float step = 45.0f * SIMPLib::Constants::k_PiOver180D;
   float avgDiff = 0;
-  if(m_FeatureIds[neighborpoint] == 0 && (!m_UseGoodVoxels || m_GoodVoxels[neighborpoint]))
+  for(int i = 0; i < 8; i++)
   {
-    for(int i = 0; i < 8; i++)
-    {
-      shift = float(i) * step;
-      v1 = m_SineParams[3 * referencepoint] * sin(2.0 * (shift + m_SineParams[3 * referencepoint + 2])) + m_SineParams[3 * referencepoint + 1];
-      v2 = m_SineParams[3 * neighborpoint] * sin(2.0 * (shift + m_SineParams[3 * neighborpoint + 2])) + m_SineParams[3 * neighborpoint + 1];
-      avgDiff += fabs(v1 - v2);
-    }
-    avgDiff /= 8.0;
-    if(avgDiff < 7)
-    {
-      group = true;
-      m_FeatureIds[neighborpoint] = gnum;
-    }
+    shift = float(i) * step;
+    v1 = m_SineParams[3 * referencepoint] * sin(2.0 * (shift + m_SineParams[3 * referencepoint + 2])) + m_SineParams[3 * referencepoint + 1];
+    v2 = m_SineParams[3 * neighborpoint] * sin(2.0 * (shift + m_SineParams[3 * neighborpoint + 2])) + m_SineParams[3 * neighborpoint + 1];
+    avgDiff += fabs(v1 - v2);
   }
+  avgDiff /= 8.0;
+  return avgDiff < 7;
+}
 
-  return group;
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void SineParamsSegmentFeatures::setFeatureCount(int32_t numFeatures)
+{
+  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getDataContainerName());
+  std::vector<size_t> tDims(1, numFeatures + 1);
+  m->getAttributeMatrix(getCellFeatureAttributeMatrixName())->resizeAttributeArrays(tDims);
+  updateFeatureInstancePointers();
 }
 
 // -----------------------------------------------------------------------------
@@ -261,6 +261,12 @@ protected:
 
   int64_t getSeed(int32_t gnum, int64_t nextSeed) override;
   bool determineGrouping(int64_t referencepoint, int64_t neighborpoint, int32_t gnum) override;
+  bool supportsParallelSegmentation() const override;
+  int32_t* getFeatureIdsPointer() override;
+  bool isValidSeed(int64_t point) const override;
+  bool isValidNeighbor(int64_t point) const override;
+  bool meetsGroupingCriteria(int64_t referencepoint, int64_t neighborpoint) const override;
+  void setFeatureCount(int32_t numFeatures) override;
 
 private:
   std::weak_ptr<DataArray<float>> m_SineParamsPtr;
@@ -284,7 +284,7 @@ int64_t VectorSegmentFeatures::getSeed(int32_t gnum, int64_t nextSeed)
   {
     if(m_FeatureIds[randpoint] == 0) // If the GrainId of the voxel is ZERO then we can use this as a seed point
     {
-      if(!m_UseGoodVoxels || m_GoodVoxels[randpoint])
+      if(isValidSeed(randpoint))
       {
         seed = randpoint;
       }
@@ -313,38 +313,79 @@ int64_t VectorSegmentFeatures::getSeed(int32_t gnum, int64_t nextSeed)
 // -----------------------------------------------------------------------------
 bool VectorSegmentFeatures::determineGrouping(int64_t referencepoint, int64_t neighborpoint, int32_t gnum)
 {
-  bool group = false;
-  float v1[3] = {0.0f, 0.0f, 0.0f};
-  float v2[3] = {0.0f, 0.0f, 0.0f};
-  if(m_FeatureIds[neighborpoint] == 0 && (!m_UseGoodVoxels || m_GoodVoxels[neighborpoint]))
+  if(m_FeatureIds[neighborpoint] == 0 && isValidNeighbor(neighborpoint) && meetsGroupingCriteria(referencepoint, neighborpoint))
   {
-    v1[0] = m_Vectors[3 * referencepoint + 0];
-    v1[1] = m_Vectors[3 * referencepoint + 1];
-    v1[2] = m_Vectors[3 * referencepoint + 2];
-    v2[0] = m_Vectors[3 * neighborpoint + 0];
-    v2[1] = m_Vectors[3 * neighborpoint + 1];
-    v2[2] = m_Vectors[3 * neighborpoint + 2];
-    if(v1[2] < 0)
-    {
-      MatrixMath::Multiply3x1withConstant(v1, -1.0f);
-    }
-    if(v2[2] < 0)
-    {
-      MatrixMath::Multiply3x1withConstant(v2, -1.0f);
-    }
-    float w = GeometryMath::CosThetaBetweenVectors(v1, v2);
-    w = acosf(w);
-    if(w > SIMPLib::Constants::k_PiOver2D)
-    {
-      w = SIMPLib::Constants::k_PiD - w;
-    }
-    if(w < m_AngleToleranceRad)
-    {
-      group = true;
-      m_FeatureIds[neighborpoint] = gnum;
-    }
+    m_FeatureIds[neighborpoint] = gnum;
+    return true;
   }
-  return group;
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool VectorSegmentFeatures::supportsParallelSegmentation() const
+{
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int32_t* VectorSegmentFeatures::getFeatureIdsPointer()
+{
+  return m_FeatureIds;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool VectorSegmentFeatures::isValidSeed(int64_t point) const
+{
+  return !m_UseGoodVoxels || m_GoodVoxels[point];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool VectorSegmentFeatures::isValidNeighbor(int64_t point) const
+{
+  return !m_UseGoodVoxels || m_GoodVoxels[point];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool VectorSegmentFeatures::meetsGroupingCriteria(int64_t referencepoint, int64_t neighborpoint) const
+{
+  float v1[3] = {m_Vectors[3 * referencepoint + 0], m_Vectors[3 * referencepoint + 1], m_Vectors[3 * referencepoint + 2]};
+  float v2[3] = {m_Vectors[3 * neighborpoint + 0], m_Vectors[3 * neighborpoint + 1], m_Vectors[3 * neighborpoint + 2]};
+  if(v1[2] < 0)
+  {
+    MatrixMath::Multiply3x1withConstant(v1, -1.0f);
+  }
+  if(v2[2] < 0)
+  {
+    MatrixMath::Multiply3x1withConstant(v2, -1.0f);
+  }
+  float w = GeometryMath::CosThetaBetweenVectors(v1, v2);
+  w = acosf(w);
+  if(w > SIMPLib::Constants::k_PiOver2D)
+  {
+    w = SIMPLib::Constants::k_PiD - w;
+  }
+  return w < m_AngleToleranceRad;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void VectorSegmentFeatures::setFeatureCount(int32_t numFeatures)
+{
+  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getDataContainerName());
+  std::vector<size_t> tDims(1, numFeatures + 1);
+  m->getAttributeMatrix(getCellFeatureAttributeMatrixName())->resizeAttributeArrays(tDims);
+  updateFeatureInstancePointers();
 }
 
 // -----------------------------------------------------------------------------
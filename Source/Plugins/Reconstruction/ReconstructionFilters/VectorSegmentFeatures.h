@@ -267,6 +267,36 @@ protected:
    */
   bool determineGrouping(int64_t referencepoint, int64_t neighborpoint, int32_t gnum) override;
 
+  /**
+   * @brief supportsParallelSegmentation Reimplemented from @see SegmentFeatures class
+   */
+  bool supportsParallelSegmentation() const override;
+
+  /**
+   * @brief getFeatureIdsPointer Reimplemented from @see SegmentFeatures class
+   */
+  int32_t* getFeatureIdsPointer() override;
+
+  /**
+   * @brief isValidSeed Reimplemented from @see SegmentFeatures class
+   */
+  bool isValidSeed(int64_t point) const override;
+
+  /**
+   * @brief isValidNeighbor Reimplemented from @see SegmentFeatures class
+   */
+  bool isValidNeighbor(int64_t point) const override;
+
+  /**
+   * @brief meetsGroupingCriteria Reimplemented from @see SegmentFeatures class
+   */
+  bool meetsGroupingCriteria(int64_t referencepoint, int64_t neighborpoint) const override;
+
+  /**
+   * @brief setFeatureCount Reimplemented from @see SegmentFeatures class
+   */
+  void setFeatureCount(int32_t numFeatures) override;
+
 private:
   std::weak_ptr<DataArray<float>> m_VectorsPtr;
   float* m_Vectors = nullptr;
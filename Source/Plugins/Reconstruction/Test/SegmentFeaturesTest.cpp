@@ -0,0 +1,387 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include <QtCore/QDebug>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterFactory.hpp"
+#include "SIMPLib/Filtering/FilterManager.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#include "UnitTestSupport.hpp"
+
+#include "ReconstructionTestFileLocations.h"
+
+namespace SegmentFeaturesTestConsts
+{
+const QString k_ScalarsName("Scalars");
+const QString k_QuatsName("Quats");
+const QString k_PhasesName("Phases");
+const QString k_GoodVoxelsName("Mask");
+const QString k_CrystalStructuresName("CrystalStructures");
+
+// Tall enough in z that the multi-threaded engine cuts the volume into several slabs on any machine
+const size_t k_Dims[3] = {24, 20, 48};
+const size_t k_NumGrains = 60;
+const uint32_t k_RandomSeed = 5489;
+
+// Crystal structures of phases 0, 1 and 2: unknown, cubic m-3m and hexagonal 6/mmm
+const uint32_t k_CrystalStructures[3] = {999, 1, 0};
+} // namespace SegmentFeaturesTestConsts
+
+class SegmentFeaturesTest
+{
+
+public:
+  SegmentFeaturesTest() = default;
+  ~SegmentFeaturesTest() = default;
+
+  /**
+   * @brief Returns the name of the class for SegmentFeaturesTest
+   */
+  QString getNameOfClass() const
+  {
+    return QString("SegmentFeaturesTest");
+  }
+
+  /**
+   * @brief Returns the name of the class for SegmentFeaturesTest
+   */
+  QString ClassName()
+  {
+    return QString("SegmentFeaturesTest");
+  }
+
+  SegmentFeaturesTest(const SegmentFeaturesTest&) = delete;            // Copy Constructor Not Implemented
+  SegmentFeaturesTest(SegmentFeaturesTest&&) = delete;                 // Move Constructor Not Implemented
+  SegmentFeaturesTest& operator=(const SegmentFeaturesTest&) = delete; // Copy Assignment Not Implemented
+  SegmentFeaturesTest& operator=(SegmentFeaturesTest&&) = delete;      // Move Assignment Not Implemented
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestFilterAvailability()
+  {
+    // Now instantiate the segmentation Filters from the FilterManager
+    QStringList filtNames = {"ScalarSegmentFeatures", "EBSDSegmentFeatures"};
+    FilterManager* fm = FilterManager::Instance();
+    for(const QString& filtName : filtNames)
+    {
+      IFilterFactory::Pointer filterFactory = fm->getFactoryFromClassName(filtName);
+      if(nullptr == filterFactory.get())
+      {
+        std::stringstream ss;
+        ss << "The SegmentFeaturesTest Requires the use of the " << filtName.toStdString() << " filter which is found in the Reconstruction Plugin";
+        DREAM3D_TEST_THROW_EXCEPTION(ss.str())
+      }
+    }
+    return 0;
+  }
+
+  // -----------------------------------------------------------------------------
+  // Multiplies the quaternions p and q, both stored as (x, y, z, w)
+  // -----------------------------------------------------------------------------
+  void multiplyQuats(const float* p, const float* q, float* out)
+  {
+    out[0] = p[3] * q[0] + p[0] * q[3] + p[1] * q[2] - p[2] * q[1];
+    out[1] = p[3] * q[1] + p[1] * q[3] + p[2] * q[0] - p[0] * q[2];
+    out[2] = p[3] * q[2] + p[2] * q[3] + p[0] * q[1] - p[1] * q[0];
+    out[3] = p[3] * q[3] - p[0] * q[0] - p[1] * q[1] - p[2] * q[2];
+  }
+
+  // -----------------------------------------------------------------------------
+  // Writes a rotation of a random axis by an angle drawn from [0, maxAngle] radians as a quaternion
+  // -----------------------------------------------------------------------------
+  void randomRotation(std::mt19937& generator, float maxAngle, float* out)
+  {
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    std::uniform_real_distribution<float> uniform(0.0f, maxAngle);
+    float axis[3] = {normal(generator), normal(generator), normal(generator)};
+    float length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+    if(length == 0.0f)
+    {
+      axis[2] = length = 1.0f;
+    }
+    float halfAngle = 0.5f * uniform(generator);
+    float s = std::sin(halfAngle) / length;
+    out[0] = axis[0] * s;
+    out[1] = axis[1] * s;
+    out[2] = axis[2] * s;
+    out[3] = std::cos(halfAngle);
+  }
+
+  // -----------------------------------------------------------------------------
+  // Builds a seeded random Voronoi microstructure. Every grain has a scalar level and an orientation. Neighboring
+  // grain levels and some grain orientations lie within the grouping tolerances, and every Cell adds noise on top,
+  // so Features meander through several grains and across the slab boundaries. About one Cell in twelve is masked
+  // out and a few grains belong to a second phase.
+  // -----------------------------------------------------------------------------
+  DataContainerArray::Pointer createVolume()
+  {
+    std::vector<size_t> tDims = {SegmentFeaturesTestConsts::k_Dims[0], SegmentFeaturesTestConsts::k_Dims[1], SegmentFeaturesTestConsts::k_Dims[2]};
+    const size_t totalPoints = tDims[0] * tDims[1] * tDims[2];
+
+    DataContainerArray::Pointer dca = DataContainerArray::New();
+    DataContainer::Pointer dc = DataContainer::New(SIMPL::Defaults::ImageDataContainerName);
+    ImageGeom::Pointer image = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+    image->setDimensions(SizeVec3Type(tDims[0], tDims[1], tDims[2]));
+    image->setSpacing(FloatVec3Type(1.0f, 1.0f, 1.0f));
+    image->setOrigin(FloatVec3Type(0.0f, 0.0f, 0.0f));
+    dc->setGeometry(image);
+
+    std::mt19937 generator(SegmentFeaturesTestConsts::k_RandomSeed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_int_distribution<int32_t> noise(0, 3);
+
+    const size_t numGrains = SegmentFeaturesTestConsts::k_NumGrains;
+    std::vector<float> centers(3 * numGrains);
+    std::vector<float> grainQuats(4 * numGrains);
+    std::vector<int32_t> grainPhases(numGrains, 1);
+    for(size_t g = 0; g < numGrains; g++)
+    {
+      for(size_t d = 0; d < 3; d++)
+      {
+        centers[3 * g + d] = unit(generator) * static_cast<float>(tDims[d]);
+      }
+      if(g % 3 == 1)
+      {
+        // Within the misorientation tolerance of the previous grain
+        float rotation[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        randomRotation(generator, 0.05f, rotation);
+        multiplyQuats(grainQuats.data() + 4 * (g - 1), rotation, grainQuats.data() + 4 * g);
+      }
+      else
+      {
+        randomRotation(generator, 3.1415926f, grainQuats.data() + 4 * g);
+      }
+      if(g % 10 == 7)
+      {
+        grainPhases[g] = 2;
+      }
+    }
+
+    AttributeMatrix::Pointer cellAttrMat = AttributeMatrix::New(tDims, SIMPL::Defaults::CellAttributeMatrixName, AttributeMatrix::Type::Cell);
+    std::vector<size_t> cDims(1, 1);
+    Int32ArrayType::Pointer scalars = Int32ArrayType::CreateArray(tDims, cDims, SegmentFeaturesTestConsts::k_ScalarsName, true);
+    Int32ArrayType::Pointer phases = Int32ArrayType::CreateArray(tDims, cDims, SegmentFeaturesTestConsts::k_PhasesName, true);
+    BoolArrayType::Pointer goodVoxels = BoolArrayType::CreateArray(tDims, cDims, SegmentFeaturesTestConsts::k_GoodVoxelsName, true);
+    cDims[0] = 4;
+    FloatArrayType::Pointer quats = FloatArrayType::CreateArray(tDims, cDims, SegmentFeaturesTestConsts::k_QuatsName, true);
+
+    for(size_t i = 0; i < totalPoints; i++)
+    {
+      float coords[3] = {static_cast<float>(i % tDims[0]), static_cast<float>((i / tDims[0]) % tDims[1]), static_cast<float>(i / (tDims[0] * tDims[1]))};
+      size_t grain = 0;
+      float minDistance = std::numeric_limits<float>::max();
+      for(size_t g = 0; g < numGrains; g++)
+      {
+        float dx = coords[0] - centers[3 * g];
+        float dy = coords[1] - centers[3 * g + 1];
+        float dz = coords[2] - centers[3 * g + 2];
+        float distance = dx * dx + dy * dy + dz * dz;
+        if(distance < minDistance)
+        {
+          minDistance = distance;
+          grain = g;
+        }
+      }
+
+      // Levels of neighboring grains are 4 apart and the noise spans 3, so a tolerance of 2 both splits grains
+      // and joins some of them
+      scalars->setValue(i, 4 * static_cast<int32_t>(grain % 8) + noise(generator));
+      phases->setValue(i, grainPhases[grain]);
+      goodVoxels->setValue(i, unit(generator) >= 0.08f);
+
+      float rotation[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+      randomRotation(generator, 0.06f, rotation);
+      multiplyQuats(grainQuats.data() + 4 * grain, rotation, quats->getTuplePointer(i));
+    }
+    cellAttrMat->insertOrAssign(scalars);
+    cellAttrMat->insertOrAssign(phases);
+    cellAttrMat->insertOrAssign(goodVoxels);
+    cellAttrMat->insertOrAssign(quats);
+    dc->addOrReplaceAttributeMatrix(cellAttrMat);
+
+    std::vector<size_t> ensembleDims(1, 3);
+    AttributeMatrix::Pointer ensembleAttrMat = AttributeMatrix::New(ensembleDims, SIMPL::Defaults::CellEnsembleAttributeMatrixName, AttributeMatrix::Type::CellEnsemble);
+    cDims[0] = 1;
+    UInt32ArrayType::Pointer crystalStructures = UInt32ArrayType::CreateArray(ensembleDims, cDims, SegmentFeaturesTestConsts::k_CrystalStructuresName, true);
+    for(size_t e = 0; e < 3; e++)
+    {
+      crystalStructures->setValue(e, SegmentFeaturesTestConsts::k_CrystalStructures[e]);
+    }
+    ensembleAttrMat->insertOrAssign(crystalStructures);
+    dc->addOrReplaceAttributeMatrix(ensembleAttrMat);
+
+    dca->addOrReplaceDataContainer(dc);
+    return dca;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  DataArrayPath cellArrayPath(const QString& name)
+  {
+    return DataArrayPath(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellAttributeMatrixName, name);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void setFilterProperty(const AbstractFilter::Pointer& filter, const char* name, const QVariant& value)
+  {
+    bool propWasSet = filter->setProperty(name, value);
+    DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+  }
+
+  // -----------------------------------------------------------------------------
+  // Runs the segmentation Filter on a fresh copy of the volume, with the multi-threaded engine or the serial burn
+  // -----------------------------------------------------------------------------
+  DataContainerArray::Pointer runSegmentation(const QString& filtName, bool useParallelSegmentation)
+  {
+    DataContainerArray::Pointer dca = createVolume();
+
+    FilterManager* fm = FilterManager::Instance();
+    IFilterFactory::Pointer factory = fm->getFactoryFromClassName(filtName);
+    DREAM3D_REQUIRE(factory.get() != nullptr)
+
+    AbstractFilter::Pointer filter = factory->create();
+    DREAM3D_REQUIRE(filter.get() != nullptr)
+    filter->setDataContainerArray(dca);
+
+    QVariant var;
+    var.setValue(true);
+    setFilterProperty(filter, "UseGoodVoxels", var);
+    var.setValue(false);
+    setFilterProperty(filter, "RandomizeFeatureIds", var);
+    var.setValue(useParallelSegmentation);
+    setFilterProperty(filter, "UseParallelSegmentation", var);
+    var.setValue(cellArrayPath(SegmentFeaturesTestConsts::k_GoodVoxelsName));
+    setFilterProperty(filter, "GoodVoxelsArrayPath", var);
+
+    if(filtName == "ScalarSegmentFeatures")
+    {
+      var.setValue(cellArrayPath(SegmentFeaturesTestConsts::k_ScalarsName));
+      setFilterProperty(filter, "ScalarArrayPath", var);
+      var.setValue(2.0f);
+      setFilterProperty(filter, "ScalarTolerance", var);
+    }
+    else
+    {
+      var.setValue(cellArrayPath(SegmentFeaturesTestConsts::k_QuatsName));
+      setFilterProperty(filter, "QuatsArrayPath", var);
+      var.setValue(cellArrayPath(SegmentFeaturesTestConsts::k_PhasesName));
+      setFilterProperty(filter, "CellPhasesArrayPath", var);
+      var.setValue(DataArrayPath(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellEnsembleAttributeMatrixName, SegmentFeaturesTestConsts::k_CrystalStructuresName));
+      setFilterProperty(filter, "CrystalStructuresArrayPath", var);
+      var.setValue(5.0f);
+      setFilterProperty(filter, "MisorientationTolerance", var);
+    }
+
+    filter->execute();
+    DREAM3D_REQUIRE_EQUAL(filter->getErrorCode(), 0)
+    return dca;
+  }
+
+  // -----------------------------------------------------------------------------
+  // The slab union-find must reproduce the Feature Ids and the number of Features of the serial burn exactly
+  // -----------------------------------------------------------------------------
+  int TestParallelMatchesSerial(const QString& filtName)
+  {
+    DataContainerArray::Pointer serialDca = runSegmentation(filtName, false);
+    DataContainerArray::Pointer parallelDca = runSegmentation(filtName, true);
+
+    DataArrayPath featureIdsPath = cellArrayPath(SIMPL::CellData::FeatureIds);
+    Int32ArrayType::Pointer serialIds = serialDca->getAttributeMatrix(featureIdsPath)->getAttributeArrayAs<Int32ArrayType>(SIMPL::CellData::FeatureIds);
+    Int32ArrayType::Pointer parallelIds = parallelDca->getAttributeMatrix(featureIdsPath)->getAttributeArrayAs<Int32ArrayType>(SIMPL::CellData::FeatureIds);
+    DREAM3D_REQUIRE(serialIds.get() != nullptr)
+    DREAM3D_REQUIRE(parallelIds.get() != nullptr)
+    DREAM3D_REQUIRE_EQUAL(serialIds->getNumberOfTuples(), parallelIds->getNumberOfTuples())
+
+    DataArrayPath featureAMPath(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellFeatureAttributeMatrixName, "");
+    size_t serialFeatures = serialDca->getAttributeMatrix(featureAMPath)->getNumberOfTuples();
+    size_t parallelFeatures = parallelDca->getAttributeMatrix(featureAMPath)->getNumberOfTuples();
+    DREAM3D_REQUIRE_EQUAL(serialFeatures, parallelFeatures)
+    // Enough Features that the volume is not trivially a single grain
+    DREAM3D_REQUIRE(serialFeatures > SegmentFeaturesTestConsts::k_NumGrains / 4)
+
+    size_t numTuples = serialIds->getNumberOfTuples();
+    for(size_t i = 0; i < numTuples; i++)
+    {
+      DREAM3D_REQUIRE_EQUAL(serialIds->getValue(i), parallelIds->getValue(i))
+    }
+
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestScalarSegmentFeatures()
+  {
+    return TestParallelMatchesSerial("ScalarSegmentFeatures");
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestEBSDSegmentFeatures()
+  {
+    return TestParallelMatchesSerial("EBSDSegmentFeatures");
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    int err = EXIT_SUCCESS;
+    std::cout << "---- " << getNameOfClass().toStdString() << " ----" << std::endl;
+
+    DREAM3D_REGISTER_TEST(TestFilterAvailability());
+
+    DREAM3D_REGISTER_TEST(TestScalarSegmentFeatures())
+    DREAM3D_REGISTER_TEST(TestEBSDSegmentFeatures())
+  }
+
+private:
+};
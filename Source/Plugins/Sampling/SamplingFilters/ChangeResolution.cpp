@@ -34,6 +34,10 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "ChangeResolution.h"
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 #include <QtCore/QTextStream>
 
 #include "SIMPLib/Common/Constants.h"
@@ -41,6 +45,7 @@
 #include "SIMPLib/DataContainers/DataContainerArray.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
 #include "SIMPLib/FilterParameters/AttributeMatrixSelectionFilterParameter.h"
+#include "SIMPLib/FilterParameters/ChoiceFilterParameter.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/DataContainerCreationFilterParameter.h"
 #include "SIMPLib/FilterParameters/FloatVec3FilterParameter.h"
@@ -49,9 +54,324 @@
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
 #include "SIMPLib/Geometry/ImageGeom.h"
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
 #include "Sampling/SamplingConstants.h"
 #include "Sampling/SamplingVersion.h"
 
+namespace
+{
+/**
+ * @brief The AxisSampling struct maps the new cells along one axis onto the old cells along the same axis.
+ * Each axis is handled on its own, so the mapping costs a few entries per new row instead of one index per new cell.
+ */
+struct AxisSampling
+{
+  std::vector<size_t> nearest;  // Old cell that contains the start of each new cell
+  std::vector<size_t> blockEnd; // One past the last old cell that starts inside each new cell
+  std::vector<size_t> lower;    // Old cell centers on either side of the new cell center
+  std::vector<size_t> upper;
+  std::vector<float> weight; // Weight of the upper cell center
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AxisSampling createAxisSampling(size_t newDim, size_t oldDim, float newRes, float oldRes)
+{
+  AxisSampling axis;
+  axis.nearest.resize(newDim);
+  axis.blockEnd.resize(newDim);
+  axis.lower.resize(newDim);
+  axis.upper.resize(newDim);
+  axis.weight.resize(newDim);
+  for(size_t k = 0; k < newDim; k++)
+  {
+    float x = (k * newRes);
+    axis.nearest[k] = std::min(size_t(x / oldRes), oldDim - 1);
+
+    x = ((k + 1) * newRes);
+    axis.blockEnd[k] = std::max(std::min(size_t(x / oldRes), oldDim), axis.nearest[k] + 1);
+
+    float u = ((k + 0.5f) * newRes) / oldRes - 0.5f;
+    u = std::max(0.0f, std::min(u, static_cast<float>(oldDim - 1)));
+    axis.lower[k] = static_cast<size_t>(u);
+    axis.upper[k] = std::min(axis.lower[k] + 1, oldDim - 1);
+    axis.weight[k] = u - static_cast<float>(axis.lower[k]);
+  }
+  return axis;
+}
+
+enum class SamplingKind
+{
+  Nearest,
+  LinearFloat,
+  LinearDouble
+};
+
+/**
+ * @brief The CopyTarget struct is one array that the majority vote copies from the old grid to the new grid
+ */
+struct CopyTarget
+{
+  const uint8_t* source;
+  uint8_t* destination;
+  size_t tupleSize;
+};
+
+/**
+ * @brief The CopyMajorityCellsImpl class picks, for a range of rows of the new grid, the old cell that every
+ * non-interpolated array is copied from and copies all of those arrays for the row. That cell holds the most common
+ * label among the old cells that start inside the new cell, so all arrays of a new cell come from one and the same
+ * old cell. Only one row of source cells is kept at a time.
+ */
+class CopyMajorityCellsImpl
+{
+public:
+  CopyMajorityCellsImpl(const AxisSampling& xAxis, const AxisSampling& yAxis, const AxisSampling& zAxis, const SizeVec3Type& oldDims, size_t newDimX, size_t newDimY, const int32_t* labels,
+                        const std::vector<CopyTarget>& targets)
+  : m_XAxis(xAxis)
+  , m_YAxis(yAxis)
+  , m_ZAxis(zAxis)
+  , m_OldDims(oldDims)
+  , m_NewDimX(newDimX)
+  , m_NewDimY(newDimY)
+  , m_Labels(labels)
+  , m_Targets(targets)
+  {
+  }
+  virtual ~CopyMajorityCellsImpl() = default;
+
+  /**
+   * @brief convert Ties go to the nearest old cell if its label is among the most common ones and to the smallest
+   * label otherwise. The source cell is the nearest old cell if it carries the winning label and the first old cell
+   * of the block that does otherwise.
+   */
+  void convert(size_t start, size_t end) const
+  {
+    std::vector<int32_t> labels;
+    std::vector<size_t> sourceCells(m_NewDimX);
+    for(size_t row = start; row < end; row++)
+    {
+      size_t j = row % m_NewDimY;
+      size_t i = row / m_NewDimY;
+      for(size_t k = 0; k < m_NewDimX; k++)
+      {
+        size_t nearest = oldIndex(m_XAxis.nearest[k], m_YAxis.nearest[j], m_ZAxis.nearest[i]);
+        int32_t bestLabel = m_Labels[nearest];
+
+        labels.clear();
+        for(size_t plane = m_ZAxis.nearest[i]; plane < m_ZAxis.blockEnd[i]; plane++)
+        {
+          for(size_t r = m_YAxis.nearest[j]; r < m_YAxis.blockEnd[j]; r++)
+          {
+            for(size_t col = m_XAxis.nearest[k]; col < m_XAxis.blockEnd[k]; col++)
+            {
+              labels.push_back(m_Labels[oldIndex(col, r, plane)]);
+            }
+          }
+        }
+
+        if(labels.size() > 1)
+        {
+          std::sort(labels.begin(), labels.end());
+          size_t bestCount = 0;
+          size_t nearestCount = 0;
+          int32_t nearestLabel = bestLabel;
+          for(size_t runStart = 0; runStart < labels.size();)
+          {
+            size_t runEnd = runStart + 1;
+            while(runEnd < labels.size() && labels[runEnd] == labels[runStart])
+            {
+              runEnd++;
+            }
+            if(runEnd - runStart > bestCount)
+            {
+              bestCount = runEnd - runStart;
+              bestLabel = labels[runStart];
+            }
+            if(labels[runStart] == nearestLabel)
+            {
+              nearestCount = runEnd - runStart;
+            }
+            runStart = runEnd;
+          }
+          if(nearestCount == bestCount)
+          {
+            bestLabel = nearestLabel;
+          }
+        }
+
+        size_t source = nearest;
+        if(m_Labels[nearest] != bestLabel)
+        {
+          source = findFirstCell(i, j, k, bestLabel);
+        }
+        sourceCells[k] = source;
+      }
+
+      for(const CopyTarget& target : m_Targets)
+      {
+        uint8_t* destination = target.destination + row * m_NewDimX * target.tupleSize;
+        for(size_t k = 0; k < m_NewDimX; k++)
+        {
+          ::memcpy(destination + k * target.tupleSize, target.source + sourceCells[k] * target.tupleSize, target.tupleSize);
+        }
+      }
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+
+private:
+  const AxisSampling& m_XAxis;
+  const AxisSampling& m_YAxis;
+  const AxisSampling& m_ZAxis;
+  SizeVec3Type m_OldDims;
+  size_t m_NewDimX;
+  size_t m_NewDimY;
+  const int32_t* m_Labels;
+  const std::vector<CopyTarget>& m_Targets;
+
+  size_t oldIndex(size_t col, size_t row, size_t plane) const
+  {
+    return (plane * m_OldDims[1] * m_OldDims[0]) + (row * m_OldDims[0]) + col;
+  }
+
+  size_t findFirstCell(size_t i, size_t j, size_t k, int32_t label) const
+  {
+    for(size_t plane = m_ZAxis.nearest[i]; plane < m_ZAxis.blockEnd[i]; plane++)
+    {
+      for(size_t r = m_YAxis.nearest[j]; r < m_YAxis.blockEnd[j]; r++)
+      {
+        for(size_t col = m_XAxis.nearest[k]; col < m_XAxis.blockEnd[k]; col++)
+        {
+          if(m_Labels[oldIndex(col, r, plane)] == label)
+          {
+            return oldIndex(col, r, plane);
+          }
+        }
+      }
+    }
+    return oldIndex(m_XAxis.nearest[k], m_YAxis.nearest[j], m_ZAxis.nearest[i]);
+  }
+};
+
+/**
+ * @brief The ChangeResolutionImpl class fills a range of rows of the new grid for one array. A row is a line
+ * of new cells along X, numbered plane by plane.
+ */
+class ChangeResolutionImpl
+{
+public:
+  ChangeResolutionImpl(const AxisSampling& xAxis, const AxisSampling& yAxis, const AxisSampling& zAxis, const SizeVec3Type& oldDims, size_t newDimX, size_t newDimY, SamplingKind kind,
+                       const IDataArray::Pointer& source, const IDataArray::Pointer& destination)
+  : m_XAxis(xAxis)
+  , m_YAxis(yAxis)
+  , m_ZAxis(zAxis)
+  , m_OldDims(oldDims)
+  , m_NewDimX(newDimX)
+  , m_NewDimY(newDimY)
+  , m_Kind(kind)
+  , m_Source(static_cast<uint8_t*>(source->getVoidPointer(0)))
+  , m_Destination(static_cast<uint8_t*>(destination->getVoidPointer(0)))
+  , m_TupleSize(source->getTypeSize() * source->getNumberOfComponents())
+  {
+  }
+  virtual ~ChangeResolutionImpl() = default;
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t row = start; row < end; row++)
+    {
+      size_t j = row % m_NewDimY;
+      size_t i = row / m_NewDimY;
+      switch(m_Kind)
+      {
+      case SamplingKind::Nearest:
+        copyNearestRow(row, i, j);
+        break;
+      case SamplingKind::LinearFloat:
+        interpolateRow<float>(row, i, j);
+        break;
+      case SamplingKind::LinearDouble:
+        interpolateRow<double>(row, i, j);
+        break;
+      }
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+
+private:
+  const AxisSampling& m_XAxis;
+  const AxisSampling& m_YAxis;
+  const AxisSampling& m_ZAxis;
+  SizeVec3Type m_OldDims;
+  size_t m_NewDimX;
+  size_t m_NewDimY;
+  SamplingKind m_Kind;
+  uint8_t* m_Source;
+  uint8_t* m_Destination;
+  size_t m_TupleSize;
+
+  size_t oldIndex(size_t col, size_t row, size_t plane) const
+  {
+    return (plane * m_OldDims[1] * m_OldDims[0]) + (row * m_OldDims[0]) + col;
+  }
+
+  void copyNearestRow(size_t row, size_t i, size_t j) const
+  {
+    size_t rowStart = oldIndex(0, m_YAxis.nearest[j], m_ZAxis.nearest[i]);
+    uint8_t* destination = m_Destination + row * m_NewDimX * m_TupleSize;
+    for(size_t k = 0; k < m_NewDimX; k++)
+    {
+      ::memcpy(destination + k * m_TupleSize, m_Source + (rowStart + m_XAxis.nearest[k]) * m_TupleSize, m_TupleSize);
+    }
+  }
+
+  template <typename T>
+  void interpolateRow(size_t row, size_t i, size_t j) const
+  {
+    const T* source = reinterpret_cast<const T*>(m_Source);
+    T* destination = reinterpret_cast<T*>(m_Destination) + row * m_NewDimX;
+    size_t y0 = m_YAxis.lower[j];
+    size_t y1 = m_YAxis.upper[j];
+    size_t z0 = m_ZAxis.lower[i];
+    size_t z1 = m_ZAxis.upper[i];
+    T wy = static_cast<T>(m_YAxis.weight[j]);
+    T wz = static_cast<T>(m_ZAxis.weight[i]);
+    for(size_t k = 0; k < m_NewDimX; k++)
+    {
+      size_t x0 = m_XAxis.lower[k];
+      size_t x1 = m_XAxis.upper[k];
+      T wx = static_cast<T>(m_XAxis.weight[k]);
+      T c00 = source[oldIndex(x0, y0, z0)] + wx * (source[oldIndex(x1, y0, z0)] - source[oldIndex(x0, y0, z0)]);
+      T c10 = source[oldIndex(x0, y1, z0)] + wx * (source[oldIndex(x1, y1, z0)] - source[oldIndex(x0, y1, z0)]);
+      T c01 = source[oldIndex(x0, y0, z1)] + wx * (source[oldIndex(x1, y0, z1)] - source[oldIndex(x0, y0, z1)]);
+      T c11 = source[oldIndex(x0, y1, z1)] + wx * (source[oldIndex(x1, y1, z1)] - source[oldIndex(x0, y1, z1)]);
+      T c0 = c00 + wy * (c10 - c00);
+      T c1 = c01 + wy * (c11 - c01);
+      destination[k] = c0 + wz * (c1 - c0);
+    }
+  }
+};
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -59,6 +379,7 @@ ChangeResolution::ChangeResolution()
 : m_NewDataContainerName(SIMPL::Defaults::NewImageDataContainerName)
 , m_CellAttributeMatrixPath(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellAttributeMatrixName, "")
 , m_CellFeatureAttributeMatrixPath(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellFeatureAttributeMatrixName, "")
+, m_ResamplingMode(0)
 , m_RenumberFeatures(true)
 , m_SaveAsNewDataContainer(false)
 , m_FeatureIdsArrayPath(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellAttributeMatrixName, SIMPL::CellData::FeatureIds)
@@ -81,10 +402,15 @@ void ChangeResolution::setupFilterParameters()
   FilterParameterVectorType parameters;
   parameters.push_back(SIMPL_NEW_FLOAT_VEC3_FP("Spacing", Spacing, FilterParameter::Parameter, ChangeResolution));
   parameters.back()->setLegacyPropertyName("Resolution");
+  {
+    QVector<QString> choices;
+    choices.push_back("Nearest Neighbor");
+    choices.push_back("Trilinear / Majority Vote");
+    parameters.push_back(SIMPL_NEW_CHOICE_FP("Resampling Mode", ResamplingMode, FilterParameter::Parameter, ChangeResolution, choices, false));
+  }
 
   QStringList linkedProps;
-  linkedProps << "CellFeatureAttributeMatrixPath"
-              << "FeatureIdsArrayPath";
+  linkedProps << "CellFeatureAttributeMatrixPath";
   parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Renumber Features", RenumberFeatures, FilterParameter::Parameter, ChangeResolution, linkedProps));
   linkedProps.clear();
   linkedProps << "NewDataContainerName";
@@ -118,6 +444,7 @@ void ChangeResolution::readFilterParameters(AbstractFilterParametersReader* read
   setCellFeatureAttributeMatrixPath(reader->readDataArrayPath("CellFeatureAttributeMatrixPath", getCellFeatureAttributeMatrixPath()));
   setFeatureIdsArrayPath(reader->readDataArrayPath("FeatureIdsArrayPath", getFeatureIdsArrayPath()));
   setSpacing(reader->readFloatVec3("Spacing", getSpacing()));
+  setResamplingMode(reader->readValue("ResamplingMode", getResamplingMode()));
   setRenumberFeatures(reader->readValue("RenumberFeatures", getRenumberFeatures()));
   setSaveAsNewDataContainer(reader->readValue("SaveAsNewDataContainer", getSaveAsNewDataContainer()));
   reader->closeFilterGroup();
@@ -168,7 +495,8 @@ void ChangeResolution::dataCheck()
 
   getDataContainerArray()->getPrereqAttributeMatrixFromPath(this, getCellAttributeMatrixPath(), -301);
 
-  if(getRenumberFeatures())
+  // The majority vote is taken on the Feature Ids, so they are needed for renumbering and for that mode
+  if(getRenumberFeatures() || getResamplingMode() == 1)
   {
     std::vector<size_t> cDims(1, 1);
     m_FeatureIdsPtr = getDataContainerArray()->getPrereqArrayFromPath<DataArray<int32_t>>(this, getFeatureIdsArrayPath(), cDims);
@@ -314,42 +642,12 @@ void ChangeResolution::execute()
   }
   size_t totalPoints = m_XP * m_YP * m_ZP;
 
-  float x = 0.0f, y = 0.0f, z = 0.0f;
-  size_t col = 0, row = 0, plane = 0;
-  size_t index = 0;
-  size_t index_old = 0;
-  size_t progressInt = 0;
-  std::vector<size_t> newindicies(totalPoints);
   FloatVec3Type res = m->getGeometryAs<ImageGeom>()->getSpacing();
 
-  for(size_t i = 0; i < m_ZP; i++)
-  {
-    if(getCancel())
-    {
-      break;
-    }
-    progressInt = static_cast<size_t>((static_cast<float>(i) / m_ZP) * 100.0f);
-    QString ss = QObject::tr("Changing Spacing || %1% Complete").arg(progressInt);
-    notifyStatusMessage(ss);
-    for(size_t j = 0; j < m_YP; j++)
-    {
-      for(size_t k = 0; k < m_XP; k++)
-      {
-        x = (k * m_Spacing[0]);
-        y = (j * m_Spacing[1]);
-        z = (i * m_Spacing[2]);
-        col = size_t(x / res[0]);
-        row = size_t(y / res[1]);
-        plane = size_t(z / res[2]);
-        index_old = (plane * dims[1] * dims[0]) + (row * dims[0]) + col;
-        index = (i * m_XP * m_YP) + (j * m_XP) + k;
-        newindicies[index] = index_old;
-      }
-    }
-  }
-
-  QString ss = QObject::tr("Copying Data...");
-  notifyStatusMessage(ss);
+  // The new grid is separable, so every new cell is located through one small lookup table per axis
+  AxisSampling xAxis = createAxisSampling(m_XP, dims[0], m_Spacing[0], res[0]);
+  AxisSampling yAxis = createAxisSampling(m_YP, dims[1], m_Spacing[1], res[1]);
+  AxisSampling zAxis = createAxisSampling(m_ZP, dims[2], m_Spacing[2], res[2]);
 
   std::vector<size_t> tDims(3, 0);
   tDims[0] = m_XP;
@@ -357,29 +655,86 @@ void ChangeResolution::execute()
   tDims[2] = m_ZP;
   AttributeMatrix::Pointer newCellAttrMat = AttributeMatrix::New(tDims, cellAttrMat->getName(), cellAttrMat->getType());
 
+  // In the majority vote mode one old cell is picked for every new cell from the Feature Ids, and every array
+  // that is not interpolated is copied from that cell so the labels of a new cell stay consistent
+  Int32ArrayType::Pointer featureIds;
+  std::vector<CopyTarget> majorityTargets;
+  if(m_ResamplingMode == 1)
+  {
+    featureIds = std::dynamic_pointer_cast<Int32ArrayType>(cellAttrMat->getAttributeArray(getFeatureIdsArrayPath().getDataArrayName()));
+    if(nullptr == featureIds.get())
+    {
+      QString ss = QObject::tr("The Feature Ids array '%1' could not be found in the Cell Attribute Matrix").arg(getFeatureIdsArrayPath().serialize("/"));
+      setErrorCondition(-5558, ss);
+      return;
+    }
+  }
+
   QList<QString> voxelArrayNames = cellAttrMat->getAttributeArrayNames();
+  int32_t arrayIndex = 0;
   for(QList<QString>::iterator iter = voxelArrayNames.begin(); iter != voxelArrayNames.end(); ++iter)
   {
+    if(getCancel())
+    {
+      return;
+    }
+    arrayIndex++;
+    QString ss = QObject::tr("Copying Data || Array %1 of %2").arg(arrayIndex).arg(voxelArrayNames.size());
+    notifyStatusMessage(ss);
+
     IDataArray::Pointer p = cellAttrMat->getAttributeArray(*iter);
     // Make a copy of the 'p' array that has the same name. When placed into
     // the data container this will over write the current array with
     // the same name. At least in theory.
-    IDataArray::Pointer data = p->createNewArray(p->getNumberOfTuples(), p->getComponentDimensions(), p->getName());
-    data->resizeTuples(totalPoints);
-    void* source = nullptr;
-    void* destination = nullptr;
-    size_t newIndicies_I = 0;
-    int32_t nComp = data->getNumberOfComponents();
-    for(size_t i = 0; i < static_cast<size_t>(totalPoints); i++)
+    IDataArray::Pointer data = p->createNewArray(totalPoints, p->getComponentDimensions(), p->getName(), true);
+
+    // Single component floating point arrays are treated as scalars and interpolated, all other arrays are
+    // copied from the cell that won the majority vote in one pass over the new grid once every array is allocated.
+    // Their old arrays are kept until then, the Feature Ids among them.
+    SamplingKind kind = SamplingKind::Nearest;
+    if(m_ResamplingMode == 1)
     {
-      newIndicies_I = newindicies[i];
-      source = p->getVoidPointer((nComp * newIndicies_I));
-      destination = data->getVoidPointer((data->getNumberOfComponents() * i));
-      ::memcpy(destination, source, p->getTypeSize() * data->getNumberOfComponents());
+      if(p->getNumberOfComponents() == 1 && nullptr != std::dynamic_pointer_cast<FloatArrayType>(p))
+      {
+        kind = SamplingKind::LinearFloat;
+      }
+      else if(p->getNumberOfComponents() == 1 && nullptr != std::dynamic_pointer_cast<DoubleArrayType>(p))
+      {
+        kind = SamplingKind::LinearDouble;
+      }
+      else
+      {
+        majorityTargets.push_back({static_cast<const uint8_t*>(p->getVoidPointer(0)), static_cast<uint8_t*>(data->getVoidPointer(0)), p->getTypeSize() * p->getNumberOfComponents()});
+        newCellAttrMat->insertOrAssign(data);
+        continue;
+      }
     }
+
+    ChangeResolutionImpl impl(xAxis, yAxis, zAxis, dims, m_XP, m_YP, kind, p, data);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_YP * m_ZP), impl, tbb::auto_partitioner());
+#else
+    impl.convert(0, m_YP * m_ZP);
+#endif
+
     cellAttrMat->removeAttributeArray(*iter);
     newCellAttrMat->insertOrAssign(data);
   }
+
+  if(!majorityTargets.empty())
+  {
+    if(getCancel())
+    {
+      return;
+    }
+    notifyStatusMessage(QObject::tr("Copying Data From The Majority Cells || %1 Arrays").arg(majorityTargets.size()));
+    CopyMajorityCellsImpl majorityImpl(xAxis, yAxis, zAxis, dims, m_XP, m_YP, featureIds->getPointer(0), majorityTargets);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_YP * m_ZP), majorityImpl, tbb::auto_partitioner());
+#else
+    majorityImpl.convert(0, m_YP * m_ZP);
+#endif
+  }
   m->getGeometryAs<ImageGeom>()->setSpacing(std::make_tuple(m_Spacing[0], m_Spacing[1], m_Spacing[2]));
   m->getGeometryAs<ImageGeom>()->setDimensions(std::make_tuple(m_XP, m_YP, m_ZP));
   m->removeAttributeMatrix(getCellAttributeMatrixPath().getAttributeMatrixName());
@@ -560,6 +915,18 @@ FloatVec3Type ChangeResolution::getSpacing() const
   return m_Spacing;
 }
 
+// -----------------------------------------------------------------------------
+void ChangeResolution::setResamplingMode(int32_t value)
+{
+  m_ResamplingMode = value;
+}
+
+// -----------------------------------------------------------------------------
+int32_t ChangeResolution::getResamplingMode() const
+{
+  return m_ResamplingMode;
+}
+
 // -----------------------------------------------------------------------------
 void ChangeResolution::setRenumberFeatures(bool value)
 {
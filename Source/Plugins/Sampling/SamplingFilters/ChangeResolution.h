@@ -63,6 +63,7 @@ class Sampling_EXPORT ChangeResolution : public AbstractFilter
   PYB11_PROPERTY(bool RenumberFeatures READ getRenumberFeatures WRITE setRenumberFeatures)
   PYB11_PROPERTY(bool SaveAsNewDataContainer READ getSaveAsNewDataContainer WRITE setSaveAsNewDataContainer)
   PYB11_PROPERTY(DataArrayPath FeatureIdsArrayPath READ getFeatureIdsArrayPath WRITE setFeatureIdsArrayPath)
+  PYB11_PROPERTY(int32_t ResamplingMode READ getResamplingMode WRITE setResamplingMode)
   PYB11_END_BINDINGS()
   // End Python bindings declarations
 
@@ -140,6 +141,17 @@ public:
   FloatVec3Type getSpacing() const;
   Q_PROPERTY(FloatVec3Type Spacing READ getSpacing WRITE setSpacing)
 
+  /**
+   * @brief Setter property for ResamplingMode
+   */
+  void setResamplingMode(int32_t value);
+  /**
+   * @brief Getter property for ResamplingMode
+   * @return Value of ResamplingMode
+   */
+  int32_t getResamplingMode() const;
+  Q_PROPERTY(int32_t ResamplingMode READ getResamplingMode WRITE setResamplingMode)
+
   /**
    * @brief Setter property for RenumberFeatures
    */
@@ -254,6 +266,7 @@ private:
   DataArrayPath m_CellAttributeMatrixPath = {};
   DataArrayPath m_CellFeatureAttributeMatrixPath = {};
   FloatVec3Type m_Spacing = {};
+  int32_t m_ResamplingMode = {};
   bool m_RenumberFeatures = {};
   bool m_SaveAsNewDataContainer = {};
   DataArrayPath m_FeatureIdsArrayPath = {};
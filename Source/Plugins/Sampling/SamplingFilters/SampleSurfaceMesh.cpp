@@ -34,10 +34,12 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "SampleSurfaceMesh.h"
 
-#include <mutex>
-#include <thread>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
 
-#include <QtCore/QDateTime>
 #include <QtCore/QTextStream>
 
 #include "SIMPLib/Common/Constants.h"
@@ -51,7 +53,6 @@
 #include "SIMPLib/Geometry/VertexGeom.h"
 #include "SIMPLib/Math/GeometryMath.h"
 #include "SIMPLib/Math/SIMPLibRandom.h"
-#include "SIMPLib/Utilities/TimeUtilities.h"
 
 #include "Sampling/SamplingConstants.h"
 #include "Sampling/SamplingVersion.h"
@@ -63,77 +64,208 @@
 #include <tbb/tbb_machine.h>
 #endif
 
-class SampleSurfaceMeshImplByPoints
+namespace
 {
-  SampleSurfaceMesh* m_Filter = nullptr;
-  TriangleGeom::Pointer m_Faces;
-  Int32Int32DynamicListArray::Pointer m_FaceIds;
-  VertexGeom::Pointer m_FaceBBs;
-  VertexGeom::Pointer m_Points;
-  size_t m_FeatureId = 0;
-  int32_t* m_PolyIds = nullptr;
+// Upper bound on the number of bins along any axis of the Feature bin grid
+constexpr size_t k_MaxBinsPerDim = 1024;
 
-public:
-  SampleSurfaceMeshImplByPoints(SampleSurfaceMesh* filter, TriangleGeom::Pointer faces, Int32Int32DynamicListArray::Pointer faceIds, VertexGeom::Pointer faceBBs, VertexGeom::Pointer points,
-                                size_t featureId, int32_t* polyIds)
-  : m_Filter(filter)
-  , m_Faces(faces)
-  , m_FaceIds(faceIds)
-  , m_FaceBBs(faceBBs)
-  , m_Points(points)
-  , m_FeatureId(featureId)
-  , m_PolyIds(polyIds)
+/**
+ * @brief The FeatureBinGrid struct is a uniform grid laid over the union of the Feature bounding boxes. Each bin
+ * lists, in increasing order, the Features whose bounding box overlaps that bin, so a sampling point only needs to
+ * be tested against the Features listed in the bin it falls in.
+ */
+struct FeatureBinGrid
+{
+  std::array<float, 3> lowerLeft = {0.0F, 0.0F, 0.0F};
+  std::array<float, 3> upperRight = {0.0F, 0.0F, 0.0F};
+  std::array<float, 3> inverseBinWidth = {0.0F, 0.0F, 0.0F};
+  std::array<size_t, 3> dims = {1, 1, 1};
+  std::vector<size_t> binOffsets;
+  std::vector<int32_t> binFeatures;
+
+  /**
+   * @brief Returns the bin coordinate of x along axis d. The mapping is monotonic, so a point inside a bounding box
+   * always maps to a bin inside the bin range of that box.
+   */
+  size_t binCoord(float x, size_t d) const
   {
+    float c = (x - lowerLeft[d]) * inverseBinWidth[d];
+    if(c <= 0.0F)
+    {
+      return 0;
+    }
+    return std::min(static_cast<size_t>(c), dims[d] - 1);
   }
-  virtual ~SampleSurfaceMeshImplByPoints() = default;
 
-  void checkPoints(size_t start, size_t end) const
+  bool contains(const float* p) const
   {
-    float radius = 0.0f;
-    float distToBoundary = 0.0f;
-    int64_t numPoints = m_Points->getNumberOfVertices();
-    std::array<float, 3> lowerLeft = {0.0F, 0.0F, 0.0F};
-    std::array<float, 3> upperRight = {0.0F, 0.0F, 0.0F};
-    float* point = nullptr;
-    char code = ' ';
+    return lowerLeft[0] <= p[0] && p[0] <= upperRight[0] && lowerLeft[1] <= p[1] && p[1] <= upperRight[1] && lowerLeft[2] <= p[2] && p[2] <= upperRight[2];
+  }
 
-    size_t iter = m_FeatureId;
+  size_t binIndex(const float* p) const
+  {
+    return (binCoord(p[2], 2) * dims[1] + binCoord(p[1], 1)) * dims[0] + binCoord(p[0], 0);
+  }
+};
 
-    // find bounding box for current feature
-    GeometryMath::FindBoundingBoxOfFaces(m_Faces.get(), m_FaceIds->getElementList(iter), lowerLeft.data(), upperRight.data());
-    GeometryMath::FindDistanceBetweenPoints(lowerLeft.data(), upperRight.data(), radius);
-    int64_t pointsVisited = 0;
-    // check points in vertex array to see if they are in the bounding box of the feature
-    for(int64_t i = static_cast<int64_t>(start); i < static_cast<int64_t>(end); i++)
+/**
+ * @brief buildFeatureBinGrid Sizes the bin grid so that there are roughly as many bins as Features and then
+ * registers every Feature that owns Triangles in each bin its bounding box overlaps
+ * @param lowerLeft Lower left corners of the Feature bounding boxes (3 per Feature)
+ * @param upperRight Upper right corners of the Feature bounding boxes (3 per Feature)
+ * @param hasFaces Flags the Features that own at least one Triangle
+ * @param grid Bin grid to fill
+ */
+void buildFeatureBinGrid(const std::vector<float>& lowerLeft, const std::vector<float>& upperRight, const std::vector<uint8_t>& hasFaces, FeatureBinGrid& grid)
+{
+  size_t numFeatures = hasFaces.size();
+  size_t numActive = 0;
+  grid.lowerLeft.fill(std::numeric_limits<float>::max());
+  grid.upperRight.fill(std::numeric_limits<float>::lowest());
+  for(size_t feature = 0; feature < numFeatures; feature++)
+  {
+    if(hasFaces[feature] == 0)
     {
-      point = m_Points->getVertexPointer(i);
-      if(m_PolyIds[i] == 0 && GeometryMath::PointInBox(point, lowerLeft.data(), upperRight.data()))
+      continue;
+    }
+    numActive++;
+    for(size_t d = 0; d < 3; d++)
+    {
+      grid.lowerLeft[d] = std::min(grid.lowerLeft[d], lowerLeft[3 * feature + d]);
+      grid.upperRight[d] = std::max(grid.upperRight[d], upperRight[3 * feature + d]);
+    }
+  }
+  grid.dims = {1, 1, 1};
+  grid.inverseBinWidth = {0.0F, 0.0F, 0.0F};
+  grid.binOffsets.assign(2, 0);
+  grid.binFeatures.clear();
+  if(numActive == 0)
+  {
+    return;
+  }
+
+  // Pick a cubic bin size from the extents that are not flat
+  double volume = 1.0;
+  int32_t numExtents = 0;
+  for(size_t d = 0; d < 3; d++)
+  {
+    double extent = static_cast<double>(grid.upperRight[d]) - static_cast<double>(grid.lowerLeft[d]);
+    if(extent > 0.0)
+    {
+      volume *= extent;
+      numExtents++;
+    }
+  }
+  double binSize = numExtents > 0 ? std::pow(volume / static_cast<double>(numActive), 1.0 / numExtents) : 0.0;
+  for(size_t d = 0; d < 3; d++)
+  {
+    double extent = static_cast<double>(grid.upperRight[d]) - static_cast<double>(grid.lowerLeft[d]);
+    if(extent > 0.0 && binSize > 0.0)
+    {
+      double numBins = std::min(std::max(std::ceil(extent / binSize), 1.0), static_cast<double>(k_MaxBinsPerDim));
+      grid.dims[d] = static_cast<size_t>(numBins);
+      grid.inverseBinWidth[d] = static_cast<float>(numBins / extent);
+    }
+  }
+
+  size_t numBins = grid.dims[0] * grid.dims[1] * grid.dims[2];
+  std::vector<std::array<size_t, 6>> binRanges(numFeatures);
+  grid.binOffsets.assign(numBins + 1, 0);
+  for(size_t feature = 0; feature < numFeatures; feature++)
+  {
+    if(hasFaces[feature] == 0)
+    {
+      continue;
+    }
+    std::array<size_t, 6>& range = binRanges[feature];
+    for(size_t d = 0; d < 3; d++)
+    {
+      range[d] = grid.binCoord(lowerLeft[3 * feature + d], d);
+      range[d + 3] = grid.binCoord(upperRight[3 * feature + d], d);
+    }
+    for(size_t z = range[2]; z <= range[5]; z++)
+    {
+      for(size_t y = range[1]; y <= range[4]; y++)
       {
-        code = GeometryMath::PointInPolyhedron(m_Faces.get(), m_FaceIds->getElementList(iter), m_FaceBBs.get(), point, lowerLeft.data(), upperRight.data(), radius, distToBoundary);
-        if(code == 'i' || code == 'V' || code == 'E' || code == 'F')
+        for(size_t x = range[0]; x <= range[3]; x++)
         {
-          m_PolyIds[i] = iter;
+          grid.binOffsets[(z * grid.dims[1] + y) * grid.dims[0] + x + 1]++;
         }
       }
-      pointsVisited++;
+    }
+  }
+  for(size_t bin = 0; bin < numBins; bin++)
+  {
+    grid.binOffsets[bin + 1] += grid.binOffsets[bin];
+  }
 
-      // Send some feedback
-      if(pointsVisited % 1000 == 0)
+  // Features are appended in increasing order, so every bin list is sorted
+  grid.binFeatures.resize(grid.binOffsets[numBins]);
+  std::vector<size_t> binFill(grid.binOffsets.begin(), grid.binOffsets.end() - 1);
+  for(size_t feature = 0; feature < numFeatures; feature++)
+  {
+    if(hasFaces[feature] == 0)
+    {
+      continue;
+    }
+    const std::array<size_t, 6>& range = binRanges[feature];
+    for(size_t z = range[2]; z <= range[5]; z++)
+    {
+      for(size_t y = range[1]; y <= range[4]; y++)
       {
-        m_Filter->sendThreadSafeProgressMessage(m_FeatureId, 1000, numPoints);
+        for(size_t x = range[0]; x <= range[3]; x++)
+        {
+          grid.binFeatures[binFill[(z * grid.dims[1] + y) * grid.dims[0] + x]++] = static_cast<int32_t>(feature);
+        }
       }
-      // Check for the filter being cancelled.
-      if(m_Filter->getCancel())
+    }
+  }
+}
+} // namespace
+
+/**
+ * @brief The SampleSurfaceMeshFeatureBoundsImpl class computes the bounding box and bounding radius of each Feature.
+ */
+class SampleSurfaceMeshFeatureBoundsImpl
+{
+  TriangleGeom::Pointer m_Faces;
+  Int32Int32DynamicListArray::Pointer m_FaceIds;
+  std::vector<float>& m_LowerLeft;
+  std::vector<float>& m_UpperRight;
+  std::vector<float>& m_Radius;
+  std::vector<uint8_t>& m_HasFaces;
+
+public:
+  SampleSurfaceMeshFeatureBoundsImpl(TriangleGeom::Pointer faces, Int32Int32DynamicListArray::Pointer faceIds, std::vector<float>& lowerLeft, std::vector<float>& upperRight,
+                                     std::vector<float>& radius, std::vector<uint8_t>& hasFaces)
+  : m_Faces(faces)
+  , m_FaceIds(faceIds)
+  , m_LowerLeft(lowerLeft)
+  , m_UpperRight(upperRight)
+  , m_Radius(radius)
+  , m_HasFaces(hasFaces)
+  {
+  }
+  virtual ~SampleSurfaceMeshFeatureBoundsImpl() = default;
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t iter = start; iter < end; iter++)
+    {
+      m_HasFaces[iter] = (m_FaceIds->getNumberOfElements(iter) > 0) ? 1 : 0;
+      if(m_HasFaces[iter] == 0)
       {
-        return;
+        continue;
       }
+      GeometryMath::FindBoundingBoxOfFaces(m_Faces.get(), m_FaceIds->getElementList(iter), m_LowerLeft.data() + 3 * iter, m_UpperRight.data() + 3 * iter);
+      GeometryMath::FindDistanceBetweenPoints(m_LowerLeft.data() + 3 * iter, m_UpperRight.data() + 3 * iter, m_Radius[iter]);
     }
   }
 
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
   void operator()(const tbb::blocked_range<size_t>& r) const
   {
-    checkPoints(r.begin(), r.end());
+    convert(r.begin(), r.end());
   }
 #endif
 private:
@@ -141,23 +273,32 @@ private:
 
 /**
  * @brief The SampleSurfaceMeshImpl class implements a threaded algorithm that samples a surface mesh based on points passed from subclassed Filters.
+ * Each point is only tested against the Features listed in its bin of the FeatureBinGrid and is assigned to the
+ * lowest numbered Feature it falls in.
  */
 class SampleSurfaceMeshImpl
 {
-  SampleSurfaceMesh* m_Filter = nullptr;
   TriangleGeom::Pointer m_Faces;
   Int32Int32DynamicListArray::Pointer m_FaceIds;
   VertexGeom::Pointer m_FaceBBs;
   VertexGeom::Pointer m_Points;
+  const FeatureBinGrid& m_BinGrid;
+  const std::vector<float>& m_LowerLeft;
+  const std::vector<float>& m_UpperRight;
+  const std::vector<float>& m_Radius;
   int32_t* m_PolyIds = nullptr;
 
 public:
-  SampleSurfaceMeshImpl(SampleSurfaceMesh* filter, TriangleGeom::Pointer faces, Int32Int32DynamicListArray::Pointer faceIds, VertexGeom::Pointer faceBBs, VertexGeom::Pointer points, int32_t* polyIds)
-  : m_Filter(filter)
-  , m_Faces(faces)
+  SampleSurfaceMeshImpl(TriangleGeom::Pointer faces, Int32Int32DynamicListArray::Pointer faceIds, VertexGeom::Pointer faceBBs, VertexGeom::Pointer points, const FeatureBinGrid& binGrid,
+                        const std::vector<float>& lowerLeft, const std::vector<float>& upperRight, const std::vector<float>& radius, int32_t* polyIds)
+  : m_Faces(faces)
   , m_FaceIds(faceIds)
   , m_FaceBBs(faceBBs)
   , m_Points(points)
+  , m_BinGrid(binGrid)
+  , m_LowerLeft(lowerLeft)
+  , m_UpperRight(upperRight)
+  , m_Radius(radius)
   , m_PolyIds(polyIds)
   {
   }
@@ -165,37 +306,36 @@ public:
 
   void checkPoints(size_t start, size_t end) const
   {
-    float radius = 0.0f;
     float distToBoundary = 0.0f;
-    int64_t numPoints = m_Points->getNumberOfVertices();
     std::array<float, 3> lowerLeft = {0.0F, 0.0F, 0.0F};
     std::array<float, 3> upperRight = {0.0F, 0.0F, 0.0F};
     float* point = nullptr;
     char code = ' ';
 
-    for(size_t iter = start; iter < end; iter++)
+    for(size_t i = start; i < end; i++)
     {
-      // find bounding box for current feature
-      GeometryMath::FindBoundingBoxOfFaces(m_Faces.get(), m_FaceIds->getElementList(iter), lowerLeft.data(), upperRight.data());
-      GeometryMath::FindDistanceBetweenPoints(lowerLeft.data(), upperRight.data(), radius);
+      point = m_Points->getVertexPointer(i);
+      if(!m_BinGrid.contains(point))
+      {
+        continue;
+      }
 
-      // check points in vertex array to see if they are in the bounding box of the feature
-      for(int64_t i = 0; i < numPoints; i++)
+      // check the point against the bounding boxes of the features registered in its bin
+      size_t bin = m_BinGrid.binIndex(point);
+      for(size_t n = m_BinGrid.binOffsets[bin]; n < m_BinGrid.binOffsets[bin + 1]; n++)
       {
-        // Check for the filter being cancelled.
-        if(m_Filter->getCancel())
+        int32_t iter = m_BinGrid.binFeatures[n];
+        std::copy_n(m_LowerLeft.begin() + 3 * iter, 3, lowerLeft.begin());
+        std::copy_n(m_UpperRight.begin() + 3 * iter, 3, upperRight.begin());
+        if(!GeometryMath::PointInBox(point, lowerLeft.data(), upperRight.data()))
         {
-          return;
+          continue;
         }
-
-        point = m_Points->getVertexPointer(i);
-        if(m_PolyIds[i] == 0 && GeometryMath::PointInBox(point, lowerLeft.data(), upperRight.data()))
+        code = GeometryMath::PointInPolyhedron(m_Faces.get(), m_FaceIds->getElementList(iter), m_FaceBBs.get(), point, lowerLeft.data(), upperRight.data(), m_Radius[iter], distToBoundary);
+        if(code == 'i' || code == 'V' || code == 'E' || code == 'F')
         {
-          code = GeometryMath::PointInPolyhedron(m_Faces.get(), m_FaceIds->getElementList(iter), m_FaceBBs.get(), point, lowerLeft.data(), upperRight.data(), radius, distToBoundary);
-          if(code == 'i' || code == 'V' || code == 'E' || code == 'F')
-          {
-            m_PolyIds[i] = iter;
-          }
+          m_PolyIds[i] = iter;
+          break;
         }
       }
     }
@@ -435,65 +575,57 @@ void SampleSurfaceMesh::execute()
   iArray->initializeWithZeros();
   int32_t* polyIds = iArray->getPointer(0);
 
-  notifyStatusMessage("Sampling triangle geometry ...");
+  notifyStatusMessage("Binning feature bounding boxes ...");
 
-  // C++11 RIGHT HERE....
-  int32_t nthreads = static_cast<int32_t>(std::thread::hardware_concurrency()); // Returns ZERO if not defined on this platform
-  // If the number of features is larger than the number of cores to do the work then parallelize over the number of features
-  // otherwise parallelize over the number of triangle points.
-  if(numFeatures > nthreads)
-  {
+  // find the bounding box of every feature and register the boxes in a bin grid so that each
+  // sampling point is only tested against the features whose boxes overlap its bin
+  std::vector<float> featureLowerLeft(3 * numFeatures, 0.0f);
+  std::vector<float> featureUpperRight(3 * numFeatures, 0.0f);
+  std::vector<float> featureRadius(numFeatures, 0.0f);
+  std::vector<uint8_t> hasFaces(numFeatures, 0);
+  SampleSurfaceMeshFeatureBoundsImpl boundsImpl(triangleGeom, faceLists, featureLowerLeft, featureUpperRight, featureRadius, hasFaces);
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, numFeatures), SampleSurfaceMeshImpl(this, triangleGeom, faceLists, faceBBs, points, polyIds), tbb::auto_partitioner());
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, numFeatures), boundsImpl, tbb::auto_partitioner());
 #else
-    SampleSurfaceMeshImpl serial(this, triangleGeom, faceLists, faceBBs, points, polyIds);
-    serial.checkPoints(0, numFeatures);
+  boundsImpl.convert(0, numFeatures);
 #endif
-  }
-  else
+
+  FeatureBinGrid binGrid;
+  buildFeatureBinGrid(featureLowerLeft, featureUpperRight, hasFaces, binGrid);
+
+  // Check for user canceled flag.
+  if(getCancel())
   {
-    for(int featureId = 0; featureId < numFeatures; featureId++)
-    {
-      m_NumCompleted = 0;
-      m_StartMillis = QDateTime::currentMSecsSinceEpoch();
-      m_Millis = m_StartMillis;
-      size_t numPoints = points->getNumberOfVertices();
+    return;
+  }
 
-#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-      tbb::parallel_for(tbb::blocked_range<size_t>(0, numPoints), SampleSurfaceMeshImplByPoints(this, triangleGeom, faceLists, faceBBs, points, featureId, polyIds), tbb::auto_partitioner());
+  notifyStatusMessage("Sampling triangle geometry ...");
 
+  // sample the points in blocks so progress and cancellation are handled between blocks
+  size_t totalPoints = static_cast<size_t>(numPoints);
+  size_t blockSize = std::max<size_t>(1, totalPoints / 100);
+  SampleSurfaceMeshImpl sampleImpl(triangleGeom, faceLists, faceBBs, points, binGrid, featureLowerLeft, featureUpperRight, featureRadius, polyIds);
+  for(size_t blockStart = 0; blockStart < totalPoints; blockStart += blockSize)
+  {
+    size_t blockEnd = std::min(totalPoints, blockStart + blockSize);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    tbb::parallel_for(tbb::blocked_range<size_t>(blockStart, blockEnd), sampleImpl, tbb::auto_partitioner());
 #else
-      SampleSurfaceMeshImplByPoints serial(this, triangleGeom, faceLists, faceBBs, points, featureId, polyIds);
-      serial.checkPoints(0, numPoints);
+    sampleImpl.checkPoints(blockStart, blockEnd);
 #endif
+
+    // Check for user canceled flag.
+    if(getCancel())
+    {
+      return;
     }
+    notifyStatusMessage(QObject::tr("Sampling triangle geometry || Points Completed: %1 of %2").arg(blockEnd).arg(totalPoints));
   }
   assign_points(iArray);
 
   notifyStatusMessage("Complete");
 }
 
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-void SampleSurfaceMesh::sendThreadSafeProgressMessage(int featureId, size_t numCompleted, size_t totalFeatures)
-{
-  static std::mutex mutex;
-  std::lock_guard<std::mutex> lock(mutex);
-  qint64 currentMillis = QDateTime::currentMSecsSinceEpoch();
-  m_NumCompleted = m_NumCompleted + numCompleted;
-  if(currentMillis - m_Millis > 1000)
-  {
-    float inverseRate = static_cast<float>(currentMillis - m_Millis) / static_cast<float>(m_NumCompleted - m_LastCompletedPoints);
-    qint64 remainMillis = inverseRate * (totalFeatures - m_NumCompleted);
-    QString ss = QObject::tr("Feature %3 | Points Completed: %1 of %2").arg(m_NumCompleted).arg(totalFeatures).arg(featureId);
-    ss = ss + QObject::tr(" || Est. Time Remain: %1").arg(DREAM3D::convertMillisToHrsMinSecs(remainMillis));
-    notifyStatusMessage(ss);
-    m_Millis = QDateTime::currentMSecsSinceEpoch();
-    m_LastCompletedPoints = m_NumCompleted;
-  }
-}
-
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
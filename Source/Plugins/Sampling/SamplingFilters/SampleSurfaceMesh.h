@@ -161,13 +161,6 @@ public:
    */
   void execute() override;
 
-  /**
-   * @brief sendThreadSafeProgressMessage
-   * @param counter
-   * @param max
-   */
-  void sendThreadSafeProgressMessage(int featureId, size_t numCompleted, size_t totalFeatures);
-
 protected:
   SampleSurfaceMesh();
   /**
@@ -199,11 +192,6 @@ private:
 
   DataArrayPath m_SurfaceMeshFaceLabelsArrayPath = {};
 
-  size_t m_NumCompleted = 0;
-  qint64 m_StartMillis = 0;
-  qint64 m_Millis = 0;
-  int64_t m_LastCompletedPoints = 0;
-
 public:
   SampleSurfaceMesh(const SampleSurfaceMesh&) = delete;            // Copy Constructor Not Implemented
   SampleSurfaceMesh(SampleSurfaceMesh&&) = delete;                 // Move Constructor Not Implemented
@@ -0,0 +1,309 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <QtCore/QDebug>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterFactory.hpp"
+#include "SIMPLib/Filtering/FilterManager.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#include "UnitTestSupport.hpp"
+
+#include "SamplingTestFileLocations.h"
+
+namespace ChangeResolutionTestArrays
+{
+const QString k_FeatureIdsName("FeatureIds");
+const QString k_PhasesName("Phases");
+const QString k_ScalarName("Scalar");
+const QString k_EulersName("Eulers");
+} // namespace ChangeResolutionTestArrays
+
+class ChangeResolutionTest
+{
+
+public:
+  ChangeResolutionTest() = default;
+  ~ChangeResolutionTest() = default;
+
+  /**
+   * @brief Returns the name of the class for ChangeResolutionTest
+   */
+  QString getNameOfClass() const
+  {
+    return QString("ChangeResolutionTest");
+  }
+
+  /**
+   * @brief Returns the name of the class for ChangeResolutionTest
+   */
+  QString ClassName()
+  {
+    return QString("ChangeResolutionTest");
+  }
+
+  ChangeResolutionTest(const ChangeResolutionTest&) = delete;            // Copy Constructor Not Implemented
+  ChangeResolutionTest(ChangeResolutionTest&&) = delete;                 // Move Constructor Not Implemented
+  ChangeResolutionTest& operator=(const ChangeResolutionTest&) = delete; // Copy Assignment Not Implemented
+  ChangeResolutionTest& operator=(ChangeResolutionTest&&) = delete;      // Move Assignment Not Implemented
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestFilterAvailability()
+  {
+    // Now instantiate the ChangeResolution Filter from the FilterManager
+    QString filtName = "ChangeResolution";
+    FilterManager* fm = FilterManager::Instance();
+    IFilterFactory::Pointer filterFactory = fm->getFactoryFromClassName(filtName);
+    if(nullptr == filterFactory.get())
+    {
+      std::stringstream ss;
+      ss << "The ChangeResolutionTest Requires the use of the " << filtName.toStdString() << " filter which is found in the Sampling Plugin";
+      DREAM3D_TEST_THROW_EXCEPTION(ss.str())
+    }
+    return 0;
+  }
+
+  // -----------------------------------------------------------------------------
+  // Builds an image with unit spacing. Phases holds 10 times the cell index and Eulers holds the cell index
+  // in all three components, so the old cell that a new cell was copied from can be read back from them.
+  // Scalar is x + 10 * y + 100 * z, which trilinear interpolation reproduces exactly.
+  // -----------------------------------------------------------------------------
+  DataContainerArray::Pointer createVolume(const std::vector<size_t>& tDims, const std::vector<int32_t>& featureIds)
+  {
+    DataContainerArray::Pointer dca = DataContainerArray::New();
+    DataContainer::Pointer dc = DataContainer::New(SIMPL::Defaults::ImageDataContainerName);
+    ImageGeom::Pointer image = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+    image->setDimensions(SizeVec3Type(tDims[0], tDims[1], tDims[2]));
+    image->setSpacing(FloatVec3Type(1.0f, 1.0f, 1.0f));
+    image->setOrigin(FloatVec3Type(0.0f, 0.0f, 0.0f));
+    dc->setGeometry(image);
+
+    AttributeMatrix::Pointer cellAttrMat = AttributeMatrix::New(tDims, SIMPL::Defaults::CellAttributeMatrixName, AttributeMatrix::Type::Cell);
+    std::vector<size_t> cDims(1, 1);
+    Int32ArrayType::Pointer ids = Int32ArrayType::CreateArray(tDims, cDims, ChangeResolutionTestArrays::k_FeatureIdsName, true);
+    Int32ArrayType::Pointer phases = Int32ArrayType::CreateArray(tDims, cDims, ChangeResolutionTestArrays::k_PhasesName, true);
+    FloatArrayType::Pointer scalar = FloatArrayType::CreateArray(tDims, cDims, ChangeResolutionTestArrays::k_ScalarName, true);
+    cDims[0] = 3;
+    FloatArrayType::Pointer eulers = FloatArrayType::CreateArray(tDims, cDims, ChangeResolutionTestArrays::k_EulersName, true);
+
+    size_t index = 0;
+    for(size_t z = 0; z < tDims[2]; z++)
+    {
+      for(size_t y = 0; y < tDims[1]; y++)
+      {
+        for(size_t x = 0; x < tDims[0]; x++)
+        {
+          ids->setValue(index, featureIds[index]);
+          phases->setValue(index, static_cast<int32_t>(10 * index));
+          scalar->setValue(index, static_cast<float>(x + 10 * y + 100 * z));
+          for(int32_t c = 0; c < 3; c++)
+          {
+            eulers->setComponent(index, c, static_cast<float>(index));
+          }
+          index++;
+        }
+      }
+    }
+    cellAttrMat->insertOrAssign(ids);
+    cellAttrMat->insertOrAssign(phases);
+    cellAttrMat->insertOrAssign(scalar);
+    cellAttrMat->insertOrAssign(eulers);
+    dc->addOrReplaceAttributeMatrix(cellAttrMat);
+    dca->addOrReplaceDataContainer(dc);
+    return dca;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int RunChangeResolution(const DataContainerArray::Pointer& dca, const FloatVec3Type& spacing, int32_t resamplingMode)
+  {
+    QString filtName = "ChangeResolution";
+    FilterManager* fm = FilterManager::Instance();
+    IFilterFactory::Pointer factory = fm->getFactoryFromClassName(filtName);
+    DREAM3D_REQUIRE(factory.get() != nullptr)
+
+    AbstractFilter::Pointer filter = factory->create();
+    DREAM3D_REQUIRE(filter.get() != nullptr)
+    filter->setDataContainerArray(dca);
+
+    QVariant var;
+    var.setValue(spacing);
+    bool propWasSet = filter->setProperty("Spacing", var);
+    DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+
+    var.setValue(resamplingMode);
+    propWasSet = filter->setProperty("ResamplingMode", var);
+    DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+
+    var.setValue(false);
+    propWasSet = filter->setProperty("RenumberFeatures", var);
+    DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+
+    var.setValue(DataArrayPath(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellAttributeMatrixName, ""));
+    propWasSet = filter->setProperty("CellAttributeMatrixPath", var);
+    DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+
+    var.setValue(DataArrayPath(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellAttributeMatrixName, ChangeResolutionTestArrays::k_FeatureIdsName));
+    propWasSet = filter->setProperty("FeatureIdsArrayPath", var);
+    DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+
+    filter->execute();
+    DREAM3D_REQUIRE_EQUAL(filter->getErrorCode(), 0)
+
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename T>
+  typename DataArray<T>::Pointer getCellArray(const DataContainerArray::Pointer& dca, const QString& name)
+  {
+    DataArrayPath path(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellAttributeMatrixName, name);
+    return dca->getAttributeMatrix(path)->getAttributeArrayAs<DataArray<T>>(name);
+  }
+
+  // -----------------------------------------------------------------------------
+  // The nearest neighbor mode copies every array from the old cell that contains the corner of each new cell,
+  // which is what the filter always did before it had a resampling mode
+  // -----------------------------------------------------------------------------
+  int TestNearestNeighbor()
+  {
+    std::vector<size_t> oldDims = {6, 5, 3};
+    std::vector<int32_t> featureIds(oldDims[0] * oldDims[1] * oldDims[2]);
+    for(size_t i = 0; i < featureIds.size(); i++)
+    {
+      featureIds[i] = static_cast<int32_t>(1 + i % 7);
+    }
+
+    const std::vector<FloatVec3Type> spacings = {FloatVec3Type(2.0f, 2.0f, 2.0f), FloatVec3Type(0.5f, 0.75f, 1.5f)};
+    for(const auto& spacing : spacings)
+    {
+      DataContainerArray::Pointer dca = createVolume(oldDims, featureIds);
+      int err = RunChangeResolution(dca, spacing, 0);
+      DREAM3D_REQUIRE_EQUAL(err, EXIT_SUCCESS)
+
+      SizeVec3Type newDims = dca->getDataContainer(SIMPL::Defaults::ImageDataContainerName)->getGeometryAs<ImageGeom>()->getDimensions();
+      DREAM3D_REQUIRE_EQUAL(newDims[0], static_cast<size_t>(oldDims[0] / spacing[0]))
+      DREAM3D_REQUIRE_EQUAL(newDims[1], static_cast<size_t>(oldDims[1] / spacing[1]))
+      DREAM3D_REQUIRE_EQUAL(newDims[2], static_cast<size_t>(oldDims[2] / spacing[2]))
+
+      Int32ArrayType::Pointer ids = getCellArray<int32_t>(dca, ChangeResolutionTestArrays::k_FeatureIdsName);
+      Int32ArrayType::Pointer phases = getCellArray<int32_t>(dca, ChangeResolutionTestArrays::k_PhasesName);
+      FloatArrayType::Pointer scalar = getCellArray<float>(dca, ChangeResolutionTestArrays::k_ScalarName);
+      FloatArrayType::Pointer eulers = getCellArray<float>(dca, ChangeResolutionTestArrays::k_EulersName);
+      size_t index = 0;
+      for(size_t i = 0; i < newDims[2]; i++)
+      {
+        for(size_t j = 0; j < newDims[1]; j++)
+        {
+          for(size_t k = 0; k < newDims[0]; k++)
+          {
+            size_t col = size_t((k * spacing[0]) / 1.0f);
+            size_t row = size_t((j * spacing[1]) / 1.0f);
+            size_t plane = size_t((i * spacing[2]) / 1.0f);
+            size_t oldIndex = (plane * oldDims[1] * oldDims[0]) + (row * oldDims[0]) + col;
+            DREAM3D_REQUIRE_EQUAL(ids->getValue(index), featureIds[oldIndex])
+            DREAM3D_REQUIRE_EQUAL(phases->getValue(index), static_cast<int32_t>(10 * oldIndex))
+            DREAM3D_REQUIRE_EQUAL(scalar->getValue(index), static_cast<float>(col + 10 * row + 100 * plane))
+            DREAM3D_REQUIRE_EQUAL(eulers->getComponent(index, 2), static_cast<float>(oldIndex))
+            index++;
+          }
+        }
+      }
+    }
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  // Down-samples a 4x2x1 image to 2x1x1. The left new cell covers the Feature Ids 1 2 / 2 3, so feature 2 wins
+  // even though the nearest old cell has feature 1, and every other label array comes from the first old cell
+  // with feature 2. The right new cell covers 3 3 / 4 4, a tie that goes to the nearest old cell. The scalar
+  // is interpolated at the new cell centers.
+  // -----------------------------------------------------------------------------
+  int TestTrilinearMajority()
+  {
+    std::vector<size_t> oldDims = {4, 2, 1};
+    std::vector<int32_t> featureIds = {1, 2, 3, 3, 2, 3, 4, 4};
+    DataContainerArray::Pointer dca = createVolume(oldDims, featureIds);
+    int err = RunChangeResolution(dca, FloatVec3Type(2.0f, 2.0f, 1.0f), 1);
+    DREAM3D_REQUIRE_EQUAL(err, EXIT_SUCCESS)
+
+    SizeVec3Type newDims = dca->getDataContainer(SIMPL::Defaults::ImageDataContainerName)->getGeometryAs<ImageGeom>()->getDimensions();
+    DREAM3D_REQUIRE_EQUAL(newDims[0], static_cast<size_t>(2))
+    DREAM3D_REQUIRE_EQUAL(newDims[1], static_cast<size_t>(1))
+    DREAM3D_REQUIRE_EQUAL(newDims[2], static_cast<size_t>(1))
+
+    Int32ArrayType::Pointer ids = getCellArray<int32_t>(dca, ChangeResolutionTestArrays::k_FeatureIdsName);
+    Int32ArrayType::Pointer phases = getCellArray<int32_t>(dca, ChangeResolutionTestArrays::k_PhasesName);
+    FloatArrayType::Pointer scalar = getCellArray<float>(dca, ChangeResolutionTestArrays::k_ScalarName);
+    FloatArrayType::Pointer eulers = getCellArray<float>(dca, ChangeResolutionTestArrays::k_EulersName);
+
+    DREAM3D_REQUIRE_EQUAL(ids->getValue(0), 2)
+    DREAM3D_REQUIRE_EQUAL(phases->getValue(0), 10)
+    DREAM3D_REQUIRE_EQUAL(eulers->getComponent(0, 0), 1.0f)
+    DREAM3D_REQUIRE_EQUAL(scalar->getValue(0), 5.5f)
+
+    DREAM3D_REQUIRE_EQUAL(ids->getValue(1), 3)
+    DREAM3D_REQUIRE_EQUAL(phases->getValue(1), 20)
+    DREAM3D_REQUIRE_EQUAL(eulers->getComponent(1, 0), 2.0f)
+    DREAM3D_REQUIRE_EQUAL(scalar->getValue(1), 7.5f)
+
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    int err = EXIT_SUCCESS;
+    std::cout << "---- " << getNameOfClass().toStdString() << " ----" << std::endl;
+
+    DREAM3D_REGISTER_TEST(TestFilterAvailability());
+
+    DREAM3D_REGISTER_TEST(TestNearestNeighbor())
+    DREAM3D_REGISTER_TEST(TestTrilinearMajority())
+  }
+
+private:
+};
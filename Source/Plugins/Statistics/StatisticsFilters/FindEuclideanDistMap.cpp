@@ -34,10 +34,14 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "FindEuclideanDistMap.h"
 
+#include <cmath>
+#include <limits>
+
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
 
 #include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
 #include <tbb/task_group.h>
 #include <tbb/tick_count.h>
 #endif
@@ -288,6 +292,131 @@ public:
   }
 };
 
+/**
+ * @brief The ExactDistanceTransformImpl class runs one axis pass of the separable exact Euclidean distance
+ * transform of Felzenszwalb and Huttenlocher. Every line of Cells along the axis is replaced by the lower envelope
+ * of the parabolas rooted at its Cells, so after one pass per axis each Cell holds the exact squared distance to
+ * its nearest seed Cell. The index of that seed Cell is carried along with the distance.
+ */
+class ExactDistanceTransformImpl
+{
+public:
+  ExactDistanceTransformImpl(const int64_t* dims, double spacing, size_t axis, const std::vector<double*>& sqDistances, const std::vector<int32_t*>& nearestSeeds)
+  : m_Spacing(spacing)
+  , m_Axis(axis)
+  , m_SqDistances(sqDistances)
+  , m_NearestSeeds(nearestSeeds)
+  {
+    m_Dims[0] = dims[0];
+    m_Dims[1] = dims[1];
+    m_Dims[2] = dims[2];
+  }
+
+  virtual ~ExactDistanceTransformImpl() = default;
+
+  void convert(size_t start, size_t end) const
+  {
+    const int64_t length = m_Dims[m_Axis];
+    const int64_t stride = (m_Axis == 0) ? 1 : ((m_Axis == 1) ? m_Dims[0] : m_Dims[0] * m_Dims[1]);
+    const double sqSpacing = m_Spacing * m_Spacing;
+
+    std::vector<double> f(length);
+    std::vector<int32_t> seeds(length);
+    std::vector<int64_t> v(length);
+    std::vector<double> z(length + 1);
+
+    for(size_t line = start; line < end; line++)
+    {
+      int64_t first = 0;
+      if(m_Axis == 0)
+      {
+        first = static_cast<int64_t>(line) * m_Dims[0];
+      }
+      else if(m_Axis == 1)
+      {
+        first = (static_cast<int64_t>(line) / m_Dims[0]) * m_Dims[0] * m_Dims[1] + (static_cast<int64_t>(line) % m_Dims[0]);
+      }
+      else
+      {
+        first = static_cast<int64_t>(line);
+      }
+
+      for(size_t m = 0; m < m_SqDistances.size(); m++)
+      {
+        double* sqDist = m_SqDistances[m];
+        int32_t* nearest = m_NearestSeeds[m];
+        for(int64_t q = 0; q < length; q++)
+        {
+          f[q] = sqDist[first + q * stride];
+          seeds[q] = nearest[first + q * stride];
+        }
+
+        // Build the lower envelope from the Cells that already have a finite distance
+        int64_t k = -1;
+        for(int64_t q = 0; q < length; q++)
+        {
+          if(f[q] == std::numeric_limits<double>::infinity())
+          {
+            continue;
+          }
+          if(k < 0)
+          {
+            k = 0;
+            v[0] = q;
+            z[0] = -std::numeric_limits<double>::infinity();
+            z[1] = std::numeric_limits<double>::infinity();
+            continue;
+          }
+          double intersect = 0.0;
+          while(true)
+          {
+            intersect = ((f[q] + sqSpacing * q * q) - (f[v[k]] + sqSpacing * v[k] * v[k])) / (2.0 * sqSpacing * (q - v[k]));
+            if(intersect > z[k])
+            {
+              break;
+            }
+            k--;
+          }
+          k++;
+          v[k] = q;
+          z[k] = intersect;
+          z[k + 1] = std::numeric_limits<double>::infinity();
+        }
+        if(k < 0)
+        {
+          continue;
+        }
+
+        k = 0;
+        for(int64_t q = 0; q < length; q++)
+        {
+          while(z[k + 1] < static_cast<double>(q))
+          {
+            k++;
+          }
+          const double delta = static_cast<double>(q - v[k]);
+          sqDist[first + q * stride] = sqSpacing * delta * delta + f[v[k]];
+          nearest[first + q * stride] = seeds[v[k]];
+        }
+      }
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+
+private:
+  int64_t m_Dims[3] = {0, 0, 0};
+  double m_Spacing = 1.0;
+  size_t m_Axis = 0;
+  std::vector<double*> m_SqDistances;
+  std::vector<int32_t*> m_NearestSeeds;
+};
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -302,6 +431,7 @@ FindEuclideanDistMap::FindEuclideanDistMap()
 , m_DoQuadPoints(false)
 , m_SaveNearestNeighbors(false)
 , m_CalcManhattanDist(true)
+, m_UseExactDistanceTransform(false)
 {
 }
 
@@ -317,6 +447,7 @@ void FindEuclideanDistMap::setupFilterParameters()
 {
   FilterParameterVectorType parameters;
   parameters.push_back(SIMPL_NEW_BOOL_FP("Calculate Manhattan Distance", CalcManhattanDist, FilterParameter::Parameter, FindEuclideanDistMap));
+  parameters.push_back(SIMPL_NEW_BOOL_FP("Use Exact Euclidean Distance Transform", UseExactDistanceTransform, FilterParameter::Parameter, FindEuclideanDistMap));
   QStringList linkedProps("GBDistancesArrayName");
 
   parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Calculate Distance to Boundaries", DoBoundaries, FilterParameter::Parameter, FindEuclideanDistMap, linkedProps));
@@ -362,6 +493,7 @@ void FindEuclideanDistMap::readFilterParameters(AbstractFilterParametersReader*
   setDoQuadPoints(reader->readValue("DoQuadPoints", getDoQuadPoints()));
   setSaveNearestNeighbors(reader->readValue("SaveNearestNeighbors", getSaveNearestNeighbors()));
   setCalcManhattanDist(reader->readValue("CalcOnlyManhattanDist", getCalcManhattanDist()));
+  setUseExactDistanceTransform(reader->readValue("UseExactDistanceTransform", getUseExactDistanceTransform()));
   reader->closeFilterGroup();
 }
 
@@ -666,6 +798,12 @@ void FindEuclideanDistMap::findDistanceMap()
     }
   }
 
+  if(!m_CalcManhattanDist && m_UseExactDistanceTransform)
+  {
+    findExactDistanceMap();
+    return;
+  }
+
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
   if(true)
   {
@@ -741,6 +879,107 @@ void FindEuclideanDistMap::findDistanceMap()
   }
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void FindEuclideanDistMap::findExactDistanceMap()
+{
+  ImageGeom::Pointer imageGeom = getDataContainerArray()->getDataContainer(m_FeatureIdsArrayPath.getDataContainerName())->getGeometryAs<ImageGeom>();
+  SizeVec3Type udims = imageGeom->getDimensions();
+  FloatVec3Type spacing = imageGeom->getSpacing();
+
+  int64_t dims[3] = {
+      static_cast<int64_t>(udims[0]),
+      static_cast<int64_t>(udims[1]),
+      static_cast<int64_t>(udims[2]),
+  };
+  size_t totalPoints = m_FeatureIdsPtr.lock()->getNumberOfTuples();
+
+  std::vector<MapType> mapTypes;
+  std::vector<float*> distances;
+  if(m_DoBoundaries)
+  {
+    mapTypes.push_back(MapType::FeatureBoundary);
+    distances.push_back(m_GBEuclideanDistances);
+  }
+  if(m_DoTripleLines)
+  {
+    mapTypes.push_back(MapType::TripleJunction);
+    distances.push_back(m_TJEuclideanDistances);
+  }
+  if(m_DoQuadPoints)
+  {
+    mapTypes.push_back(MapType::QuadPoint);
+    distances.push_back(m_QPEuclideanDistances);
+  }
+  if(mapTypes.empty())
+  {
+    return;
+  }
+
+  // All requested maps are transformed together so each axis pass walks the volume once.
+  // The seed Cells are the ones findDistanceMap() set to a distance of 0.
+  std::vector<std::vector<double>> sqDistStorage(mapTypes.size(), std::vector<double>(totalPoints));
+  std::vector<std::vector<int32_t>> nearestStorage(mapTypes.size(), std::vector<int32_t>(totalPoints));
+  std::vector<double*> sqDistances(mapTypes.size());
+  std::vector<int32_t*> nearestSeeds(mapTypes.size());
+  for(size_t m = 0; m < mapTypes.size(); m++)
+  {
+    sqDistances[m] = sqDistStorage[m].data();
+    nearestSeeds[m] = nearestStorage[m].data();
+    for(size_t a = 0; a < totalPoints; a++)
+    {
+      bool seed = (m_FeatureIds[a] > 0 && distances[m][a] == 0.0f);
+      sqDistances[m][a] = seed ? 0.0 : std::numeric_limits<double>::infinity();
+      nearestSeeds[m][a] = seed ? static_cast<int32_t>(a) : -1;
+    }
+  }
+
+  for(size_t axis = 0; axis < 3; axis++)
+  {
+    if(getCancel())
+    {
+      return;
+    }
+    // A pass along an axis of a single Cell leaves the distances unchanged
+    if(dims[axis] == 1)
+    {
+      continue;
+    }
+    size_t numLines = totalPoints / static_cast<size_t>(dims[axis]);
+    ExactDistanceTransformImpl pass(dims, static_cast<double>(spacing[axis]), axis, sqDistances, nearestSeeds);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numLines), pass, tbb::auto_partitioner());
+#else
+    pass.convert(0, numLines);
+#endif
+  }
+
+  // Cells outside of any Feature keep themselves as nearest neighbor at a distance of 0, as in the iterative map
+  for(size_t m = 0; m < mapTypes.size(); m++)
+  {
+    const size_t comp = static_cast<size_t>(mapTypes[m]);
+    for(size_t a = 0; a < totalPoints; a++)
+    {
+      if(m_FeatureIds[a] <= 0)
+      {
+        distances[m][a] = 0.0f;
+        m_NearestNeighbors[a * 3 + comp] = static_cast<int32_t>(a);
+      }
+      else if(nearestSeeds[m][a] < 0)
+      {
+        distances[m][a] = -1.0f;
+        m_NearestNeighbors[a * 3 + comp] = -1;
+      }
+      else
+      {
+        distances[m][a] = static_cast<float>(std::sqrt(sqDistances[m][a]));
+        m_NearestNeighbors[a * 3 + comp] = nearestSeeds[m][a];
+      }
+    }
+  }
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -983,3 +1222,15 @@ bool FindEuclideanDistMap::getCalcManhattanDist() const
 {
   return m_CalcManhattanDist;
 }
+
+// -----------------------------------------------------------------------------
+void FindEuclideanDistMap::setUseExactDistanceTransform(bool value)
+{
+  m_UseExactDistanceTransform = value;
+}
+
+// -----------------------------------------------------------------------------
+bool FindEuclideanDistMap::getUseExactDistanceTransform() const
+{
+  return m_UseExactDistanceTransform;
+}
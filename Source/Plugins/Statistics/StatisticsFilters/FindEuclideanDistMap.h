@@ -65,6 +65,7 @@ class Statistics_EXPORT FindEuclideanDistMap : public AbstractFilter
   PYB11_PROPERTY(bool DoQuadPoints READ getDoQuadPoints WRITE setDoQuadPoints)
   PYB11_PROPERTY(bool SaveNearestNeighbors READ getSaveNearestNeighbors WRITE setSaveNearestNeighbors)
   PYB11_PROPERTY(bool CalcManhattanDist READ getCalcManhattanDist WRITE setCalcManhattanDist)
+  PYB11_PROPERTY(bool UseExactDistanceTransform READ getUseExactDistanceTransform WRITE setUseExactDistanceTransform)
   PYB11_END_BINDINGS()
   // End Python bindings declarations
 
@@ -217,6 +218,17 @@ public:
   bool getCalcManhattanDist() const;
   Q_PROPERTY(bool CalcManhattanDist READ getCalcManhattanDist WRITE setCalcManhattanDist)
 
+  /**
+   * @brief Setter property for UseExactDistanceTransform
+   */
+  void setUseExactDistanceTransform(bool value);
+  /**
+   * @brief Getter property for UseExactDistanceTransform
+   * @return Value of UseExactDistanceTransform
+   */
+  bool getUseExactDistanceTransform() const;
+  Q_PROPERTY(bool UseExactDistanceTransform READ getUseExactDistanceTransform WRITE setUseExactDistanceTransform)
+
   /**
    * @brief getCompiledLibraryName Reimplemented from @see AbstractFilter class
    */
@@ -300,6 +312,12 @@ protected:
    */
   void findDistanceMap();
 
+  /**
+   * @brief findExactDistanceMap Computes the exact Euclidean distance maps with a separable distance
+   * transform, one parallel pass per axis, instead of growing the maps out from the seed Cells
+   */
+  void findExactDistanceMap();
+
 private:
   std::weak_ptr<DataArray<int32_t>> m_FeatureIdsPtr;
   int32_t* m_FeatureIds = nullptr;
@@ -328,6 +346,7 @@ private:
   bool m_DoQuadPoints = {};
   bool m_SaveNearestNeighbors = {};
   bool m_CalcManhattanDist = {};
+  bool m_UseExactDistanceTransform = {};
 
   // Full Euclidean Distance Arrays
 
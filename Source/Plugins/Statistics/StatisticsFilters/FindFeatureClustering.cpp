@@ -34,7 +34,9 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "FindFeatureClustering.h"
 
+#include <algorithm>
 #include <fstream>
+#include <thread>
 
 #include <QtCore/QTextStream>
 
@@ -56,6 +58,12 @@
 #include "Statistics/StatisticsConstants.h"
 #include "Statistics/StatisticsVersion.h"
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
 /* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
 enum createdPathID : RenameDataPath::DataID_t
 {
@@ -64,6 +72,145 @@ enum createdPathID : RenameDataPath::DataID_t
   DataArrayID32 = 32,
 };
 
+/**
+ * @brief The FindFeatureClusteringImpl class streams the centroid distances of all pairs of Features of the
+ * selected phase. Each chunk owns a contiguous range of first Features, chosen so that the chunks hold about the
+ * same number of pairs, and reduces its pairs either to the smallest and largest squared distance or into its own
+ * histogram of the RDF bins.
+ */
+class FindFeatureClusteringImpl
+{
+public:
+  FindFeatureClusteringImpl(const std::vector<float>& coords, const std::vector<uint8_t>& pairWeights, const std::vector<size_t>& chunkStart, std::vector<float>& chunkMinDist2,
+                            std::vector<float>& chunkMaxDist2, std::vector<std::vector<uint64_t>>& chunkCounts, float min, float stepsize, int32_t numBins)
+  : m_Coords(coords)
+  , m_PairWeights(pairWeights)
+  , m_ChunkStart(chunkStart)
+  , m_ChunkMinDist2(chunkMinDist2)
+  , m_ChunkMaxDist2(chunkMaxDist2)
+  , m_ChunkCounts(chunkCounts)
+  , m_Min(min)
+  , m_Stepsize(stepsize)
+  , m_NumBins(numBins)
+  {
+  }
+  virtual ~FindFeatureClusteringImpl() = default;
+
+  void convert(size_t start, size_t end) const
+  {
+    size_t numFeatures = m_PairWeights.size();
+    for(size_t chunk = start; chunk < end; chunk++)
+    {
+      float minDist2 = std::numeric_limits<float>::max();
+      float maxDist2 = 0.0f;
+      uint64_t* counts = m_ChunkCounts.empty() ? nullptr : m_ChunkCounts[chunk].data();
+      for(size_t i = m_ChunkStart[chunk]; i < m_ChunkStart[chunk + 1]; i++)
+      {
+        float x = m_Coords[3 * i];
+        float y = m_Coords[3 * i + 1];
+        float z = m_Coords[3 * i + 2];
+        for(size_t j = i + 1; j < numFeatures; j++)
+        {
+          float xn = m_Coords[3 * j];
+          float yn = m_Coords[3 * j + 1];
+          float zn = m_Coords[3 * j + 2];
+          float dist2 = (x - xn) * (x - xn) + (y - yn) * (y - yn) + (z - zn) * (z - zn);
+          if(nullptr == counts)
+          {
+            minDist2 = std::min(minDist2, dist2);
+            maxDist2 = std::max(maxDist2, dist2);
+            continue;
+          }
+          // Each unbiased Feature of the pair counts the distance once
+          uint8_t weight = m_PairWeights[i] + m_PairWeights[j];
+          if(weight == 0)
+          {
+            continue;
+          }
+          int32_t bin = (sqrtf(dist2) - m_Min) / m_Stepsize;
+          if(bin >= m_NumBins)
+          {
+            bin = m_NumBins - 1;
+          }
+          counts[bin] += weight;
+        }
+      }
+      m_ChunkMinDist2[chunk] = minDist2;
+      m_ChunkMaxDist2[chunk] = maxDist2;
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+
+private:
+  const std::vector<float>& m_Coords;
+  const std::vector<uint8_t>& m_PairWeights;
+  const std::vector<size_t>& m_ChunkStart;
+  std::vector<float>& m_ChunkMinDist2;
+  std::vector<float>& m_ChunkMaxDist2;
+  std::vector<std::vector<uint64_t>>& m_ChunkCounts;
+  float m_Min;
+  float m_Stepsize;
+  int32_t m_NumBins;
+};
+
+/**
+ * @brief The FindFeatureClusteringListImpl class fills the clustering lists of a range of Features of the selected
+ * phase with the distances to all other Features of that phase, in the order of their Feature Ids.
+ */
+class FindFeatureClusteringListImpl
+{
+public:
+  FindFeatureClusteringListImpl(const std::vector<float>& coords, const std::vector<size_t>& featureIds, std::vector<std::vector<float>>& clusteringlist)
+  : m_Coords(coords)
+  , m_FeatureIds(featureIds)
+  , m_ClusteringList(clusteringlist)
+  {
+  }
+  virtual ~FindFeatureClusteringListImpl() = default;
+
+  void convert(size_t start, size_t end) const
+  {
+    size_t numFeatures = m_FeatureIds.size();
+    for(size_t i = start; i < end; i++)
+    {
+      std::vector<float>& list = m_ClusteringList[m_FeatureIds[i]];
+      list.reserve(numFeatures - 1);
+      for(size_t j = 0; j < numFeatures; j++)
+      {
+        if(j == i)
+        {
+          continue;
+        }
+        float x = m_Coords[3 * i];
+        float y = m_Coords[3 * i + 1];
+        float z = m_Coords[3 * i + 2];
+        float xn = m_Coords[3 * j];
+        float yn = m_Coords[3 * j + 1];
+        float zn = m_Coords[3 * j + 2];
+        list.push_back(sqrtf((x - xn) * (x - xn) + (y - yn) * (y - yn) + (z - zn) * (z - zn)));
+      }
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+
+private:
+  const std::vector<float>& m_Coords;
+  const std::vector<size_t>& m_FeatureIds;
+  std::vector<std::vector<float>>& m_ClusteringList;
+};
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -73,6 +220,7 @@ FindFeatureClustering::FindFeatureClustering()
 , m_PhaseNumber(1)
 , m_CellEnsembleAttributeMatrixName(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellEnsembleAttributeMatrixName, "")
 , m_RemoveBiasedFeatures(false)
+, m_StoreClusteringList(false)
 , m_EquivalentDiametersArrayPath(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellFeatureAttributeMatrixName, SIMPL::FeatureData::EquivalentDiameters)
 , m_FeaturePhasesArrayPath(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellFeatureAttributeMatrixName, SIMPL::FeatureData::Phases)
 , m_CentroidsArrayPath(SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellFeatureAttributeMatrixName, SIMPL::FeatureData::Centroids)
@@ -97,6 +245,9 @@ void FindFeatureClustering::setupFilterParameters()
   parameters.push_back(SIMPL_NEW_INTEGER_FP("Phase Index", PhaseNumber, FilterParameter::Parameter, FindFeatureClustering));
   QStringList linkedProps("BiasedFeaturesArrayPath");
   parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Remove Biased Features", RemoveBiasedFeatures, FilterParameter::Parameter, FindFeatureClustering, linkedProps));
+  linkedProps.clear();
+  linkedProps << "ClusteringListArrayName";
+  parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Store Clustering List", StoreClusteringList, FilterParameter::Parameter, FindFeatureClustering, linkedProps));
   parameters.push_back(SeparatorFilterParameter::New("Cell Feature Data", FilterParameter::RequiredArray));
   {
     DataArraySelectionFilterParameter::RequirementType req =
@@ -151,6 +302,8 @@ void FindFeatureClustering::readFilterParameters(AbstractFilterParametersReader*
   setPhaseNumber(reader->readValue("PhaseNumber", getPhaseNumber()));
   setBiasedFeaturesArrayPath(reader->readDataArrayPath("BiasedFeaturesArrayPath", getBiasedFeaturesArrayPath()));
   setRemoveBiasedFeatures(reader->readValue("RemoveBiasedFeatures", getRemoveBiasedFeatures()));
+  // Pipelines written before this option existed always stored the Clustering List
+  setStoreClusteringList(reader->readValue("StoreClusteringList", true));
   reader->closeFilterGroup();
 }
 
@@ -223,9 +376,12 @@ void FindFeatureClustering::dataCheck()
     m_MaxMinArray = m_MaxMinArrayPtr.lock()->getPointer(0);
   } /* Now assign the raw pointer to data from the DataArray<T> object */
 
-  cDims[0] = 1;
-  tempPath.update(getFeaturePhasesArrayPath().getDataContainerName(), getFeaturePhasesArrayPath().getAttributeMatrixName(), getClusteringListArrayName());
-  m_ClusteringList = getDataContainerArray()->createNonPrereqArrayFromPath<NeighborList<float>>(this, tempPath, 0, cDims, "", DataArrayID32);
+  if(m_StoreClusteringList)
+  {
+    cDims[0] = 1;
+    tempPath.update(getFeaturePhasesArrayPath().getDataContainerName(), getFeaturePhasesArrayPath().getAttributeMatrixName(), getClusteringListArrayName());
+    m_ClusteringList = getDataContainerArray()->createNonPrereqArrayFromPath<NeighborList<float>>(this, tempPath, 0, cDims, "", DataArrayID32);
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -242,20 +398,14 @@ void FindFeatureClustering::find_clustering()
     writeErrorFile = true;
   }
 
-  float x = 0.0f, y = 0.0f, z = 0.0f;
-  float xn = 0.0f, yn = 0.0f, zn = 0.0f;
   float r = 0.0f;
 
-  int32_t bin = 0;
-  int32_t ensemble = 0;
   int32_t totalPPTfeatures = 0;
   float min = std::numeric_limits<float>::max();
   float max = 0.0f;
-  float value = 0.0f;
   float sizex = 0.0f, sizey = 0.0f, sizez = 0.0f, totalvol = 0.0f, totalpoints = 0.0f;
   float normFactor = 0.0f;
 
-  std::vector<std::vector<float>> clusteringlist;
   std::vector<float> oldcount(m_NumberOfBins);
   std::vector<float> randomRDF;
 
@@ -287,87 +437,114 @@ void FindFeatureClustering::find_clustering()
     }
   }
 
-  clusteringlist.resize(totalFeatures);
-
+  // Gather the centroids of the Features of the selected phase. The weight of a Feature is the number of times
+  // each of its distances is counted in the RDF
+  std::vector<size_t> featureIds;
+  std::vector<float> coords;
+  std::vector<uint8_t> pairWeights;
+  featureIds.reserve(totalPPTfeatures);
+  coords.reserve(3 * totalPPTfeatures);
+  pairWeights.reserve(totalPPTfeatures);
   for(size_t i = 1; i < totalFeatures; i++)
   {
     if(m_FeaturePhases[i] == m_PhaseNumber)
     {
-      if(i % 1000 == 0)
-      {
-        QString ss = QObject::tr("Working on Feature %1 of %2").arg(i).arg(totalPPTfeatures);
-        notifyStatusMessage(ss);
-      }
-
-      x = m_Centroids[3 * i];
-      y = m_Centroids[3 * i + 1];
-      z = m_Centroids[3 * i + 2];
+      featureIds.push_back(i);
+      coords.push_back(m_Centroids[3 * i]);
+      coords.push_back(m_Centroids[3 * i + 1]);
+      coords.push_back(m_Centroids[3 * i + 2]);
+      pairWeights.push_back((!m_RemoveBiasedFeatures || !m_BiasedFeatures[i]) ? 1 : 0);
+    }
+  }
 
-      for(size_t j = i + 1; j < totalFeatures; j++)
+  if(outFile.is_open())
+  {
+    for(size_t i = 0; i < featureIds.size(); i++)
+    {
+      for(size_t j = i + 1; j < featureIds.size(); j++)
       {
-        if(m_FeaturePhases[i] == m_FeaturePhases[j])
+        if(writeErrorFile && m_FeaturePhases[featureIds[j]] == 2)
         {
-          xn = m_Centroids[3 * j];
-          yn = m_Centroids[3 * j + 1];
-          zn = m_Centroids[3 * j + 2];
-
-          r = sqrtf((x - xn) * (x - xn) + (y - yn) * (y - yn) + (z - zn) * (z - zn));
-
-          clusteringlist[i].push_back(r);
-          clusteringlist[j].push_back(r);
-
-          if(writeErrorFile && m_FeaturePhases[j] == 2)
-          {
-            outFile << r << "\n" << r << "\n";
-          }
+          r = sqrtf((coords[3 * i] - coords[3 * j]) * (coords[3 * i] - coords[3 * j]) + (coords[3 * i + 1] - coords[3 * j + 1]) * (coords[3 * i + 1] - coords[3 * j + 1]) +
+                    (coords[3 * i + 2] - coords[3 * j + 2]) * (coords[3 * i + 2] - coords[3 * j + 2]));
+          outFile << r << "\n" << r << "\n";
         }
       }
     }
   }
 
-  for(size_t i = 1; i < totalFeatures; i++)
+  // Split the first Features of the pairs into chunks that hold about the same number of pairs
+  size_t numPPT = featureIds.size();
+  size_t numChunks = 1;
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  numChunks = std::max<size_t>(1, std::min<size_t>(numPPT, std::thread::hardware_concurrency() * 4));
+#endif
+  std::vector<size_t> chunkStart(numChunks + 1, numPPT);
+  chunkStart[0] = 0;
   {
-    for(size_t j = 0; j < clusteringlist[i].size(); j++)
+    double totalPairs = 0.5 * static_cast<double>(numPPT) * static_cast<double>(numPPT > 0 ? numPPT - 1 : 0);
+    double pairs = 0.0;
+    size_t chunk = 1;
+    for(size_t i = 0; i < numPPT && chunk < numChunks; i++)
     {
-      if(m_FeaturePhases[i] == m_PhaseNumber)
+      pairs += static_cast<double>(numPPT - 1 - i);
+      if(pairs >= totalPairs * static_cast<double>(chunk) / static_cast<double>(numChunks))
       {
-        value = clusteringlist[i][j];
-        if(value > max)
-        {
-          max = value;
-        }
-        if(value < min)
-        {
-          min = value;
-        }
+        chunkStart[chunk++] = i + 1;
       }
     }
   }
 
+  notifyStatusMessage("Finding the range of the separation distances");
+  std::vector<float> chunkMinDist2(numChunks, 0.0f);
+  std::vector<float> chunkMaxDist2(numChunks, 0.0f);
+  std::vector<std::vector<uint64_t>> chunkCounts;
+  {
+    FindFeatureClusteringImpl impl(coords, pairWeights, chunkStart, chunkMinDist2, chunkMaxDist2, chunkCounts, 0.0f, 1.0f, m_NumberOfBins);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numChunks, 1), impl, tbb::simple_partitioner());
+#else
+    impl.convert(0, numChunks);
+#endif
+  }
+  // sqrtf is monotonic, so the extreme distances are the roots of the extreme squared distances
+  if(numPPT > 1)
+  {
+    min = sqrtf(*std::min_element(chunkMinDist2.begin(), chunkMinDist2.end()));
+    max = sqrtf(*std::max_element(chunkMaxDist2.begin(), chunkMaxDist2.end()));
+  }
+  if(getCancel())
+  {
+    return;
+  }
+
   float stepsize = (max - min) / m_NumberOfBins;
 
   m_MaxMinArray[(m_PhaseNumber * 2)] = max;
   m_MaxMinArray[(m_PhaseNumber * 2) + 1] = min;
 
-  for(size_t i = 1; i < totalFeatures; i++)
+  notifyStatusMessage("Binning the separation distances");
+  chunkCounts.assign(numChunks, std::vector<uint64_t>(m_NumberOfBins, 0));
+  if(numPPT > 1)
+  {
+    FindFeatureClusteringImpl impl(coords, pairWeights, chunkStart, chunkMinDist2, chunkMaxDist2, chunkCounts, min, stepsize, m_NumberOfBins);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numChunks, 1), impl, tbb::simple_partitioner());
+#else
+    impl.convert(0, numChunks);
+#endif
+  }
+  for(size_t chunk = 0; chunk < numChunks; chunk++)
   {
-    for(size_t j = 0; j < clusteringlist[i].size(); j++)
+    for(int32_t b = 0; b < m_NumberOfBins; b++)
     {
-      if(m_FeaturePhases[i] == m_PhaseNumber)
-      {
-        if(!m_RemoveBiasedFeatures || !m_BiasedFeatures[i])
-        {
-          ensemble = m_FeaturePhases[i];
-          bin = (clusteringlist[i][j] - min) / stepsize;
-          if(bin >= m_NumberOfBins)
-          {
-            bin = m_NumberOfBins - 1;
-          }
-          m_NewEnsembleArray[(m_NumberOfBins * ensemble) + bin]++;
-        }
-      }
+      m_NewEnsembleArray[(m_NumberOfBins * m_PhaseNumber) + b] += static_cast<float>(chunkCounts[chunk][b]);
     }
   }
+  if(getCancel())
+  {
+    return;
+  }
 
   // Generate random distribution based on same box size and same stepsize
   float max_box_distance = sqrtf((sizex * sizex) + (sizey * sizey) + (sizez * sizez));
@@ -414,11 +591,26 @@ void FindFeatureClustering::find_clustering()
   //    }
   //    testFile7.close();
 
+  if(!m_StoreClusteringList)
+  {
+    return;
+  }
+
+  // The full lists hold every distance twice, so they are only built when they were asked for
+  std::vector<std::vector<float>> clusteringlist(totalFeatures);
+  {
+    FindFeatureClusteringListImpl listImpl(coords, featureIds, clusteringlist);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numPPT), listImpl, tbb::auto_partitioner());
+#else
+    listImpl.convert(0, numPPT);
+#endif
+  }
   for(size_t i = 1; i < totalFeatures; i++)
   {
     // Set the vector for each list into the Clustering Object
     NeighborList<float>::SharedVectorType sharedClustLst(new std::vector<float>);
-    sharedClustLst->assign(clusteringlist[i].begin(), clusteringlist[i].end());
+    sharedClustLst->swap(clusteringlist[i]);
     m_ClusteringList.lock()->setList(static_cast<int>(i), sharedClustLst);
   }
 }
@@ -682,3 +874,15 @@ QString FindFeatureClustering::getMaxMinArrayName() const
 {
   return m_MaxMinArrayName;
 }
+
+// -----------------------------------------------------------------------------
+void FindFeatureClustering::setStoreClusteringList(bool value)
+{
+  m_StoreClusteringList = value;
+}
+
+// -----------------------------------------------------------------------------
+bool FindFeatureClustering::getStoreClusteringList() const
+{
+  return m_StoreClusteringList;
+}
@@ -67,6 +67,7 @@ class Statistics_EXPORT FindFeatureClustering : public AbstractFilter
   PYB11_PROPERTY(QString ClusteringListArrayName READ getClusteringListArrayName WRITE setClusteringListArrayName)
   PYB11_PROPERTY(QString NewEnsembleArrayArrayName READ getNewEnsembleArrayArrayName WRITE setNewEnsembleArrayArrayName)
   PYB11_PROPERTY(QString MaxMinArrayName READ getMaxMinArrayName WRITE setMaxMinArrayName)
+  PYB11_PROPERTY(bool StoreClusteringList READ getStoreClusteringList WRITE setStoreClusteringList)
   PYB11_END_BINDINGS()
   // End Python bindings declarations
 
@@ -154,6 +155,17 @@ public:
   bool getRemoveBiasedFeatures() const;
   Q_PROPERTY(bool RemoveBiasedFeatures READ getRemoveBiasedFeatures WRITE setRemoveBiasedFeatures)
 
+  /**
+   * @brief Setter property for StoreClusteringList
+   */
+  void setStoreClusteringList(bool value);
+  /**
+   * @brief Getter property for StoreClusteringList
+   * @return Value of StoreClusteringList
+   */
+  bool getStoreClusteringList() const;
+  Q_PROPERTY(bool StoreClusteringList READ getStoreClusteringList WRITE setStoreClusteringList)
+
   /**
    * @brief Setter property for BiasedFeaturesArrayPath
    */
@@ -327,6 +339,7 @@ private:
   int m_PhaseNumber = {};
   DataArrayPath m_CellEnsembleAttributeMatrixName = {};
   bool m_RemoveBiasedFeatures = {};
+  bool m_StoreClusteringList = {};
   DataArrayPath m_BiasedFeaturesArrayPath = {};
   DataArrayPath m_EquivalentDiametersArrayPath = {};
   DataArrayPath m_FeaturePhasesArrayPath = {};
@@ -34,6 +34,9 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "FindNeighborhoods.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <mutex>
 
 #include <QtCore/QTextStream>
@@ -66,24 +69,36 @@ enum createdPathID : RenameDataPath::DataID_t
   DataArrayID31 = 31,
 };
 
+/**
+ * @brief The FindNeighborhoodsImpl class finds the neighborhood of each Feature by only visiting the
+ * centroid bins that lie within the critical distance of the Feature. Each Feature's list is written by
+ * the thread that owns the Feature so no synchronization is needed.
+ */
 class FindNeighborhoodsImpl
 {
 public:
-  FindNeighborhoodsImpl(FindNeighborhoods* filter, size_t totalFeatures, float* centroids, const std::vector<int64_t>& bins, const std::vector<float>& criticalDistance)
+  FindNeighborhoodsImpl(FindNeighborhoods* filter, size_t totalFeatures, const std::vector<int64_t>& bins, const std::vector<float>& criticalDistance, const int64_t* gridMin, const int64_t* gridDims,
+                        const std::vector<size_t>& cellStart, const std::vector<int32_t>& cellFeatures, int32_t* neighborhoods, std::vector<std::vector<int32_t>>& neighborhoodLists)
   : m_Filter(filter)
   , m_TotalFeatures(totalFeatures)
-  , m_Centroids(centroids)
   , m_Bins(bins)
   , m_CriticalDistance(criticalDistance)
+  , m_GridMin(gridMin)
+  , m_GridDims(gridDims)
+  , m_CellStart(cellStart)
+  , m_CellFeatures(cellFeatures)
+  , m_Neighborhoods(neighborhoods)
+  , m_NeighborhoodLists(neighborhoodLists)
   {
   }
 
   void convert(size_t start, size_t end) const
   {
-    float x = 0.0f, y = 0.0f, z = 0.0f;
-    int64_t bin1x = 0, bin2x = 0, bin1y = 0, bin2y = 0, bin1z = 0, bin2z = 0;
+    int64_t bin1[3] = {0, 0, 0};
+    int64_t low[3] = {0, 0, 0};
+    int64_t high[3] = {0, 0, 0};
     float dBinX = 0, dBinY = 0, dBinZ = 0;
-    float criticalDistance1 = 0, criticalDistance2 = 0;
+    float criticalDistance1 = 0;
 
     size_t increment = (end - start) / 100;
     size_t incCount = 0;
@@ -97,43 +112,59 @@ public:
       incCount++;
       if(incCount == increment || i == end - 1)
       {
+        m_Filter->updateProgress(incCount, m_TotalFeatures);
         incCount = 0;
-        m_Filter->updateProgress(increment, m_TotalFeatures);
       }
       if(m_Filter->getCancel())
       {
         break;
       }
-      x = m_Centroids[3 * i];
-      y = m_Centroids[3 * i + 1];
-      z = m_Centroids[3 * i + 2];
-      bin1x = m_Bins[3 * i];
-      bin1y = m_Bins[3 * i + 1];
-      bin1z = m_Bins[3 * i + 2];
       criticalDistance1 = m_CriticalDistance[i];
+      std::vector<int32_t>& neighborhood = m_NeighborhoodLists[i];
+      neighborhood.clear();
+      if(criticalDistance1 <= 0.0f)
+      {
+        m_Neighborhoods[i] = 0;
+        continue;
+      }
 
-      for(size_t j = i + 1; j < m_TotalFeatures; j++)
+      // Only bins closer than the critical distance along every axis can hold neighbors
+      int64_t reach = static_cast<int64_t>(std::ceil(criticalDistance1)) - 1;
+      for(size_t d = 0; d < 3; d++)
       {
-        bin2x = m_Bins[3 * j];
-        bin2y = m_Bins[3 * j + 1];
-        bin2z = m_Bins[3 * j + 2];
-        criticalDistance2 = m_CriticalDistance[j];
-        // Use the llabs version of the "C" abs function because we are using int64_t
-        // do NOT try to use the std::abs() function as this is C++11 ONLY
-        dBinX = llabs(bin2x - bin1x);
-        dBinY = llabs(bin2y - bin1y);
-        dBinZ = llabs(bin2z - bin1z);
-
-        if(dBinX < criticalDistance1 && dBinY < criticalDistance1 && dBinZ < criticalDistance1)
-        {
-          m_Filter->updateNeighborHood(i, j);
-        }
+        bin1[d] = m_Bins[3 * i + d];
+        low[d] = std::max(bin1[d] - reach, m_GridMin[d]) - m_GridMin[d];
+        high[d] = std::min(bin1[d] + reach, m_GridMin[d] + m_GridDims[d] - 1) - m_GridMin[d];
+      }
 
-        if(dBinX < criticalDistance2 && dBinY < criticalDistance2 && dBinZ < criticalDistance2)
+      for(int64_t zBin = low[2]; zBin <= high[2]; zBin++)
+      {
+        for(int64_t yBin = low[1]; yBin <= high[1]; yBin++)
         {
-          m_Filter->updateNeighborHood(j, i);
+          for(int64_t xBin = low[0]; xBin <= high[0]; xBin++)
+          {
+            size_t cell = static_cast<size_t>((zBin * m_GridDims[1] + yBin) * m_GridDims[0] + xBin);
+            for(size_t c = m_CellStart[cell]; c < m_CellStart[cell + 1]; c++)
+            {
+              size_t j = static_cast<size_t>(m_CellFeatures[c]);
+              if(j == i)
+              {
+                continue;
+              }
+              // Use the llabs version of the "C" abs function because we are using int64_t
+              dBinX = llabs(m_Bins[3 * j] - bin1[0]);
+              dBinY = llabs(m_Bins[3 * j + 1] - bin1[1]);
+              dBinZ = llabs(m_Bins[3 * j + 2] - bin1[2]);
+              if(dBinX < criticalDistance1 && dBinY < criticalDistance1 && dBinZ < criticalDistance1)
+              {
+                neighborhood.push_back(static_cast<int32_t>(j));
+              }
+            }
+          }
         }
       }
+      std::sort(neighborhood.begin(), neighborhood.end());
+      m_Neighborhoods[i] = static_cast<int32_t>(neighborhood.size());
     }
   }
 
@@ -147,9 +178,14 @@ public:
 private:
   FindNeighborhoods* m_Filter = nullptr;
   size_t m_TotalFeatures = 0;
-  float* m_Centroids = nullptr;
   const std::vector<int64_t>& m_Bins;
   const std::vector<float>& m_CriticalDistance;
+  const int64_t* m_GridMin = nullptr;
+  const int64_t* m_GridDims = nullptr;
+  const std::vector<size_t>& m_CellStart;
+  const std::vector<int32_t>& m_CellFeatures;
+  int32_t* m_Neighborhoods = nullptr;
+  std::vector<std::vector<int32_t>>& m_NeighborhoodLists;
 };
 
 // -----------------------------------------------------------------------------
@@ -355,17 +391,54 @@ void FindNeighborhoods::execute()
     bins[3 * i + 2] = static_cast<int64_t>(zbin);
   }
 
-#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-  if(true)
+  // Sort the Features into a uniform grid of centroid bins (compressed row storage) so each Feature
+  // only has to be compared against the Features in the bins around it
+  int64_t gridMin[3] = {std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::max()};
+  int64_t gridMax[3] = {std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::min()};
+  for(size_t i = 1; i < totalFeatures; i++)
   {
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, totalFeatures), FindNeighborhoodsImpl(this, totalFeatures, m_Centroids, bins, criticalDistance), tbb::auto_partitioner());
+    for(size_t d = 0; d < 3; d++)
+    {
+      gridMin[d] = std::min(gridMin[d], bins[3 * i + d]);
+      gridMax[d] = std::max(gridMax[d], bins[3 * i + d]);
+    }
   }
-  else
-#endif
+  int64_t gridDims[3] = {0, 0, 0};
+  size_t numCells = 0;
+  if(totalFeatures > 1)
+  {
+    gridDims[0] = gridMax[0] - gridMin[0] + 1;
+    gridDims[1] = gridMax[1] - gridMin[1] + 1;
+    gridDims[2] = gridMax[2] - gridMin[2] + 1;
+    numCells = static_cast<size_t>(gridDims[0] * gridDims[1] * gridDims[2]);
+  }
+  std::vector<size_t> cellStart(numCells + 1, 0);
+  std::vector<int32_t> cellFeatures(totalFeatures > 1 ? totalFeatures - 1 : 0, 0);
+  std::vector<size_t> featureCell(totalFeatures, 0);
+  for(size_t i = 1; i < totalFeatures; i++)
+  {
+    featureCell[i] = static_cast<size_t>(((bins[3 * i + 2] - gridMin[2]) * gridDims[1] + (bins[3 * i + 1] - gridMin[1])) * gridDims[0] + (bins[3 * i] - gridMin[0]));
+    cellStart[featureCell[i] + 1]++;
+  }
+  for(size_t c = 0; c < numCells; c++)
   {
-    FindNeighborhoodsImpl serial(this, totalFeatures, m_Centroids, bins, criticalDistance);
-    serial.convert(0, totalFeatures);
+    cellStart[c + 1] += cellStart[c];
   }
+  {
+    std::vector<size_t> cellFill(cellStart.begin(), cellStart.end() - 1);
+    for(size_t i = 1; i < totalFeatures; i++)
+    {
+      cellFeatures[cellFill[featureCell[i]]++] = static_cast<int32_t>(i);
+    }
+  }
+  std::vector<size_t>().swap(featureCell);
+
+  FindNeighborhoodsImpl impl(this, totalFeatures, bins, criticalDistance, gridMin, gridDims, cellStart, cellFeatures, m_Neighborhoods, m_LocalNeighborhoodList);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, totalFeatures), impl, tbb::auto_partitioner());
+#else
+  impl.convert(0, totalFeatures);
+#endif
 
   for(size_t i = 1; i < totalFeatures; i++)
   {
@@ -376,17 +449,6 @@ void FindNeighborhoods::execute()
   }
 }
 
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-void FindNeighborhoods::updateNeighborHood(size_t sourceIndex, size_t destIndex)
-{
-  static std::mutex mutex;
-  std::lock_guard<std::mutex> lock(mutex);
-  m_Neighborhoods[sourceIndex]++;
-  m_LocalNeighborhoodList[sourceIndex].push_back(static_cast<int32_t>(destIndex));
-}
-
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -33,6 +33,10 @@
  *
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include <QtCore/QDir>
 #include <QtCore/QFile>
 
@@ -323,6 +327,100 @@ public:
     return EXIT_SUCCESS;
   }
 
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int RunExactTransformTest()
+  {
+    std::vector<size_t> tDims = {10, 6, 1};
+    DataContainerArray::Pointer dca = initializeDataContainerArray(tDims);
+
+    QString filtName = "FindEuclideanDistMap";
+    FilterManager* fm = FilterManager::Instance();
+    IFilterFactory::Pointer factory = fm->getFactoryFromClassName(filtName);
+    DREAM3D_REQUIRE(factory.get() != nullptr)
+
+    AbstractFilter::Pointer filter = factory->create();
+    DREAM3D_REQUIRE(filter.get() != nullptr)
+
+    filter->setDataContainerArray(dca);
+
+    QVariant var;
+    var.setValue(k_FeatureIdsArrayPath);
+    int err = filter->setProperty("FeatureIdsArrayPath", var);
+    DREAM3D_REQUIRE(err >= 0);
+    var.setValue(false);
+    err = filter->setProperty("CalcManhattanDist", var);
+    DREAM3D_REQUIRE(err >= 0);
+    var.setValue(true);
+    err = filter->setProperty("UseExactDistanceTransform", var);
+    DREAM3D_REQUIRE(err >= 0);
+    err = filter->setProperty("DoTripleLines", var);
+    DREAM3D_REQUIRE(err >= 0);
+    err = filter->setProperty("SaveNearestNeighbors", var);
+    DREAM3D_REQUIRE(err >= 0);
+    var.setValue(QString("GBExactDistance"));
+    err = filter->setProperty("GBDistancesArrayName", var);
+    DREAM3D_REQUIRE(err >= 0);
+    var.setValue(QString("TJExactDistance"));
+    err = filter->setProperty("TJDistancesArrayName", var);
+    DREAM3D_REQUIRE(err >= 0);
+
+    filter->execute();
+    DREAM3D_REQUIRE(filter->getErrorCode() >= 0);
+
+    AttributeMatrix::Pointer am = dca->getAttributeMatrix(k_FeatureIdsArrayPath);
+    Int32ArrayType::Pointer featureIds = am->getAttributeArrayAs<Int32ArrayType>(k_FeatureIdsArrayPath.getDataArrayName());
+    Int32ArrayType::Pointer nearestNeighbors = am->getAttributeArrayAs<Int32ArrayType>(SIMPL::CellData::NearestNeighbors);
+    DREAM3D_REQUIRE(nearestNeighbors.get() != nullptr);
+
+    // Compare every Cell against a brute force search over the seed Cells, using the (1, 2, 1) spacing
+    const float spacing[3] = {1.0f, 2.0f, 1.0f};
+    QStringList arrayNames = {"GBExactDistance", "TJExactDistance"};
+    for(int32_t m = 0; m < arrayNames.size(); m++)
+    {
+      FloatArrayType::Pointer distances = am->getAttributeArrayAs<FloatArrayType>(arrayNames[m]);
+      DREAM3D_REQUIRE(distances.get() != nullptr);
+      size_t numTuples = distances->getNumberOfTuples();
+
+      std::vector<size_t> seeds;
+      for(size_t i = 0; i < numTuples; i++)
+      {
+        if(featureIds->getValue(i) > 0 && distances->getValue(i) == 0.0f)
+        {
+          seeds.push_back(i);
+        }
+      }
+      DREAM3D_REQUIRE(!seeds.empty());
+
+      for(size_t i = 0; i < numTuples; i++)
+      {
+        if(featureIds->getValue(i) <= 0)
+        {
+          continue;
+        }
+        float refValue = std::numeric_limits<float>::max();
+        for(size_t seed : seeds)
+        {
+          float dx = (static_cast<float>(i % tDims[0]) - static_cast<float>(seed % tDims[0])) * spacing[0];
+          float dy = (static_cast<float>(i / tDims[0]) - static_cast<float>(seed / tDims[0])) * spacing[1];
+          refValue = std::min(refValue, std::sqrt(dx * dx + dy * dy));
+        }
+        float computedValue = distances->getValue(i);
+        DREAM3D_COMPARE_FLOATS(&computedValue, &refValue, 1);
+
+        int32_t nearest = nearestNeighbors->getComponent(i, m);
+        DREAM3D_REQUIRE(nearest >= 0);
+        float dx = (static_cast<float>(i % tDims[0]) - static_cast<float>(nearest % tDims[0])) * spacing[0];
+        float dy = (static_cast<float>(i / tDims[0]) - static_cast<float>(nearest / tDims[0])) * spacing[1];
+        float nearestValue = std::sqrt(dx * dx + dy * dy);
+        DREAM3D_COMPARE_FLOATS(&nearestValue, &refValue, 1);
+      }
+    }
+
+    return EXIT_SUCCESS;
+  }
+
   // -----------------------------------------------------------------------------
   //
   // -----------------------------------------------------------------------------
@@ -334,6 +432,7 @@ public:
     DREAM3D_REGISTER_TEST(TestFilterAvailability());
 
     DREAM3D_REGISTER_TEST(RunTest())
+    DREAM3D_REGISTER_TEST(RunExactTransformTest())
 
     DREAM3D_REGISTER_TEST(RemoveTestFiles())
   }
@@ -32,30 +32,40 @@
  *    United States Prime Contract Navy N00173-07-C-2068
  *
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
-
 #include "CalculateTriangleGroupCurvatures.h"
 
-#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-#include <tbb/task.h>
-#include <tbb/task_group.h>
-#endif
+#include <algorithm>
+#include <cstring>
+#include <iterator>
 
 #include <Eigen/Dense>
 
 #include "SIMPLib/Geometry/TriangleGeom.h"
 #include "SIMPLib/Math/MatrixMath.h"
-#include "SurfaceMeshing/SurfaceMeshingFilters/FindNRingNeighbors.h"
+
+#include "SurfaceMeshing/SurfaceMeshingFilters/FeatureFaceCurvatureFilter.h"
+
+namespace
+{
+// Number of triangles between two progress updates sent to the filter
+const size_t k_ProgressInterval = 1000;
+} // namespace
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-CalculateTriangleGroupCurvatures::CalculateTriangleGroupCurvatures(int64_t nring, std::vector<int64_t> triangleIds, bool useNormalsForCurveFitting, DoubleArrayType::Pointer principleCurvature1,
-                                                                   DoubleArrayType::Pointer principleCurvature2, DoubleArrayType::Pointer principleDirection1,
-                                                                   DoubleArrayType::Pointer principleDirection2, DoubleArrayType::Pointer gaussianCurvature, DoubleArrayType::Pointer meanCurvature,
-                                                                   TriangleGeom::Pointer trianglesGeom, DataArray<int32_t>::Pointer surfaceMeshFaceLabels,
-                                                                   DataArray<double>::Pointer surfaceMeshFaceNormals, DataArray<double>::Pointer surfaceMeshTriangleCentroids, AbstractFilter* parent)
+CalculateTriangleGroupCurvatures::CalculateTriangleGroupCurvatures(int64_t nring, const std::vector<MeshIndexType>& vertTriOffsets, const std::vector<MeshIndexType>& vertTris,
+                                                                   const std::vector<int32_t>& faceRegionIds, int32_t* featureFaceIds, bool useNormalsForCurveFitting,
+                                                                   DoubleArrayType::Pointer principleCurvature1, DoubleArrayType::Pointer principleCurvature2,
+                                                                   DoubleArrayType::Pointer principleDirection1, DoubleArrayType::Pointer principleDirection2,
+                                                                   DoubleArrayType::Pointer gaussianCurvature, DoubleArrayType::Pointer meanCurvature, TriangleGeom::Pointer trianglesGeom,
+                                                                   DataArray<int32_t>::Pointer surfaceMeshFaceLabels, DataArray<double>::Pointer surfaceMeshFaceNormals,
+                                                                   DataArray<double>::Pointer surfaceMeshTriangleCentroids, FeatureFaceCurvatureFilter* parent)
 : m_NRing(nring)
-, m_TriangleIds(triangleIds)
+, m_VertTriOffsets(vertTriOffsets)
+, m_VertTris(vertTris)
+, m_FaceRegionIds(faceRegionIds)
+, m_FeatureFaceIds(featureFaceIds)
 , m_UseNormalsForCurveFitting(useNormalsForCurveFitting)
 , m_PrincipleCurvature1(principleCurvature1)
 , m_PrincipleCurvature2(principleCurvature2)
@@ -79,230 +89,248 @@ CalculateTriangleGroupCurvatures::~CalculateTriangleGroupCurvatures() = default;
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void subtractVector3d(DataArray<double>::Pointer data, double* v)
+void CalculateTriangleGroupCurvatures::convert(size_t start, size_t end) const
 {
-  size_t count = data->getNumberOfTuples();
-  for(size_t i = 0; i < count; ++i)
+  PatchScratch scratch;
+  size_t numCompleted = 0;
+
+  for(size_t i = start; i < end; ++i)
   {
-    double* ptr = data->getPointer(i * 3);
-    ptr[0] = ptr[0] - v[0];
-    ptr[1] = ptr[1] - v[1];
-    ptr[2] = ptr[2] - v[2];
+    if(m_ParentFilter->getCancel())
+    {
+      return;
+    }
+    MeshIndexType triId = static_cast<MeshIndexType>(i);
+    int32_t faceId = m_FeatureFaceIds[triId];
+    if(findNRing(triId, m_FaceRegionIds[faceId * 2], m_FaceRegionIds[faceId * 2 + 1], scratch) && scratch.patch.size() > 1)
+    {
+      computeCurvature(triId, scratch);
+    }
+
+    numCompleted++;
+    if(numCompleted == k_ProgressInterval)
+    {
+      m_ParentFilter->sendThreadSafeProgressMessage(numCompleted);
+      numCompleted = 0;
+    }
   }
+  m_ParentFilter->sendThreadSafeProgressMessage(numCompleted);
 }
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void CalculateTriangleGroupCurvatures::operator()() const
+void CalculateTriangleGroupCurvatures::operator()(const tbb::blocked_range<size_t>& r) const
 {
-  int32_t err = 0;
-
-  if(m_TriangleIds.size() == 0)
-  {
-    return;
-  }
-
-  // Instantiate a FindNRingNeighbors class to use during the loop
-  FindNRingNeighbors::Pointer nRingNeighborAlg = FindNRingNeighbors::New();
+  convert(r.begin(), r.end());
+}
+#endif
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool CalculateTriangleGroupCurvatures::findNRing(MeshIndexType triId, int32_t feature0, int32_t feature1, PatchScratch& scratch) const
+{
+  MeshIndexType* triangles = m_TrianglesPtr->getTriPointer(0);
   int32_t* faceLabels = m_SurfaceMeshFaceLabels->getPointer(0);
 
-  int32_t* fl = faceLabels + m_TriangleIds[0] * 2;
-  int32_t feature0 = 0;
-  int32_t feature1 = 0;
-  if(fl[0] < fl[1])
+  std::vector<MeshIndexType>& patch = scratch.patch;
+  std::vector<MeshIndexType>& merged = scratch.merged;
+  std::vector<MeshIndexType>& frontier = scratch.frontier;
+  std::vector<MeshIndexType>& candidates = scratch.candidates;
+  patch.clear();
+  frontier.clear();
+
+  int32_t* fl = faceLabels + triId * 2;
+  if(!(fl[0] == feature0 && fl[1] == feature1) && !(fl[1] == feature0 && fl[0] == feature1))
   {
-    feature0 = fl[0];
-    feature1 = fl[1];
+    return false;
   }
-  else
+  patch.push_back(triId);
+  frontier.push_back(triId);
+
+  // Grow the patch one ring at a time. Only the triangles added by the previous ring can reach new
+  // triangles, so each ring expands the frontier instead of the whole patch.
+  for(int64_t ring = 0; ring < m_NRing && !frontier.empty(); ++ring)
   {
-    feature0 = fl[1];
-    feature1 = fl[0];
+    candidates.clear();
+    for(MeshIndexType triangleIdx : frontier)
+    {
+      for(int32_t i = 0; i < 3; ++i)
+      {
+        MeshIndexType vert = triangles[triangleIdx * 3 + i];
+        for(MeshIndexType j = m_VertTriOffsets[vert]; j < m_VertTriOffsets[vert + 1]; ++j)
+        {
+          MeshIndexType tid = m_VertTris[j];
+          fl = faceLabels + tid * 2;
+          if((fl[0] == feature0 && fl[1] == feature1) || (fl[1] == feature0 && fl[0] == feature1))
+          {
+            candidates.push_back(tid);
+          }
+        }
+      }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // The new frontier is every candidate that is not part of the patch yet
+    frontier.clear();
+    std::set_difference(candidates.begin(), candidates.end(), patch.begin(), patch.end(), std::back_inserter(frontier));
+
+    merged.clear();
+    std::merge(patch.begin(), patch.end(), frontier.begin(), frontier.end(), std::back_inserter(merged));
+    patch.swap(merged);
   }
+  return true;
+}
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void CalculateTriangleGroupCurvatures::computeCurvature(MeshIndexType triId, PatchScratch& scratch) const
+{
   bool computeGaussian = (m_GaussianCurvature.get() != nullptr);
   bool computeMean = (m_MeanCurvature.get() != nullptr);
   bool computeDirection = (m_PrincipleDirection1.get() != nullptr);
 
-  std::vector<int64_t>::size_type tCount = m_TriangleIds.size();
-  // For each triangle in the group
-  for(std::vector<int64_t>::size_type i = 0; i < tCount; ++i)
+  // Gather the patch centroids with the seed triangle first followed by the rest of the patch in ascending order,
+  // translating the patch to the 0,0,0 origin on the way
+  double* centroids = m_SurfaceMeshTriangleCentroids->getPointer(0);
+  size_t rows = scratch.patch.size();
+  scratch.centroids.resize(rows * 3);
+  double* patchCentroids = scratch.centroids.data();
+  double sub[3] = {centroids[triId * 3], centroids[triId * 3 + 1], centroids[triId * 3 + 2]};
+  size_t m = 0;
+  patchCentroids[0] = centroids[triId * 3] - sub[0];
+  patchCentroids[1] = centroids[triId * 3 + 1] - sub[1];
+  patchCentroids[2] = centroids[triId * 3 + 2] - sub[2];
+  ++m;
+  for(MeshIndexType t : scratch.patch)
   {
-    if(m_ParentFilter->getCancel() == true)
+    if(t == triId)
     {
-      return;
+      continue;
     }
-    int64_t triId = m_TriangleIds[i];
-    nRingNeighborAlg->setTriangleId(triId);
-    nRingNeighborAlg->setRegionId0(feature0);
-    nRingNeighborAlg->setRegionId1(feature1);
-    nRingNeighborAlg->setRing(m_NRing);
-    err = nRingNeighborAlg->generate(m_TrianglesPtr, faceLabels);
-    Q_ASSERT(err >= 0);
-
-    UniqueFaceIds_t triPatch = nRingNeighborAlg->getNRingTriangles();
-    Q_ASSERT(triPatch.size() > 1);
-
-    DataArray<double>::Pointer patchCentroids = extractPatchData(triId, triPatch, m_SurfaceMeshTriangleCentroids->getPointer(0), QString("_INTERNAL_USE_ONLY_Patch_Centroids"));
-    DataArray<double>::Pointer patchNormals = extractPatchData(triId, triPatch, m_SurfaceMeshFaceNormals->getPointer(0), QString("_INTERNAL_USE_ONLY_Patch_Normals"));
-
-    // Translate the patch to the 0,0,0 origin
-    double sub[3] = {patchCentroids->getComponent(0, 0), patchCentroids->getComponent(0, 1), patchCentroids->getComponent(0, 2)};
-    subtractVector3d(patchCentroids, sub);
-
-    double np[3] = {patchNormals->getComponent(0, 0), patchNormals->getComponent(0, 1), patchNormals->getComponent(0, 2)};
-
-    double seedCentroid[3] = {patchCentroids->getComponent(0, 0), patchCentroids->getComponent(0, 1), patchCentroids->getComponent(0, 2)};
-    double firstCentroid[3] = {patchCentroids->getComponent(1, 0), patchCentroids->getComponent(1, 1), patchCentroids->getComponent(1, 2)};
-
-    double temp[3] = {firstCentroid[0] - seedCentroid[0], firstCentroid[1] - seedCentroid[1], firstCentroid[2] - seedCentroid[2]};
-    double vp[3] = {0.0, 0.0, 0.0};
-
-    // Cross Product of np and temp
-    MatrixMath::Normalize3x1(np);
-    MatrixMath::CrossProduct(np, temp, vp);
-    MatrixMath::Normalize3x1(vp);
-
-    // get the third orthogonal vector
-    double up[3] = {0.0, 0.0, 0.0};
-    MatrixMath::CrossProduct(vp, np, up);
-
-    // this constitutes a rotation matrix to a local coordinate system
-    double rot[3][3] = {{up[0], up[1], up[2]}, {vp[0], vp[1], vp[2]}, {np[0], np[1], np[2]}};
-    double out[3] = {0.0, 0.0, 0.0};
-    // Transform all centroids and normals to new coordinate system
-    for(size_t m = 0; m < patchCentroids->getNumberOfTuples(); ++m)
-    {
-      ::memcpy(out, patchCentroids->getPointer(m * 3), 3 * sizeof(double));
-      MatrixMath::Multiply3x3with3x1(rot, patchCentroids->getPointer(m * 3), out);
-      ::memcpy(patchCentroids->getPointer(m * 3), out, 3 * sizeof(double));
+    patchCentroids[m * 3] = centroids[t * 3] - sub[0];
+    patchCentroids[m * 3 + 1] = centroids[t * 3 + 1] - sub[1];
+    patchCentroids[m * 3 + 2] = centroids[t * 3 + 2] - sub[2];
+    ++m;
+  }
 
-      ::memcpy(out, patchNormals->getPointer(m * 3), 3 * sizeof(double));
-      MatrixMath::Multiply3x3with3x1(rot, patchNormals->getPointer(m * 3), out);
-      ::memcpy(patchNormals->getPointer(m * 3), out, 3 * sizeof(double));
+  // Only the normal of the seed triangle is needed to build the local coordinate system
+  double* normals = m_SurfaceMeshFaceNormals->getPointer(0);
+  double np[3] = {normals[triId * 3], normals[triId * 3 + 1], normals[triId * 3 + 2]};
 
-      // We rotate the normals now but we dont use them yet. If we start using part 3 of Goldfeathers paper then we
-      // will need the normals.
-    }
+  double seedCentroid[3] = {patchCentroids[0], patchCentroids[1], patchCentroids[2]};
+  double firstCentroid[3] = {patchCentroids[3], patchCentroids[4], patchCentroids[5]};
 
-    {
-      // Solve the Least Squares fit
-      static const uint32_t NO_NORMALS = 3;
-      static const uint32_t USE_NORMALS = 7;
-      uint32_t cols = NO_NORMALS;
-      if(m_UseNormalsForCurveFitting == true)
-      {
-        cols = USE_NORMALS;
-      }
-      size_t rows = patchCentroids->getNumberOfTuples();
-      Eigen::MatrixXd A(rows, cols);
-      Eigen::VectorXd b(rows);
-      double x = 0.0, y = 0.0, z = 0.0;
-      for(size_t m = 0; m < rows; ++m)
-      {
-        x = patchCentroids->getComponent(m, 0);
-        y = patchCentroids->getComponent(m, 1);
-        z = patchCentroids->getComponent(m, 2);
-
-        A(m) = 0.5 * x * x;            // 1/2 x^2
-        A(m + rows) = x * y;           // x*y
-        A(m + rows * 2) = 0.5 * y * y; // 1/2 y^2
-        if(m_UseNormalsForCurveFitting == true)
-        {
-          A(m + rows * 3) = x * x * x;
-          A(m + rows * 4) = x * x * y;
-          A(m + rows * 5) = x * y * y;
-          A(m + rows * 6) = y * y * y;
-        }
-        b[m] = z; // The Z Values
-      }
+  double temp[3] = {firstCentroid[0] - seedCentroid[0], firstCentroid[1] - seedCentroid[1], firstCentroid[2] - seedCentroid[2]};
+  double vp[3] = {0.0, 0.0, 0.0};
 
-      Eigen::Matrix2d M;
+  // Cross Product of np and temp
+  MatrixMath::Normalize3x1(np);
+  MatrixMath::CrossProduct(np, temp, vp);
+  MatrixMath::Normalize3x1(vp);
 
-      if(false == m_UseNormalsForCurveFitting)
-      {
-        typedef Eigen::Matrix<double, NO_NORMALS, 1> Vector3d;
-        Vector3d sln1 = A.colPivHouseholderQr().solve(b);
-        // Now that we have the A, B, C constants we can solve the Eigen value/vector problem
-        // to get the principal curvatures and pricipal directions.
-        M << sln1(0), sln1(1), sln1(1), sln1(2);
-      }
-      else
-      {
-        typedef Eigen::Matrix<double, USE_NORMALS, 1> Vector7d;
-        Vector7d sln1 = A.colPivHouseholderQr().solve(b);
-        // Now that we have the A, B, C, D, E, F & G constants we can solve the Eigen value/vector problem
-        // to get the principal curvatures and pricipal directions.
-        M << sln1(0), sln1(1), sln1(1), sln1(2);
-      }
+  // get the third orthogonal vector
+  double up[3] = {0.0, 0.0, 0.0};
+  MatrixMath::CrossProduct(vp, np, up);
 
-      Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d> eig(M);
-      Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d>::RealVectorType eValues = eig.eigenvalues();
-      Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d>::MatrixType eVectors = eig.eigenvectors();
+  // this constitutes a rotation matrix to a local coordinate system
+  double rot[3][3] = {{up[0], up[1], up[2]}, {vp[0], vp[1], vp[2]}, {np[0], np[1], np[2]}};
+  double out[3] = {0.0, 0.0, 0.0};
+  // Transform all centroids to new coordinate system. The normals of the patch would only be needed
+  // for part 3 of Goldfeathers paper so they are not transformed.
+  for(m = 0; m < rows; ++m)
+  {
+    MatrixMath::Multiply3x3with3x1(rot, patchCentroids + m * 3, out);
+    ::memcpy(patchCentroids + m * 3, out, 3 * sizeof(double));
+  }
 
-      // Kappa1 >= Kappa2
-      double kappa1 = eValues(0) * -1; // Kappa 1
-      double kappa2 = eValues(1) * -1; // kappa 2
-      Q_ASSERT(kappa1 >= kappa2);
-      m_PrincipleCurvature1->setValue(triId, kappa1);
-      m_PrincipleCurvature2->setValue(triId, kappa2);
+  // Solve the Least Squares fit
+  static const uint32_t NO_NORMALS = 3;
+  static const uint32_t USE_NORMALS = 7;
+  uint32_t cols = NO_NORMALS;
+  if(m_UseNormalsForCurveFitting)
+  {
+    cols = USE_NORMALS;
+  }
+  Eigen::MatrixXd A(rows, cols);
+  Eigen::VectorXd b(rows);
+  double x = 0.0, y = 0.0, z = 0.0;
+  for(m = 0; m < rows; ++m)
+  {
+    x = patchCentroids[m * 3];
+    y = patchCentroids[m * 3 + 1];
+    z = patchCentroids[m * 3 + 2];
+
+    A(m) = 0.5 * x * x;            // 1/2 x^2
+    A(m + rows) = x * y;           // x*y
+    A(m + rows * 2) = 0.5 * y * y; // 1/2 y^2
+    if(m_UseNormalsForCurveFitting)
+    {
+      A(m + rows * 3) = x * x * x;
+      A(m + rows * 4) = x * x * y;
+      A(m + rows * 5) = x * y * y;
+      A(m + rows * 6) = y * y * y;
+    }
+    b[m] = z; // The Z Values
+  }
 
-      if(computeGaussian == true)
-      {
-        m_GaussianCurvature->setValue(triId, kappa1 * kappa2);
-      }
-      if(computeMean == true)
-      {
-        m_MeanCurvature->setValue(triId, (kappa1 + kappa2) / 2.0);
-      }
+  Eigen::Matrix2d M;
 
-      if(computeDirection == true)
-      {
-        Eigen::Matrix3d e_rot_T;
-        e_rot_T.row(0) = Eigen::Vector3d(up[0], vp[0], np[0]);
-        e_rot_T.row(1) = Eigen::Vector3d(up[1], vp[1], np[1]);
-        e_rot_T.row(2) = Eigen::Vector3d(up[2], vp[2], np[2]);
-
-        // Rotate our principal directions back into the original coordinate system
-        Eigen::Vector3d dir1(eVectors.col(0)(0), eVectors.col(0)(1), 0.0);
-        dir1 = e_rot_T * dir1;
-        ::memcpy(m_PrincipleDirection1->getPointer(triId * 3), dir1.data(), 3 * sizeof(double));
-
-        Eigen::Vector3d dir2(eVectors.col(1)(0), eVectors.col(1)(1), 0.0);
-        dir2 = e_rot_T * dir2;
-        ::memcpy(m_PrincipleDirection2->getPointer(triId * 3), dir2.data(), 3 * sizeof(double));
-      }
-    }
-  } // End Loop over this triangle
-}
+  if(!m_UseNormalsForCurveFitting)
+  {
+    typedef Eigen::Matrix<double, NO_NORMALS, 1> Vector3d;
+    Vector3d sln1 = A.colPivHouseholderQr().solve(b);
+    // Now that we have the A, B, C constants we can solve the Eigen value/vector problem
+    // to get the principal curvatures and pricipal directions.
+    M << sln1(0), sln1(1), sln1(1), sln1(2);
+  }
+  else
+  {
+    typedef Eigen::Matrix<double, USE_NORMALS, 1> Vector7d;
+    Vector7d sln1 = A.colPivHouseholderQr().solve(b);
+    // Now that we have the A, B, C, D, E, F & G constants we can solve the Eigen value/vector problem
+    // to get the principal curvatures and pricipal directions.
+    M << sln1(0), sln1(1), sln1(1), sln1(2);
+  }
 
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-DataArray<double>::Pointer CalculateTriangleGroupCurvatures::extractPatchData(int64_t triId, UniqueFaceIds_t& triPatch, double* data, const QString& name) const
-{
-  std::vector<size_t> cDims(1, 3);
-  DataArray<double>::Pointer extractedData = DataArray<double>::CreateArray(triPatch.size(), cDims, name, true);
-  // This little chunk makes sure the current seed triangles centroid and normal data appear
-  // first in the returned arrays which makes the next steps a tad easier.
-  int32_t i = 0;
-  extractedData->setComponent(i, 0, data[triId * 3]);
-  extractedData->setComponent(i, 1, data[triId * 3 + 1]);
-  extractedData->setComponent(i, 2, data[triId * 3 + 2]);
-  ++i;
-  triPatch.erase(triId);
-
-  for(UniqueFaceIds_t::iterator iter = triPatch.begin(); iter != triPatch.end(); ++iter)
+  Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d> eig(M);
+  Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d>::RealVectorType eValues = eig.eigenvalues();
+  Eigen::SelfAdjointEigenSolver<Eigen::Matrix2d>::MatrixType eVectors = eig.eigenvectors();
+
+  // Kappa1 >= Kappa2
+  double kappa1 = eValues(0) * -1; // Kappa 1
+  double kappa2 = eValues(1) * -1; // kappa 2
+  Q_ASSERT(kappa1 >= kappa2);
+  m_PrincipleCurvature1->setValue(triId, kappa1);
+  m_PrincipleCurvature2->setValue(triId, kappa2);
+
+  if(computeGaussian)
+  {
+    m_GaussianCurvature->setValue(triId, kappa1 * kappa2);
+  }
+  if(computeMean)
   {
-    int64_t t = *iter;
-    extractedData->setComponent(i, 0, data[t * 3]);
-    extractedData->setComponent(i, 1, data[t * 3 + 1]);
-    extractedData->setComponent(i, 2, data[t * 3 + 2]);
-    ++i;
+    m_MeanCurvature->setValue(triId, (kappa1 + kappa2) / 2.0);
   }
-  triPatch.insert(triId);
 
-  return extractedData;
+  if(computeDirection)
+  {
+    Eigen::Matrix3d e_rot_T;
+    e_rot_T.row(0) = Eigen::Vector3d(up[0], vp[0], np[0]);
+    e_rot_T.row(1) = Eigen::Vector3d(up[1], vp[1], np[1]);
+    e_rot_T.row(2) = Eigen::Vector3d(up[2], vp[2], np[2]);
+
+    // Rotate our principal directions back into the original coordinate system
+    Eigen::Vector3d dir1(eVectors.col(0)(0), eVectors.col(0)(1), 0.0);
+    dir1 = e_rot_T * dir1;
+    ::memcpy(m_PrincipleDirection1->getPointer(triId * 3), dir1.data(), 3 * sizeof(double));
+
+    Eigen::Vector3d dir2(eVectors.col(1)(0), eVectors.col(1)(1), 0.0);
+    dir2 = e_rot_T * dir2;
+    ::memcpy(m_PrincipleDirection2->getPointer(triId * 3), dir2.data(), 3 * sizeof(double));
+  }
 }
@@ -32,52 +32,86 @@
  *    United States Prime Contract Navy N00173-07-C-2068
  *
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
-
 #pragma once
 
-#include <set>
+#include <vector>
 
 #include "SIMPLib/SIMPLib.h"
 #include "SIMPLib/DataArrays/DataArray.hpp"
-#include "SIMPLib/Filtering/AbstractFilter.h"
 #include "SIMPLib/Geometry/TriangleGeom.h"
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#endif
+
+class FeatureFaceCurvatureFilter;
+
 /**
- * @brief The CalculateTriangleGroupCurvatures class calculates the curvature values for a group of triangles
- * where each triangle in the group will have the 2 Principal Curvature values computed and optionally
- * the 2 Principal Directions and optionally the Mean and Gaussian Curvature computed.
+ * @brief The CalculateTriangleGroupCurvatures class calculates the curvature values for a range of triangles
+ * where each triangle in the range will have the 2 Principal Curvature values computed and optionally
+ * the 2 Principal Directions and optionally the Mean and Gaussian Curvature computed. The patch used for each
+ * triangle is its N-Ring of triangles that lie on the same feature face.
  */
 class CalculateTriangleGroupCurvatures
 {
 public:
-  CalculateTriangleGroupCurvatures(int64_t nring, std::vector<int64_t> triangleIds, bool useNormalsForCurveFitting, DoubleArrayType::Pointer principleCurvature1,
-                                   DoubleArrayType::Pointer principleCurvature2, DoubleArrayType::Pointer principleDirection1, DoubleArrayType::Pointer principleDirection2,
-                                   DoubleArrayType::Pointer gaussianCurvature, DoubleArrayType::Pointer meanCurvature, TriangleGeom::Pointer trianglesGeom,
-                                   DataArray<int32_t>::Pointer surfaceMeshFaceLabels, DataArray<double>::Pointer surfaceMeshFaceNormals, DataArray<double>::Pointer surfaceMeshTriangleCentroids,
-                                   AbstractFilter* parent);
+  /**
+   * @param vertTriOffsets Offsets into vertTris for each vertex, with one extra trailing entry
+   * @param vertTris The triangles that use each vertex, stored back to back
+   * @param faceRegionIds The sorted pair of feature labels for each feature face id
+   */
+  CalculateTriangleGroupCurvatures(int64_t nring, const std::vector<MeshIndexType>& vertTriOffsets, const std::vector<MeshIndexType>& vertTris, const std::vector<int32_t>& faceRegionIds,
+                                   int32_t* featureFaceIds, bool useNormalsForCurveFitting, DoubleArrayType::Pointer principleCurvature1, DoubleArrayType::Pointer principleCurvature2,
+                                   DoubleArrayType::Pointer principleDirection1, DoubleArrayType::Pointer principleDirection2, DoubleArrayType::Pointer gaussianCurvature,
+                                   DoubleArrayType::Pointer meanCurvature, TriangleGeom::Pointer trianglesGeom, DataArray<int32_t>::Pointer surfaceMeshFaceLabels,
+                                   DataArray<double>::Pointer surfaceMeshFaceNormals, DataArray<double>::Pointer surfaceMeshTriangleCentroids, FeatureFaceCurvatureFilter* parent);
 
   virtual ~CalculateTriangleGroupCurvatures();
 
-  void operator()() const;
+  void convert(size_t start, size_t end) const;
 
-  typedef std::set<int64_t> UniqueFaceIds_t;
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const;
+#endif
 
 protected:
-  CalculateTriangleGroupCurvatures();
+  /**
+   * @brief The PatchScratch struct holds the buffers of one ring search so that they are allocated once per
+   * range of triangles instead of once per triangle.
+   */
+  struct PatchScratch
+  {
+    std::vector<MeshIndexType> patch;
+    std::vector<MeshIndexType> merged;
+    std::vector<MeshIndexType> frontier;
+    std::vector<MeshIndexType> candidates;
+    std::vector<double> centroids;
+  };
+
+  /**
+   * @brief findNRing Collects the N-Ring of triangles around the seed triangle that carry the same pair of
+   * feature labels. On return the patch holds the triangle ids in ascending order, including the seed.
+   * @param triId The seed triangle Id
+   * @param feature0 The smaller feature label of the face
+   * @param feature1 The larger feature label of the face
+   * @param scratch The buffers to use
+   * @return false if the seed triangle is not part of the face
+   */
+  bool findNRing(MeshIndexType triId, int32_t feature0, int32_t feature1, PatchScratch& scratch) const;
 
   /**
-   * @brief extractPatchData Extracts out the needed data values from the global arrays
+   * @brief computeCurvature Fits the patch found by findNRing and stores the curvature values of the seed triangle
    * @param triId The seed triangle Id
-   * @param triPatch The group of triangles being used
-   * @param data The data to extract from
-   * @param name The name of the data array being used
-   * @return Shared pointer to the extracted data
+   * @param scratch The buffers holding the patch
    */
-  DataArray<double>::Pointer extractPatchData(int64_t triId, UniqueFaceIds_t& triPatch, double* data, const QString& name) const;
+  void computeCurvature(MeshIndexType triId, PatchScratch& scratch) const;
 
 private:
   int64_t m_NRing;
-  std::vector<int64_t> m_TriangleIds;
+  const std::vector<MeshIndexType>& m_VertTriOffsets;
+  const std::vector<MeshIndexType>& m_VertTris;
+  const std::vector<int32_t>& m_FaceRegionIds;
+  int32_t* m_FeatureFaceIds;
   bool m_UseNormalsForCurveFitting;
   DoubleArrayType::Pointer m_PrincipleCurvature1;
   DoubleArrayType::Pointer m_PrincipleCurvature2;
@@ -89,5 +123,5 @@ private:
   DataArray<int32_t>::Pointer m_SurfaceMeshFaceLabels;
   DataArray<double>::Pointer m_SurfaceMeshFaceNormals;
   DataArray<double>::Pointer m_SurfaceMeshTriangleCentroids;
-  AbstractFilter* m_ParentFilter;
+  FeatureFaceCurvatureFilter* m_ParentFilter;
 };
@@ -34,6 +34,10 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "FeatureFaceCurvatureFilter.h"
 
+#include <algorithm>
+#include <mutex>
+
+#include <QtCore/QDateTime>
 #include <QtCore/QTextStream>
 
 #include "SIMPLib/DataContainers/DataContainer.h"
@@ -47,12 +51,14 @@
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
 #include "SIMPLib/Geometry/TriangleGeom.h"
+#include "SIMPLib/Utilities/TimeUtilities.h"
 
 #include "CalculateTriangleGroupCurvatures.h"
 
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-#include <tbb/task.h>
-#include <tbb/task_group.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
 #endif
 
 // -----------------------------------------------------------------------------
@@ -174,8 +180,10 @@ void FeatureFaceCurvatureFilter::readFilterParameters(AbstractFilterParametersRe
 void FeatureFaceCurvatureFilter::initialize()
 {
   m_SurfaceMeshFaceEdges = nullptr;
-  m_TotalFeatureFaces = -1;
-  m_CompletedFeatureFaces = -1;
+  m_TotalTriangles = 0;
+  m_NumCompleted = 0;
+  m_LastCompletedTriangles = 0;
+  m_Millis = 0;
 }
 
 // -----------------------------------------------------------------------------
@@ -331,16 +339,27 @@ void FeatureFaceCurvatureFilter::execute()
   // Just to double check we have everything.
   int64_t numTriangles = triangleGeom->getNumberOfTris();
 
-  // Make sure the Face Connectivity is created because the FindNRing algorithm needs this and will
-  // assert if the data is NOT in the SurfaceMesh Data Container
-  ElementDynamicList::Pointer vertLinks = triangleGeom->getElementsContainingVert();
-  if(nullptr == vertLinks.get())
+  // Build the vertex to triangle connectivity once as flat offset and list arrays that every ring search reads from
+  MeshIndexType numVerts = triangleGeom->getNumberOfVertices();
+  MeshIndexType* triangles = triangleGeom->getTriPointer(0);
+  std::vector<MeshIndexType> vertTriOffsets(numVerts + 1, 0);
+  for(int64_t t = 0; t < numTriangles * 3; ++t)
   {
-    triangleGeom->findElementsContainingVert();
+    vertTriOffsets[triangles[t] + 1]++;
+  }
+  for(MeshIndexType v = 0; v < numVerts; ++v)
+  {
+    vertTriOffsets[v + 1] += vertTriOffsets[v];
+  }
+  std::vector<MeshIndexType> vertTris(vertTriOffsets[numVerts]);
+  std::vector<MeshIndexType> vertFill(vertTriOffsets.begin(), vertTriOffsets.end() - 1);
+  for(int64_t t = 0; t < numTriangles; ++t)
+  {
+    for(int32_t i = 0; i < 3; ++i)
+    {
+      vertTris[vertFill[triangles[t * 3 + i]]++] = static_cast<MeshIndexType>(t);
+    }
   }
-
-  // get the QMap from the SharedFeatureFaces filter
-  SharedFeatureFaces_t sharedFeatureFaces;
 
   int32_t maxFaceId = 0;
   for(int64_t t = 0; t < numTriangles; ++t)
@@ -350,84 +369,61 @@ void FeatureFaceCurvatureFilter::execute()
       maxFaceId = m_SurfaceMeshFeatureFaceIds[t];
     }
   }
-  std::vector<int32_t> faceSizes(maxFaceId + 1, 0);
-  // Loop through all the Triangles and assign each one to a unique Feature Face Id.
-  for(int64_t t = 0; t < numTriangles; ++t)
-  {
-    faceSizes[m_SurfaceMeshFeatureFaceIds[t]]++;
-  }
-
-  // Allocate all the vectors that we need
-  for(size_t iter = 0; iter < faceSizes.size(); ++iter)
-  {
-    FaceIds_t v;
-    v.reserve(faceSizes[iter]);
-    sharedFeatureFaces[iter] = v;
-  }
 
-  // Loop through all the Triangles and assign each one to a unique Feature Face Id.
+  // Each Feature Face is described by the sorted pair of feature labels of its first triangle
+  std::vector<int32_t> faceRegionIds((maxFaceId + 1) * 2, 0);
+  std::vector<bool> faceFound(maxFaceId + 1, false);
   for(int64_t t = 0; t < numTriangles; ++t)
   {
-    sharedFeatureFaces[m_SurfaceMeshFeatureFaceIds[t]].push_back(t);
-  }
-
-  m_TotalFeatureFaces = sharedFeatureFaces.size();
-  m_CompletedFeatureFaces = 0;
-
-#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-  std::shared_ptr<tbb::task_group> g(new tbb::task_group);
-#else
-
-#endif
-  // typedef here for conveneince
-  typedef SharedFeatureFaces_t::iterator SharedFeatureFaceIterator_t;
-
-  for(SharedFeatureFaceIterator_t iter = sharedFeatureFaces.begin(); iter != sharedFeatureFaces.end(); ++iter)
-  {
-    QString ss = QObject::tr("Working on Face Id %1/%2").arg((*iter).first).arg(maxFaceId);
-    notifyStatusMessage(ss);
-
-    FaceIds_t& triangleIds = (*iter).second;
-#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-    if(true)
-    {
-      g->run(CalculateTriangleGroupCurvatures(m_NRing, triangleIds, m_UseNormalsForCurveFitting, m_SurfaceMeshPrincipalCurvature1sPtr.lock(), m_SurfaceMeshPrincipalCurvature2sPtr.lock(),
-                                              m_SurfaceMeshPrincipalDirection1sPtr.lock(), m_SurfaceMeshPrincipalDirection2sPtr.lock(), m_SurfaceMeshGaussianCurvaturesPtr.lock(),
-                                              m_SurfaceMeshMeanCurvaturesPtr.lock(), triangleGeom, m_SurfaceMeshFaceLabelsPtr.lock(), m_SurfaceMeshFaceNormalsPtr.lock(),
-                                              m_SurfaceMeshTriangleCentroidsPtr.lock(), this));
-    }
-    else
-#endif
+    int32_t faceId = m_SurfaceMeshFeatureFaceIds[t];
+    if(faceFound[faceId])
     {
-      CalculateTriangleGroupCurvatures curvature(m_NRing, triangleIds, m_UseNormalsForCurveFitting, m_SurfaceMeshPrincipalCurvature1sPtr.lock(), m_SurfaceMeshPrincipalCurvature2sPtr.lock(),
-                                                 m_SurfaceMeshPrincipalDirection1sPtr.lock(), m_SurfaceMeshPrincipalDirection2sPtr.lock(), m_SurfaceMeshGaussianCurvaturesPtr.lock(),
-                                                 m_SurfaceMeshMeanCurvaturesPtr.lock(), triangleGeom, m_SurfaceMeshFaceLabelsPtr.lock(), m_SurfaceMeshFaceNormalsPtr.lock(),
-                                                 m_SurfaceMeshTriangleCentroidsPtr.lock(), this);
-      curvature();
+      continue;
     }
+    faceFound[faceId] = true;
+    faceRegionIds[faceId * 2] = std::min(m_SurfaceMeshFaceLabels[t * 2], m_SurfaceMeshFaceLabels[t * 2 + 1]);
+    faceRegionIds[faceId * 2 + 1] = std::max(m_SurfaceMeshFaceLabels[t * 2], m_SurfaceMeshFaceLabels[t * 2 + 1]);
   }
-  // *********************** END END END END END END  ********************************************************************
 
+  m_TotalTriangles = numTriangles;
+  m_NumCompleted = 0;
+  m_LastCompletedTriangles = 0;
+  m_Millis = QDateTime::currentMSecsSinceEpoch();
+
+  // The work is split over the triangles rather than the Feature Faces so a few very large faces can not
+  // leave most of the threads idle
+  CalculateTriangleGroupCurvatures curvature(m_NRing, vertTriOffsets, vertTris, faceRegionIds, m_SurfaceMeshFeatureFaceIds, m_UseNormalsForCurveFitting, m_SurfaceMeshPrincipalCurvature1sPtr.lock(),
+                                             m_SurfaceMeshPrincipalCurvature2sPtr.lock(), m_SurfaceMeshPrincipalDirection1sPtr.lock(), m_SurfaceMeshPrincipalDirection2sPtr.lock(),
+                                             m_SurfaceMeshGaussianCurvaturesPtr.lock(), m_SurfaceMeshMeanCurvaturesPtr.lock(), triangleGeom, m_SurfaceMeshFaceLabelsPtr.lock(),
+                                             m_SurfaceMeshFaceNormalsPtr.lock(), m_SurfaceMeshTriangleCentroidsPtr.lock(), this);
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-  g->wait(); // Wait for all the threads to complete before moving on.
-
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, static_cast<size_t>(numTriangles)), curvature, tbb::auto_partitioner());
+#else
+  curvature.convert(0, static_cast<size_t>(numTriangles));
 #endif
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-void FeatureFaceCurvatureFilter::tbbTaskProgress()
+void FeatureFaceCurvatureFilter::sendThreadSafeProgressMessage(size_t numCompleted)
 {
-  m_CompletedFeatureFaces++;
-
-  QString ss = QObject::tr("%1/%2 Complete").arg(m_CompletedFeatureFaces).arg(m_TotalFeatureFaces);
-  notifyStatusMessage(ss);
+  std::lock_guard<std::mutex> lock(m_ProgressMutex);
+  m_NumCompleted = m_NumCompleted + numCompleted;
+  qint64 currentMillis = QDateTime::currentMSecsSinceEpoch();
+  // Without new triangles since the last message there is no rate to estimate the remaining time from
+  if(currentMillis - m_Millis > 1000 && m_NumCompleted > m_LastCompletedTriangles)
+  {
+    float inverseRate = static_cast<float>(currentMillis - m_Millis) / static_cast<float>(m_NumCompleted - m_LastCompletedTriangles);
+    qint64 remainMillis = inverseRate * (m_TotalTriangles - m_NumCompleted);
+    QString ss = QObject::tr("Triangles Completed: %1 of %2").arg(m_NumCompleted).arg(m_TotalTriangles);
+    ss = ss + QObject::tr(" || Est. Time Remain: %1").arg(DREAM3D::convertMillisToHrsMinSecs(remainMillis));
+    notifyStatusMessage(ss);
+    m_Millis = QDateTime::currentMSecsSinceEpoch();
+    m_LastCompletedTriangles = m_NumCompleted;
+  }
 }
 
-#endif
-
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -36,6 +36,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 
 #include "SIMPLib/SIMPLib.h"
 #include "SIMPLib/DataArrays/DataArray.hpp"
@@ -102,9 +103,6 @@ public:
 
   ~FeatureFaceCurvatureFilter() override;
 
-  typedef std::vector<int64_t> FaceIds_t;
-  typedef std::map<int32_t, FaceIds_t> SharedFeatureFaces_t;
-
   /**
    * @brief Setter property for FaceAttributeMatrixPath
    */
@@ -346,9 +344,12 @@ public:
    */
   void execute() override;
 
-#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
-  virtual void tbbTaskProgress();
-#endif
+  /**
+   * @brief sendThreadSafeProgressMessage Adds to the number of completed triangles and sends a status
+   * message at most once per second. This may be called from any thread.
+   * @param numCompleted The number of triangles completed since the last call
+   */
+  void sendThreadSafeProgressMessage(size_t numCompleted);
 
 protected:
   FeatureFaceCurvatureFilter();
@@ -404,8 +405,11 @@ private:
   DataArray<int32_t>::WeakPointer m_SurfaceMeshUniqueEdgesPtr;
 
   int32_t* m_SurfaceMeshFaceEdges;
-  int32_t m_TotalFeatureFaces;
-  int32_t m_CompletedFeatureFaces;
+  size_t m_TotalTriangles = 0;
+  size_t m_NumCompleted = 0;
+  size_t m_LastCompletedTriangles = 0;
+  qint64 m_Millis = 0;
+  std::mutex m_ProgressMutex;
 
 public:
   FeatureFaceCurvatureFilter(const FeatureFaceCurvatureFilter&) = delete;            // Copy Constructor Not Implemented
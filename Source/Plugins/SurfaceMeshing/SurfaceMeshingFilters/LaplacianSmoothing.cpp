@@ -36,6 +36,7 @@
 
 #include <cstdio>
 #include <sstream>
+#include <vector>
 
 #include <QtCore/QDebug>
 #include <QtCore/QTextStream>
@@ -54,6 +55,108 @@
 #include "SurfaceMeshing/SurfaceMeshingConstants.h"
 #include "SurfaceMeshing/SurfaceMeshingVersion.h"
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
+/**
+ * @brief The LaplacianSmoothingDeltaImpl class sums the vectors from each vertex to its neighbors. Every vertex
+ * only reads the shared vertex positions and writes its own delta, so no synchronization is needed.
+ */
+class LaplacianSmoothingDeltaImpl
+{
+public:
+  LaplacianSmoothingDeltaImpl(const float* verts, const std::vector<MeshIndexType>& neighborOffsets, const std::vector<MeshIndexType>& neighbors, double* delta)
+  : m_Verts(verts)
+  , m_NeighborOffsets(neighborOffsets)
+  , m_Neighbors(neighbors)
+  , m_Delta(delta)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t i = start; i < end; i++)
+    {
+      const float* vert = m_Verts + 3 * i;
+      double sum[3] = {0.0, 0.0, 0.0};
+      for(MeshIndexType n = m_NeighborOffsets[i]; n < m_NeighborOffsets[i + 1]; n++)
+      {
+        const float* neighbor = m_Verts + 3 * m_Neighbors[n];
+        for(size_t j = 0; j < 3; j++)
+        {
+          sum[j] += static_cast<double>(neighbor[j] - vert[j]);
+        }
+      }
+      m_Delta[3 * i] = sum[0];
+      m_Delta[3 * i + 1] = sum[1];
+      m_Delta[3 * i + 2] = sum[2];
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+private:
+  const float* m_Verts;
+  const std::vector<MeshIndexType>& m_NeighborOffsets;
+  const std::vector<MeshIndexType>& m_Neighbors;
+  double* m_Delta;
+};
+
+/**
+ * @brief The LaplacianSmoothingMoveImpl class moves each vertex by its lambda times the average of its deltas
+ */
+class LaplacianSmoothingMoveImpl
+{
+public:
+  LaplacianSmoothingMoveImpl(float* verts, const std::vector<MeshIndexType>& neighborOffsets, const double* delta, const float* lambda, float lambdaFactor)
+  : m_Verts(verts)
+  , m_NeighborOffsets(neighborOffsets)
+  , m_Delta(delta)
+  , m_Lambda(lambda)
+  , m_LambdaFactor(lambdaFactor)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t i = start; i < end; i++)
+    {
+      // A vertex without any edges has no neighborhood to move towards
+      MeshIndexType ncon = m_NeighborOffsets[i + 1] - m_NeighborOffsets[i];
+      if(ncon == 0)
+      {
+        continue;
+      }
+      float ll = m_Lambda[i] * m_LambdaFactor;
+      for(size_t j = 0; j < 3; j++)
+      {
+        double dlta = m_Delta[3 * i + j] / ncon;
+        m_Verts[3 * i + j] += ll * dlta;
+      }
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+private:
+  float* m_Verts;
+  const std::vector<MeshIndexType>& m_NeighborOffsets;
+  const double* m_Delta;
+  const float* m_Lambda;
+  float m_LambdaFactor;
+};
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -283,103 +386,72 @@ int32_t LaplacianSmoothing::edgeBasedSmoothing()
   MeshIndexType* uedges = surfaceMesh->getEdgePointer(0);
   MeshIndexType nedges = surfaceMesh->getNumberOfEdges();
 
-  DataArray<int32_t>::Pointer numConnections = DataArray<int32_t>::CreateArray(nvert, std::string("_INTERNAL_USE_ONLY_Laplacian_Smoothing_NumberConnections_Array"), true);
-  numConnections->initializeWithZeros();
-  int32_t* ncon = numConnections->getPointer(0);
-
-  std::vector<size_t> cDims(1, 3);
-  DataArray<double>::Pointer deltaArray = DataArray<double>::CreateArray(nvert, cDims, "_INTERNAL_USE_ONLY_Laplacian_Smoothing_Delta_Array", true);
-  deltaArray->initializeWithZeros();
-  double* delta = deltaArray->getPointer(0);
-
-  double dlta = 0.0;
-  for(int32_t q = 0; q < m_IterationSteps; q++)
+  // Build the vertex adjacency once in compressed row form. Each vertex lists its neighbors in
+  // the order of the edge list, which keeps the sums below in the same order as an edge sweep.
+  std::vector<MeshIndexType> neighborOffsets(nvert + 1, 0);
+  for(MeshIndexType i = 0; i < nedges; i++)
   {
-    if(getCancel())
-    {
-      return -1;
-    }
-    QString ss = QObject::tr("Iteration %1 of %2").arg(q).arg(m_IterationSteps);
-    notifyStatusMessage(ss);
-    // Compute the Deltas for each point
+    neighborOffsets[uedges[2 * i] + 1]++;
+    neighborOffsets[uedges[2 * i + 1] + 1]++;
+  }
+  for(MeshIndexType i = 0; i < nvert; i++)
+  {
+    neighborOffsets[i + 1] += neighborOffsets[i];
+  }
+  std::vector<MeshIndexType> neighbors(neighborOffsets[nvert]);
+  {
+    std::vector<MeshIndexType> fill(neighborOffsets.begin(), neighborOffsets.end() - 1);
     for(MeshIndexType i = 0; i < nedges; i++)
     {
       MeshIndexType in1 = uedges[2 * i];     // row of the first vertex
       MeshIndexType in2 = uedges[2 * i + 1]; // row the second vertex
-
-      for(MeshIndexType j = 0; j < 3; j++)
-      {
-        Q_ASSERT(static_cast<size_t>(3 * in1 + j) < static_cast<size_t>(nvert * 3));
-        Q_ASSERT(static_cast<size_t>(3 * in2 + j) < static_cast<size_t>(nvert * 3));
-        dlta = static_cast<double>(verts[3 * in2 + j] - verts[3 * in1 + j]);
-        delta[3 * in1 + j] += dlta;
-        delta[3 * in2 + j] += -1.0 * dlta;
-      }
-      ncon[in1] += 1;
-      ncon[in2] += 1;
+      neighbors[fill[in1]++] = in2;
+      neighbors[fill[in2]++] = in1;
     }
+  }
 
-    // Move each point
-    float ll = 0.0f;
-    for(MeshIndexType i = 0; i < nvert; i++)
-    {
-      for(MeshIndexType j = 0; j < 3; j++)
-      {
-        MeshIndexType in0 = 3 * i + j;
-        dlta = delta[in0] / ncon[i];
+  std::vector<double> delta(nvert * 3, 0.0);
 
-        ll = lambda[i];
-        verts[3 * i + j] += ll * dlta;
-        delta[in0] = 0.0; // reset for next iteration
-      }
-      ncon[i] = 0; // reset for next iteration
-    }
+  LaplacianSmoothingDeltaImpl deltaImpl(verts, neighborOffsets, neighbors, delta.data());
+  LaplacianSmoothingMoveImpl moveImpl(verts, neighborOffsets, delta.data(), lambda, 1.0f);
+  // Taubin's smoothing without shrinkage follows every step with a step of negative lambda based on the
+  // mu Factor value. This effectively runs a low pass filter on the data
+  LaplacianSmoothingMoveImpl taubinMoveImpl(verts, neighborOffsets, delta.data(), lambda, m_MuFactor);
 
-    // Now optionally apply a negative lambda based on the mu Factor value.
-    // This is from Taubin's paper on smoothing without shrinkage. This effectively
-    // runs a low pass filter on the data
-    if(m_UseTaubinSmoothing)
+  const int32_t numPasses = m_UseTaubinSmoothing ? 2 : 1;
+  for(int32_t q = 0; q < m_IterationSteps; q++)
+  {
+    for(int32_t pass = 0; pass < numPasses; pass++)
     {
-
       if(getCancel())
       {
         return -1;
       }
       QString ss = QObject::tr("Iteration %1 of %2").arg(q).arg(m_IterationSteps);
       notifyStatusMessage(ss);
-      // Compute the Delta's
-      for(MeshIndexType i = 0; i < nedges; i++)
-      {
-        MeshIndexType in1 = uedges[2 * i];     // row of the first vertex
-        MeshIndexType in2 = uedges[2 * i + 1]; // row the second vertex
 
-        for(int32_t j = 0; j < 3; j++)
-        {
-          Q_ASSERT(static_cast<size_t>(3 * in1 + j) < static_cast<size_t>(nvert * 3));
-          Q_ASSERT(static_cast<size_t>(3 * in2 + j) < static_cast<size_t>(nvert * 3));
-          dlta = verts[3 * in2 + j] - verts[3 * in1 + j];
-          delta[3 * in1 + j] += dlta;
-          delta[3 * in2 + j] += -1.0 * dlta;
-        }
-        ncon[in1] += 1;
-        ncon[in2] += 1;
+      // Compute the Deltas for each point, then move each point
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, nvert), deltaImpl, tbb::auto_partitioner());
+      if(pass == 0)
+      {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, nvert), moveImpl, tbb::auto_partitioner());
       }
-
-      // MOve the points
-      float ll = 0.0f;
-      for(MeshIndexType i = 0; i < nvert; i++)
+      else
       {
-        for(MeshIndexType j = 0; j < 3; j++)
-        {
-          MeshIndexType in0 = 3 * i + j;
-          dlta = delta[in0] / ncon[i];
-
-          ll = lambda[i] * m_MuFactor;
-          verts[3 * i + j] += ll * dlta;
-          delta[in0] = 0.0; // reset for next iteration
-        }
-        ncon[i] = 0; // reset for next iteration
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, nvert), taubinMoveImpl, tbb::auto_partitioner());
+      }
+#else
+      deltaImpl.convert(0, nvert);
+      if(pass == 0)
+      {
+        moveImpl.convert(0, nvert);
       }
+      else
+      {
+        taubinMoveImpl.convert(0, nvert);
+      }
+#endif
     }
   }
 
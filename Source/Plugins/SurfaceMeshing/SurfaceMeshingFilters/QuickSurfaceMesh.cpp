@@ -34,9 +34,12 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "QuickSurfaceMesh.h"
 
+#include <algorithm>
 #include <array>
+#include <limits>
 #include <random>
 #include <set>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -64,6 +67,324 @@
 #include "SurfaceMeshing/SurfaceMeshingConstants.h"
 #include "SurfaceMeshing/SurfaceMeshingVersion.h"
 
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
+/**
+ * @brief The NodeOwners struct records the distinct Features that share a mesh node. The node type only
+ * counts up to 4 owners, so the record saturates once 4 distinct Features have been seen and never has to
+ * grow. The outside of the volume (Feature -1) is tracked by a separate flag.
+ */
+struct QuickSurfaceMesh::NodeOwners
+{
+  int32_t owners[4] = {0, 0, 0, 0};
+  int8_t numOwners = 0;
+  bool onSurface = false;
+
+  void insert(int32_t featureId)
+  {
+    if(featureId == -1)
+    {
+      onSurface = true;
+      return;
+    }
+    for(int8_t i = 0; i < numOwners; i++)
+    {
+      if(owners[i] == featureId)
+      {
+        return;
+      }
+    }
+    if(numOwners < 4)
+    {
+      owners[numOwners] = featureId;
+      numOwners++;
+    }
+  }
+
+  int8_t nodeType() const
+  {
+    int8_t nodeType = numOwners + (onSurface ? 1 : 0);
+    if(nodeType > 4)
+    {
+      nodeType = 4;
+    }
+    if(onSurface)
+    {
+      nodeType += 10;
+    }
+    return nodeType;
+  }
+};
+
+namespace
+{
+/**
+ * @brief visitVoxelFaces Walks the boundary faces of voxel (i, j, k) in the order the mesh is built and hands
+ * the 4 grid nodes of every face to nodeFunc. Each face becomes 2 triangles.
+ * @return Number of faces visited
+ */
+template <typename NodeFunc>
+MeshIndexType visitVoxelFaces(const int32_t* featureIds, MeshIndexType xP, MeshIndexType yP, MeshIndexType zP, MeshIndexType i, MeshIndexType j, MeshIndexType k, NodeFunc nodeFunc)
+{
+  const MeshIndexType point = (k * xP * yP) + (j * xP) + i;
+  const MeshIndexType rowNodes = xP + 1;
+  const MeshIndexType planeNodes = (xP + 1) * (yP + 1);
+
+  const MeshIndexType n000 = (k * planeNodes) + (j * rowNodes) + i;
+  const MeshIndexType n100 = n000 + 1;
+  const MeshIndexType n010 = n000 + rowNodes;
+  const MeshIndexType n110 = n010 + 1;
+  const MeshIndexType n001 = n000 + planeNodes;
+  const MeshIndexType n101 = n001 + 1;
+  const MeshIndexType n011 = n001 + rowNodes;
+  const MeshIndexType n111 = n011 + 1;
+
+  MeshIndexType faceCount = 0;
+  auto face = [&](MeshIndexType a, MeshIndexType b, MeshIndexType c, MeshIndexType d) {
+    nodeFunc(a);
+    nodeFunc(b);
+    nodeFunc(c);
+    nodeFunc(d);
+    faceCount++;
+  };
+
+  if(i == 0)
+  {
+    face(n000, n010, n001, n011);
+  }
+  if(j == 0)
+  {
+    face(n000, n100, n001, n101);
+  }
+  if(k == 0)
+  {
+    face(n000, n100, n010, n110);
+  }
+  if(i == (xP - 1) || featureIds[point] != featureIds[point + 1])
+  {
+    face(n100, n110, n101, n111);
+  }
+  if(j == (yP - 1) || featureIds[point] != featureIds[point + xP])
+  {
+    face(n110, n010, n111, n011);
+  }
+  if(k == (zP - 1) || featureIds[point] != featureIds[point + (xP * yP)])
+  {
+    face(n101, n001, n111, n011);
+  }
+  return faceCount;
+}
+} // namespace
+
+/**
+ * @brief The QuickSurfaceMeshActiveNodesImpl class numbers the boundary nodes of each z slab on its own, in the
+ * order a serial sweep would first touch them. The nodes on the bottom plane of a slab that the last plane of voxels
+ * of the slab below also touches are left to the slab below; they are flagged in the slab's shared node mask.
+ */
+class QuickSurfaceMeshActiveNodesImpl
+{
+public:
+  QuickSurfaceMeshActiveNodesImpl(const int32_t* featureIds, MeshIndexType xP, MeshIndexType yP, MeshIndexType zP, std::vector<MeshIndexType>& nodeIds, const std::vector<MeshIndexType>& slabStart,
+                                  std::vector<std::vector<uint8_t>>& sharedNodes, std::vector<MeshIndexType>& slabNodeCounts, std::vector<MeshIndexType>& slabTriangleCounts)
+  : m_FeatureIds(featureIds)
+  , m_XP(xP)
+  , m_YP(yP)
+  , m_ZP(zP)
+  , m_NodeIds(nodeIds)
+  , m_SlabStart(slabStart)
+  , m_SharedNodes(sharedNodes)
+  , m_SlabNodeCounts(slabNodeCounts)
+  , m_SlabTriangleCounts(slabTriangleCounts)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    const MeshIndexType planeNodes = (m_XP + 1) * (m_YP + 1);
+    for(size_t slab = start; slab < end; slab++)
+    {
+      const MeshIndexType zStart = m_SlabStart[slab];
+      const MeshIndexType zEnd = m_SlabStart[slab + 1];
+      const MeshIndexType firstSharedNode = zStart * planeNodes;
+      std::vector<uint8_t>& shared = m_SharedNodes[slab];
+
+      // Replay the top faces of the voxel plane below this slab to find the nodes it owns
+      if(zStart > 0)
+      {
+        shared.assign(planeNodes, 0);
+        for(MeshIndexType j = 0; j < m_YP; j++)
+        {
+          for(MeshIndexType i = 0; i < m_XP; i++)
+          {
+            visitVoxelFaces(m_FeatureIds, m_XP, m_YP, m_ZP, i, j, zStart - 1, [&](MeshIndexType node) {
+              if(node >= firstSharedNode)
+              {
+                shared[node - firstSharedNode] = 1;
+              }
+            });
+          }
+        }
+      }
+
+      MeshIndexType nodeCount = 0;
+      MeshIndexType faceCount = 0;
+      for(MeshIndexType k = zStart; k < zEnd; k++)
+      {
+        for(MeshIndexType j = 0; j < m_YP; j++)
+        {
+          for(MeshIndexType i = 0; i < m_XP; i++)
+          {
+            faceCount += visitVoxelFaces(m_FeatureIds, m_XP, m_YP, m_ZP, i, j, k, [&](MeshIndexType node) {
+              if(!shared.empty() && node - firstSharedNode < planeNodes && shared[node - firstSharedNode] != 0)
+              {
+                return;
+              }
+              if(m_NodeIds[node] == std::numeric_limits<MeshIndexType>::max())
+              {
+                m_NodeIds[node] = nodeCount;
+                nodeCount++;
+              }
+            });
+          }
+        }
+      }
+      m_SlabNodeCounts[slab] = nodeCount;
+      m_SlabTriangleCounts[slab] = faceCount * 2;
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+private:
+  const int32_t* m_FeatureIds;
+  MeshIndexType m_XP;
+  MeshIndexType m_YP;
+  MeshIndexType m_ZP;
+  std::vector<MeshIndexType>& m_NodeIds;
+  const std::vector<MeshIndexType>& m_SlabStart;
+  std::vector<std::vector<uint8_t>>& m_SharedNodes;
+  std::vector<MeshIndexType>& m_SlabNodeCounts;
+  std::vector<MeshIndexType>& m_SlabTriangleCounts;
+};
+
+/**
+ * @brief The QuickSurfaceMeshRenumberNodesImpl class turns the slab local node numbers into global node numbers
+ * by adding the number of nodes owned by all slabs below the owning slab.
+ */
+class QuickSurfaceMeshRenumberNodesImpl
+{
+public:
+  QuickSurfaceMeshRenumberNodesImpl(MeshIndexType xP, MeshIndexType yP, MeshIndexType zP, std::vector<MeshIndexType>& nodeIds, const std::vector<MeshIndexType>& slabStart,
+                                    const std::vector<std::vector<uint8_t>>& sharedNodes, const std::vector<MeshIndexType>& nodeOffsets)
+  : m_XP(xP)
+  , m_YP(yP)
+  , m_ZP(zP)
+  , m_NodeIds(nodeIds)
+  , m_SlabStart(slabStart)
+  , m_SharedNodes(sharedNodes)
+  , m_NodeOffsets(nodeOffsets)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    const MeshIndexType planeNodes = (m_XP + 1) * (m_YP + 1);
+    const size_t numSlabs = m_SlabStart.size() - 1;
+    for(size_t slab = start; slab < end; slab++)
+    {
+      // Each slab fixes its bottom node plane up to (not including) the bottom plane of the next slab; the
+      // last slab also takes the top node plane of the volume
+      const MeshIndexType zStart = m_SlabStart[slab];
+      const MeshIndexType zEnd = (slab + 1 == numSlabs) ? m_ZP + 1 : m_SlabStart[slab + 1];
+      const std::vector<uint8_t>& shared = m_SharedNodes[slab];
+      for(MeshIndexType k = zStart; k < zEnd; k++)
+      {
+        for(MeshIndexType p = 0; p < planeNodes; p++)
+        {
+          MeshIndexType& nodeId = m_NodeIds[k * planeNodes + p];
+          if(nodeId == std::numeric_limits<MeshIndexType>::max())
+          {
+            continue;
+          }
+          const bool ownedBelow = (k == zStart && slab > 0 && shared[p] != 0);
+          nodeId += ownedBelow ? m_NodeOffsets[slab - 1] : m_NodeOffsets[slab];
+        }
+      }
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+private:
+  MeshIndexType m_XP;
+  MeshIndexType m_YP;
+  MeshIndexType m_ZP;
+  std::vector<MeshIndexType>& m_NodeIds;
+  const std::vector<MeshIndexType>& m_SlabStart;
+  const std::vector<std::vector<uint8_t>>& m_SharedNodes;
+  const std::vector<MeshIndexType>& m_NodeOffsets;
+};
+
+/**
+ * @brief The QuickSurfaceMeshTrianglesImpl class writes the vertices, triangles and face data of every other z slab.
+ * Slabs of the same parity never share a node plane, so they can be meshed at the same time.
+ */
+class QuickSurfaceMeshTrianglesImpl
+{
+public:
+  QuickSurfaceMeshTrianglesImpl(QuickSurfaceMesh* filter, const IGeometryGrid::Pointer& grid, float* vertex, MeshIndexType* triangle, const std::vector<MeshIndexType>& nodeIds,
+                                std::vector<QuickSurfaceMesh::NodeOwners>& ownerLists, const std::vector<MeshIndexType>& slabStart, const std::vector<MeshIndexType>& slabTriangleOffsets, size_t parity)
+  : m_Filter(filter)
+  , m_Grid(grid)
+  , m_Vertex(vertex)
+  , m_Triangle(triangle)
+  , m_NodeIds(nodeIds)
+  , m_OwnerLists(ownerLists)
+  , m_SlabStart(slabStart)
+  , m_SlabTriangleOffsets(slabTriangleOffsets)
+  , m_Parity(parity)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t t = start; t < end; t++)
+    {
+      const size_t slab = 2 * t + m_Parity;
+      m_Filter->createSlabNodesAndTriangles(m_Grid, m_Vertex, m_Triangle, m_NodeIds, m_OwnerLists, m_SlabStart[slab], m_SlabStart[slab + 1], m_SlabTriangleOffsets[slab]);
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+private:
+  QuickSurfaceMesh* m_Filter;
+  const IGeometryGrid::Pointer& m_Grid;
+  float* m_Vertex;
+  MeshIndexType* m_Triangle;
+  const std::vector<MeshIndexType>& m_NodeIds;
+  std::vector<QuickSurfaceMesh::NodeOwners>& m_OwnerLists;
+  const std::vector<MeshIndexType>& m_SlabStart;
+  const std::vector<MeshIndexType>& m_SlabTriangleOffsets;
+  size_t m_Parity;
+};
+
 enum createdPathID : RenameDataPath::DataID_t
 {
   AttributeMatrixID21 = 21,
@@ -622,7 +943,8 @@ void QuickSurfaceMesh::correctProblemVoxels()
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void QuickSurfaceMesh::determineActiveNodes(std::vector<MeshIndexType>& nodeIds, MeshIndexType& nodeCount, MeshIndexType& triangleCount)
+void QuickSurfaceMesh::determineActiveNodes(std::vector<MeshIndexType>& nodeIds, std::vector<MeshIndexType>& slabStart, std::vector<MeshIndexType>& slabTriangleOffsets, MeshIndexType& nodeCount,
+                                            MeshIndexType& triangleCount)
 {
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(m_FeatureIdsArrayPath.getDataContainerName());
 
@@ -634,295 +956,57 @@ void QuickSurfaceMesh::determineActiveNodes(std::vector<MeshIndexType>& nodeIds,
   MeshIndexType yP = udims[1];
   MeshIndexType zP = udims[2];
 
-  std::vector<std::set<int32_t>> ownerLists;
-
-  MeshIndexType point = 0, neigh1 = 0, neigh2 = 0, neigh3 = 0;
-
-  MeshIndexType nodeId1 = 0, nodeId2 = 0, nodeId3 = 0, nodeId4 = 0;
+  // Split the volume into z slabs of whole planes. Without the parallel algorithms there is a single slab
+  // and the sweep below is exactly the original serial sweep.
+  size_t numSlabs = 1;
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  numSlabs = static_cast<size_t>(std::min<MeshIndexType>(zP, std::max<MeshIndexType>(1, static_cast<MeshIndexType>(std::thread::hardware_concurrency()) * 4)));
+#endif
+  slabStart.assign(numSlabs + 1, 0);
+  for(size_t s = 0; s <= numSlabs; s++)
+  {
+    slabStart[s] = (zP * s) / numSlabs;
+  }
 
-  // first determining which nodes are actually boundary nodes and
-  // count number of nodes and triangles that will be created
-  for(MeshIndexType k = 0; k < zP; k++)
+  // First determine which nodes are actually boundary nodes and count the number of nodes and triangles
+  // that will be created. Every slab numbers the nodes it touches first from 0 in serial visiting order.
+  std::vector<std::vector<uint8_t>> sharedNodes(numSlabs);
+  std::vector<MeshIndexType> slabNodeCounts(numSlabs, 0);
+  std::vector<MeshIndexType> slabTriangleCounts(numSlabs, 0);
+  QuickSurfaceMeshActiveNodesImpl activeNodesImpl(m_FeatureIds, xP, yP, zP, nodeIds, slabStart, sharedNodes, slabNodeCounts, slabTriangleCounts);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, numSlabs, 1), activeNodesImpl, tbb::simple_partitioner());
+#else
+  activeNodesImpl.convert(0, numSlabs);
+#endif
+
+  // Slab s continues the numbering where slab s - 1 stopped, which reproduces the serial numbering
+  std::vector<MeshIndexType> nodeOffsets(numSlabs + 1, 0);
+  slabTriangleOffsets.assign(numSlabs + 1, 0);
+  for(size_t s = 0; s < numSlabs; s++)
   {
-    for(MeshIndexType j = 0; j < yP; j++)
-    {
-      for(MeshIndexType i = 0; i < xP; i++)
-      {
-        point = (k * xP * yP) + (j * xP) + i;
-        neigh1 = point + 1;
-        neigh2 = point + xP;
-        neigh3 = point + (xP * yP);
+    nodeOffsets[s + 1] = nodeOffsets[s] + slabNodeCounts[s];
+    slabTriangleOffsets[s + 1] = slabTriangleOffsets[s] + slabTriangleCounts[s];
+  }
+  nodeCount = nodeOffsets[numSlabs];
+  triangleCount = slabTriangleOffsets[numSlabs];
 
-        if(i == 0)
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if(nodeIds[nodeId1] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if(nodeIds[nodeId2] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if(nodeIds[nodeId3] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if(nodeIds[nodeId4] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        if(j == 0)
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if(nodeIds[nodeId1] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId2] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if(nodeIds[nodeId3] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId4] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        if(k == 0)
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if(nodeIds[nodeId1] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId2] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if(nodeIds[nodeId3] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId4] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        if(i == (xP - 1))
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId1] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId2] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId3] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId4] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        else if(m_FeatureIds[point] != m_FeatureIds[neigh1])
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId1] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId2] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId3] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId4] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        if(j == (yP - 1))
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId1] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if(nodeIds[nodeId2] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId3] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if(nodeIds[nodeId4] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        else if(m_FeatureIds[point] != m_FeatureIds[neigh2])
-        {
-          nodeId1 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId1] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = (k * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if(nodeIds[nodeId2] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId3] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if(nodeIds[nodeId4] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        if(k == (zP - 1))
-        {
-          nodeId1 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId1] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if(nodeIds[nodeId2] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId3] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if(nodeIds[nodeId4] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-        else if(k < zP - 1 && m_FeatureIds[point] != m_FeatureIds[neigh3])
-        {
-          nodeId1 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId1] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId1] = nodeCount;
-            nodeCount++;
-          }
-          nodeId2 = ((k + 1) * (xP + 1) * (yP + 1)) + (j * (xP + 1)) + i;
-          if(nodeIds[nodeId2] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId2] = nodeCount;
-            nodeCount++;
-          }
-          nodeId3 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + (i + 1);
-          if(nodeIds[nodeId3] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId3] = nodeCount;
-            nodeCount++;
-          }
-          nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          if(nodeIds[nodeId4] == std::numeric_limits<size_t>::max())
-          {
-            nodeIds[nodeId4] = nodeCount;
-            nodeCount++;
-          }
-          triangleCount++;
-          triangleCount++;
-        }
-      }
-    }
+  if(numSlabs > 1)
+  {
+    QuickSurfaceMeshRenumberNodesImpl renumberImpl(xP, yP, zP, nodeIds, slabStart, sharedNodes, nodeOffsets);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    tbb::parallel_for(tbb::blocked_range<size_t>(1, numSlabs, 1), renumberImpl, tbb::simple_partitioner());
+#else
+    renumberImpl.convert(1, numSlabs);
+#endif
   }
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void QuickSurfaceMesh::createNodesAndTriangles(std::vector<MeshIndexType> m_NodeIds, MeshIndexType nodeCount, MeshIndexType triangleCount)
+void QuickSurfaceMesh::createNodesAndTriangles(const std::vector<MeshIndexType>& m_NodeIds, const std::vector<MeshIndexType>& slabStart, const std::vector<MeshIndexType>& slabTriangleOffsets,
+                                               MeshIndexType nodeCount, MeshIndexType triangleCount)
 {
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(m_FeatureIdsArrayPath.getDataContainerName());
   DataContainer::Pointer sm = getDataContainerArray()->getDataContainer(getSurfaceDataContainerName());
@@ -943,20 +1027,6 @@ void QuickSurfaceMesh::createNodesAndTriangles(std::vector<MeshIndexType> m_Node
 
   IGeometryGrid::Pointer grid = m->getGeometryAs<IGeometryGrid>();
 
-  SizeVec3Type udims = grid->getDimensions();
-
-  MeshIndexType xP = udims[0];
-  MeshIndexType yP = udims[1];
-  MeshIndexType zP = udims[2];
-
-  std::vector<std::set<int32_t>> ownerLists;
-
-  MeshIndexType point = 0, neigh1 = 0, neigh2 = 0, neigh3 = 0;
-
-  MeshIndexType nodeId1 = 0, nodeId2 = 0, nodeId3 = 0, nodeId4 = 0;
-
-  MeshIndexType cIndex1 = 0, cIndex2 = 0;
-
   TriangleGeom::Pointer triangleGeom = sm->getGeometryAs<TriangleGeom>();
 
   float* vertex = triangleGeom->getVertexPointer(0);
@@ -970,11 +1040,47 @@ void QuickSurfaceMesh::createNodesAndTriangles(std::vector<MeshIndexType> m_Node
   updateVertexInstancePointers();
   updateFaceInstancePointers();
 
-  ownerLists.resize(nodeCount);
+  std::vector<NodeOwners> ownerLists(nodeCount);
 
-  // Cycle through again assigning coordinates to each node and assigning node numbers and feature labels to each triangle
-  MeshIndexType triangleIndex = 0;
-  for(MeshIndexType k = 0; k < zP; k++)
+  // Cycle through again assigning coordinates to each node and assigning node numbers and feature labels to each triangle.
+  // Neighboring slabs share a plane of nodes, so all even slabs are meshed first and all odd slabs after them.
+  const size_t numSlabs = slabStart.size() - 1;
+  for(size_t parity = 0; parity < 2; parity++)
+  {
+    const size_t numParitySlabs = (numSlabs + 1 - parity) / 2;
+    QuickSurfaceMeshTrianglesImpl trianglesImpl(this, grid, vertex, triangle, m_NodeIds, ownerLists, slabStart, slabTriangleOffsets, parity);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numParitySlabs, 1), trianglesImpl, tbb::simple_partitioner());
+#else
+    trianglesImpl.convert(0, numParitySlabs);
+#endif
+  }
+
+  for(size_t i = 0; i < nodeCount; i++)
+  {
+    m_NodeTypes[i] = ownerLists[i].nodeType();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void QuickSurfaceMesh::createSlabNodesAndTriangles(const IGeometryGrid::Pointer& grid, float* vertex, MeshIndexType* triangle, const std::vector<MeshIndexType>& m_NodeIds,
+                                                   std::vector<NodeOwners>& ownerLists, MeshIndexType zStart, MeshIndexType zEnd, MeshIndexType triangleIndex)
+{
+  SizeVec3Type udims = grid->getDimensions();
+
+  MeshIndexType xP = udims[0];
+  MeshIndexType yP = udims[1];
+  MeshIndexType zP = udims[2];
+
+  MeshIndexType point = 0, neigh1 = 0, neigh2 = 0, neigh3 = 0;
+
+  MeshIndexType nodeId1 = 0, nodeId2 = 0, nodeId3 = 0, nodeId4 = 0;
+
+  MeshIndexType cIndex1 = 0, cIndex2 = 0;
+
+  for(MeshIndexType k = zStart; k < zEnd; k++)
   {
     for(MeshIndexType j = 0; j < yP; j++)
     {
@@ -997,7 +1103,7 @@ void QuickSurfaceMesh::createNodesAndTriangles(std::vector<MeshIndexType> m_Node
           getGridCoordinates(grid, i, j, k + 1, vertex + (m_NodeIds[nodeId3] * 3));
 
           nodeId4 = ((k + 1) * (xP + 1) * (yP + 1)) + ((j + 1) * (xP + 1)) + i;
-          getGridCoordinates(grid, i + 1, j + 1, k + 1, vertex + (m_NodeIds[nodeId4] * 3));
+          getGridCoordinates(grid, i, j + 1, k + 1, vertex + (m_NodeIds[nodeId4] * 3));
 
           triangle[triangleIndex * 3 + 0] = m_NodeIds[nodeId1];
           triangle[triangleIndex * 3 + 1] = m_NodeIds[nodeId3];
@@ -1513,19 +1619,6 @@ void QuickSurfaceMesh::createNodesAndTriangles(std::vector<MeshIndexType> m_Node
       }
     }
   }
-
-  for(size_t i = 0; i < nodeCount; i++)
-  {
-    m_NodeTypes[i] = static_cast<int8_t>(ownerLists[i].size());
-    if(m_NodeTypes[i] > 4)
-    {
-      m_NodeTypes[i] = 4;
-    }
-    if(ownerLists[i].find(-1) != ownerLists[i].end())
-    {
-      m_NodeTypes[i] += 10;
-    }
-  }
 }
 
 // -----------------------------------------------------------------------------
@@ -1564,24 +1657,24 @@ void QuickSurfaceMesh::execute()
   size_t yP = udims[1];
   size_t zP = udims[2];
 
-  std::vector<std::set<int32_t>> ownerLists;
-
   size_t possibleNumNodes = (xP + 1) * (yP + 1) * (zP + 1);
   std::vector<size_t> m_NodeIds(possibleNumNodes, std::numeric_limits<size_t>::max());
 
   size_t nodeCount = 0;
   size_t triangleCount = 0;
+  std::vector<MeshIndexType> slabStart;
+  std::vector<MeshIndexType> slabTriangleOffsets;
 
   correctProblemVoxels();
 
-  determineActiveNodes(m_NodeIds, nodeCount, triangleCount);
+  determineActiveNodes(m_NodeIds, slabStart, slabTriangleOffsets, nodeCount, triangleCount);
 
   // now create node and triangle arrays knowing the number that will be needed
   TriangleGeom::Pointer triangleGeom = sm->getGeometryAs<TriangleGeom>();
   triangleGeom->resizeTriList(triangleCount);
   triangleGeom->resizeVertexList(nodeCount);
 
-  createNodesAndTriangles(m_NodeIds, nodeCount, triangleCount);
+  createNodesAndTriangles(m_NodeIds, slabStart, slabTriangleOffsets, nodeCount, triangleCount);
 
   MeshIndexType* triangle = triangleGeom->getTriPointer(0);
 
@@ -329,9 +329,30 @@ private:
 
   void correctProblemVoxels();
 
-  void determineActiveNodes(std::vector<MeshIndexType>& m_NodeIds, MeshIndexType& nodeCount, MeshIndexType& triangleCount);
+  /**
+   * @brief determineActiveNodes Numbers the boundary nodes and counts the triangles. The volume is split into
+   * z slabs that are swept in parallel; the resulting numbering is identical to a single serial sweep.
+   * @param m_NodeIds Grid node to mesh node map, filled with numeric_limits::max() on input
+   * @param slabStart First voxel plane of every slab, plus the end plane
+   * @param slabTriangleOffsets Index of the first triangle of every slab, plus the total
+   * @param nodeCount
+   * @param triangleCount
+   */
+  void determineActiveNodes(std::vector<MeshIndexType>& m_NodeIds, std::vector<MeshIndexType>& slabStart, std::vector<MeshIndexType>& slabTriangleOffsets, MeshIndexType& nodeCount,
+                            MeshIndexType& triangleCount);
+
+  void createNodesAndTriangles(const std::vector<MeshIndexType>& m_NodeIds, const std::vector<MeshIndexType>& slabStart, const std::vector<MeshIndexType>& slabTriangleOffsets,
+                               MeshIndexType nodeCount, MeshIndexType triangleCount);
 
-  void createNodesAndTriangles(std::vector<MeshIndexType> m_NodeIds, MeshIndexType nodeCount, MeshIndexType triangleCount);
+  struct NodeOwners;
+  friend class QuickSurfaceMeshTrianglesImpl;
+
+  /**
+   * @brief createSlabNodesAndTriangles Writes the vertices, triangles and face data for the voxel planes [zStart, zEnd)
+   * @param triangleIndex Index of the first triangle of the slab
+   */
+  void createSlabNodesAndTriangles(const IGeometryGrid::Pointer& grid, float* vertex, MeshIndexType* triangle, const std::vector<MeshIndexType>& m_NodeIds, std::vector<NodeOwners>& ownerLists,
+                                   MeshIndexType zStart, MeshIndexType zEnd, MeshIndexType triangleIndex);
 
   /**
    * @brief updateFaceInstancePointers Updates raw Face pointers
@@ -58,12 +58,11 @@ endforeach()
 # This is the list of Private Filters. These filters are available from other filters but the user will not
 # be able to use them from the DREAM3D user interface.
 set(_PrivateFilters
-
+  VerifyTriangleWinding
   
   # These filters require extensive updates to comply with the IGeometry design
   #M3CSliceBySlice
   #MovingFiniteElementSmoothing
-  #VerifyTriangleWinding
 )
 
 #-----------------
@@ -34,286 +34,373 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "VerifyTriangleWinding.h"
 
-#include <QtCore/QString>
-#include <deque>
-#include <iostream>
-#include <limits>
-#include <queue>
-
-#ifdef _MSC_VER
-#include <hash_set>
-// using namespace stdext;
-#define STDEXT stdext
-#else
-#include <ext/hash_set>
-// using namespace __gnu_cxx;
-#define STDEXT __gnu_cxx
-#endif
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
 
-#include <QtCore/QDebug>
+#include <QtCore/QTextStream>
 
+#include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/DataContainers/DataContainer.h"
 #include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
+#include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
+#include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
 #include "SIMPLib/Geometry/TriangleGeom.h"
-#include "SIMPLib/Math/MatrixMath.h"
 
-#include "SurfaceMeshing/SurfaceMeshingFilters/ReverseTriangleWinding.h"
-#include "SurfaceMeshing/SurfaceMeshingFilters/util/Plane.h"
-#include "SurfaceMeshing/SurfaceMeshingFilters/util/TriangleOps.h"
-#include "SurfaceMeshing/SurfaceMeshingFilters/util/Vector3.h"
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
 
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-class Mesh
+#include "SurfaceMeshing/SurfaceMeshingConstants.h"
+#include "SurfaceMeshing/SurfaceMeshingVersion.h"
+
+/**
+ * @brief The TriangleEdgeNeighborsImpl class finds, for a range of triangles, the triangles that share one of
+ * their edges. The first pass only counts the neighbors of each triangle, the second pass fills them in at the
+ * offsets built from those counts.
+ */
+class TriangleEdgeNeighborsImpl
 {
 public:
-  using Self = Mesh;
-  using Pointer = std::shared_ptr<Self>;
-  using ConstPointer = std::shared_ptr<const Self>;
-  using WeakPointer = std::weak_ptr<Self>;
-  using ConstWeakPointer = std::weak_ptr<const Self>;
-  static Pointer NullPointer();
-  Pointer NullPointer()
+  TriangleEdgeNeighborsImpl(MeshIndexType* triangles, const std::vector<MeshIndexType>& vertTriOffsets, const std::vector<MeshIndexType>& vertTris, std::vector<MeshIndexType>& neighborOffsets,
+                            std::vector<MeshIndexType>& neighbors, std::vector<uint8_t>& neighborEdges, bool fill)
+  : m_Triangles(triangles)
+  , m_VertTriOffsets(vertTriOffsets)
+  , m_VertTris(vertTris)
+  , m_NeighborOffsets(neighborOffsets)
+  , m_Neighbors(neighbors)
+  , m_NeighborEdges(neighborEdges)
+  , m_Fill(fill)
   {
-    return Pointer(static_cast<Self*>(nullptr));
   }
+  virtual ~TriangleEdgeNeighborsImpl() = default;
 
-  static Pointer New();
-
-  virtual ~Mesh()
-  {
-  }
-  int getMaxLabel()
+  void convert(size_t start, size_t end) const
   {
-    return -1;
-  }
-  int getMinLabel()
-  {
-    return -1;
-  }
-  void setMaxLabel(int32_t l)
-  {
-    m_MaxLabel = l;
-  }
-  void setMinLabel(int32_t l)
-  {
-    m_MinLabel = l;
-  }
-  void incrementMaxLabel()
-  {
-    m_MaxLabel++;
+    for(size_t t = start; t < end; t++)
+    {
+      MeshIndexType count = 0;
+      MeshIndexType pos = m_Fill ? m_NeighborOffsets[t] : 0;
+      for(uint8_t e = 0; e < 3; e++)
+      {
+        MeshIndexType a = m_Triangles[t * 3 + e];
+        MeshIndexType b = m_Triangles[t * 3 + (e + 1) % 3];
+        for(MeshIndexType j = m_VertTriOffsets[a]; j < m_VertTriOffsets[a + 1]; j++)
+        {
+          MeshIndexType n = m_VertTris[j];
+          if(n == t)
+          {
+            continue;
+          }
+          MeshIndexType* nVerts = m_Triangles + n * 3;
+          if(nVerts[0] != b && nVerts[1] != b && nVerts[2] != b)
+          {
+            continue;
+          }
+          if(m_Fill)
+          {
+            m_Neighbors[pos] = n;
+            m_NeighborEdges[pos] = e;
+            pos++;
+          }
+          else
+          {
+            count++;
+          }
+        }
+      }
+      if(!m_Fill)
+      {
+        m_NeighborOffsets[t + 1] = count;
+      }
+    }
   }
 
-protected:
-  Mesh()
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
   {
+    convert(r.begin(), r.end());
   }
+#endif
 
 private:
-  int32_t m_MinLabel;
-  int32_t m_MaxLabel;
-
-  Mesh(const Mesh&);           // Copy Constructor Not Implemented
-  void operator=(const Mesh&); // Operator '=' Not Implemented
+  MeshIndexType* m_Triangles;
+  const std::vector<MeshIndexType>& m_VertTriOffsets;
+  const std::vector<MeshIndexType>& m_VertTris;
+  std::vector<MeshIndexType>& m_NeighborOffsets;
+  std::vector<MeshIndexType>& m_Neighbors;
+  std::vector<uint8_t>& m_NeighborEdges;
+  bool m_Fill;
 };
 
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-class LabelVisitorInfo
+/**
+ * @brief The FeatureWindingImpl class makes the winding of the triangles of a range of features consistent.
+ * Every connected patch of a feature is walked across its shared edges, where two neighboring triangles must
+ * run along the shared edge in opposite directions when both are seen from the feature. Every closed patch is a
+ * shell of the feature and is then turned so that its normals point out of the feature: an outer shell encloses
+ * a positive volume, while the shell of a cavity (around an enclosed feature) encloses a negative volume. Each
+ * triangle is decided by the larger of its two labels, so every entry of the flip array has a single writer and
+ * the features can run in any order.
+ */
+class FeatureWindingImpl
 {
 public:
-  //   typedef Mesh<int32_t>::Pointer                MeshPtrType;
-  typedef FaceArray::Face_t FaceType;
-  typedef QVector<int32_t> FaceListType;
-
-  using Self = LabelVisitorInfo;
-  using Pointer = std::shared_ptr<Self>;
-  using ConstPointer = std::shared_ptr<const Self>;
-  using WeakPointer = std::weak_ptr<Self>;
-  using ConstWeakPointer = std::weak_ptr<const Self>;
-  static Pointer NullPointer();
-  Pointer NullPointer()
-  {
-    return Pointer(static_cast<Self*>(nullptr));
-  }
-
-  static Pointer New(int32_t label, size_t tIndex)
-  {
-    Pointer sharedPtr(new LabelVisitorInfo(label, tIndex));
-    return sharedPtr;
-  }
-
-  virtual ~LabelVisitorInfo()
-  {
-  }
-
-private:
-  int32_t m_Label;
-
-public:
-  int32_t getLabel()
-  {
-    if(m_Relabeled)
+  FeatureWindingImpl(AbstractFilter* filter, MeshIndexType* triangles, float* vertices, int32_t* faceLabels, const std::vector<MeshIndexType>& featureTriOffsets,
+                     const std::vector<MeshIndexType>& featureTris, const std::vector<MeshIndexType>& featureSlots, const std::vector<MeshIndexType>& neighborOffsets,
+                     const std::vector<MeshIndexType>& neighbors, const std::vector<uint8_t>& neighborEdges, std::vector<uint8_t>& flip, std::atomic<size_t>& conflicts)
+  : m_Filter(filter)
+  , m_Triangles(triangles)
+  , m_Vertices(vertices)
+  , m_FaceLabels(faceLabels)
+  , m_FeatureTriOffsets(featureTriOffsets)
+  , m_FeatureTris(featureTris)
+  , m_FeatureSlots(featureSlots)
+  , m_NeighborOffsets(neighborOffsets)
+  , m_Neighbors(neighbors)
+  , m_NeighborEdges(neighborEdges)
+  , m_Flip(flip)
+  , m_Conflicts(conflicts)
+  {
+  }
+  virtual ~FeatureWindingImpl() = default;
+
+  void convert(size_t start, size_t end) const
+  {
+    std::vector<uint64_t> visited;
+    std::vector<uint8_t> relative;
+    std::vector<MeshIndexType> patches;
+    std::vector<size_t> patchStarts;
+    size_t conflicts = 0;
+
+    for(size_t feature = start; feature < end; feature++)
     {
-      return m_NewLabel;
-    }
-    return m_Label;
-  }
+      if(m_Filter->getCancel())
+      {
+        break;
+      }
+      int32_t label = static_cast<int32_t>(feature);
+      MeshIndexType first = m_FeatureTriOffsets[feature];
+      MeshIndexType count = m_FeatureTriOffsets[feature + 1] - first;
+      visited.assign((count + 63) / 64, 0);
+      relative.assign(count, 0);
+      patches.clear();
+      patchStarts.assign(1, 0);
+
+      for(MeshIndexType seed = 0; seed < count; seed++)
+      {
+        if((visited[seed / 64] & (1ULL << (seed % 64))) != 0)
+        {
+          continue;
+        }
+        visited[seed / 64] |= (1ULL << (seed % 64));
+        patches.push_back(seed);
 
-  // -----------------------------------------------------------------------------
-  void setStartIndex(const size_t& value)
-  {
-    m_StartIndex = value;
-  }
+        // Walk the patch breadth first. relative holds whether a triangle must be flipped relative to its stored winding.
+        for(size_t head = patchStarts.back(); head < patches.size(); head++)
+        {
+          MeshIndexType local = patches[head];
+          MeshIndexType t = m_FeatureTris[first + local];
+          bool reversedT = (m_FaceLabels[t * 2] != label);
+
+          // An edge shared with more than one other triangle of the feature is a pinch point of the surface
+          // and says nothing about the winding, so the walk only crosses edges with a single partner
+          int32_t edgePartners[3] = {0, 0, 0};
+          for(MeshIndexType k = m_NeighborOffsets[t]; k < m_NeighborOffsets[t + 1]; k++)
+          {
+            MeshIndexType n = m_Neighbors[k];
+            if(m_FaceLabels[n * 2] == label || m_FaceLabels[n * 2 + 1] == label)
+            {
+              edgePartners[m_NeighborEdges[k]]++;
+            }
+          }
 
-  // -----------------------------------------------------------------------------
-  size_t getStartIndex() const
-  {
-    return m_StartIndex;
-  }
+          for(MeshIndexType k = m_NeighborOffsets[t]; k < m_NeighborOffsets[t + 1]; k++)
+          {
+            MeshIndexType n = m_Neighbors[k];
+            bool reversedN = (m_FaceLabels[n * 2] != label);
+            if((reversedN && m_FaceLabels[n * 2 + 1] != label) || edgePartners[m_NeighborEdges[k]] != 1)
+            {
+              continue;
+            }
+            // Direction of the shared edge a->b in both triangles as seen from this feature
+            uint8_t e = m_NeighborEdges[k];
+            MeshIndexType a = m_Triangles[t * 3 + e];
+            MeshIndexType b = m_Triangles[t * 3 + (e + 1) % 3];
+            MeshIndexType* nVerts = m_Triangles + n * 3;
+            int32_t p = (nVerts[0] == a) ? 0 : ((nVerts[1] == a) ? 1 : 2);
+            bool forwardT = !reversedT;
+            bool forwardN = (nVerts[(p + 1) % 3] == b) != reversedN;
+            uint8_t expected = relative[local] ^ static_cast<uint8_t>(forwardT == forwardN);
+
+            MeshIndexType nLocal = m_FeatureSlots[n * 2 + (reversedN ? 1 : 0)];
+            if((visited[nLocal / 64] & (1ULL << (nLocal % 64))) == 0)
+            {
+              visited[nLocal / 64] |= (1ULL << (nLocal % 64));
+              relative[nLocal] = expected;
+              patches.push_back(nLocal);
+            }
+            else if(relative[nLocal] != expected && t < n)
+            {
+              conflicts++;
+            }
+          }
+        }
 
-  // -----------------------------------------------------------------------------
-  void setPrimed(bool value)
-  {
-    m_Primed = value;
-  }
+        patchStarts.push_back(patches.size());
+      }
 
-  // -----------------------------------------------------------------------------
-  bool getPrimed() const
-  {
-    return m_Primed;
-  }
+      // A shell that lies inside an odd number of the other shells of the feature bounds a cavity. Its normals point
+      // out of the feature into the cavity, so it has to enclose a negative volume instead of a positive one.
+      size_t numPatches = patchStarts.size() - 1;
+      for(size_t p = 0; p < numPatches; p++)
+      {
+        bool cavity = false;
+        if(numPatches > 1)
+        {
+          double point[3] = {0.0, 0.0, 0.0};
+          patchPoint(first, patches[patchStarts[p]], point);
+          for(size_t q = 0; q < numPatches; q++)
+          {
+            if(q != p && std::abs(windingNumber(label, first, patches, patchStarts[q], patchStarts[q + 1], relative, point)) > 0.5)
+            {
+              cavity = !cavity;
+            }
+          }
+        }
+        if((patchVolume(label, first, patches, patchStarts[p], patchStarts[p + 1], relative) < 0.0) != cavity)
+        {
+          for(size_t i = patchStarts[p]; i < patchStarts[p + 1]; i++)
+          {
+            relative[patches[i]] ^= 1;
+          }
+        }
+      }
 
-  // -----------------------------------------------------------------------------
-  void setNewLabel(int32_t value)
-  {
-    m_NewLabel = value;
+      for(MeshIndexType local : patches)
+      {
+        MeshIndexType t = m_FeatureTris[first + local];
+        if(std::max(m_FaceLabels[t * 2], m_FaceLabels[t * 2 + 1]) == label)
+        {
+          m_Flip[t] = relative[local];
+        }
+      }
+    }
+    m_Conflicts += conflicts;
   }
 
-  // -----------------------------------------------------------------------------
-  int32_t getNewLabel() const
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
   {
-    return m_NewLabel;
+    convert(r.begin(), r.end());
   }
+#endif
 
-  // -----------------------------------------------------------------------------
-  void setRelabeled(bool value)
-  {
-    m_Relabeled = value;
-  }
+private:
+  AbstractFilter* m_Filter;
+  MeshIndexType* m_Triangles;
+  float* m_Vertices;
+  int32_t* m_FaceLabels;
+  const std::vector<MeshIndexType>& m_FeatureTriOffsets;
+  const std::vector<MeshIndexType>& m_FeatureTris;
+  const std::vector<MeshIndexType>& m_FeatureSlots;
+  const std::vector<MeshIndexType>& m_NeighborOffsets;
+  const std::vector<MeshIndexType>& m_Neighbors;
+  const std::vector<uint8_t>& m_NeighborEdges;
+  std::vector<uint8_t>& m_Flip;
+  std::atomic<size_t>& m_Conflicts;
 
-  // -----------------------------------------------------------------------------
-  bool getRelabeled() const
+  /**
+   * @brief orientedTriangle Returns the vertices of a triangle wound as seen from the feature and flipped when flipped is set
+   */
+  void orientedTriangle(int32_t label, MeshIndexType t, bool flipped, MeshIndexType verts[3]) const
   {
-    return m_Relabeled;
+    bool reversed = (m_FaceLabels[t * 2] != label) != flipped;
+    verts[0] = m_Triangles[t * 3 + (reversed ? 2 : 0)];
+    verts[1] = m_Triangles[t * 3 + 1];
+    verts[2] = m_Triangles[t * 3 + (reversed ? 0 : 2)];
   }
 
-  QSet<int32_t> m_Faces;
-  QSet<int32_t> m_OriginalFaceList;
-
   /**
-   *
-   * @param mesh
-   * @param masterVisited
-   * @return
+   * @brief patchVolume Computes six times the signed volume enclosed by the patches[begin, end) when every triangle is
+   * wound as seen from the feature and flipped where relative is set. The vertices are taken relative to the first
+   * vertex of the patch to keep the sum accurate far from the origin.
    */
-  Pointer relabelFaces(Mesh::Pointer mesh, DataArray<int32_t>::Pointer masterFaceListPtr, const QVector<bool>& masterVisited)
+  double patchVolume(int32_t label, MeshIndexType first, const std::vector<MeshIndexType>& patches, size_t begin, size_t end, const std::vector<uint8_t>& relative) const
   {
-    size_t triangleIndex = *(m_Faces.begin());
-    int32_t newLabel = mesh->getMaxLabel() + 1;
-    mesh->incrementMaxLabel();
-    int32_t* masterFaceList = masterFaceListPtr->getPointer(0);
-    LabelVisitorInfo::Pointer p = LabelVisitorInfo::New(m_Label, triangleIndex);
-
-    p->setPrimed(false);
-    p->setNewLabel(newLabel);
-    p->setRelabeled(true);
-    p->m_Faces = m_Faces;            // This will make a copy of the current set of triangles
-    p->m_OriginalFaceList = m_Faces; // Make a copy that does NOT get updated
-    bool seedIsSet = false;
-    for(QSet<int32_t>::iterator triIter = p->m_Faces.begin(); triIter != p->m_Faces.end(); ++triIter)
+    float* origin = m_Vertices + m_Triangles[m_FeatureTris[first + patches[begin]] * 3] * 3;
+    double volume = 0.0;
+    for(size_t i = begin; i < end; i++)
     {
-      if(masterFaceList[(*triIter) * 2] == m_Label)
-      {
-        masterFaceList[(*triIter) * 2] = newLabel;
-      }
-      if(masterFaceList[(*triIter) * 2 + 1] == m_Label)
-      {
-        masterFaceList[(*triIter) * 2 + 1] = newLabel;
-      }
-      if(masterVisited[*triIter])
+      MeshIndexType local = patches[i];
+      MeshIndexType verts[3] = {0, 0, 0};
+      orientedTriangle(label, m_FeatureTris[first + local], relative[local] != 0, verts);
+      double p[3][3];
+      for(size_t v = 0; v < 3; v++)
       {
-        p->setStartIndex(*triIter);
-        seedIsSet = true;
+        for(size_t c = 0; c < 3; c++)
+        {
+          p[v][c] = static_cast<double>(m_Vertices[verts[v] * 3 + c]) - origin[c];
+        }
       }
+      volume += p[0][0] * (p[1][1] * p[2][2] - p[1][2] * p[2][1]) + p[0][1] * (p[1][2] * p[2][0] - p[1][0] * p[2][2]) + p[0][2] * (p[1][0] * p[2][1] - p[1][1] * p[2][0]);
     }
-    if(seedIsSet)
+    return volume;
+  }
+
+  /**
+   * @brief patchPoint Returns the centroid of a triangle of the patch, which lies on that patch but on no other patch
+   */
+  void patchPoint(MeshIndexType first, MeshIndexType local, double point[3]) const
+  {
+    MeshIndexType t = m_FeatureTris[first + local];
+    for(size_t c = 0; c < 3; c++)
     {
-      p->setPrimed(true);
+      point[c] = (static_cast<double>(m_Vertices[m_Triangles[t * 3] * 3 + c]) + m_Vertices[m_Triangles[t * 3 + 1] * 3 + c] + m_Vertices[m_Triangles[t * 3 + 2] * 3 + c]) / 3.0;
     }
-
-    return p;
   }
 
   /**
-   *
-   * @param mesh
+   * @brief windingNumber Computes the winding number of the patches[begin, end) around the point from the solid angles
+   * of its triangles. It is close to +-1 for a point inside a closed patch and close to 0 for a point outside of it.
    */
-  void revertFaceLabels(DataArray<int32_t>::Pointer masterFaceListPtr)
+  double windingNumber(int32_t label, MeshIndexType first, const std::vector<MeshIndexType>& patches, size_t begin, size_t end, const std::vector<uint8_t>& relative, const double point[3]) const
   {
-    int32_t* masterFaceList = masterFaceListPtr->getPointer(0);
-
-    if(m_Relabeled == true)
+    double solidAngle = 0.0;
+    for(size_t i = begin; i < end; i++)
     {
-      //  qDebug() << "    Reverting Label " << m_NewLabel << " To " << m_Label << "\n";
-      for(QSet<int32_t>::iterator triIter = m_OriginalFaceList.begin(); triIter != m_OriginalFaceList.end(); ++triIter)
+      MeshIndexType local = patches[i];
+      MeshIndexType verts[3] = {0, 0, 0};
+      orientedTriangle(label, m_FeatureTris[first + local], relative[local] != 0, verts);
+      double p[3][3];
+      double length[3];
+      for(size_t v = 0; v < 3; v++)
       {
-        if(masterFaceList[(*triIter) * 2] == m_NewLabel)
+        for(size_t c = 0; c < 3; c++)
         {
-          masterFaceList[(*triIter) * 2] = m_Label;
-        }
-        if(masterFaceList[(*triIter) * 2 + 1] == m_NewLabel)
-        {
-          masterFaceList[(*triIter) * 2 + 1] = m_Label;
+          p[v][c] = static_cast<double>(m_Vertices[verts[v] * 3 + c]) - point[c];
         }
+        length[v] = std::sqrt(p[v][0] * p[v][0] + p[v][1] * p[v][1] + p[v][2] * p[v][2]);
       }
-      m_Relabeled = false;
-      m_NewLabel = m_Label;
-      m_Primed = false;
+      double triple = p[0][0] * (p[1][1] * p[2][2] - p[1][2] * p[2][1]) + p[0][1] * (p[1][2] * p[2][0] - p[1][0] * p[2][2]) + p[0][2] * (p[1][0] * p[2][1] - p[1][1] * p[2][0]);
+      double dot01 = p[0][0] * p[1][0] + p[0][1] * p[1][1] + p[0][2] * p[1][2];
+      double dot02 = p[0][0] * p[2][0] + p[0][1] * p[2][1] + p[0][2] * p[2][2];
+      double dot12 = p[1][0] * p[2][0] + p[1][1] * p[2][1] + p[1][2] * p[2][2];
+      double denominator = length[0] * length[1] * length[2] + dot01 * length[2] + dot02 * length[1] + dot12 * length[0];
+      solidAngle += 2.0 * std::atan2(triple, denominator);
     }
+    return solidAngle / (4.0 * SIMPLib::Constants::k_PiD);
   }
-
-protected:
-  LabelVisitorInfo(int32_t label, size_t tIndex)
-  : m_Label(label)
-  , m_StartIndex(tIndex)
-  , m_Primed(false)
-  , m_NewLabel(label)
-  , m_Relabeled(false)
-  {
-  }
-
-private:
-  size_t m_StartIndex = {};
-  bool m_Primed = {};
-  int32_t m_NewLabel = {};
-  bool m_Relabeled = {};
-
-  LabelVisitorInfo(const LabelVisitorInfo&); // Copy Constructor Not Implemented
-  void operator=(const LabelVisitorInfo&);   // Operator '=' Not Implemented
 };
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
 VerifyTriangleWinding::VerifyTriangleWinding()
-: m_SurfaceDataContainerName(SIMPL::Defaults::DataContainerName)
-, m_SurfaceMeshNodeFacesArrayName(SIMPL::VertexData::SurfaceMeshNodeFaces)
-, m_SurfaceMeshFaceLabelsArrayPath(SIMPL::Defaults::DataContainerName, SIMPL::Defaults::FaceAttributeMatrixName, SIMPL::FaceData::SurfaceMeshFaceLabels)
-, m_SurfaceMeshFaceLabelsArrayName(SIMPL::FaceData::SurfaceMeshFaceLabels)
-, m_SurfaceMeshFaceLabels(nullptr)
+: m_SurfaceMeshFaceLabelsArrayPath(SIMPL::Defaults::TriangleDataContainerName, SIMPL::Defaults::FaceAttributeMatrixName, SIMPL::FaceData::SurfaceMeshFaceLabels)
 {
 }
 
@@ -327,13 +414,12 @@ VerifyTriangleWinding::~VerifyTriangleWinding() = default;
 // -----------------------------------------------------------------------------
 void VerifyTriangleWinding::setupFilterParameters()
 {
-  SurfaceMeshFilter::setupFilterParameters();
   FilterParameterVectorType parameters;
-
-  parameters.push_back(SeparatorFilterParameter::New("Required Information", FilterParameter::Uncategorized));
-  parameters.push_back(DataArraySelectionFilterParameter::New("SurfaceMeshFaceLabels", "SurfaceMeshFaceLabelsArrayPath", getSurfaceMeshFaceLabelsArrayPath(), FilterParameter::Uncategorized,
-                                                              SIMPL_BIND_SETTER(VerifyTriangleWinding, this, SurfaceMeshFaceLabelsArrayPath),
-                                                              SIMPL_BIND_GETTER(VerifyTriangleWinding, this, SurfaceMeshFaceLabelsArrayPath)));
+  parameters.push_back(SeparatorFilterParameter::New("Face Data", FilterParameter::RequiredArray));
+  {
+    DataArraySelectionFilterParameter::RequirementType req = DataArraySelectionFilterParameter::CreateRequirement(SIMPL::TypeNames::Int32, 2, AttributeMatrix::Type::Face, IGeometry::Type::Triangle);
+    parameters.push_back(SIMPL_NEW_DA_SELECTION_FP("Face Labels", SurfaceMeshFaceLabelsArrayPath, FilterParameter::RequiredArray, VerifyTriangleWinding, req));
+  }
   setFilterParameters(parameters);
 }
 
@@ -359,65 +445,31 @@ void VerifyTriangleWinding::initialize()
 // -----------------------------------------------------------------------------
 void VerifyTriangleWinding::dataCheck()
 {
-  DataContainer::Pointer sm = getDataContainerArray()->getPrereqDataContainer(this, getSurfaceMeshFaceLabelsArrayPath().getDataContainerName(), false);
-  if(getErrorCondition() < 0)
-  {
-    return;
-  }
-
-  IGeometry::Pointer geom = sm->getGeometry();
-  if(nullptr == geom.get())
-  {
-    QString ss = QObject::tr("DataContainer Geometry is missing.");
-    setErrorCondition(-385, ss);
-    return;
-  }
+  clearErrorCode();
+  clearWarningCode();
+  initialize();
 
-  TriangleGeom::Pointer triangles = sm->getGeometryAs<TriangleGeom>();
-  if(nullptr == triangles.get())
+  TriangleGeom::Pointer triangles = getDataContainerArray()->getPrereqGeometryFromDataContainer<TriangleGeom>(this, getSurfaceMeshFaceLabelsArrayPath().getDataContainerName());
+  if(getErrorCode() < 0)
   {
-    QString ss = QObject::tr("DataContainer Geometry is not compatible. The Geometry type is %1").arg(geom->getGeometryTypeAsString());
-    setErrorCondition(-384, ss);
     return;
   }
 
-  // We MUST have Nodes
-  if(nullptr == triangles->getVertices().get())
+  std::vector<size_t> cDims(1, 2);
+  m_SurfaceMeshFaceLabelsPtr = getDataContainerArray()->getPrereqArrayFromPath<DataArray<int32_t>>(this, getSurfaceMeshFaceLabelsArrayPath(), cDims);
+  if(nullptr != m_SurfaceMeshFaceLabelsPtr.lock())
   {
-    setErrorCondition(-386, "DataContainer Geometry missing Vertices");
-  }
-  // We MUST have Triangles defined also.
-  if(nullptr == triangles->getTriangles().get())
-  {
-    setErrorCondition(-387, "DataContainer Geometry missing Triangles");
-  }
-  else
+    m_SurfaceMeshFaceLabels = m_SurfaceMeshFaceLabelsPtr.lock()->getPointer(0);
+  } /* Now assign the raw pointer to data from the DataArray<T> object */
+  if(getErrorCode() < 0)
   {
-    std::vector<size_t> dims(1, 2);
-    m_SurfaceMeshFaceLabelsPtr = getDataContainerArray()->getPrereqArrayFromPath<DataArray<int32_t>, AbstractFilter>(this, getSurfaceMeshFaceLabelsArrayPath(), dims);
-    if(nullptr != m_SurfaceMeshFaceLabelsPtr.lock())
-    {
-      m_SurfaceMeshFaceLabels = m_SurfaceMeshFaceLabelsPtr.lock()->getPointer(0);
-    } /* Now assign the raw pointer to data from the DataArray<T> object */
+    return;
   }
-}
-
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-void VerifyTriangleWinding::preflight()
-{
-  setInPreflight(true);
-  emit preflightAboutToExecute();
-  emit updateFilterParameters(this);
-  dataCheck();
-  emit preflightExecuted();
-  setInPreflight(false);
 
-  /* *** THIS FILTER NEEDS TO BE CHECKED *** */
-  QString ss = QObject::tr("Filter is NOT updated for IGeometry Redesign. A Programmer needs to check this filter. Please report this to the DREAM3D developers.");
-  setErrorCondition(0xABABABAB, ss);
-  /* *** THIS FILTER NEEDS TO BE CHECKED *** */
+  QVector<IDataArray::Pointer> dataArrays;
+  dataArrays.push_back(triangles->getTriangles());
+  dataArrays.push_back(m_SurfaceMeshFaceLabelsPtr.lock());
+  getDataContainerArray()->validateNumberOfTuples(this, dataArrays);
 }
 
 // -----------------------------------------------------------------------------
@@ -428,445 +480,160 @@ void VerifyTriangleWinding::execute()
   clearErrorCode();
   clearWarningCode();
   dataCheck();
-  if(getErrorCondition() < 0)
+  if(getErrorCode() < 0)
   {
     return;
   }
 
-  DataContainer::Pointer sm = getDataContainerArray()->getDataContainer(getSurfaceMeshFaceLabelsArrayPath().getDataContainerName());
-
-  FaceArray::Pointer facesPtr = sm->getFaces();
-
-  notifyStatusMessage("Generating Face List for each Node");
-  // Make sure the Face Connectivity is created because the FindNRing algorithm needs this and will
-  // assert if the data is NOT in the SurfaceMesh Data Container
-  if(nullptr == facesPtr->getFacesContainingVert())
-  {
-    facesPtr->findFacesContainingVert();
-  }
-  if(getCancel())
-  {
-    return;
-  }
-  if(nullptr == facesPtr->getFaceNeighbors())
-  {
-    facesPtr->findFaceNeighbors();
-  }
+  size_t conflicts = verifyTriangleWinding();
   if(getCancel())
   {
     return;
   }
-  if(facesPtr->getUniqueEdges() == nullptr)
+  if(conflicts > 0)
   {
-    facesPtr->generateUniqueEdgeIds();
-  }
-
-  // Execute the actual verification step.
-  notifyStatusMessage("Generating Connectivity Complete. Starting Analysis");
-  verifyTriangleWinding();
-}
-
-// -----------------------------------------------------------------------------
-// Groups the triangles according to which Feature they are a part of
-// -----------------------------------------------------------------------------
-void VerifyTriangleWinding::getLabelTriangelMap(LabelFaceMap_t& trianglesToLabelMap)
-{
-  DataContainer::Pointer sm = getDataContainerArray()->getDataContainer(getSurfaceMeshFaceLabelsArrayPath().getDataContainerName());
-  FaceArray::Pointer masterFaceList = sm->getFaces();
-  if(nullptr == masterFaceList.get())
-  {
-    setErrorCondition(-556, "The SurfaceMesh DataContainer Does NOT contain Faces");
-    return;
-  }
-
-  int ntri = masterFaceList->getNumberOfTuples();
-  // FaceArray::Face_t* triangles = masterFaceList->getPointer(0);
-
-  // Loop over all the triangles and group them according to which feature/region they are a part of
-  for(int t = 0; t < ntri; ++t)
-  {
-    int32_t* label = m_SurfaceMeshFaceLabels + t * 2;
-    trianglesToLabelMap[label[0]].insert(t);
-    trianglesToLabelMap[label[1]].insert(t);
+    QString ss = QObject::tr("%1 pairs of neighboring triangles could not be wound consistently. The surface mesh is not manifold or not orientable around them.").arg(conflicts);
+    setWarningCondition(-5555, ss);
   }
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-int32_t VerifyTriangleWinding::getSeedTriangle(int32_t label, QSet<int32_t>& triangleIndices)
+size_t VerifyTriangleWinding::verifyTriangleWinding()
 {
   DataContainer::Pointer sm = getDataContainerArray()->getDataContainer(getSurfaceMeshFaceLabelsArrayPath().getDataContainerName());
+  TriangleGeom::Pointer triangleGeom = sm->getGeometryAs<TriangleGeom>();
 
-  VertexArray::Vert_t* verts = sm->getVertices()->getPointer(0);
-  FaceArray::Face_t* triangles = sm->getFaces()->getPointer(0);
+  MeshIndexType numTris = triangleGeom->getNumberOfTris();
+  MeshIndexType numVerts = triangleGeom->getNumberOfVertices();
+  MeshIndexType* triangles = triangleGeom->getTriPointer(0);
+  float* vertices = triangleGeom->getVertexPointer(0);
 
-  float xMax = std::numeric_limits<float>::min();
-  float avgX = 0.0f;
-  int32_t seedFaceIdx = 0;
+  notifyStatusMessage("Generating Triangle Connectivity");
 
-  for(QSet<int32_t>::iterator iter = triangleIndices.begin(); iter != triangleIndices.end(); ++iter)
+  // Vertex to triangle connectivity as flat offset and list arrays
+  std::vector<MeshIndexType> vertTriOffsets(numVerts + 1, 0);
+  for(MeshIndexType i = 0; i < numTris * 3; i++)
   {
-    int32_t i = *iter;
-    avgX = (verts[triangles[i].verts[0]].pos[0] + verts[triangles[i].verts[1]].pos[0] + verts[triangles[i].verts[2]].pos[0]) / 3.0;
-    if(avgX > xMax)
-    {
-      xMax = avgX;
-      seedFaceIdx = i;
-    }
+    vertTriOffsets[triangles[i] + 1]++;
   }
-  // Now we have the "right most" triangle based on x component of the centroid of the triangles for this label.
-  // Lets now figure out if the normal points generally in the positive or negative X direction.
-
-  int32_t* faceLabel = m_SurfaceMeshFaceLabels + seedFaceIdx * 2;
-  VectorType normal;
-  if(faceLabel[0] == label)
+  for(MeshIndexType v = 0; v < numVerts; v++)
   {
-    normal = TriangleOps::computeNormal(verts[triangles[seedFaceIdx].verts[0]], verts[triangles[seedFaceIdx].verts[1]], verts[triangles[seedFaceIdx].verts[2]]);
+    vertTriOffsets[v + 1] += vertTriOffsets[v];
   }
-  else
+  std::vector<MeshIndexType> vertTris(vertTriOffsets[numVerts]);
   {
-    normal = TriangleOps::computeNormal(verts[triangles[seedFaceIdx].verts[2]], verts[triangles[seedFaceIdx].verts[1]], verts[triangles[seedFaceIdx].verts[0]]);
+    std::vector<MeshIndexType> vertFill(vertTriOffsets.begin(), vertTriOffsets.end() - 1);
+    for(MeshIndexType t = 0; t < numTris; t++)
+    {
+      for(size_t i = 0; i < 3; i++)
+      {
+        vertTris[vertFill[triangles[t * 3 + i]]++] = t;
+      }
+    }
   }
 
-  if(normal.x < 0.0f)
+  // Triangles that share an edge, together with the edge of the first triangle they share
+  std::vector<MeshIndexType> neighborOffsets(numTris + 1, 0);
+  std::vector<MeshIndexType> neighbors;
+  std::vector<uint8_t> neighborEdges;
+  for(int32_t pass = 0; pass < 2; pass++)
   {
-    ReverseTriangleWinding::Pointer reverse = ReverseTriangleWinding::New();
-    reverse->setDataContainerArray(getDataContainerArray());
-    connect(reverse.get(), SIGNAL(filterGeneratedMessage(const PipelineMessage&)), this, SLOT(broadcastPipelineMessage(const PipelineMessage&)));
-    reverse->setMessagePrefix(getMessagePrefix());
-    reverse->execute();
-    if(reverse->getErrorCondition() < 0)
-    {
-      setErrorCondition(reverse->getErrorCondition(), "Error Reversing the Face Winding");
-      return -1;
-    }
-    if(faceLabel[0] == label)
-    {
-      normal = TriangleOps::computeNormal(verts[triangles[seedFaceIdx].verts[0]], verts[triangles[seedFaceIdx].verts[1]], verts[triangles[seedFaceIdx].verts[2]]);
-    }
-    else
-    {
-      normal = TriangleOps::computeNormal(verts[triangles[seedFaceIdx].verts[2]], verts[triangles[seedFaceIdx].verts[1]], verts[triangles[seedFaceIdx].verts[0]]);
-    }
-    if(normal.x < 0.0f)
+    TriangleEdgeNeighborsImpl neighborsImpl(triangles, vertTriOffsets, vertTris, neighborOffsets, neighbors, neighborEdges, pass == 1);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numTris), neighborsImpl, tbb::auto_partitioner());
+#else
+    neighborsImpl.convert(0, numTris);
+#endif
+    if(pass == 0)
     {
-      setErrorCondition(-802, "Error After attempted triangle winding reversal. Face normal is still oriented in wrong direction.");
-      seedFaceIdx = -1;
+      for(MeshIndexType t = 0; t < numTris; t++)
+      {
+        neighborOffsets[t + 1] += neighborOffsets[t];
+      }
+      neighbors.resize(neighborOffsets[numTris]);
+      neighborEdges.resize(neighborOffsets[numTris]);
     }
   }
-
-  return seedFaceIdx;
-}
-
-#define PRINT_FACE(index, triangles)                                                                                                                                                                   \
-  qDebug() << " " << triangles[index].verts[0] << " " << triangles[index].verts[1] << " " << triangles[index].verts[2] << "\n";                                                                        \
-  qDebug() << "Face ID: " << index << "\n";                                                                                                                                                            \
-  qDebug() << "Face.labels[0] " << triangles[index].labels[0] << "\n";                                                                                                                                 \
-  qDebug() << "Face.labels[1] " << triangles[index].labels[1] << "\n";
-
-#define PRINT_VERT(index) qDebug() << index << " " << verts[index].pos[0] << " " << verts[index].pos[1] << " " << verts[index].pos[2] << "\n";
-
-#define PRINT_NORMAL(i, nodes, triangles)                                                                                                                                                              \
-  {                                                                                                                                                                                                    \
-    VectorType normal = TriangleOps::computeNormal(nodes[triangles[i].verts[0]], nodes[triangles[i].verts[1]], nodes[triangles[i].verts[2]]);                                                          \
-    qDebug() << normal.x << " " << normal.y << " " << normal.z << "\n";                                                                                                                                \
-  }
-
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
-int VerifyTriangleWinding::verifyTriangleWinding()
-{
-  int err = 0;
-  //  qDebug() << "--------------------------------------------------------------" << "\n";
-  //  FaceListType& masterFaceList = *(mesh->triangles());  // Create a reference variable for better syntax
-  //  NodeVector&       masterNodeList = *(mesh->nodes());
-
-  DataContainer::Pointer sm = getDataContainerArray()->getDataContainer(getSurfaceMeshFaceLabelsArrayPath().getDataContainerName());
-  // get the triangle definitions - use the pointer to the start of the Struct Array
-  FaceArray::Pointer masterFaceList = sm->getFaces();
-  if(nullptr == masterFaceList.get())
+  vertTris = std::vector<MeshIndexType>();
+  vertTriOffsets = std::vector<MeshIndexType>();
+  if(getCancel())
   {
-    setErrorCondition(-556, "The SurfaceMesh DataContainer Does NOT contain Faces");
-    return getErrorCondition();
+    return 0;
   }
-  FaceArray::Face_t* triangles = masterFaceList->getPointer(0);
-
-  int numFaces = masterFaceList->getNumberOfTuples();
 
-  VertexArray::Pointer masterNodeListPtr = sm->getVertices();
-  if(nullptr == masterNodeListPtr.get())
+  // Group the triangles by feature. Labels of 0 and below mark the outside of the volume and are not walked.
+  int32_t maxLabel = 0;
+  for(MeshIndexType i = 0; i < numTris * 2; i++)
   {
-    setErrorCondition(-555, "The SurfaceMesh DataContainer Does NOT contain Nodes");
-    return getErrorCondition();
+    maxLabel = std::max(maxLabel, m_SurfaceMeshFaceLabels[i]);
   }
-
-  Mesh::Pointer mesh = Mesh::New();
-  int min = std::numeric_limits<int32_t>::max();
-  int max = std::numeric_limits<int32_t>::min();
-  // Set the min and Max labels in the Mesh class;
-  for(int n = 0; n < numFaces; ++n)
+  std::vector<MeshIndexType> featureTriOffsets(static_cast<size_t>(maxLabel) + 2, 0);
+  for(MeshIndexType t = 0; t < numTris; t++)
   {
-    int l = m_SurfaceMeshFaceLabels[n * 2];
-    if(l < min)
-    {
-      min = l;
-    }
-    if(l > max)
+    int32_t l0 = m_SurfaceMeshFaceLabels[t * 2];
+    int32_t l1 = m_SurfaceMeshFaceLabels[t * 2 + 1];
+    if(l0 > 0)
     {
-      max = l;
+      featureTriOffsets[l0 + 1]++;
     }
-    l = m_SurfaceMeshFaceLabels[n * 2 + 1];
-    if(l < min)
-    {
-      min = l;
-    }
-    if(l > max)
-    {
-      max = l;
-    }
-  }
-  mesh->setMaxLabel(max);
-  mesh->setMinLabel(min);
-
-  // Get a grouping of triangles by feature ID
-  LabelFaceMap_t trianglesToLabelMap;
-  getLabelTriangelMap(trianglesToLabelMap);
-  //  for(LabelFaceMap_t::iterator iter = trianglesToLabelMap.begin(); iter != trianglesToLabelMap.end(); ++iter)
-  //  {
-  //    qDebug() << "Feature: " << iter.key() << "   Face Count: " << iter.value().size() << "\n";
-  //  }
-
-  int32_t currentLabel = 0;
-
-  // Find the first Non Zero Feature Id (Label). This is going to be our starting feature.
-  for(LabelFaceMap_t::iterator iter = trianglesToLabelMap.begin(); iter != trianglesToLabelMap.end(); ++iter)
-  {
-    if(iter.key() > 0)
+    if(l1 > 0 && l1 != l0)
     {
-      currentLabel = iter.key();
-      break;
+      featureTriOffsets[l1 + 1]++;
     }
   }
-
-  std::deque<LabelVisitorInfo::Pointer> labelObjectsToVisit;
-
-  // Keeps a list of all the triangles that have been visited.
-  QVector<bool> masterVisited(masterFaceList->getNumberOfTuples(), false);
-
-  STDEXT::hash_set<int32_t> labelsVisitedSet;
-  STDEXT::hash_set<int32_t> labelsToVisitSet;
-  int32_t triIndex = 0;
-
-  bool firstLabel = false;
-
-  // Get the first triangle in the list
-  // FaceArray::Face_t& triangle = triangles[triIndex];
-
-  // Now that we have the starting Feature, lets try and get a seed triangle that is oriented in the proper direction.
-  /* Make sure the winding is correct on the first triangle of the first label that will be checked. */
-  triIndex = getSeedTriangle(currentLabel, trianglesToLabelMap[currentLabel]);
-  if(getErrorCondition() < 0 || triIndex < 0)
+  for(int32_t l = 0; l <= maxLabel; l++)
   {
-    return -1;
+    featureTriOffsets[l + 1] += featureTriOffsets[l];
   }
-
-  LabelVisitorInfo::Pointer ldo = LabelVisitorInfo::New(currentLabel, triIndex);
-  labelObjectsToVisit.push_back(ldo);
-  LabelVisitorInfo::Pointer curLdo = LabelVisitorInfo::NullPointer();
-  labelsToVisitSet.insert(currentLabel);
-
-  float total = (float)(trianglesToLabelMap.size());
-  float curPercent = 0.0;
-  int progressIndex = 0;
-
-  // Start looping on all the Face Labels (Feature Ids) values
-  while(labelObjectsToVisit.empty() == false)
+  // featureSlots holds the position of each triangle within the list of the feature on either side of it
+  std::vector<MeshIndexType> featureTris(featureTriOffsets[maxLabel + 1]);
+  std::vector<MeshIndexType> featureSlots(numTris * 2, 0);
   {
-    if(getCancel())
-    {
-      return -1;
-    }
-    if((progressIndex / total * 100.0f) > (curPercent))
-    {
-      QString ss = QObject::tr("%1% Complete").arg(static_cast<int>(progressIndex / total * 100.0f));
-      notifyStatusMessage(ss);
-      curPercent += 5.0f;
-    }
-    ++progressIndex;
-
-    QMap<int32_t, int32_t> neighborlabels;
-
-    curLdo = labelObjectsToVisit.front();
-    labelObjectsToVisit.pop_front();
-    currentLabel = curLdo->getLabel();
-    labelsToVisitSet.erase(currentLabel);
-    labelsVisitedSet.insert(currentLabel);
-    if(curLdo->getPrimed() == false && curLdo->getRelabeled() == false)
-    {
-      curLdo->m_Faces = trianglesToLabelMap[currentLabel];
-      curLdo->setPrimed(true);
-    }
-    else if(curLdo->getPrimed() == false && curLdo->getRelabeled() == true)
-    {
-      //    qDebug() << "    Reint32_ting could not find a starting index. Using first index in triangle set" << "\n";
-      curLdo->setStartIndex(*(curLdo->m_Faces.begin()));
-      curLdo->setPrimed(true);
-    }
-
-    if(firstLabel == true)
-    {
-      triIndex = 0;
-      firstLabel = false;
-    }
-    else
-    {
-      triIndex = curLdo->getStartIndex();
-    }
-    // Get the number of triangles remaining to be visited for the current label
-    QSet<int32_t>::size_type nLabelTriStart = curLdo->m_Faces.size();
-
-    STDEXT::hash_set<int> localVisited;
-    std::deque<int> triangleDeque;
-    // FaceArray::Face_t& triangle = triangles[triIndex];
-    triangleDeque.push_back(triIndex);
-
-    while(triangleDeque.empty() == false)
+    std::vector<MeshIndexType> featureFill(featureTriOffsets.begin(), featureTriOffsets.end() - 1);
+    for(MeshIndexType t = 0; t < numTris; t++)
     {
-      int32_t triangleIndex = triangleDeque.front();
-      FaceArray::Face_t& triangle = triangles[triangleIndex];
-      int32_t* faceLabel = m_SurfaceMeshFaceLabels + (triangleIndex * 2); // Here we are getting a new pointer offset from the start of the labels array
-
-      //   qDebug() << " $ tIndex: " << triangleIndex << "\n";
-      FaceArray::Pointer facesPtr = sm->getFaces();
-      if(facesPtr == nullptr)
+      int32_t l0 = m_SurfaceMeshFaceLabels[t * 2];
+      int32_t l1 = m_SurfaceMeshFaceLabels[t * 2 + 1];
+      if(l0 > 0)
       {
-        break;
+        featureSlots[t * 2] = featureFill[l0] - featureTriOffsets[l0];
+        featureTris[featureFill[l0]++] = t;
       }
-      // FaceArray::Face_t* faces = facesPtr->getPointer(0);
-
-      QVector<int32_t> adjTris = TriangleOps::findAdjacentTriangles(facesPtr, triangleIndex, m_SurfaceMeshFaceLabelsPtr.lock(), currentLabel);
-
-      for(FaceList_t::iterator adjTri = adjTris.begin(); adjTri != adjTris.end(); ++adjTri)
+      if(l1 > 0 && l1 != l0)
       {
-        // qDebug() << "  ^ AdjTri index: " << *adjTri << "\n";
-        if(masterVisited[*adjTri] == false)
-        {
-          //    qDebug() << "   * Checking Winding: " << *adjTri << "\n";
-          if(TriangleOps::verifyWinding(triangle, triangles[*adjTri], faceLabel, m_SurfaceMeshFaceLabels + (*adjTri * 2), currentLabel) == true)
-          {
-            //   qDebug() << "Face winding flipped for triangle id = " << *adjTri << " Feature Id: " << currentLabel << "\n";
-          }
-        }
-
-        if(localVisited.find(*adjTri) == localVisited.end() && find(triangleDeque.begin(), triangleDeque.end(), *adjTri) == triangleDeque.end())
-        {
-          // qDebug() << "   # Adding to Deque: " << *adjTri << "\n";
-          triangleDeque.push_back(*adjTri);
-          localVisited.insert(*adjTri);
-          masterVisited[*adjTri] = true;
-        }
-      }
-
-      // Just add the neighbor label to a set so we end up with a list of unique
-      // labels that are neighbors to the current label
-      if(currentLabel != faceLabel[0])
-      {
-        neighborlabels.insert(faceLabel[0], triangleIndex);
-      }
-      if(currentLabel != faceLabel[1])
-      {
-        neighborlabels.insert(faceLabel[1], triangleIndex);
-      }
-
-      localVisited.insert(triangleIndex);
-      masterVisited[triangleIndex] = true;
-      curLdo->m_Faces.remove(triangleIndex);
-      triangleDeque.pop_front();
-    } // End of loop to visit all triangles in the 'currentLabel'
-
-    // Find the Next label to push onto the end of the labels List, but ONLY if it is NOT
-    // currently on the list and NOT currently on the label visited list.
-    for(QMap<int32_t, int32_t>::iterator neigh = neighborlabels.begin(); neigh != neighborlabels.end(); ++neigh)
-    {
-      int32_t triangleIndex = neigh.value();
-      int32_t* triangleLabel = m_SurfaceMeshFaceLabels + triangleIndex * 2;
-
-      if(labelsToVisitSet.find(triangleLabel[0]) == labelsToVisitSet.end() && (labelsVisitedSet.find(triangleLabel[0]) == labelsVisitedSet.end()))
-      {
-        // Push the int32_t value into the "set"
-        labelsToVisitSet.insert(triangleLabel[0]);
-        LabelVisitorInfo::Pointer l = LabelVisitorInfo::New(triangleLabel[0], triangleIndex);
-        labelObjectsToVisit.push_back(l);
-        // qDebug() << "    Adding Label " << triangle.labels[0] << " to visit starting at tIndex " << triangleIndex << "\n";
-      }
-      if(labelsToVisitSet.find(triangleLabel[1]) == labelsToVisitSet.end() && (labelsVisitedSet.find(triangleLabel[1]) == labelsVisitedSet.end()))
-      {
-        // Push the int32_t value into the "set"
-        labelsToVisitSet.insert(triangleLabel[1]);
-        LabelVisitorInfo::Pointer l = LabelVisitorInfo::New(triangleLabel[1], triangleIndex);
-        labelObjectsToVisit.push_back(l);
-        //  qDebug() << "    Adding Label " << triangle.labels[1] << " to visit starting at tIndex " << triangleIndex << "\n";
+        featureSlots[t * 2 + 1] = featureFill[l1] - featureTriOffsets[l1];
+        featureTris[featureFill[l1]++] = t;
       }
     }
-
-    QSet<int32_t>::size_type nLabelTriEnd = curLdo->m_Faces.size();
-    if(nLabelTriStart == nLabelTriEnd)
-    {
-      // qDebug() << "    !--!++! No new triangles visited for int32_t " << currentLabel << "\n";
-    }
-    else if(nLabelTriEnd == 0)
-    {
-      //  qDebug() << "    No Faces remain to be visited for label " << "\n";
-      // If this currentLabel was the result of a "relabeling" then revert back to the original
-      // label for those triangles.
-      curLdo->revertFaceLabels(m_SurfaceMeshFaceLabelsPtr.lock());
-    }
-    else
-    {
-      // qDebug() << "    Not all triangles visited for label"  << "\n";
-      // qDebug() << "    " << nLabelTriEnd << " Faces Remaining to be visited" << "\n";
-      // At this point relabel the remaining triangles
-      //      if (currentLabel == 28) {
-      //        qDebug() << "break" << "\n";
-      //      }
-      LabelVisitorInfo::Pointer p = curLdo->relabelFaces(mesh, m_SurfaceMeshFaceLabelsPtr.lock(), masterVisited);
-      labelObjectsToVisit.push_back(p);
-      labelsToVisitSet.insert(p->getLabel());
-      // Revert the current labelVisitorObject to its original label
-      curLdo->revertFaceLabels(m_SurfaceMeshFaceLabelsPtr.lock());
-      // qDebug() << "    New label " << mesh->getMaxLabel() << " added to visit" << "\n";
-    }
-
-  } // End of Loop over each int32_t
-
-  // qDebug() << "Total: "<< total << "\n";
-  // qDebug() << "labelsToVisitSet.size() :" << labelsToVisitSet.size() << "\n";
-  if(labelsToVisitSet.size() != 0)
-  {
-    // qDebug() << " labelsToVisitSet:" << "\n";
-    for(STDEXT::hash_set<int32_t>::iterator iter = labelsToVisitSet.begin(); iter != labelsToVisitSet.end(); ++iter)
-    {
-      // qDebug() << "  int32_t: " << *iter << "\n";
-    }
   }
-  // qDebug() << "labelsVisited.size() :" << labelsVisitedSet.size() << "\n";
 
-  QSet<int32_t> thelabels = TriangleOps::generateUniqueLabels(m_SurfaceMeshFaceLabelsPtr.lock());
-  for(STDEXT::hash_set<int32_t>::iterator iter = labelsVisitedSet.begin(); iter != labelsVisitedSet.end(); ++iter)
+  notifyStatusMessage("Verifying Triangle Winding");
+
+  std::vector<uint8_t> flip(numTris, 0);
+  std::atomic<size_t> conflicts(0);
+  FeatureWindingImpl windingImpl(this, triangles, vertices, m_SurfaceMeshFaceLabels, featureTriOffsets, featureTris, featureSlots, neighborOffsets, neighbors, neighborEdges, flip, conflicts);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  tbb::parallel_for(tbb::blocked_range<size_t>(1, static_cast<size_t>(maxLabel) + 1), windingImpl, tbb::auto_partitioner());
+#else
+  windingImpl.convert(1, static_cast<size_t>(maxLabel) + 1);
+#endif
+  if(getCancel())
   {
-    thelabels.remove(*iter);
+    return 0;
   }
 
-  // qDebug() << "labels NOT visited:" << "\n";
-  for(QSet<int32_t>::iterator iter = thelabels.begin(); iter != thelabels.end(); ++iter)
+  // All features have read the original winding, so the triangles can now be flipped in place
+  for(MeshIndexType t = 0; t < numTris; t++)
   {
-    // qDebug() << "  int32_t: " << *iter << "\n";
+    if(flip[t] != 0)
+    {
+      std::swap(triangles[t * 3], triangles[t * 3 + 2]);
+    }
   }
 
-  // qDebug() << "--------------------------------------------------------------" << "\n";
-  return err;
+  return conflicts;
 }
 
 // -----------------------------------------------------------------------------
@@ -890,6 +657,25 @@ QString VerifyTriangleWinding::getCompiledLibraryName() const
   return SurfaceMeshingConstants::SurfaceMeshingBaseName;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString VerifyTriangleWinding::getBrandingString() const
+{
+  return "SurfaceMeshing";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString VerifyTriangleWinding::getFilterVersion() const
+{
+  QString version;
+  QTextStream vStream(&version);
+  vStream << SurfaceMeshing::Version::Major() << "." << SurfaceMeshing::Version::Minor() << "." << SurfaceMeshing::Version::Patch();
+  return version;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -951,30 +737,6 @@ QString VerifyTriangleWinding::ClassName()
   return QString("VerifyTriangleWinding");
 }
 
-// -----------------------------------------------------------------------------
-void VerifyTriangleWinding::setSurfaceDataContainerName(const QString& value)
-{
-  m_SurfaceDataContainerName = value;
-}
-
-// -----------------------------------------------------------------------------
-QString VerifyTriangleWinding::getSurfaceDataContainerName() const
-{
-  return m_SurfaceDataContainerName;
-}
-
-// -----------------------------------------------------------------------------
-void VerifyTriangleWinding::setSurfaceMeshNodeFacesArrayName(const QString& value)
-{
-  m_SurfaceMeshNodeFacesArrayName = value;
-}
-
-// -----------------------------------------------------------------------------
-QString VerifyTriangleWinding::getSurfaceMeshNodeFacesArrayName() const
-{
-  return m_SurfaceMeshNodeFacesArrayName;
-}
-
 // -----------------------------------------------------------------------------
 void VerifyTriangleWinding::setSurfaceMeshFaceLabelsArrayPath(const DataArrayPath& value)
 {
@@ -32,44 +32,50 @@
  *    United States Prime Contract Navy N00173-07-C-2068
  *
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
-
 #pragma once
 
 #include <memory>
 
-#include <QtCore/QString>
-
 #include "SIMPLib/SIMPLib.h"
 #include "SIMPLib/DataArrays/DataArray.hpp"
-#include "SIMPLib/DataArrays/IDataArray.h"
-
-#include "SurfaceMeshing/SurfaceMeshingConstants.h"
-#include "SurfaceMeshing/SurfaceMeshingFilters/SurfaceMeshFilter.h"
-#include "SurfaceMeshing/SurfaceMeshingVersion.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
 
 #include "SurfaceMeshing/SurfaceMeshingDLLExport.h"
 
 /**
- * @class VerifyTriangleWinding VerifyTriangleWinding.h /SurfaceMeshFilters/VerifyTriangleWinding.h
- * @brief
- * @author
- * @date
- * @version 1.0
+ * @brief The VerifyTriangleWinding class. See [Filter documentation](@ref verifytrianglewinding) for details.
  */
-class SurfaceMeshing_EXPORT VerifyTriangleWinding : public SurfaceMeshFilter
+class SurfaceMeshing_EXPORT VerifyTriangleWinding : public AbstractFilter
 {
   Q_OBJECT
-  //  PYB11_BEGIN_BINDINGS(VerifyTriangleWinding SUPERCLASS SurfaceMeshFilter)
-  //  PYB11_PROPERTY(DataArrayPath SurfaceMeshFaceLabelsArrayPath READ getSurfaceMeshFaceLabelsArrayPath WRITE setSurfaceMeshFaceLabelsArrayPath)
+
+  // Start Python bindings declarations
+  PYB11_BEGIN_BINDINGS(VerifyTriangleWinding SUPERCLASS AbstractFilter)
+  PYB11_FILTER()
+  PYB11_SHARED_POINTERS(VerifyTriangleWinding)
+  PYB11_FILTER_NEW_MACRO(VerifyTriangleWinding)
+  PYB11_PROPERTY(DataArrayPath SurfaceMeshFaceLabelsArrayPath READ getSurfaceMeshFaceLabelsArrayPath WRITE setSurfaceMeshFaceLabelsArrayPath)
+  PYB11_END_BINDINGS()
+  // End Python bindings declarations
+
 public:
   using Self = VerifyTriangleWinding;
   using Pointer = std::shared_ptr<Self>;
   using ConstPointer = std::shared_ptr<const Self>;
   using WeakPointer = std::weak_ptr<Self>;
   using ConstWeakPointer = std::weak_ptr<const Self>;
+
+  /**
+   * @brief Returns a NullPointer wrapped by a shared_ptr<>
+   * @return
+   */
   static Pointer NullPointer();
 
-  static std::shared_ptr<VerifyTriangleWinding> New();
+  /**
+   * @brief Creates a new object wrapped in a shared_ptr<>
+   * @return
+   */
+  static Pointer New();
 
   /**
    * @brief Returns the name of the class for VerifyTriangleWinding
@@ -81,49 +87,50 @@ public:
   static QString ClassName();
 
   ~VerifyTriangleWinding() override;
+
   /**
-   * @brief Setter property for SurfaceDataContainerName
+   * @brief Setter property for SurfaceMeshFaceLabelsArrayPath
    */
-  void setSurfaceDataContainerName(const QString& value);
+  void setSurfaceMeshFaceLabelsArrayPath(const DataArrayPath& value);
   /**
-   * @brief Getter property for SurfaceDataContainerName
-   * @return Value of SurfaceDataContainerName
+   * @brief Getter property for SurfaceMeshFaceLabelsArrayPath
+   * @return Value of SurfaceMeshFaceLabelsArrayPath
    */
-  QString getSurfaceDataContainerName() const;
+  DataArrayPath getSurfaceMeshFaceLabelsArrayPath() const;
+  Q_PROPERTY(DataArrayPath SurfaceMeshFaceLabelsArrayPath READ getSurfaceMeshFaceLabelsArrayPath WRITE setSurfaceMeshFaceLabelsArrayPath)
 
   /**
-   * @brief Setter property for SurfaceMeshNodeFacesArrayName
+   * @brief getCompiledLibraryName Reimplemented from @see AbstractFilter class
    */
-  void setSurfaceMeshNodeFacesArrayName(const QString& value);
+  QString getCompiledLibraryName() const override;
+
   /**
-   * @brief Getter property for SurfaceMeshNodeFacesArrayName
-   * @return Value of SurfaceMeshNodeFacesArrayName
+   * @brief getBrandingString Returns the branding string for the filter, which is a tag
+   * used to denote the filter's association with specific plugins
+   * @return Branding string
    */
-  QString getSurfaceMeshNodeFacesArrayName() const;
-
-  typedef QMap<int, QSet<int>> LabelFaceMap_t;
-  typedef QVector<int32_t> FaceList_t;
+  QString getBrandingString() const override;
 
   /**
-   * @brief This returns the group that the filter belonds to. You can select
-   * a different group if you want. The string returned here will be displayed
-   * in the GUI for the filter
+   * @brief getFilterVersion Returns a version string for this filter. Default
+   * value is an empty string.
+   * @return
    */
+  QString getFilterVersion() const override;
+
   /**
-   * @brief Setter property for SurfaceMeshFaceLabelsArrayPath
+   * @brief newFilterInstance Reimplemented from @see AbstractFilter class
    */
-  void setSurfaceMeshFaceLabelsArrayPath(const DataArrayPath& value);
+  AbstractFilter::Pointer newFilterInstance(bool copyFilterParameters) const override;
+
   /**
-   * @brief Getter property for SurfaceMeshFaceLabelsArrayPath
-   * @return Value of SurfaceMeshFaceLabelsArrayPath
+   * @brief getGroupName Reimplemented from @see AbstractFilter class
    */
-  DataArrayPath getSurfaceMeshFaceLabelsArrayPath() const;
-
-  Q_PROPERTY(DataArrayPath SurfaceMeshFaceLabelsArrayPath READ getSurfaceMeshFaceLabelsArrayPath WRITE setSurfaceMeshFaceLabelsArrayPath)
-
-  QString getCompiledLibraryName() const override;
-  AbstractFilter::Pointer newFilterInstance(bool copyFilterParameters) const override;
   QString getGroupName() const override;
+
+  /**
+   * @brief getSubGroupName Reimplemented from @see AbstractFilter class
+   */
   QString getSubGroupName() const override;
 
   /**
@@ -133,25 +140,22 @@ public:
   QUuid getUuid() const override;
 
   /**
-   * @brief This returns a string that is displayed in the GUI. It should be readable
-   * and understandable by humans.
+   * @brief getHumanLabel Reimplemented from @see AbstractFilter class
    */
   QString getHumanLabel() const override;
 
   /**
-   * @brief This method will instantiate all the end user settable options/parameters
-   * for this filter
+   * @brief setupFilterParameters Reimplemented from @see AbstractFilter class
    */
   void setupFilterParameters() override;
 
   /**
-   * @brief This method will read the options from a file
-   * @param reader The reader that is used to read the options from a file
+   * @brief readFilterParameters Reimplemented from @see AbstractFilter class
    */
   void readFilterParameters(AbstractFilterParametersReader* reader, int index) override;
 
   /**
-   * @brief Reimplemented from @see AbstractFilter class
+   * @brief execute Reimplemented from @see AbstractFilter class
    */
   void execute() override;
 
@@ -168,37 +172,18 @@ protected:
    */
   void initialize();
 
-  /**
-   * @brief This method generates a mapping between a "Label" (Feature Id) and the set of triangles that belong to that
-   * lable value.
-   * @param trianglesToLabelMap
-   */
-  void getLabelTriangelMap(LabelFaceMap_t& trianglesToLabelMap);
-
   /**
    * @brief This method verifies the winding of all the triangles and makes them consistent
-   * @return
-   */
-  int verifyTriangleWinding();
-
-  /**
-   * @brief VerifyTriangleWinding::getSeedTriangle
-   * @param label
-   * @param triangleIndices
-   * @return
+   * @return The number of shared edges whose winding could not be made consistent
    */
-  int32_t getSeedTriangle(int32_t label, QSet<int32_t>& triangleIndices);
+  size_t verifyTriangleWinding();
 
 private:
   std::weak_ptr<DataArray<int32_t>> m_SurfaceMeshFaceLabelsPtr;
   int32_t* m_SurfaceMeshFaceLabels = nullptr;
 
-  QString m_SurfaceDataContainerName = {};
-  QString m_SurfaceMeshNodeFacesArrayName = {};
   DataArrayPath m_SurfaceMeshFaceLabelsArrayPath = {};
 
-  bool m_DoNodeFaceConnectivityFilter;
-
 public:
   VerifyTriangleWinding(const VerifyTriangleWinding&) = delete;            // Copy Constructor Not Implemented
   VerifyTriangleWinding(VerifyTriangleWinding&&) = delete;                 // Move Constructor Not Implemented
@@ -387,6 +387,17 @@ public:
       DREAM3D_REQUIRE_EQUAL(coords[1], k_VertexCoords[v][1]);
       DREAM3D_REQUIRE_EQUAL(coords[2], k_VertexCoords[v][2]);
     }
+
+    // Every node lies on the outside of the 1 voxel thick volume, and the nodes along y = 1 are shared by both Features
+    AttributeMatrix::Pointer vertexAttrMat = dca->getDataContainer(imageSurfMesh)->getAttributeMatrix(SIMPL::Defaults::VertexAttributeMatrixName);
+    DREAM3D_REQUIRE(vertexAttrMat.get() != nullptr)
+    Int8ArrayType::Pointer nodeTypes = vertexAttrMat->getAttributeArrayAs<Int8ArrayType>(SIMPL::VertexData::SurfaceMeshNodeType);
+    DREAM3D_REQUIRE(nodeTypes.get() != nullptr)
+    for(size_t v = 0; v < imageSurfMeshGeom->getNumberOfVertices(); v++)
+    {
+      int8_t nodeType = (k_VertexCoords[v][1] == 1.0f) ? 13 : 12;
+      DREAM3D_REQUIRE_EQUAL(nodeTypes->getValue(v), nodeType);
+    }
   }
 
   // -----------------------------------------------------------------------------
@@ -0,0 +1,298 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include <array>
+#include <vector>
+
+#include <QtCore/QDebug>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterFactory.hpp"
+#include "SIMPLib/Filtering/FilterManager.h"
+#include "SIMPLib/Geometry/TriangleGeom.h"
+
+#include "UnitTestSupport.hpp"
+
+#include "SurfaceMeshingTestFileLocations.h"
+
+class VerifyTriangleWindingTest
+{
+
+public:
+  VerifyTriangleWindingTest() = default;
+  ~VerifyTriangleWindingTest() = default;
+
+  /**
+   * @brief Returns the name of the class for VerifyTriangleWindingTest
+   */
+  QString getNameOfClass() const
+  {
+    return QString("VerifyTriangleWindingTest");
+  }
+
+  /**
+   * @brief Returns the name of the class for VerifyTriangleWindingTest
+   */
+  QString ClassName()
+  {
+    return QString("VerifyTriangleWindingTest");
+  }
+
+  VerifyTriangleWindingTest(const VerifyTriangleWindingTest&) = delete;            // Copy Constructor Not Implemented
+  VerifyTriangleWindingTest(VerifyTriangleWindingTest&&) = delete;                 // Move Constructor Not Implemented
+  VerifyTriangleWindingTest& operator=(const VerifyTriangleWindingTest&) = delete; // Copy Assignment Not Implemented
+  VerifyTriangleWindingTest& operator=(VerifyTriangleWindingTest&&) = delete;      // Move Assignment Not Implemented
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestFilterAvailability()
+  {
+    // Now instantiate the VerifyTriangleWinding Filter from the FilterManager
+    QString filtName = "VerifyTriangleWinding";
+    FilterManager* fm = FilterManager::Instance();
+    IFilterFactory::Pointer filterFactory = fm->getFactoryFromClassName(filtName);
+    if(nullptr == filterFactory.get())
+    {
+      std::stringstream ss;
+      ss << "The SurfaceMeshing Requires the use of the " << filtName.toStdString() << " filter which is found in the SurfaceMeshing Plugin";
+      DREAM3D_TEST_THROW_EXCEPTION(ss.str())
+    }
+    return 0;
+  }
+
+  // -----------------------------------------------------------------------------
+  // Builds the voxel surface mesh of a 4x4x4 volume whose labels are given by labels(x, y, z). Every boundary
+  // face is split into two triangles whose winding and label order are scrambled. For every triangle the
+  // direction from its first label towards its second label is stored, which is where a correctly wound
+  // normal points.
+  // -----------------------------------------------------------------------------
+  template <typename LabelFunc>
+  DataContainerArray::Pointer createVoxelMesh(LabelFunc labels, std::vector<std::array<float, 3>>& expectedNormals)
+  {
+    const int32_t dim = 4;
+    const size_t vertsPerRow = dim + 1;
+
+    std::vector<size_t> triList;
+    std::vector<int32_t> labelList;
+    auto label = [&](int32_t x, int32_t y, int32_t z) { return (x < 0 || y < 0 || z < 0 || x >= dim || y >= dim || z >= dim) ? -1 : labels(x, y, z); };
+    auto vertex = [&](int32_t x, int32_t y, int32_t z) { return (static_cast<size_t>(z) * vertsPerRow + y) * vertsPerRow + x; };
+
+    for(int32_t z = -1; z < dim; z++)
+    {
+      for(int32_t y = -1; y < dim; y++)
+      {
+        for(int32_t x = -1; x < dim; x++)
+        {
+          for(int32_t axis = 0; axis < 3; axis++)
+          {
+            int32_t nx = x + (axis == 0 ? 1 : 0);
+            int32_t ny = y + (axis == 1 ? 1 : 0);
+            int32_t nz = z + (axis == 2 ? 1 : 0);
+            int32_t l0 = label(x, y, z);
+            int32_t l1 = label(nx, ny, nz);
+            if(l0 == l1)
+            {
+              continue;
+            }
+            size_t quad[4] = {0, 0, 0, 0};
+            if(axis == 0)
+            {
+              quad[0] = vertex(nx, ny, nz), quad[1] = vertex(nx, ny + 1, nz), quad[2] = vertex(nx, ny + 1, nz + 1), quad[3] = vertex(nx, ny, nz + 1);
+            }
+            else if(axis == 1)
+            {
+              quad[0] = vertex(nx, ny, nz), quad[1] = vertex(nx + 1, ny, nz), quad[2] = vertex(nx + 1, ny, nz + 1), quad[3] = vertex(nx, ny, nz + 1);
+            }
+            else
+            {
+              quad[0] = vertex(nx, ny, nz), quad[1] = vertex(nx + 1, ny, nz), quad[2] = vertex(nx + 1, ny + 1, nz), quad[3] = vertex(nx, ny + 1, nz);
+            }
+            size_t halves[2][3] = {{quad[0], quad[1], quad[2]}, {quad[0], quad[2], quad[3]}};
+            for(size_t h = 0; h < 2; h++)
+            {
+              size_t t = labelList.size() / 2;
+              std::array<float, 3> normal = {0.0f, 0.0f, 0.0f};
+              normal[axis] = 1.0f;
+              if(t % 2 == 1)
+              {
+                labelList.push_back(l1);
+                labelList.push_back(l0);
+                normal[axis] = -1.0f;
+              }
+              else
+              {
+                labelList.push_back(l0);
+                labelList.push_back(l1);
+              }
+              expectedNormals.push_back(normal);
+              if(t % 3 == 0)
+              {
+                std::swap(halves[h][0], halves[h][2]);
+              }
+              triList.insert(triList.end(), halves[h], halves[h] + 3);
+            }
+          }
+        }
+      }
+    }
+
+    DataContainerArray::Pointer dca = DataContainerArray::New();
+    DataContainer::Pointer tdc = DataContainer::New(SIMPL::Defaults::TriangleDataContainerName);
+    dca->addOrReplaceDataContainer(tdc);
+
+    size_t numTris = labelList.size() / 2;
+    SharedVertexList::Pointer vertexList = TriangleGeom::CreateSharedVertexList(vertsPerRow * vertsPerRow * vertsPerRow);
+    TriangleGeom::Pointer triangle = TriangleGeom::CreateGeometry(numTris, vertexList, SIMPL::Geometry::TriangleGeometry);
+    tdc->setGeometry(triangle);
+    float* vertices = triangle->getVertexPointer(0);
+    for(size_t z = 0; z < vertsPerRow; z++)
+    {
+      for(size_t y = 0; y < vertsPerRow; y++)
+      {
+        for(size_t x = 0; x < vertsPerRow; x++)
+        {
+          size_t v = (z * vertsPerRow + y) * vertsPerRow + x;
+          vertices[3 * v + 0] = static_cast<float>(x);
+          vertices[3 * v + 1] = static_cast<float>(y);
+          vertices[3 * v + 2] = static_cast<float>(z);
+        }
+      }
+    }
+    std::copy(triList.begin(), triList.end(), triangle->getTriPointer(0));
+
+    std::vector<size_t> tDims(1, numTris);
+    AttributeMatrix::Pointer faceAttrMat = AttributeMatrix::New(tDims, SIMPL::Defaults::FaceAttributeMatrixName, AttributeMatrix::Type::Face);
+    tdc->addOrReplaceAttributeMatrix(faceAttrMat);
+    std::vector<size_t> cDims(1, 2);
+    Int32ArrayType::Pointer faceLabels = Int32ArrayType::CreateArray(numTris, cDims, SIMPL::FaceData::SurfaceMeshFaceLabels, true);
+    std::copy(labelList.begin(), labelList.end(), faceLabels->getPointer(0));
+    faceAttrMat->insertOrAssign(faceLabels);
+
+    return dca;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  template <typename LabelFunc>
+  int RunVerifyTriangleWinding(LabelFunc labels)
+  {
+    std::vector<std::array<float, 3>> expectedNormals;
+    DataContainerArray::Pointer dca = createVoxelMesh(labels, expectedNormals);
+
+    QString filtName = "VerifyTriangleWinding";
+    FilterManager* fm = FilterManager::Instance();
+    IFilterFactory::Pointer factory = fm->getFactoryFromClassName(filtName);
+    DREAM3D_REQUIRE(factory.get() != nullptr)
+
+    AbstractFilter::Pointer windingFilter = factory->create();
+    DREAM3D_REQUIRE(windingFilter.get() != nullptr)
+
+    windingFilter->setDataContainerArray(dca);
+
+    QVariant var;
+    DataArrayPath path(SIMPL::Defaults::TriangleDataContainerName, SIMPL::Defaults::FaceAttributeMatrixName, SIMPL::FaceData::SurfaceMeshFaceLabels);
+    var.setValue(path);
+    bool propWasSet = windingFilter->setProperty("SurfaceMeshFaceLabelsArrayPath", var);
+    DREAM3D_REQUIRE_EQUAL(propWasSet, true)
+
+    windingFilter->execute();
+    DREAM3D_REQUIRE_EQUAL(windingFilter->getErrorCode(), 0)
+    DREAM3D_REQUIRE_EQUAL(windingFilter->getWarningCode(), 0)
+
+    // Every triangle must now point from its first label towards its second label
+    TriangleGeom::Pointer triangle = dca->getDataContainer(SIMPL::Defaults::TriangleDataContainerName)->getGeometryAs<TriangleGeom>();
+    float* vertices = triangle->getVertexPointer(0);
+    size_t* tris = triangle->getTriPointer(0);
+    for(size_t t = 0; t < expectedNormals.size(); t++)
+    {
+      float* p0 = vertices + tris[3 * t + 0] * 3;
+      float* p1 = vertices + tris[3 * t + 1] * 3;
+      float* p2 = vertices + tris[3 * t + 2] * 3;
+      float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+      float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+      float normal[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+      float dot = normal[0] * expectedNormals[t][0] + normal[1] * expectedNormals[t][1] + normal[2] * expectedNormals[t][2];
+      DREAM3D_REQUIRE(dot > 0.0f)
+    }
+
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestSeparateFeatures()
+  {
+    // Eight 2x2x2 features that each have a single outer shell
+    return RunVerifyTriangleWinding([](int32_t x, int32_t y, int32_t z) { return 1 + (x / 2) + 2 * (y / 2) + 4 * (z / 2); });
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestEnclosedFeature()
+  {
+    // Feature 2 fills the volume around feature 1, so its mesh has an outer shell and the shell of a cavity
+    auto inside = [](int32_t x, int32_t y, int32_t z) { return x >= 1 && x < 3 && y >= 1 && y < 3 && z >= 1 && z < 3; };
+    int err = RunVerifyTriangleWinding([&](int32_t x, int32_t y, int32_t z) { return inside(x, y, z) ? 1 : 2; });
+    if(err != EXIT_SUCCESS)
+    {
+      return err;
+    }
+    // The same with the labels swapped so that the enclosing feature has the smaller label
+    return RunVerifyTriangleWinding([&](int32_t x, int32_t y, int32_t z) { return inside(x, y, z) ? 2 : 1; });
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    int err = EXIT_SUCCESS;
+    std::cout << "---- " << getNameOfClass().toStdString() << " ----" << std::endl;
+
+    DREAM3D_REGISTER_TEST(TestFilterAvailability());
+
+    DREAM3D_REGISTER_TEST(TestSeparateFeatures())
+    DREAM3D_REGISTER_TEST(TestEnclosedFeature())
+  }
+
+private:
+};
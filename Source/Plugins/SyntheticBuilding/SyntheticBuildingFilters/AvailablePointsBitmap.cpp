@@ -0,0 +1,212 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "AvailablePointsBitmap.h"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+inline uint64_t popCount(uint64_t x)
+{
+  x = x - ((x >> 1) & 0x5555555555555555ULL);
+  x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+  x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (x * 0x0101010101010101ULL) >> 56;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+inline size_t lowestBit(uint64_t x)
+{
+  size_t index = 0;
+  for(size_t shift = 32; shift > 0; shift >>= 1)
+  {
+    uint64_t mask = (uint64_t(1) << shift) - 1;
+    if((x & mask) == 0)
+    {
+      x >>= shift;
+      index += shift;
+    }
+  }
+  return index;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AvailablePointsBitmap::AvailablePointsBitmap(size_t numPoints)
+: m_NumPoints(numPoints)
+, m_Words((numPoints + k_WordBits - 1) / k_WordBits, 0)
+{
+  size_t numBlocks = (m_Words.size() + k_WordsPerBlock - 1) / k_WordsPerBlock;
+  m_BlockCounts.resize(numBlocks + 1, 0);
+  m_BlockStep = 1;
+  while(m_BlockStep * 2 <= numBlocks)
+  {
+    m_BlockStep *= 2;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AvailablePointsBitmap::~AvailablePointsBitmap() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t AvailablePointsBitmap::size() const
+{
+  return m_Count;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool AvailablePointsBitmap::contains(size_t index) const
+{
+  return ((m_Words[index / k_WordBits] >> (index % k_WordBits)) & 1) != 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void AvailablePointsBitmap::insert(size_t index)
+{
+  uint64_t bit = uint64_t(1) << (index % k_WordBits);
+  uint64_t& word = m_Words[index / k_WordBits];
+  if((word & bit) != 0)
+  {
+    return;
+  }
+  word |= bit;
+  m_Count++;
+  addToBlock(index / (k_WordBits * k_WordsPerBlock), 1);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void AvailablePointsBitmap::erase(size_t index)
+{
+  uint64_t bit = uint64_t(1) << (index % k_WordBits);
+  uint64_t& word = m_Words[index / k_WordBits];
+  if((word & bit) == 0)
+  {
+    return;
+  }
+  word &= ~bit;
+  m_Count--;
+  addToBlock(index / (k_WordBits * k_WordsPerBlock), -1);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t AvailablePointsBitmap::select(size_t rank) const
+{
+  // Descend the Fenwick tree to the block holding the point with this rank
+  size_t numBlocks = m_BlockCounts.size() - 1;
+  size_t block = 0;
+  uint64_t remaining = rank;
+  for(size_t step = m_BlockStep; step > 0; step >>= 1)
+  {
+    size_t next = block + step;
+    if(next <= numBlocks && m_BlockCounts[next] <= remaining)
+    {
+      block = next;
+      remaining -= m_BlockCounts[next];
+    }
+  }
+
+  // Then scan the words of that block and the bits of the word that holds it
+  size_t w = block * k_WordsPerBlock;
+  uint64_t count = popCount(m_Words[w]);
+  while(remaining >= count)
+  {
+    remaining -= count;
+    w++;
+    count = popCount(m_Words[w]);
+  }
+  uint64_t word = m_Words[w];
+  for(uint64_t i = 0; i < remaining; i++)
+  {
+    word &= word - 1;
+  }
+  return w * k_WordBits + lowestBit(word);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void AvailablePointsBitmap::rebuildCounts()
+{
+  size_t numBlocks = m_BlockCounts.size() - 1;
+  m_Count = 0;
+  for(size_t b = 0; b < numBlocks; b++)
+  {
+    uint64_t blockCount = 0;
+    size_t end = (b + 1) * k_WordsPerBlock < m_Words.size() ? (b + 1) * k_WordsPerBlock : m_Words.size();
+    for(size_t w = b * k_WordsPerBlock; w < end; w++)
+    {
+      blockCount += popCount(m_Words[w]);
+    }
+    m_BlockCounts[b + 1] = blockCount;
+    m_Count += blockCount;
+  }
+  // Turn the per block counts into a Fenwick tree in place
+  for(size_t i = 1; i <= numBlocks; i++)
+  {
+    size_t parent = i + (i & (~i + 1));
+    if(parent <= numBlocks)
+    {
+      m_BlockCounts[parent] += m_BlockCounts[i];
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void AvailablePointsBitmap::addToBlock(size_t block, int64_t delta)
+{
+  size_t numBlocks = m_BlockCounts.size() - 1;
+  for(size_t i = block + 1; i <= numBlocks; i += (i & (~i + 1)))
+  {
+    m_BlockCounts[i] += static_cast<uint64_t>(delta);
+  }
+}
@@ -0,0 +1,127 @@
+/* ============================================================================
+ * Copyright (c) 2009-2016 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SyntheticBuilding/SyntheticBuildingDLLExport.h"
+
+/**
+ * @brief The AvailablePointsBitmap class keeps the set of packing points that are still available
+ * for placing a feature centroid. Each point costs a single bit, and a Fenwick tree over the number
+ * of set bits in every block of 4096 points answers rank queries, so the i'th available point in
+ * point order can be found without a separate index array.
+ */
+class SyntheticBuilding_EXPORT AvailablePointsBitmap
+{
+public:
+  explicit AvailablePointsBitmap(size_t numPoints);
+  virtual ~AvailablePointsBitmap();
+
+  AvailablePointsBitmap(const AvailablePointsBitmap&) = default;
+  AvailablePointsBitmap(AvailablePointsBitmap&&) = default;
+  AvailablePointsBitmap& operator=(const AvailablePointsBitmap&) = default;
+  AvailablePointsBitmap& operator=(AvailablePointsBitmap&&) = default;
+
+  /**
+   * @brief Marks every point for which predicate(index) is true as available and every other
+   * point as unavailable. The block counts are rebuilt in a single pass.
+   * @param predicate
+   */
+  template <typename Predicate>
+  void fill(Predicate predicate)
+  {
+    for(size_t w = 0; w < m_Words.size(); w++)
+    {
+      uint64_t word = 0;
+      size_t start = w * k_WordBits;
+      size_t end = (start + k_WordBits < m_NumPoints) ? start + k_WordBits : m_NumPoints;
+      for(size_t i = start; i < end; i++)
+      {
+        if(predicate(i))
+        {
+          word |= (uint64_t(1) << (i - start));
+        }
+      }
+      m_Words[w] = word;
+    }
+    rebuildCounts();
+  }
+
+  /**
+   * @brief Returns the number of available points
+   */
+  size_t size() const;
+
+  /**
+   * @brief Returns true if the point at index is available
+   * @param index
+   */
+  bool contains(size_t index) const;
+
+  /**
+   * @brief Marks the point at index as available. Does nothing if it already is.
+   * @param index
+   */
+  void insert(size_t index);
+
+  /**
+   * @brief Marks the point at index as unavailable. Does nothing if it already is.
+   * @param index
+   */
+  void erase(size_t index);
+
+  /**
+   * @brief Returns the index of the available point with the given rank, counting available points
+   * in increasing point order from 0. The rank must be less than size().
+   * @param rank
+   */
+  size_t select(size_t rank) const;
+
+private:
+  static const size_t k_WordBits = 64;
+  static const size_t k_WordsPerBlock = 64;
+
+  size_t m_NumPoints = 0;
+  size_t m_Count = 0;
+  std::vector<uint64_t> m_Words;
+  // 1-based Fenwick tree over the number of available points in each block of k_WordsPerBlock words
+  std::vector<uint64_t> m_BlockCounts;
+  size_t m_BlockStep = 0;
+
+  void rebuildCounts();
+  void addToBlock(size_t block, int64_t delta);
+};
@@ -37,6 +37,7 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "InsertPrecipitatePhases.h"
 
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 #include <random>
@@ -53,6 +54,7 @@
 #include "SIMPLib/FilterParameters/BooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/InputFileFilterParameter.h"
+#include "SIMPLib/FilterParameters/IntFilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedChoicesFilterParameter.h"
 #include "SIMPLib/FilterParameters/OutputFileFilterParameter.h"
@@ -74,11 +76,87 @@
 
 #include "SyntheticBuilding/SyntheticBuildingConstants.h"
 #include "SyntheticBuilding/SyntheticBuildingVersion.h"
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#endif
+
 namespace
 {
 OrthoRhombicOps::Pointer m_OrthoOps;
+
+/**
+ * @brief Number of moves proposed per batch when parallel move batches are used. The batch size does not depend
+ * on the number of threads, so a given seed always gives the same precipitate placement.
+ */
+const int32_t k_MoveBatchSize = 64;
+
+/**
+ * @brief rdfBinIndex Returns the RDF histogram bin of a distance, where bin 0 collects all distances below the minimum
+ */
+int32_t rdfBinIndex(float r, float rdfMin, float stepSize)
+{
+  int32_t rdfBin = static_cast<int32_t>((r - rdfMin) / stepSize);
+  if(r < rdfMin)
+  {
+    rdfBin = -1;
+  }
+  return rdfBin + 1;
 }
 
+/**
+ * @brief pairDistance Returns the distance between two centroids
+ */
+float pairDistance(const float* a, const float* b)
+{
+  return sqrtf((a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]) + (a[2] - b[2]) * (a[2] - b[2]));
+}
+} // namespace
+
+struct InsertPrecipitatePhases::MoveCandidate
+{
+  int32_t feature = 0;
+  float newCentroid[3] = {0.0f, 0.0f, 0.0f};
+  int32_t numPPTfeatures = 1;
+  std::vector<float> rdfChange;
+};
+
+/**
+ * @brief The InsertPrecipitatePhasesMoveBatchImpl class computes the RDF change of every move in a batch. Only
+ * the centroids of the batch precipitates change while a batch is evaluated and those are skipped here.
+ */
+class InsertPrecipitatePhasesMoveBatchImpl
+{
+public:
+  InsertPrecipitatePhasesMoveBatchImpl(InsertPrecipitatePhases* filter, std::vector<InsertPrecipitatePhases::MoveCandidate>& candidates, const std::vector<int32_t>& batchSlot)
+  : m_Filter(filter)
+  , m_Candidates(candidates)
+  , m_BatchSlot(batchSlot)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t c = start; c < end; c++)
+    {
+      m_Filter->determineMoveRDFChange(m_Candidates[c], m_BatchSlot);
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+private:
+  InsertPrecipitatePhases* m_Filter;
+  std::vector<InsertPrecipitatePhases::MoveCandidate>& m_Candidates;
+  const std::vector<int32_t>& m_BatchSlot;
+};
+
 /* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
 enum createdPathID : RenameDataPath::DataID_t
 {
@@ -109,6 +187,9 @@ InsertPrecipitatePhases::InsertPrecipitatePhases()
 , m_PrecipInputFile("")
 , m_PeriodicBoundaries(false)
 , m_MatchRDF(false)
+, m_UseParallelMoveBatches(false)
+, m_UseRandomSeed(false)
+, m_RandomSeed(0)
 , m_WriteGoalAttributes(false)
 , m_InputStatsArrayPath(SIMPL::Defaults::StatsGenerator, SIMPL::Defaults::CellEnsembleAttributeMatrixName, SIMPL::EnsembleData::Statistics)
 , m_InputPhaseTypesArrayPath(SIMPL::Defaults::StatsGenerator, SIMPL::Defaults::CellEnsembleAttributeMatrixName, SIMPL::EnsembleData::PhaseTypes)
@@ -146,6 +227,13 @@ void InsertPrecipitatePhases::setupFilterParameters()
   FilterParameterVectorType parameters;
   parameters.push_back(SIMPL_NEW_BOOL_FP("Periodic Boundaries", PeriodicBoundaries, FilterParameter::Parameter, InsertPrecipitatePhases));
   parameters.push_back(SIMPL_NEW_BOOL_FP("Match Radial Distribution Function", MatchRDF, FilterParameter::Parameter, InsertPrecipitatePhases));
+  parameters.push_back(SIMPL_NEW_BOOL_FP("Use Parallel Move Batches", UseParallelMoveBatches, FilterParameter::Parameter, InsertPrecipitatePhases));
+  {
+    QStringList linkedProps;
+    linkedProps << "RandomSeed";
+    parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Use Random Seed", UseRandomSeed, FilterParameter::Parameter, InsertPrecipitatePhases, linkedProps));
+  }
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Random Seed", RandomSeed, FilterParameter::Parameter, InsertPrecipitatePhases));
   QStringList linkedProps("MaskArrayPath");
   parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Use Mask", UseMask, FilterParameter::Parameter, InsertPrecipitatePhases, linkedProps));
   parameters.push_back(SeparatorFilterParameter::New("Cell Data", FilterParameter::RequiredArray));
@@ -281,6 +369,9 @@ void InsertPrecipitatePhases::readFilterParameters(AbstractFilterParametersReade
   setMaskArrayPath(reader->readDataArrayPath("MaskArrayPath", getMaskArrayPath()));
   setPeriodicBoundaries(reader->readValue("PeriodicBoundaries", getPeriodicBoundaries()));
   setMatchRDF(reader->readValue("MatchRDF", getMatchRDF()));
+  setUseParallelMoveBatches(reader->readValue("UseParallelMoveBatches", getUseParallelMoveBatches()));
+  setUseRandomSeed(reader->readValue("UseRandomSeed", getUseRandomSeed()));
+  setRandomSeed(reader->readValue("RandomSeed", getRandomSeed()));
   setUseMask(reader->readValue("UseMask", getUseMask()));
   bool haveFeatures = reader->readValue("HaveFeatures", false);
   if(haveFeatures)
@@ -790,7 +881,12 @@ void InsertPrecipitatePhases::place_precipitates(Int32ArrayType::Pointer exclusi
 
   clearErrorCode();
   clearWarningCode();
+  // A fixed seed reproduces the same packing on every run
   m_Seed = QDateTime::currentMSecsSinceEpoch();
+  if(m_UseRandomSeed)
+  {
+    m_Seed = static_cast<uint64_t>(m_RandomSeed);
+  }
   SIMPL_RANDOMNG_NEW_SEEDED(m_Seed)
 
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(m_FeatureIdsArrayPath.getDataContainerName());
@@ -895,8 +991,7 @@ void InsertPrecipitatePhases::place_precipitates(Int32ArrayType::Pointer exclusi
 
   // This is the set that we are going to keep updated with the points that are
   // not in an exclusion zone
-  std::map<size_t, size_t> availablePoints;
-  std::map<size_t, size_t> availablePointsInv;
+  AvailablePointsBitmap availablePoints(static_cast<size_t>(m_TotalPoints));
 
   // Get a pointer to the Feature Owners that was just initialized in the
   // initialize_packinggrid() method
@@ -1037,16 +1132,8 @@ void InsertPrecipitatePhases::place_precipitates(Int32ArrayType::Pointer exclusi
   }
 
   // determine initial set of available points
-  m_AvailablePointsCount = 0;
-  for(int64_t i = 0; i < m_TotalPoints; i++)
-  {
-    if((exclusionZones[i] == 0 && !m_UseMask) || (exclusionZones[i] == 0 && m_UseMask && m_Mask[i]))
-    {
-      availablePoints[i] = m_AvailablePointsCount;
-      availablePointsInv[m_AvailablePointsCount] = i;
-      m_AvailablePointsCount++;
-    }
-  }
+  availablePoints.fill([&](size_t i) { return exclusionZones[i] == 0 && (!m_UseMask || m_Mask[i]); });
+  m_AvailablePointsCount = availablePoints.size();
   // and clear the pointsToRemove and pointsToAdd vectors from the initial
   // packing
   m_PointsToRemove.clear();
@@ -1114,12 +1201,12 @@ void InsertPrecipitatePhases::place_precipitates(Int32ArrayType::Pointer exclusi
   //          {
   //            key = static_cast<size_t>(rg.genrand_res53() *
   //            (availablePointsCount - 1));
-  //            featureOwnersIdx = availablePointsInv[key];
+  //            featureOwnersIdx = availablePoints.select(key);
   //            while (m_BoundaryCells[featureOwnersIdx] == 0)
   //            {
   //              key = static_cast<size_t>(rg.genrand_res53() *
   //              (availablePointsCount - 1));
-  //              featureOwnersIdx = availablePointsInv[key];
+  //              featureOwnersIdx = availablePoints.select(key);
   //            }
   //          }
   //          else
@@ -1140,12 +1227,12 @@ void InsertPrecipitatePhases::place_precipitates(Int32ArrayType::Pointer exclusi
   //          {
   //            key = static_cast<size_t>(rg.genrand_res53() *
   //            (availablePointsCount - 1));
-  //            featureOwnersIdx = availablePointsInv[key];
+  //            featureOwnersIdx = availablePoints.select(key);
   //            while (m_BoundaryCells[featureOwnersIdx] != 0)
   //            {
   //              key = static_cast<size_t>(rg.genrand_res53() *
   //              (availablePointsCount - 1));
-  //              featureOwnersIdx = availablePointsInv[key];
+  //              featureOwnersIdx = availablePoints.select(key);
   //            }
   //          }
   //          else
@@ -1175,7 +1262,7 @@ void InsertPrecipitatePhases::place_precipitates(Int32ArrayType::Pointer exclusi
   //        {
   //          key = static_cast<size_t>(rg.genrand_res53() *
   //          (availablePointsCount - 1));
-  //          featureOwnersIdx = availablePointsInv[key];
+  //          featureOwnersIdx = availablePoints.select(key);
   //        }
   //        else
   //        {
@@ -1202,7 +1289,7 @@ void InsertPrecipitatePhases::place_precipitates(Int32ArrayType::Pointer exclusi
   //    }
   //    if (getCancel() == true) { return; }
   //    update_exclusionZones(i, -1000, exclusionZonesPtr);
-  //    update_availablepoints(availablePoints, availablePointsInv);
+  //    update_availablepoints(availablePoints);
   //    if (iterCount >= 100000)
   //    {
   //      tDims[0] = i + 1;
@@ -1235,11 +1322,11 @@ void InsertPrecipitatePhases::place_precipitates(Int32ArrayType::Pointer exclusi
         if(m_AvailablePointsCount > 0)
         {
           key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
-          featureOwnersIdx = availablePointsInv[key];
+          featureOwnersIdx = availablePoints.select(key);
           while(m_BoundaryCells[featureOwnersIdx] == 0)
           {
             key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
-            featureOwnersIdx = availablePointsInv[key];
+            featureOwnersIdx = availablePoints.select(key);
           }
         }
         else
@@ -1256,11 +1343,11 @@ void InsertPrecipitatePhases::place_precipitates(Int32ArrayType::Pointer exclusi
         if(m_AvailablePointsCount > 0)
         {
           key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
-          featureOwnersIdx = availablePointsInv[key];
+          featureOwnersIdx = availablePoints.select(key);
           while(m_BoundaryCells[featureOwnersIdx] != 0)
           {
             key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
-            featureOwnersIdx = availablePointsInv[key];
+            featureOwnersIdx = availablePoints.select(key);
           }
         }
         else
@@ -1289,7 +1376,7 @@ void InsertPrecipitatePhases::place_precipitates(Int32ArrayType::Pointer exclusi
       if(m_AvailablePointsCount > 0)
       {
         key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
-        featureOwnersIdx = availablePointsInv[key];
+        featureOwnersIdx = availablePoints.select(key);
       }
       else
       {
@@ -1308,7 +1395,7 @@ void InsertPrecipitatePhases::place_precipitates(Int32ArrayType::Pointer exclusi
     m_Centroids[3 * i + 2] = zc;
     insert_precipitate(i);
     update_exclusionZones(i, -1000, exclusionZonesPtr);
-    update_availablepoints(availablePoints, availablePointsInv);
+    update_availablepoints(availablePoints);
   }
 
   notifyStatusMessage("Packing Features - Initial Feature Placement Complete");
@@ -1385,148 +1472,344 @@ void InsertPrecipitatePhases::place_precipitates(Int32ArrayType::Pointer exclusi
     // This is not based on convergence or any physics - it's just a factor
     // and there's probably room for improvement here
     int32_t totalAdjustments = static_cast<int32_t>(1000 * ((numfeatures - m_FirstPrecipitateFeature) - 1));
-    for(int32_t iteration = 0; iteration < totalAdjustments; ++iteration)
+    if(m_UseParallelMoveBatches)
     {
-      QString ss;
-      ss = QObject::tr("Packing Features - Swapping/Moving/Adding/Removing "
-                       "Features Iteration %1/%2")
-               .arg(iteration)
-               .arg(totalAdjustments);
-      if(iteration % 100 == 0)
+      // Moves are proposed in batches that each touch a precipitate at most once. The RDF change of every move
+      // against the precipitates outside the batch is computed in parallel, then the moves are accepted or rejected
+      // in proposal order after adding the distances between the batch precipitates themselves, which gives the
+      // same histogram and error as applying the batch one move at a time.
+      std::vector<int32_t> batchSlot(numfeatures, -1);
+      std::vector<MoveCandidate> candidates;
+      candidates.reserve(k_MoveBatchSize);
+      for(int32_t iteration = 0; iteration < totalAdjustments; iteration += k_MoveBatchSize)
       {
+        QString ss;
+        ss = QObject::tr("Packing Features - Swapping/Moving/Adding/Removing "
+                         "Features Iteration %1/%2")
+                 .arg(iteration)
+                 .arg(totalAdjustments);
         notifyStatusMessage(ss);
-      }
 
-      if(writeErrorFile && iteration % 25 == 0)
-      {
-        outFile << iteration << " " << m_oldRDFerror << " " << acceptedmoves << "\n";
-      }
+        if(writeErrorFile)
+        {
+          outFile << iteration << " " << m_oldRDFerror << " " << acceptedmoves << "\n";
+        }
 
-      // JUMP - this one feature  random spot in the volume
-      randomfeature = m_FirstPrecipitateFeature + int32_t(rg.genrand_res53() * (int32_t(numfeatures) - m_FirstPrecipitateFeature));
-      if(randomfeature < m_FirstPrecipitateFeature)
-      {
-        randomfeature = m_FirstPrecipitateFeature;
-      }
-      if(randomfeature >= static_cast<int32_t>(numfeatures))
-      {
-        randomfeature = static_cast<int32_t>(numfeatures) - 1;
-      }
-      m_Seed++;
+        // Propose the moves on this thread so the random numbers are drawn in a fixed order. A precipitate that
+        // already moves in this batch is not proposed again.
+        int32_t batchEnd = std::min(iteration + k_MoveBatchSize, totalAdjustments);
+        candidates.clear();
+        for(int32_t batchIteration = iteration; batchIteration < batchEnd; batchIteration++)
+        {
+          randomfeature = m_FirstPrecipitateFeature + int32_t(rg.genrand_res53() * (int32_t(numfeatures) - m_FirstPrecipitateFeature));
+          if(randomfeature < m_FirstPrecipitateFeature)
+          {
+            randomfeature = m_FirstPrecipitateFeature;
+          }
+          if(randomfeature >= static_cast<int32_t>(numfeatures))
+          {
+            randomfeature = static_cast<int32_t>(numfeatures) - 1;
+          }
+          m_Seed++;
 
-      PrecipitateStatsData::Pointer pp = std::dynamic_pointer_cast<PrecipitateStatsData>(statsDataArray[m_FeaturePhases[randomfeature]]);
-      if(nullptr == pp)
-      {
-        continue;
-      }
+          PrecipitateStatsData::Pointer pp = std::dynamic_pointer_cast<PrecipitateStatsData>(statsDataArray[m_FeaturePhases[randomfeature]]);
+          if(nullptr == pp || batchSlot[randomfeature] >= 0)
+          {
+            continue;
+          }
 
-      precipboundaryfraction = pp->getPrecipBoundaryFraction();
-      random = static_cast<float>(rg.genrand_res53());
-      if(boundaryFraction != 0)
-      {
-        if(random <= precipboundaryfraction)
-        {
-          // figure out if we want this to be a boundary centroid voxel or not
-          // for the proposed precipitate
-          if(m_AvailablePointsCount > 0)
+          precipboundaryfraction = pp->getPrecipBoundaryFraction();
+          random = static_cast<float>(rg.genrand_res53());
+          if(boundaryFraction != 0)
           {
-            key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
-            featureOwnersIdx = availablePointsInv[key];
-            while(m_BoundaryCells[featureOwnersIdx] == 0)
+            if(random <= precipboundaryfraction)
             {
-              key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
-              featureOwnersIdx = availablePointsInv[key];
+              if(m_AvailablePointsCount > 0)
+              {
+                key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
+                featureOwnersIdx = availablePoints.select(key);
+                while(m_BoundaryCells[featureOwnersIdx] == 0)
+                {
+                  key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
+                  featureOwnersIdx = availablePoints.select(key);
+                }
+              }
+              else
+              {
+                featureOwnersIdx = static_cast<size_t>(rg.genrand_res53() * m_TotalPoints);
+                while(m_BoundaryCells[featureOwnersIdx] == 0)
+                {
+                  featureOwnersIdx = static_cast<size_t>(rg.genrand_res53() * m_TotalPoints);
+                }
+              }
+            }
+            else if(random > precipboundaryfraction)
+            {
+              if(m_AvailablePointsCount > 0)
+              {
+                key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
+                featureOwnersIdx = availablePoints.select(key);
+                while(m_BoundaryCells[featureOwnersIdx] != 0)
+                {
+                  key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
+                  featureOwnersIdx = availablePoints.select(key);
+                }
+              }
+              else
+              {
+                featureOwnersIdx = static_cast<size_t>(rg.genrand_res53() * m_TotalPoints);
+                while(m_BoundaryCells[featureOwnersIdx] != 0)
+                {
+                  featureOwnersIdx = static_cast<size_t>(rg.genrand_res53() * m_TotalPoints);
+                }
+              }
             }
           }
           else
           {
-            featureOwnersIdx = static_cast<size_t>(rg.genrand_res53() * m_TotalPoints);
-            while(m_BoundaryCells[featureOwnersIdx] == 0)
+            if(precipboundaryfraction > 0)
+            {
+              QString msg("There are no Feature boundaries to place precipitates "
+                          "on and the target statistics precipitate fraction is "
+                          "greater than 0. This Filter will run without trying "
+                          "to match the "
+                          "precipitate fraction");
+              setWarningCondition(-5010, msg);
+            }
+
+            if(m_AvailablePointsCount > 0)
+            {
+              key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
+              featureOwnersIdx = availablePoints.select(key);
+            }
+            else
             {
               featureOwnersIdx = static_cast<size_t>(rg.genrand_res53() * m_TotalPoints);
             }
           }
+          column = static_cast<int64_t>(featureOwnersIdx % m_XPoints);
+          row = static_cast<int64_t>(featureOwnersIdx / m_XPoints) % m_YPoints;
+          plane = static_cast<int64_t>(featureOwnersIdx / (m_XPoints * m_YPoints));
+
+          MoveCandidate candidate;
+          candidate.feature = randomfeature;
+          candidate.newCentroid[0] = static_cast<float>((column * m_XRes) + (m_XRes * 0.5));
+          candidate.newCentroid[1] = static_cast<float>((row * m_YRes) + (m_YRes * 0.5));
+          candidate.newCentroid[2] = static_cast<float>((plane * m_ZRes) + (m_ZRes * 0.5));
+          batchSlot[randomfeature] = static_cast<int32_t>(candidates.size());
+          candidates.push_back(std::move(candidate));
         }
-        else if(random > precipboundaryfraction)
+
+        InsertPrecipitatePhasesMoveBatchImpl batchImpl(this, candidates, batchSlot);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, candidates.size(), 1), batchImpl, tbb::auto_partitioner());
+#else
+        batchImpl.convert(0, candidates.size());
+#endif
+
+        for(size_t c = 0; c < candidates.size(); c++)
         {
-          if(m_AvailablePointsCount > 0)
+          MoveCandidate& candidate = candidates[c];
+          int32_t gnum = candidate.feature;
+          const float* oldCentroid = m_Centroids + 3 * gnum;
+          std::vector<float> rdf = m_RdfCurrentDist;
+          for(size_t i = 0; i < rdf.size(); i++)
           {
-            key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
-            featureOwnersIdx = availablePointsInv[key];
-            while(m_BoundaryCells[featureOwnersIdx] != 0)
+            rdf[i] += candidate.rdfChange[i];
+          }
+          // Distances to the other precipitates of the batch, which sit where the moves committed so far left them
+          for(size_t other = 0; other < candidates.size(); other++)
+          {
+            int32_t n = candidates[other].feature;
+            if(other != c && m_FeaturePhases[n] == m_FeaturePhases[gnum])
             {
-              key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
-              featureOwnersIdx = availablePointsInv[key];
+              const float* centroid = m_Centroids + 3 * n;
+              rdf[rdfBinIndex(pairDistance(oldCentroid, centroid), m_rdfMin, m_StepSize)] -= 2.0f;
+              rdf[rdfBinIndex(pairDistance(candidate.newCentroid, centroid), m_rdfMin, m_StepSize)] += 2.0f;
             }
           }
+
+          std::vector<float> rdfNorm = normalizeRDF(rdf, m_numRDFbins, m_StepSize, m_rdfMin, candidate.numPPTfeatures);
+          float bhattdist = 0.0f;
+          if(rdfNorm.size() > m_RdfTargetDist.size())
+          {
+            compare_1Ddistributions(m_RdfTargetDist, rdfNorm, bhattdist);
+          }
           else
           {
-            featureOwnersIdx = static_cast<size_t>(rg.genrand_res53() * m_TotalPoints);
-            while(m_BoundaryCells[featureOwnersIdx] != 0)
-            {
-              featureOwnersIdx = static_cast<size_t>(rg.genrand_res53() * m_TotalPoints);
-            }
+            compare_1Ddistributions(rdfNorm, m_RdfTargetDist, bhattdist);
+          }
+
+          // A rejected move leaves the histogram, the exclusion zones and the error exactly as they were. An
+          // accepted move is applied through check_RDFerror the same way the serial loop applies it.
+          if(bhattdist >= m_oldRDFerror)
+          {
+            m_currentRDFerror = check_RDFerror(-1000, gnum, true);
+            update_exclusionZones(-1000, gnum, exclusionZonesPtr);
+            move_precipitate(gnum, candidate.newCentroid[0], candidate.newCentroid[1], candidate.newCentroid[2]);
+            m_currentRDFerror = check_RDFerror(gnum, -1000, true);
+            update_exclusionZones(gnum, -1000, exclusionZonesPtr);
+            m_oldRDFerror = m_currentRDFerror;
+            update_availablepoints(availablePoints);
+            acceptedmoves++;
           }
         }
+        for(const MoveCandidate& candidate : candidates)
+        {
+          batchSlot[candidate.feature] = -1;
+        }
+
+        if(write_test_outputs)
+        {
+          testFile << "\n" << m_oldRDFerror;
+        }
       }
-      else
+    }
+    else
+    {
+      for(int32_t iteration = 0; iteration < totalAdjustments; ++iteration)
       {
+        QString ss;
+        ss = QObject::tr("Packing Features - Swapping/Moving/Adding/Removing "
+                         "Features Iteration %1/%2")
+                 .arg(iteration)
+                 .arg(totalAdjustments);
+        if(iteration % 100 == 0)
+        {
+          notifyStatusMessage(ss);
+        }
 
-        if(precipboundaryfraction > 0)
+        if(writeErrorFile && iteration % 25 == 0)
         {
-          QString msg("There are no Feature boundaries to place precipitates "
-                      "on and the target statistics precipitate fraction is "
-                      "greater than 0. This Filter will run without trying "
-                      "to match the "
-                      "precipitate fraction");
-          setWarningCondition(-5010, msg);
+          outFile << iteration << " " << m_oldRDFerror << " " << acceptedmoves << "\n";
         }
 
-        if(m_AvailablePointsCount > 0)
+        // JUMP - this one feature  random spot in the volume
+        randomfeature = m_FirstPrecipitateFeature + int32_t(rg.genrand_res53() * (int32_t(numfeatures) - m_FirstPrecipitateFeature));
+        if(randomfeature < m_FirstPrecipitateFeature)
         {
-          key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
-          featureOwnersIdx = availablePointsInv[key];
+          randomfeature = m_FirstPrecipitateFeature;
+        }
+        if(randomfeature >= static_cast<int32_t>(numfeatures))
+        {
+          randomfeature = static_cast<int32_t>(numfeatures) - 1;
+        }
+        m_Seed++;
+
+        PrecipitateStatsData::Pointer pp = std::dynamic_pointer_cast<PrecipitateStatsData>(statsDataArray[m_FeaturePhases[randomfeature]]);
+        if(nullptr == pp)
+        {
+          continue;
+        }
+
+        precipboundaryfraction = pp->getPrecipBoundaryFraction();
+        random = static_cast<float>(rg.genrand_res53());
+        if(boundaryFraction != 0)
+        {
+          if(random <= precipboundaryfraction)
+          {
+            // figure out if we want this to be a boundary centroid voxel or not
+            // for the proposed precipitate
+            if(m_AvailablePointsCount > 0)
+            {
+              key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
+              featureOwnersIdx = availablePoints.select(key);
+              while(m_BoundaryCells[featureOwnersIdx] == 0)
+              {
+                key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
+                featureOwnersIdx = availablePoints.select(key);
+              }
+            }
+            else
+            {
+              featureOwnersIdx = static_cast<size_t>(rg.genrand_res53() * m_TotalPoints);
+              while(m_BoundaryCells[featureOwnersIdx] == 0)
+              {
+                featureOwnersIdx = static_cast<size_t>(rg.genrand_res53() * m_TotalPoints);
+              }
+            }
+          }
+          else if(random > precipboundaryfraction)
+          {
+            if(m_AvailablePointsCount > 0)
+            {
+              key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
+              featureOwnersIdx = availablePoints.select(key);
+              while(m_BoundaryCells[featureOwnersIdx] != 0)
+              {
+                key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
+                featureOwnersIdx = availablePoints.select(key);
+              }
+            }
+            else
+            {
+              featureOwnersIdx = static_cast<size_t>(rg.genrand_res53() * m_TotalPoints);
+              while(m_BoundaryCells[featureOwnersIdx] != 0)
+              {
+                featureOwnersIdx = static_cast<size_t>(rg.genrand_res53() * m_TotalPoints);
+              }
+            }
+          }
         }
         else
         {
-          featureOwnersIdx = static_cast<size_t>(rg.genrand_res53() * m_TotalPoints);
+
+          if(precipboundaryfraction > 0)
+          {
+            QString msg("There are no Feature boundaries to place precipitates "
+                        "on and the target statistics precipitate fraction is "
+                        "greater than 0. This Filter will run without trying "
+                        "to match the "
+                        "precipitate fraction");
+            setWarningCondition(-5010, msg);
+          }
+
+          if(m_AvailablePointsCount > 0)
+          {
+            key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
+            featureOwnersIdx = availablePoints.select(key);
+          }
+          else
+          {
+            featureOwnersIdx = static_cast<size_t>(rg.genrand_res53() * m_TotalPoints);
+          }
         }
-      }
-      column = static_cast<int64_t>(featureOwnersIdx % m_XPoints);
-      row = static_cast<int64_t>(featureOwnersIdx / m_XPoints) % m_YPoints;
-      plane = static_cast<int64_t>(featureOwnersIdx / (m_XPoints * m_YPoints));
-      xc = static_cast<float>((column * m_XRes) + (m_XRes * 0.5));
-      yc = static_cast<float>((row * m_YRes) + (m_YRes * 0.5));
-      zc = static_cast<float>((plane * m_ZRes) + (m_ZRes * 0.5));
-      oldxc = m_Centroids[3 * randomfeature];
-      oldyc = m_Centroids[3 * randomfeature + 1];
-      oldzc = m_Centroids[3 * randomfeature + 2];
-      m_currentRDFerror = check_RDFerror(-1000, randomfeature, true);
-      update_exclusionZones(-1000, randomfeature, exclusionZonesPtr);
-      move_precipitate(randomfeature, xc, yc, zc);
-      m_currentRDFerror = check_RDFerror(randomfeature, -1000, true);
-      update_exclusionZones(randomfeature, -1000, exclusionZonesPtr);
-      if(m_currentRDFerror >= m_oldRDFerror)
-      {
-        m_oldRDFerror = m_currentRDFerror;
-        update_availablepoints(availablePoints, availablePointsInv);
-        acceptedmoves++;
-      }
-      else
-      {
+        column = static_cast<int64_t>(featureOwnersIdx % m_XPoints);
+        row = static_cast<int64_t>(featureOwnersIdx / m_XPoints) % m_YPoints;
+        plane = static_cast<int64_t>(featureOwnersIdx / (m_XPoints * m_YPoints));
+        xc = static_cast<float>((column * m_XRes) + (m_XRes * 0.5));
+        yc = static_cast<float>((row * m_YRes) + (m_YRes * 0.5));
+        zc = static_cast<float>((plane * m_ZRes) + (m_ZRes * 0.5));
+        oldxc = m_Centroids[3 * randomfeature];
+        oldyc = m_Centroids[3 * randomfeature + 1];
+        oldzc = m_Centroids[3 * randomfeature + 2];
         m_currentRDFerror = check_RDFerror(-1000, randomfeature, true);
         update_exclusionZones(-1000, randomfeature, exclusionZonesPtr);
-        move_precipitate(randomfeature, oldxc, oldyc, oldzc);
+        move_precipitate(randomfeature, xc, yc, zc);
         m_currentRDFerror = check_RDFerror(randomfeature, -1000, true);
         update_exclusionZones(randomfeature, -1000, exclusionZonesPtr);
-        m_oldRDFerror = m_currentRDFerror;
-        m_PointsToRemove.clear();
-        m_PointsToAdd.clear();
-      }
+        if(m_currentRDFerror >= m_oldRDFerror)
+        {
+          m_oldRDFerror = m_currentRDFerror;
+          update_availablepoints(availablePoints);
+          acceptedmoves++;
+        }
+        else
+        {
+          m_currentRDFerror = check_RDFerror(-1000, randomfeature, true);
+          update_exclusionZones(-1000, randomfeature, exclusionZonesPtr);
+          move_precipitate(randomfeature, oldxc, oldyc, oldzc);
+          m_currentRDFerror = check_RDFerror(randomfeature, -1000, true);
+          update_exclusionZones(randomfeature, -1000, exclusionZonesPtr);
+          m_oldRDFerror = m_currentRDFerror;
+          m_PointsToRemove.clear();
+          m_PointsToAdd.clear();
+        }
 
-      if(write_test_outputs && iteration % 100 == 0)
-      {
-        testFile << "\n" << m_oldRDFerror;
+        if(write_test_outputs && iteration % 100 == 0)
+        {
+          testFile << "\n" << m_oldRDFerror;
+        }
       }
     }
     if(write_test_outputs)
@@ -1927,33 +2210,19 @@ void InsertPrecipitatePhases::update_exclusionZones(int32_t gadd, int32_t gremov
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void InsertPrecipitatePhases::update_availablepoints(std::map<size_t, size_t>& availablePoints, std::map<size_t, size_t>& availablePointsInv)
+void InsertPrecipitatePhases::update_availablepoints(AvailablePointsBitmap& availablePoints)
 {
   size_t removeSize = m_PointsToRemove.size();
   size_t addSize = m_PointsToAdd.size();
-  size_t featureOwnersIdx = 0;
-  size_t key = 0, val = 0;
   for(size_t i = 0; i < addSize; i++)
   {
-    featureOwnersIdx = m_PointsToAdd[i];
-    availablePoints[featureOwnersIdx] = m_AvailablePointsCount;
-    availablePointsInv[m_AvailablePointsCount] = featureOwnersIdx;
-    m_AvailablePointsCount++;
+    availablePoints.insert(m_PointsToAdd[i]);
   }
   for(size_t i = 0; i < removeSize; i++)
   {
-    featureOwnersIdx = m_PointsToRemove[i];
-    key = availablePoints[featureOwnersIdx];
-    //  availablePoints.erase(featureOwnersIdx);
-    val = availablePointsInv[m_AvailablePointsCount - 1];
-    //  availablePointsInv.erase(availablePointsCount-1);
-    if(key < m_AvailablePointsCount - 1)
-    {
-      availablePointsInv[key] = val;
-      availablePoints[val] = key;
-    }
-    m_AvailablePointsCount--;
+    availablePoints.erase(m_PointsToRemove[i]);
   }
+  m_AvailablePointsCount = availablePoints.size();
   m_PointsToRemove.clear();
   m_PointsToAdd.clear();
 }
@@ -2130,6 +2399,36 @@ float InsertPrecipitatePhases::check_RDFerror(int32_t gadd, int32_t gremove, boo
   return rdferror;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void InsertPrecipitatePhases::determineMoveRDFChange(MoveCandidate& candidate, const std::vector<int32_t>& batchSlot)
+{
+  int32_t gnum = candidate.feature;
+  int32_t phase = m_FeaturePhases[gnum];
+  const float* oldCentroid = m_Centroids + 3 * gnum;
+  size_t numFeatures = m_FeaturePhasesPtr.lock()->getNumberOfTuples();
+
+  // Removing the precipitate takes 2 off the bin of every distance to its old position and adding it back
+  // puts 2 on the bin of every distance to its new position, exactly as check_RDFerror does with double counting
+  candidate.rdfChange.assign(m_RdfCurrentDist.size(), 0.0f);
+  candidate.numPPTfeatures = 1;
+  for(size_t n = size_t(m_FirstPrecipitateFeature); n < numFeatures; n++)
+  {
+    if(m_FeaturePhases[n] == phase && n != static_cast<size_t>(gnum))
+    {
+      // determine_currentRDF normalizes by the same count
+      candidate.numPPTfeatures++;
+    }
+    if(m_FeaturePhases[n] == phase && batchSlot[n] < 0)
+    {
+      const float* centroid = m_Centroids + 3 * n;
+      candidate.rdfChange[rdfBinIndex(pairDistance(oldCentroid, centroid), m_rdfMin, m_StepSize)] -= 2.0f;
+      candidate.rdfChange[rdfBinIndex(pairDistance(candidate.newCentroid, centroid), m_rdfMin, m_StepSize)] += 2.0f;
+    }
+  }
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -3265,6 +3564,42 @@ bool InsertPrecipitatePhases::getMatchRDF() const
   return m_MatchRDF;
 }
 
+// -----------------------------------------------------------------------------
+void InsertPrecipitatePhases::setUseParallelMoveBatches(bool value)
+{
+  m_UseParallelMoveBatches = value;
+}
+
+// -----------------------------------------------------------------------------
+bool InsertPrecipitatePhases::getUseParallelMoveBatches() const
+{
+  return m_UseParallelMoveBatches;
+}
+
+// -----------------------------------------------------------------------------
+void InsertPrecipitatePhases::setUseRandomSeed(bool value)
+{
+  m_UseRandomSeed = value;
+}
+
+// -----------------------------------------------------------------------------
+bool InsertPrecipitatePhases::getUseRandomSeed() const
+{
+  return m_UseRandomSeed;
+}
+
+// -----------------------------------------------------------------------------
+void InsertPrecipitatePhases::setRandomSeed(int value)
+{
+  m_RandomSeed = value;
+}
+
+// -----------------------------------------------------------------------------
+int InsertPrecipitatePhases::getRandomSeed() const
+{
+  return m_RandomSeed;
+}
+
 // -----------------------------------------------------------------------------
 void InsertPrecipitatePhases::setWriteGoalAttributes(bool value)
 {
@@ -62,6 +62,7 @@ struct Precip_t
 };
 
 #include "SyntheticBuilding/SyntheticBuildingDLLExport.h"
+#include "SyntheticBuilding/SyntheticBuildingFilters/AvailablePointsBitmap.h"
 
 /**
  * @brief The InsertPrecipitatePhases class. See [Filter documentation](@ref insertprecipitatephases) for details.
@@ -101,6 +102,9 @@ class SyntheticBuilding_EXPORT InsertPrecipitatePhases : public AbstractFilter
   PYB11_PROPERTY(int SaveGeometricDescriptions READ getSaveGeometricDescriptions WRITE setSaveGeometricDescriptions)
   PYB11_PROPERTY(DataArrayPath NewAttributeMatrixPath READ getNewAttributeMatrixPath WRITE setNewAttributeMatrixPath)
   PYB11_PROPERTY(DataArrayPath SelectedAttributeMatrixPath READ getSelectedAttributeMatrixPath WRITE setSelectedAttributeMatrixPath)
+  PYB11_PROPERTY(bool UseParallelMoveBatches READ getUseParallelMoveBatches WRITE setUseParallelMoveBatches)
+  PYB11_PROPERTY(bool UseRandomSeed READ getUseRandomSeed WRITE setUseRandomSeed)
+  PYB11_PROPERTY(int RandomSeed READ getRandomSeed WRITE setRandomSeed)
   PYB11_END_BINDINGS()
   // End Python bindings declarations
 
@@ -240,6 +244,39 @@ public:
   bool getMatchRDF() const;
   Q_PROPERTY(bool MatchRDF READ getMatchRDF WRITE setMatchRDF)
 
+  /**
+   * @brief Setter property for UseParallelMoveBatches
+   */
+  void setUseParallelMoveBatches(bool value);
+  /**
+   * @brief Getter property for UseParallelMoveBatches
+   * @return Value of UseParallelMoveBatches
+   */
+  bool getUseParallelMoveBatches() const;
+  Q_PROPERTY(bool UseParallelMoveBatches READ getUseParallelMoveBatches WRITE setUseParallelMoveBatches)
+
+  /**
+   * @brief Setter property for UseRandomSeed
+   */
+  void setUseRandomSeed(bool value);
+  /**
+   * @brief Getter property for UseRandomSeed
+   * @return Value of UseRandomSeed
+   */
+  bool getUseRandomSeed() const;
+  Q_PROPERTY(bool UseRandomSeed READ getUseRandomSeed WRITE setUseRandomSeed)
+
+  /**
+   * @brief Setter property for RandomSeed
+   */
+  void setRandomSeed(int value);
+  /**
+   * @brief Getter property for RandomSeed
+   * @return Value of RandomSeed
+   */
+  int getRandomSeed() const;
+  Q_PROPERTY(int RandomSeed READ getRandomSeed WRITE setRandomSeed)
+
   /**
    * @brief Setter property for WriteGoalAttributes
    */
@@ -593,11 +630,10 @@ protected:
   //    bool check_for_overlap(size_t gNum, Int32ArrayType::Pointer exlusionZonesPtr);
 
   /**
-   * @brief update_availablepoints Updates the maps used to associate packing points with an "available" state
-   * @param availablePoints Map between precipitate owners and number of available points
-   * @param availablePointsInv Inverse associations for the availablePoints map
+   * @brief update_availablepoints Updates the set of points with an "available" state
+   * @param availablePoints Set of available points
    */
-  void update_availablepoints(std::map<size_t, size_t>& availablePoints, std::map<size_t, size_t>& availablePointsInv);
+  void update_availablepoints(AvailablePointsBitmap& availablePoints);
 
   /**
    * @brief determine_currentRDF Determines the radial distribution function about a given precipitate
@@ -638,6 +674,17 @@ protected:
    */
   float check_RDFerror(int32_t gadd, int32_t gremove, bool double_count);
 
+  struct MoveCandidate;
+  friend class InsertPrecipitatePhasesMoveBatchImpl;
+
+  /**
+   * @brief determineMoveRDFChange Computes how a proposed move changes the current radial distribution function,
+   * counting only the distances to precipitates that are not moved by the same batch
+   * @param candidate Proposed move
+   * @param batchSlot Position of each precipitate in the batch or -1
+   */
+  void determineMoveRDFChange(MoveCandidate& candidate, const std::vector<int32_t>& batchSlot);
+
   /**
    * @brief assign_voxels Assigns precipitate Id values to voxels within the packing grid
    */
@@ -739,6 +786,9 @@ private:
   QString m_PrecipInputFile = {};
   bool m_PeriodicBoundaries = {};
   bool m_MatchRDF = {};
+  bool m_UseParallelMoveBatches = {};
+  bool m_UseRandomSeed = {};
+  int m_RandomSeed = {};
   bool m_WriteGoalAttributes = {};
   DataArrayPath m_InputStatsArrayPath = {};
   DataArrayPath m_InputPhaseTypesArrayPath = {};
@@ -35,6 +35,8 @@
 
 #include "MatchCrystallography.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 
 #include <QtCore/QTextStream>
@@ -43,8 +45,10 @@
 #include "SIMPLib/DataContainers/DataContainer.h"
 #include "SIMPLib/DataContainers/DataContainerArray.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
+#include "SIMPLib/FilterParameters/BooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/IntFilterParameter.h"
+#include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedPathCreationFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
@@ -92,6 +96,8 @@ MatchCrystallography::MatchCrystallography()
 , m_FeatureEulerAnglesArrayName(SIMPL::FeatureData::EulerAngles)
 , m_AvgQuatsArrayName(SIMPL::FeatureData::AvgQuats)
 , m_MaxIterations(1)
+, m_UseRandomSeed(false)
+, m_RandomSeed(0)
 {
   m_NeighborList = NeighborList<int32_t>::NullPointer();
   m_SharedSurfaceAreaList = NeighborList<float>::NullPointer();
@@ -117,6 +123,12 @@ void MatchCrystallography::setupFilterParameters()
 {
   FilterParameterVectorType parameters;
   parameters.push_back(SIMPL_NEW_INTEGER_FP("Maximum Number of Iterations (Swaps)", MaxIterations, FilterParameter::Parameter, MatchCrystallography));
+  {
+    QStringList linkedProps;
+    linkedProps << "RandomSeed";
+    parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Use Random Seed", UseRandomSeed, FilterParameter::Parameter, MatchCrystallography, linkedProps));
+  }
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Random Seed", RandomSeed, FilterParameter::Parameter, MatchCrystallography));
 
   parameters.push_back(SeparatorFilterParameter::New("Cell Data", FilterParameter::RequiredArray));
   {
@@ -194,6 +206,8 @@ void MatchCrystallography::readFilterParameters(AbstractFilterParametersReader*
 {
   reader->openFilterGroup(this, index);
   setMaxIterations(reader->readValue("MaxIterations", getMaxIterations()));
+  setUseRandomSeed(reader->readValue("UseRandomSeed", getUseRandomSeed()));
+  setRandomSeed(reader->readValue("RandomSeed", getRandomSeed()));
   setInputStatsArrayPath(reader->readDataArrayPath("InputStatsArrayPath", getInputStatsArrayPath()));
   setCrystalStructuresArrayPath(reader->readDataArrayPath("CrystalStructuresArrayPath", getCrystalStructuresArrayPath()));
   setPhaseTypesArrayPath(reader->readDataArrayPath("PhaseTypesArrayPath", getPhaseTypesArrayPath()));
@@ -368,6 +382,14 @@ void MatchCrystallography::execute()
     return;
   }
 
+  // A fixed seed reproduces the same orientations and swaps on every run
+  std::mt19937_64::result_type seed = static_cast<std::mt19937_64::result_type>(std::chrono::steady_clock::now().time_since_epoch().count());
+  if(m_UseRandomSeed)
+  {
+    seed = static_cast<std::mt19937_64::result_type>(m_RandomSeed);
+  }
+  m_Generator.seed(seed);
+
   m_SyntheticCrystalStructures[0] = m_CrystalStructures[0];
   for(size_t i = 1; i < totalEnsembles; ++i)
   {
@@ -553,10 +575,7 @@ void MatchCrystallography::determine_boundary_areas()
 // -----------------------------------------------------------------------------
 void MatchCrystallography::assign_eulers(size_t ensem)
 {
-  std::random_device randomDevice;           // Will be used to obtain a seed for the random number engine
-  std::mt19937_64 generator(randomDevice()); // Standard mersenne_twister_engine seeded with rd()
-  std::mt19937_64::result_type seed = static_cast<std::mt19937_64::result_type>(std::chrono::steady_clock::now().time_since_epoch().count());
-  generator.seed(seed);
+  std::mt19937_64& generator = m_Generator;
   std::uniform_real_distribution<> distribution(0.0, 1.0);
   std::array<double, 3> randx3;
 
@@ -665,12 +684,13 @@ void MatchCrystallography::MC_LoopBody1(int32_t feature, size_t ensem, size_t j,
 
   rod = OrientationTransformation::ax2ro<OrientationD, OrientationD>(axisAngle);
   newmisobin = ops->getMisoBin(rod);
-  m_MdfChange = m_MdfChange + (((m_ActualMdf->getValue(curmisobin) - m_SimMdf->getValue(curmisobin)) * (m_ActualMdf->getValue(curmisobin) - m_SimMdf->getValue(curmisobin))) -
-                               ((m_ActualMdf->getValue(curmisobin) - (m_SimMdf->getValue(curmisobin) - (neighsurfarea / m_TotalSurfaceArea[ensem]))) *
-                                (m_ActualMdf->getValue(curmisobin) - (m_SimMdf->getValue(curmisobin) - (neighsurfarea / m_TotalSurfaceArea[ensem])))));
-  m_MdfChange = m_MdfChange + (((m_ActualMdf->getValue(newmisobin) - m_SimMdf->getValue(newmisobin)) * (m_ActualMdf->getValue(newmisobin) - m_SimMdf->getValue(newmisobin))) -
-                               ((m_ActualMdf->getValue(newmisobin) - (m_SimMdf->getValue(newmisobin) + (neighsurfarea / m_TotalSurfaceArea[ensem]))) *
-                                (m_ActualMdf->getValue(newmisobin) - (m_SimMdf->getValue(newmisobin) + (neighsurfarea / m_TotalSurfaceArea[ensem])))));
+  const float* actualMdf = m_ActualMdf->getPointer(0);
+  const float* simMdf = m_SimMdf->getPointer(0);
+  float areaFraction = neighsurfarea / m_TotalSurfaceArea[ensem];
+  m_MdfChange = m_MdfChange + (((actualMdf[curmisobin] - simMdf[curmisobin]) * (actualMdf[curmisobin] - simMdf[curmisobin])) -
+                               ((actualMdf[curmisobin] - (simMdf[curmisobin] - areaFraction)) * (actualMdf[curmisobin] - (simMdf[curmisobin] - areaFraction))));
+  m_MdfChange = m_MdfChange + (((actualMdf[newmisobin] - simMdf[newmisobin]) * (actualMdf[newmisobin] - simMdf[newmisobin])) -
+                               ((actualMdf[newmisobin] - (simMdf[newmisobin] + areaFraction)) * (actualMdf[newmisobin] - (simMdf[newmisobin] + areaFraction))));
 }
 
 // -----------------------------------------------------------------------------
@@ -708,8 +728,8 @@ void MatchCrystallography::MC_LoopBody2(int32_t feature, size_t ensem, size_t j,
   m_MisorientationLists[feature][3 * j] = miso1;
   m_MisorientationLists[feature][3 * j + 1] = miso2;
   m_MisorientationLists[feature][3 * j + 2] = miso3;
-  m_SimMdf->setValue(curmisobin, (m_SimMdf->getValue(curmisobin) - (neighsurfarea / m_TotalSurfaceArea[ensem])));
-  m_SimMdf->setValue(newmisobin, (m_SimMdf->getValue(newmisobin) + (neighsurfarea / m_TotalSurfaceArea[ensem])));
+  setSimMdfValue(curmisobin, (m_SimMdf->getValue(curmisobin) - (neighsurfarea / m_TotalSurfaceArea[ensem])));
+  setSimMdfValue(newmisobin, (m_SimMdf->getValue(newmisobin) + (neighsurfarea / m_TotalSurfaceArea[ensem])));
 }
 
 // -----------------------------------------------------------------------------
@@ -725,10 +745,7 @@ void MatchCrystallography::matchCrystallography(size_t ensem)
   size_t totalPoints = m_FeatureIdsPtr.lock()->getNumberOfTuples();
   size_t totalFeatures = m_FeaturePhasesPtr.lock()->getNumberOfTuples();
 
-  std::random_device randomDevice;           // Will be used to obtain a seed for the random number engine
-  std::mt19937_64 generator(randomDevice()); // Standard mersenne_twister_engine seeded with rd()
-  std::mt19937_64::result_type seed = static_cast<std::mt19937_64::result_type>(std::chrono::steady_clock::now().time_since_epoch().count());
-  generator.seed(seed);
+  std::mt19937_64& generator = m_Generator;
   std::uniform_real_distribution<> distribution(0.0, 1.0);
   std::array<double, 3> randx3;
 
@@ -755,6 +772,11 @@ void MatchCrystallography::matchCrystallography(size_t ensem)
   LaueOps::Pointer laueOp = laueOps[laueIndex];
   numbins = laueOp->getODFSize();
 
+  // The errors are computed once here and then updated with every bin that an accepted swap or switch changes
+  m_NumOdfErrorBins = static_cast<size_t>(numbins);
+  m_NumMdfErrorBins = std::min(static_cast<size_t>(numbins), m_SimMdf->getNumberOfTuples());
+  computeFitErrors();
+
   uint64_t millis = QDateTime::currentMSecsSinceEpoch();
   uint64_t startMillis = millis;
   int32_t lastIteration = 0;
@@ -773,20 +795,8 @@ void MatchCrystallography::matchCrystallography(size_t ensem)
       millis = QDateTime::currentMSecsSinceEpoch();
       lastIteration = iterations;
     }
-    currentodferror = 0;
-    currentmdferror = 0;
-    float* actualOdfPtr = m_ActualOdf->getPointer(0);
-    float* simOdfPtr = m_SimOdf->getPointer(0);
-    float delta = 0.0f;
-    for(int32_t i = 0; i < numbins; i++)
-    {
-      delta = actualOdfPtr[i] - simOdfPtr[i];
-      currentodferror = currentodferror + (delta * delta);
-    }
-    for(int32_t i = 0; i < (numbins); i++)
-    {
-      currentmdferror = currentmdferror + ((m_ActualMdf->getValue(i) - m_SimMdf->getValue(i)) * (m_ActualMdf->getValue(i) - m_SimMdf->getValue(i)));
-    }
+    currentodferror = static_cast<float>(m_CurrentOdfError);
+    currentmdferror = static_cast<float>(m_CurrentMdfError);
     iterations++;
     badtrycount++;
     random = static_cast<float>(distribution(generator));
@@ -876,8 +886,8 @@ void MatchCrystallography::matchCrystallography(size_t ensem)
           m_FeatureEulerAngles[3 * selectedfeature1 + 1] = g1ea2;
           m_FeatureEulerAngles[3 * selectedfeature1 + 2] = g1ea3;
           q1.copyInto(m_AvgQuats + selectedfeature1 * 4, Quaternion<float>::Order::VectorScalar);
-          m_SimOdf->setValue(choose, (m_SimOdf->getValue(choose) + (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem])));
-          m_SimOdf->setValue(g1odfbin, (m_SimOdf->getValue(g1odfbin) - (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem])));
+          setSimOdfValue(choose, (m_SimOdf->getValue(choose) + (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem])));
+          setSimOdfValue(g1odfbin, (m_SimOdf->getValue(g1odfbin) - (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem])));
           size = 0;
           if(!neighborlist[selectedfeature1].empty())
           {
@@ -1030,8 +1040,8 @@ void MatchCrystallography::matchCrystallography(size_t ensem)
             m_FeatureEulerAngles[3 * selectedfeature2] = g1ea1;
             m_FeatureEulerAngles[3 * selectedfeature2 + 1] = g1ea2;
             m_FeatureEulerAngles[3 * selectedfeature2 + 2] = g1ea3;
-            m_SimOdf->setValue(g1odfbin, (m_SimOdf->getValue(g1odfbin) + (m_Volumes[selectedfeature2] / m_UnbiasedVolume[ensem]) - (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem])));
-            m_SimOdf->setValue(g2odfbin, (m_SimOdf->getValue(g2odfbin) + (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem]) - (m_Volumes[selectedfeature2] / m_UnbiasedVolume[ensem])));
+            setSimOdfValue(g1odfbin, (m_SimOdf->getValue(g1odfbin) + (m_Volumes[selectedfeature2] / m_UnbiasedVolume[ensem]) - (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem])));
+            setSimOdfValue(g2odfbin, (m_SimOdf->getValue(g2odfbin) + (m_Volumes[selectedfeature1] / m_UnbiasedVolume[ensem]) - (m_Volumes[selectedfeature2] / m_UnbiasedVolume[ensem])));
 
             q1 = OrientationTransformation::eu2qu<OrientationD, QuatF>(OrientationD(g1ea1, g1ea2, g1ea3));
             q1.copyInto(m_AvgQuats + selectedfeature1 * 4, Quaternion<float>::Order::VectorScalar);
@@ -1097,6 +1107,73 @@ void MatchCrystallography::matchCrystallography(size_t ensem)
   }
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MatchCrystallography::computeFitErrors()
+{
+  const float* actualOdf = m_ActualOdf->getPointer(0);
+  const float* simOdf = m_SimOdf->getPointer(0);
+  const float* actualMdf = m_ActualMdf->getPointer(0);
+  const float* simMdf = m_SimMdf->getPointer(0);
+
+  m_CurrentOdfError = 0.0;
+  for(size_t i = 0; i < m_NumOdfErrorBins; i++)
+  {
+    double delta = actualOdf[i] - simOdf[i];
+    m_CurrentOdfError += delta * delta;
+  }
+  m_CurrentMdfError = 0.0;
+  for(size_t i = 0; i < m_NumMdfErrorBins; i++)
+  {
+    double delta = actualMdf[i] - simMdf[i];
+    m_CurrentMdfError += delta * delta;
+  }
+  m_NumFitErrorUpdates = 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MatchCrystallography::setSimOdfValue(size_t bin, float value)
+{
+  if(bin < m_NumOdfErrorBins)
+  {
+    double oldDelta = m_ActualOdf->getValue(bin) - m_SimOdf->getValue(bin);
+    double newDelta = m_ActualOdf->getValue(bin) - value;
+    m_CurrentOdfError += newDelta * newDelta - oldDelta * oldDelta;
+  }
+  m_SimOdf->setValue(bin, value);
+  countFitErrorUpdate();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MatchCrystallography::setSimMdfValue(size_t bin, float value)
+{
+  if(bin < m_NumMdfErrorBins)
+  {
+    double oldDelta = m_ActualMdf->getValue(bin) - m_SimMdf->getValue(bin);
+    double newDelta = m_ActualMdf->getValue(bin) - value;
+    m_CurrentMdfError += newDelta * newDelta - oldDelta * oldDelta;
+  }
+  m_SimMdf->setValue(bin, value);
+  countFitErrorUpdate();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void MatchCrystallography::countFitErrorUpdate()
+{
+  m_NumFitErrorUpdates++;
+  if(m_NumFitErrorUpdates >= m_NumOdfErrorBins + m_NumMdfErrorBins)
+  {
+    computeFitErrors();
+  }
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -1437,3 +1514,27 @@ int MatchCrystallography::getMaxIterations() const
 {
   return m_MaxIterations;
 }
+
+// -----------------------------------------------------------------------------
+void MatchCrystallography::setUseRandomSeed(bool value)
+{
+  m_UseRandomSeed = value;
+}
+
+// -----------------------------------------------------------------------------
+bool MatchCrystallography::getUseRandomSeed() const
+{
+  return m_UseRandomSeed;
+}
+
+// -----------------------------------------------------------------------------
+void MatchCrystallography::setRandomSeed(int value)
+{
+  m_RandomSeed = value;
+}
+
+// -----------------------------------------------------------------------------
+int MatchCrystallography::getRandomSeed() const
+{
+  return m_RandomSeed;
+}
@@ -36,6 +36,7 @@
 #pragma once
 
 #include <memory>
+#include <random>
 
 #include "SIMPLib/SIMPLib.h"
 #include "SIMPLib/DataArrays/DataArray.hpp"
@@ -77,6 +78,8 @@ class SyntheticBuilding_EXPORT MatchCrystallography : public AbstractFilter
   PYB11_PROPERTY(QString FeatureEulerAnglesArrayName READ getFeatureEulerAnglesArrayName WRITE setFeatureEulerAnglesArrayName)
   PYB11_PROPERTY(QString AvgQuatsArrayName READ getAvgQuatsArrayName WRITE setAvgQuatsArrayName)
   PYB11_PROPERTY(int MaxIterations READ getMaxIterations WRITE setMaxIterations)
+  PYB11_PROPERTY(bool UseRandomSeed READ getUseRandomSeed WRITE setUseRandomSeed)
+  PYB11_PROPERTY(int RandomSeed READ getRandomSeed WRITE setRandomSeed)
   PYB11_END_BINDINGS()
   // End Python bindings declarations
 
@@ -267,6 +270,28 @@ public:
   int getMaxIterations() const;
   Q_PROPERTY(int MaxIterations READ getMaxIterations WRITE setMaxIterations)
 
+  /**
+   * @brief Setter property for UseRandomSeed
+   */
+  void setUseRandomSeed(bool value);
+  /**
+   * @brief Getter property for UseRandomSeed
+   * @return Value of UseRandomSeed
+   */
+  bool getUseRandomSeed() const;
+  Q_PROPERTY(bool UseRandomSeed READ getUseRandomSeed WRITE setUseRandomSeed)
+
+  /**
+   * @brief Setter property for RandomSeed
+   */
+  void setRandomSeed(int value);
+  /**
+   * @brief Getter property for RandomSeed
+   * @return Value of RandomSeed
+   */
+  int getRandomSeed() const;
+  Q_PROPERTY(int RandomSeed READ getRandomSeed WRITE setRandomSeed)
+
   /**
    * @brief getCompiledLibraryName Reimplemented from @see AbstractFilter class
    */
@@ -402,6 +427,32 @@ protected:
    */
   void matchCrystallography(size_t ensem);
 
+  /**
+   * @brief computeFitErrors Sums the squared differences between the actual and simulated ODF and MDF bins
+   * from scratch
+   */
+  void computeFitErrors();
+
+  /**
+   * @brief setSimOdfValue Sets a bin of the simulated ODF and updates the ODF error by the change of that bin
+   * @param bin ODF bin index
+   * @param value New value of the bin
+   */
+  void setSimOdfValue(size_t bin, float value);
+
+  /**
+   * @brief setSimMdfValue Sets a bin of the simulated MDF and updates the MDF error by the change of that bin
+   * @param bin MDF bin index
+   * @param value New value of the bin
+   */
+  void setSimMdfValue(size_t bin, float value);
+
+  /**
+   * @brief countFitErrorUpdate Recomputes the errors after as many bin updates as there are bins, which keeps
+   * the rounding errors of the updates from accumulating
+   */
+  void countFitErrorUpdate();
+
   /**
    * @brief measure_misorientations Determines the misorientations between each Feature
    * @param ensem Ensemle index of the current phase
@@ -446,6 +497,8 @@ private:
   QString m_FeatureEulerAnglesArrayName = {};
   QString m_AvgQuatsArrayName = {};
   int m_MaxIterations = {};
+  bool m_UseRandomSeed = {};
+  int m_RandomSeed = {};
 
   // Cell Data
 
@@ -462,6 +515,14 @@ private:
   float m_MdfChange;
   float m_OdfChange;
 
+  double m_CurrentOdfError = 0.0;
+  double m_CurrentMdfError = 0.0;
+  size_t m_NumOdfErrorBins = 0;
+  size_t m_NumMdfErrorBins = 0;
+  size_t m_NumFitErrorUpdates = 0;
+
+  std::mt19937_64 m_Generator;
+
   std::vector<float> m_UnbiasedVolume;
   std::vector<float> m_TotalSurfaceArea;
 
@@ -35,6 +35,8 @@
 
 #include "PackPrimaryPhases.h"
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 
 #include <QtCore/QDebug>
@@ -54,6 +56,7 @@
 #include "SIMPLib/FilterParameters/BooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/InputFileFilterParameter.h"
+#include "SIMPLib/FilterParameters/IntFilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedChoicesFilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedPathCreationFilterParameter.h"
@@ -77,6 +80,7 @@
 #include "EbsdLib/LaueOps/OrthoRhombicOps.h"
 
 #ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+#include <tbb/blocked_range.h>
 #include <tbb/blocked_range3d.h>
 #include <tbb/parallel_for.h>
 #include <tbb/partitioner.h>
@@ -85,8 +89,279 @@
 namespace
 {
 OrthoRhombicOps::Pointer m_OrthoOps;
+
+/**
+ * @brief neighborhoodBin Returns the bin of the 40 bin neighbor distribution that a neighborhood value falls in
+ */
+size_t neighborhoodBin(int32_t nnum, float oneOverNeighborDistStep)
+{
+  size_t nnumbin = static_cast<size_t>(nnum * oneOverNeighborDistStep);
+  if(nnumbin >= 40)
+  {
+    nnumbin = 39;
+  }
+  return nnumbin;
+}
+
+/**
+ * @brief neighborGridCoordinate Returns the neighbor grid cell coordinate along one axis, clamped into the grid
+ */
+int64_t neighborGridCoordinate(float value, float oneOverCellSize, int64_t dim)
+{
+  int64_t coord = static_cast<int64_t>(std::floor(value * oneOverCellSize));
+  if(coord < 0)
+  {
+    coord = 0;
+  }
+  if(coord > dim - 1)
+  {
+    coord = dim - 1;
+  }
+  return coord;
 }
 
+/**
+ * @brief packingPointIndex Finds the packing grid index of a point of a Feature's point lists, wrapping the point
+ * around the grid for periodic boundaries
+ * @return false if the point lies outside of a non periodic packing grid
+ */
+bool packingPointIndex(int64_t col, int64_t row, int64_t plane, const int64_t* packingPoints, bool periodicBoundaries, size_t& featureOwnersIdx)
+{
+  if(periodicBoundaries)
+  {
+    // Perform mod arithmetic to ensure we are within the packing points range
+    col = col % packingPoints[0];
+    row = row % packingPoints[1];
+    plane = plane % packingPoints[2];
+
+    if(col < 0)
+    {
+      col = col + packingPoints[0];
+    }
+    if(col > packingPoints[0] - 1)
+    {
+      col = col - packingPoints[0];
+    }
+    if(row < 0)
+    {
+      row = row + packingPoints[1];
+    }
+    if(row > packingPoints[1] - 1)
+    {
+      row = row - packingPoints[1];
+    }
+    if(plane < 0)
+    {
+      plane = plane + packingPoints[2];
+    }
+    if(plane > packingPoints[2] - 1)
+    {
+      plane = plane - packingPoints[2];
+    }
+  }
+  else if(col < 0 || col >= packingPoints[0] || row < 0 || row >= packingPoints[1] || plane < 0 || plane >= packingPoints[2])
+  {
+    return false;
+  }
+  featureOwnersIdx = (packingPoints[0] * packingPoints[1] * plane) + (packingPoints[0] * row) + col;
+  return true;
+}
+
+// Number of candidate moves proposed per batch. It does not depend on the number of threads,
+// so a given seed always produces the same packing.
+const int32_t k_MoveBatchSize = 64;
+
+/**
+ * @brief The MoveBlockGrid class tracks which blocks of packing points are touched by the moves of the current
+ * batch, so that a batch only holds moves that can be evaluated independently of each other
+ */
+class MoveBlockGrid
+{
+public:
+  MoveBlockGrid(const int64_t* packingPoints, bool periodicBoundaries)
+  : m_PeriodicBoundaries(periodicBoundaries)
+  {
+    for(size_t a = 0; a < 3; a++)
+    {
+      m_PackingPoints[a] = packingPoints[a];
+      m_BlockDims[a] = (packingPoints[a] + k_BlockSize - 1) / k_BlockSize;
+    }
+    m_Stamps.assign(static_cast<size_t>(m_BlockDims[0] * m_BlockDims[1] * m_BlockDims[2]), -1);
+  }
+
+  void nextBatch()
+  {
+    m_Batch++;
+  }
+
+  /**
+   * @brief claim Claims the blocks under the boxes of a move for the current batch. Nothing is claimed and
+   * false is returned if an earlier move of the batch already holds one of the blocks.
+   * @param boxes Packing point boxes {minColumn, maxColumn, minRow, maxRow, minPlane, maxPlane} before and after the move
+   */
+  bool claim(const int64_t boxes[2][6])
+  {
+    for(size_t b = 0; b < 2; b++)
+    {
+      if(!visitBlocks(boxes[b], false))
+      {
+        return false;
+      }
+    }
+    for(size_t b = 0; b < 2; b++)
+    {
+      visitBlocks(boxes[b], true);
+    }
+    return true;
+  }
+
+private:
+  static const int64_t k_BlockSize = 8;
+  int64_t m_PackingPoints[3] = {0, 0, 0};
+  int64_t m_BlockDims[3] = {0, 0, 0};
+  bool m_PeriodicBoundaries = false;
+  int64_t m_Batch = 0;
+  std::vector<int64_t> m_Stamps;
+
+  /**
+   * @brief blockRanges Converts the packing point interval [lo, hi] along one axis into at most two block ranges
+   * @return Number of block ranges
+   */
+  size_t blockRanges(size_t axis, int64_t lo, int64_t hi, int64_t ranges[2][2]) const
+  {
+    const int64_t points = m_PackingPoints[axis];
+    if(lo > hi)
+    {
+      return 0;
+    }
+    if(!m_PeriodicBoundaries)
+    {
+      lo = std::max<int64_t>(lo, 0);
+      hi = std::min<int64_t>(hi, points - 1);
+      if(lo > hi)
+      {
+        return 0;
+      }
+      ranges[0][0] = lo / k_BlockSize;
+      ranges[0][1] = hi / k_BlockSize;
+      return 1;
+    }
+    if(hi - lo + 1 >= points)
+    {
+      ranges[0][0] = 0;
+      ranges[0][1] = m_BlockDims[axis] - 1;
+      return 1;
+    }
+    lo = ((lo % points) + points) % points;
+    hi = ((hi % points) + points) % points;
+    if(lo <= hi)
+    {
+      ranges[0][0] = lo / k_BlockSize;
+      ranges[0][1] = hi / k_BlockSize;
+      return 1;
+    }
+    ranges[0][0] = lo / k_BlockSize;
+    ranges[0][1] = m_BlockDims[axis] - 1;
+    ranges[1][0] = 0;
+    ranges[1][1] = hi / k_BlockSize;
+    return 2;
+  }
+
+  bool visitBlocks(const int64_t* box, bool mark)
+  {
+    int64_t ranges[3][2][2];
+    size_t numRanges[3] = {0, 0, 0};
+    for(size_t a = 0; a < 3; a++)
+    {
+      numRanges[a] = blockRanges(a, box[2 * a], box[2 * a + 1], ranges[a]);
+      if(numRanges[a] == 0)
+      {
+        // the box does not cover a single packing point
+        return true;
+      }
+    }
+    for(size_t rz = 0; rz < numRanges[2]; rz++)
+    {
+      for(int64_t bz = ranges[2][rz][0]; bz <= ranges[2][rz][1]; bz++)
+      {
+        for(size_t ry = 0; ry < numRanges[1]; ry++)
+        {
+          for(int64_t by = ranges[1][ry][0]; by <= ranges[1][ry][1]; by++)
+          {
+            for(size_t rx = 0; rx < numRanges[0]; rx++)
+            {
+              for(int64_t bx = ranges[0][rx][0]; bx <= ranges[0][rx][1]; bx++)
+              {
+                size_t block = static_cast<size_t>((bz * m_BlockDims[1] + by) * m_BlockDims[0] + bx);
+                if(mark)
+                {
+                  m_Stamps[block] = m_Batch;
+                }
+                else if(m_Stamps[block] == m_Batch)
+                {
+                  return false;
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+    return true;
+  }
+};
+} // namespace
+
+/**
+ * @brief The MoveCandidate struct holds one proposed move of a batch and the outcome of its evaluation
+ */
+struct PackPrimaryPhases::MoveCandidate
+{
+  int32_t feature = 0;
+  float oldCentroid[3] = {0.0f, 0.0f, 0.0f};
+  float newCentroid[3] = {0.0f, 0.0f, 0.0f};
+  bool accepted = false;
+  int64_t fillingChange = 0;
+  std::vector<size_t> pointsToRemove;
+  std::vector<size_t> pointsToAdd;
+};
+
+/**
+ * @brief The PackPrimaryPhasesMoveBatchImpl class evaluates the moves of a batch. The moves of a batch touch
+ * disjoint packing points, so each one sees the same packing regardless of the order they are evaluated in.
+ */
+class PackPrimaryPhasesMoveBatchImpl
+{
+public:
+  PackPrimaryPhasesMoveBatchImpl(PackPrimaryPhases* filter, std::vector<PackPrimaryPhases::MoveCandidate>& candidates, int32_t* featureOwners, int32_t* exclusionOwners)
+  : m_Filter(filter)
+  , m_Candidates(candidates)
+  , m_FeatureOwners(featureOwners)
+  , m_ExclusionOwners(exclusionOwners)
+  {
+  }
+
+  void convert(size_t start, size_t end) const
+  {
+    for(size_t c = start; c < end; c++)
+    {
+      m_Filter->evaluateMoveCandidate(m_Candidates[c], m_FeatureOwners, m_ExclusionOwners);
+    }
+  }
+
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+  void operator()(const tbb::blocked_range<size_t>& r) const
+  {
+    convert(r.begin(), r.end());
+  }
+#endif
+private:
+  PackPrimaryPhases* m_Filter;
+  std::vector<PackPrimaryPhases::MoveCandidate>& m_Candidates;
+  int32_t* m_FeatureOwners;
+  int32_t* m_ExclusionOwners;
+};
+
 /* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
 enum createdPathID : RenameDataPath::DataID_t
 {
@@ -285,6 +560,9 @@ PackPrimaryPhases::PackPrimaryPhases()
 , m_FeatureInputFile("")
 , m_CsvOutputFile("")
 , m_PeriodicBoundaries(false)
+, m_UseParallelMoveBatches(false)
+, m_UseRandomSeed(false)
+, m_RandomSeed(0)
 , m_WriteGoalAttributes(false)
 , m_SaveGeometricDescriptions(0)
 , m_NewAttributeMatrixPath(SIMPL::Defaults::SyntheticVolumeDataContainerName, PrimaryPhaseSyntheticShapeParametersName, "")
@@ -371,6 +649,13 @@ void PackPrimaryPhases::setupFilterParameters()
 {
   FilterParameterVectorType parameters;
   parameters.push_back(SIMPL_NEW_BOOL_FP("Periodic Boundaries", PeriodicBoundaries, FilterParameter::Parameter, PackPrimaryPhases));
+  parameters.push_back(SIMPL_NEW_BOOL_FP("Use Parallel Move Batches", UseParallelMoveBatches, FilterParameter::Parameter, PackPrimaryPhases));
+  {
+    QStringList linkedProps;
+    linkedProps << "RandomSeed";
+    parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Use Random Seed", UseRandomSeed, FilterParameter::Parameter, PackPrimaryPhases, linkedProps));
+  }
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Random Seed", RandomSeed, FilterParameter::Parameter, PackPrimaryPhases));
   QStringList linkedProps("MaskArrayPath");
   parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Use Mask", UseMask, FilterParameter::Parameter, PackPrimaryPhases, linkedProps));
   parameters.push_back(SeparatorFilterParameter::New("Cell Data", FilterParameter::RequiredArray));
@@ -521,6 +806,9 @@ void PackPrimaryPhases::readFilterParameters(AbstractFilterParametersReader* rea
   setFeaturePhasesArrayName(reader->readString("FeaturePhasesArrayName", getFeaturePhasesArrayName()));
   setNumFeaturesArrayName(reader->readString("NumFeaturesArrayName", getNumFeaturesArrayName()));
   setPeriodicBoundaries(reader->readValue("PeriodicBoundaries", false));
+  setUseParallelMoveBatches(reader->readValue("UseParallelMoveBatches", getUseParallelMoveBatches()));
+  setUseRandomSeed(reader->readValue("UseRandomSeed", getUseRandomSeed()));
+  setRandomSeed(reader->readValue("RandomSeed", getRandomSeed()));
   setWriteGoalAttributes(reader->readValue("WriteGoalAttributes", false));
   setUseMask(reader->readValue("UseMask", getUseMask()));
 
@@ -1097,7 +1385,12 @@ void PackPrimaryPhases::placeFeatures(Int32ArrayType::Pointer featureOwnersPtr)
     writeErrorFile = outFile.is_open();
   }
 
+  // A fixed seed reproduces the same packing on every run
   m_Seed = QDateTime::currentMSecsSinceEpoch();
+  if(m_UseRandomSeed)
+  {
+    m_Seed = static_cast<uint64_t>(m_RandomSeed);
+  }
   SIMPL_RANDOMNG_NEW_SEEDED(m_Seed);
 
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getOutputCellAttributeMatrixPath().getDataContainerName());
@@ -1185,8 +1478,7 @@ void PackPrimaryPhases::placeFeatures(Int32ArrayType::Pointer featureOwnersPtr)
   exclusionOwnersPtr->initializeWithValue(0);
 
   // This is the set that we are going to keep updated with the points that are not in an exclusion zone
-  std::map<size_t, size_t> availablePoints;
-  std::map<size_t, size_t> availablePointsInv;
+  AvailablePointsBitmap availablePoints(static_cast<size_t>(m_TotalPackingPoints));
 
   // Get a pointer to the Feature Owners that was just initialized in the initialize_packinggrid() method
   int32_t* featureOwners = featureOwnersPtr->getPointer(0);
@@ -1194,16 +1486,8 @@ void PackPrimaryPhases::placeFeatures(Int32ArrayType::Pointer featureOwnersPtr)
   int64_t featureOwnersIdx = 0;
 
   // determine initial set of available points
-  m_AvailablePointsCount = 0;
-  for(int64_t i = 0; i < m_TotalPackingPoints; i++)
-  {
-    if((exclusionOwners[i] == 0 && !m_UseMask) || (exclusionOwners[i] == 0 && m_UseMask && m_Mask[i]))
-    {
-      availablePoints[i] = m_AvailablePointsCount;
-      availablePointsInv[m_AvailablePointsCount] = i;
-      m_AvailablePointsCount++;
-    }
-  }
+  availablePoints.fill([&](size_t i) { return exclusionOwners[i] == 0 && (!m_UseMask || m_Mask[i]); });
+  m_AvailablePointsCount = availablePoints.size();
   // and clear the pointsToRemove and pointsToAdd vectors from the initial packing
   m_PointsToRemove.clear();
   m_PointsToAdd.clear();
@@ -1421,6 +1705,9 @@ void PackPrimaryPhases::placeFeatures(Int32ArrayType::Pointer featureOwnersPtr)
   m_EllipFuncList.resize(totalFeatures);
   m_PackQualities.resize(totalFeatures);
   m_FillingError = 1.0f;
+  m_NeighborGridCells.clear();
+  m_NeighborGridCellIndex.clear();
+  m_NeighborGridSlot.clear();
 
   int64_t count = 0;
   int64_t column = 0, row = 0, plane = 0;
@@ -1493,6 +1780,10 @@ void PackPrimaryPhases::placeFeatures(Int32ArrayType::Pointer featureOwnersPtr)
   uint64_t estimatedTime = 0;
   float timeDiff = 0.0f;
 
+  // all Features are placed now, so from here on moves keep the neighbor grid and the neighborhood histograms current
+  initializeNeighborGrid(totalFeatures);
+  initializeNeighborhoodHistograms(totalFeatures);
+
   // determine neighborhoods and initial neighbor distribution errors
   for(size_t i = m_FirstPrimaryFeature; i < totalFeatures; i++)
   {
@@ -1515,16 +1806,8 @@ void PackPrimaryPhases::placeFeatures(Int32ArrayType::Pointer featureOwnersPtr)
   int32_t totalAdjustments = static_cast<int32_t>(100 * (totalFeatures - 1));
 
   // determine initial set of available points
-  m_AvailablePointsCount = 0;
-  for(int64_t i = 0; i < m_TotalPackingPoints; i++)
-  {
-    if((exclusionOwners[i] == 0 && !m_UseMask) || (exclusionOwners[i] == 0 && m_UseMask && m_Mask[i]))
-    {
-      availablePoints[i] = m_AvailablePointsCount;
-      availablePointsInv[m_AvailablePointsCount] = i;
-      m_AvailablePointsCount++;
-    }
-  }
+  availablePoints.fill([&](size_t i) { return exclusionOwners[i] == 0 && (!m_UseMask || m_Mask[i]); });
+  m_AvailablePointsCount = availablePoints.size();
 
   // and clear the pointsToRemove and pointsToAdd vectors from the initial packing
   m_PointsToRemove.clear();
@@ -1536,187 +1819,365 @@ void PackPrimaryPhases::placeFeatures(Int32ArrayType::Pointer featureOwnersPtr)
   size_t key = 0;
   float xshift = 0.0f, yshift = 0.0f, zshift = 0.0f;
   int32_t lastIteration = 0;
-  for(int32_t iteration = 0; iteration < totalAdjustments; ++iteration)
+  if(m_UseParallelMoveBatches)
   {
-    uint64_t currentMillis = QDateTime::currentMSecsSinceEpoch();
-    if(currentMillis - millis > 1000)
+    // A Feature's point lists keep their offsets from the packing point of its centroid as the Feature moves,
+    // so the box of packing points touched by a move follows from the centroids alone
+    std::vector<int64_t> footprintOffsets(6 * totalFeatures, 0);
+    for(size_t i = m_FirstPrimaryFeature; i < totalFeatures; i++)
     {
-      QString ss = QObject::tr("Swapping/Moving/Adding/Removing Features Iteration %1/%2").arg(iteration).arg(totalAdjustments);
-      timeDiff = ((float)iteration / (float)(currentMillis - startMillis));
-      estimatedTime = (float)(totalAdjustments - iteration) / timeDiff;
-
-      ss += QObject::tr(" || Est. Time Remain: %1 || Iterations/Sec: %2").arg(DREAM3D::convertMillisToHrsMinSecs(estimatedTime)).arg(timeDiff * 1000);
-      notifyStatusMessage(ss);
-
-      millis = QDateTime::currentMSecsSinceEpoch();
-      lastIteration = iteration;
+      int64_t center[3] = {static_cast<int64_t>((m_Centroids[3 * i] - (m_HalfPackingRes[0])) * m_OneOverPackingRes[0]),
+                           static_cast<int64_t>((m_Centroids[3 * i + 1] - (m_HalfPackingRes[1])) * m_OneOverPackingRes[1]),
+                           static_cast<int64_t>((m_Centroids[3 * i + 2] - (m_HalfPackingRes[2])) * m_OneOverPackingRes[2])};
+      const std::vector<int64_t>* lists[3] = {&m_ColumnList[i], &m_RowList[i], &m_PlaneList[i]};
+      for(size_t a = 0; a < 3; a++)
+      {
+        if(lists[a]->empty())
+        {
+          footprintOffsets[6 * i + 2 * a] = 0;
+          footprintOffsets[6 * i + 2 * a + 1] = -1;
+          continue;
+        }
+        auto minMax = std::minmax_element(lists[a]->begin(), lists[a]->end());
+        footprintOffsets[6 * i + 2 * a] = *minMax.first - center[a];
+        footprintOffsets[6 * i + 2 * a + 1] = *minMax.second - center[a];
+      }
     }
 
-    if(getCancel())
+    MoveBlockGrid moveBlocks(m_PackingPoints, m_PeriodicBoundaries);
+    std::vector<MoveCandidate> candidates;
+    candidates.reserve(k_MoveBatchSize);
+    for(int32_t iteration = 0; iteration < totalAdjustments; iteration += k_MoveBatchSize)
     {
-      return;
-    }
-
-    int32_t option = iteration % 2;
+      uint64_t currentMillis = QDateTime::currentMSecsSinceEpoch();
+      if(currentMillis - millis > 1000)
+      {
+        QString ss = QObject::tr("Swapping/Moving/Adding/Removing Features Iteration %1/%2").arg(iteration).arg(totalAdjustments);
+        timeDiff = ((float)iteration / (float)(currentMillis - startMillis));
+        estimatedTime = (float)(totalAdjustments - iteration) / timeDiff;
 
-    if(writeErrorFile && iteration % 25 == 0)
-    {
-      outFile << iteration << " " << m_FillingError << "  " << availablePoints.size() << "  " << m_AvailablePointsCount << " " << totalFeatures << " " << acceptedmoves << "\n";
-    }
+        ss += QObject::tr(" || Est. Time Remain: %1 || Iterations/Sec: %2").arg(DREAM3D::convertMillisToHrsMinSecs(estimatedTime)).arg(timeDiff * 1000);
+        notifyStatusMessage(ss);
 
-    // JUMP - this option moves one feature to a random spot in the volume
-    if(option == 0)
-    {
-      randomfeature = m_FirstPrimaryFeature + int32_t(rg.genrand_res53() * (totalFeatures - m_FirstPrimaryFeature));
-      good = false;
-      count = 0;
-      while(!good && count < static_cast<int32_t>((totalFeatures - m_FirstPrimaryFeature)))
-      {
-        xc = m_Centroids[3 * randomfeature];
-        yc = m_Centroids[3 * randomfeature + 1];
-        zc = m_Centroids[3 * randomfeature + 2];
-        column = static_cast<int64_t>((xc - (m_HalfPackingRes[0])) * m_OneOverPackingRes[0]);
-        row = static_cast<int64_t>((yc - (m_HalfPackingRes[1])) * m_OneOverPackingRes[1]);
-        plane = static_cast<int64_t>((zc - (m_HalfPackingRes[2])) * m_OneOverPackingRes[2]);
-        featureOwnersIdx = (m_PackingPoints[0] * m_PackingPoints[1] * plane) + (m_PackingPoints[0] * row) + column;
-        if(featureOwners[featureOwnersIdx] > 1)
-        {
-          good = true;
-        }
-        else
-        {
-          randomfeature++;
-        }
-        if(static_cast<size_t>(randomfeature) >= totalFeatures)
-        {
-          randomfeature = m_FirstPrimaryFeature;
-        }
-        count++;
+        millis = QDateTime::currentMSecsSinceEpoch();
       }
-      m_Seed++;
 
-      if(!availablePoints.empty())
+      if(getCancel())
       {
-        key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
-        featureOwnersIdx = availablePointsInv[key];
+        return;
       }
-      else
-      {
-        featureOwnersIdx = static_cast<size_t>(rg.genrand_res53() * m_TotalPackingPoints);
-      }
-
-      // find the column row and plane of that point
-      column = static_cast<int64_t>(featureOwnersIdx % m_PackingPoints[0]);
-      row = static_cast<int64_t>(featureOwnersIdx / m_PackingPoints[0]) % m_PackingPoints[1];
-      plane = static_cast<int64_t>(featureOwnersIdx / (m_PackingPoints[0] * m_PackingPoints[1]));
-      xc = static_cast<float>((column * m_PackingRes[0]) + (m_PackingRes[0] * 0.5));
-      yc = static_cast<float>((row * m_PackingRes[1]) + (m_PackingRes[1] * 0.5));
-      zc = static_cast<float>((plane * m_PackingRes[2]) + (m_PackingRes[2] * 0.5));
-      oldxc = m_Centroids[3 * randomfeature];
-      oldyc = m_Centroids[3 * randomfeature + 1];
-      oldzc = m_Centroids[3 * randomfeature + 2];
-      m_OldFillingError = m_FillingError;
-      m_FillingError = checkFillingError(-1000, static_cast<int32_t>(randomfeature), featureOwnersPtr, exclusionOwnersPtr);
-      moveFeature(randomfeature, xc, yc, zc);
-      m_FillingError = checkFillingError(static_cast<int32_t>(randomfeature), -1000, featureOwnersPtr, exclusionOwnersPtr);
-      m_CurrentNeighborhoodError = checkNeighborhoodError(-1000, randomfeature);
-      if(m_FillingError <= m_OldFillingError)
+
+      if(writeErrorFile)
       {
-        m_OldNeighborhoodError = m_CurrentNeighborhoodError;
-        updateAvailablePoints(availablePoints, availablePointsInv);
-        acceptedmoves++;
+        outFile << iteration << " " << m_FillingError << "  " << m_TotalPackingPoints << "  " << m_AvailablePointsCount << " " << totalFeatures << " " << acceptedmoves << "\n";
       }
-      else if(m_FillingError > m_OldFillingError)
+
+      // Propose the moves of the batch the same way the serial loop does, drawing every random number on this thread.
+      // A move that touches packing points claimed by an earlier move of the batch is dropped.
+      int32_t batchEnd = std::min(iteration + k_MoveBatchSize, totalAdjustments);
+      candidates.clear();
+      moveBlocks.nextBatch();
+      for(int32_t batchIteration = iteration; batchIteration < batchEnd; batchIteration++)
       {
-        m_FillingError = checkFillingError(-1000, static_cast<int32_t>(randomfeature), featureOwnersPtr, exclusionOwnersPtr);
-        moveFeature(randomfeature, oldxc, oldyc, oldzc);
-        m_FillingError = checkFillingError(static_cast<int32_t>(randomfeature), -1000, featureOwnersPtr, exclusionOwnersPtr);
-        m_PointsToRemove.clear();
-        m_PointsToAdd.clear();
-      }
-    }
+        randomfeature = m_FirstPrimaryFeature + int32_t(rg.genrand_res53() * (totalFeatures - m_FirstPrimaryFeature));
+        good = false;
+        count = 0;
+        while(!good && count < static_cast<int32_t>((totalFeatures - m_FirstPrimaryFeature)))
+        {
+          xc = m_Centroids[3 * randomfeature];
+          yc = m_Centroids[3 * randomfeature + 1];
+          zc = m_Centroids[3 * randomfeature + 2];
+          column = static_cast<int64_t>((xc - (m_HalfPackingRes[0])) * m_OneOverPackingRes[0]);
+          row = static_cast<int64_t>((yc - (m_HalfPackingRes[1])) * m_OneOverPackingRes[1]);
+          plane = static_cast<int64_t>((zc - (m_HalfPackingRes[2])) * m_OneOverPackingRes[2]);
+          featureOwnersIdx = (m_PackingPoints[0] * m_PackingPoints[1] * plane) + (m_PackingPoints[0] * row) + column;
+          if(featureOwners[featureOwnersIdx] > 1)
+          {
+            good = true;
+          }
+          else
+          {
+            randomfeature++;
+          }
+          if(static_cast<size_t>(randomfeature) >= totalFeatures)
+          {
+            randomfeature = m_FirstPrimaryFeature;
+          }
+          count++;
+        }
+        m_Seed++;
+        oldxc = m_Centroids[3 * randomfeature];
+        oldyc = m_Centroids[3 * randomfeature + 1];
+        oldzc = m_Centroids[3 * randomfeature + 2];
 
-    // NUDGE - this option moves one feature to a spot close to its current centroid
-    if(option == 1)
-    {
-      randomfeature = m_FirstPrimaryFeature + int32_t(rg.genrand_res53() * (totalFeatures - m_FirstPrimaryFeature));
-      good = false;
-      count = 0;
-      while(!good && count < static_cast<int32_t>((totalFeatures - m_FirstPrimaryFeature)))
-      {
-        xc = m_Centroids[3 * randomfeature];
-        yc = m_Centroids[3 * randomfeature + 1];
-        zc = m_Centroids[3 * randomfeature + 2];
-        column = static_cast<int64_t>((xc - (m_HalfPackingRes[0])) * m_OneOverPackingRes[0]);
-        row = static_cast<int64_t>((yc - (m_HalfPackingRes[1])) * m_OneOverPackingRes[1]);
-        plane = static_cast<int64_t>((zc - (m_HalfPackingRes[2])) * m_OneOverPackingRes[2]);
-        featureOwnersIdx = (m_PackingPoints[0] * m_PackingPoints[1] * plane) + (m_PackingPoints[0] * row) + column;
-        if(featureOwners[featureOwnersIdx] > 1)
+        // JUMP - even iterations move one feature to a random spot in the volume
+        if(batchIteration % 2 == 0)
         {
-          good = true;
+          if(m_AvailablePointsCount > 0)
+          {
+            key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
+            featureOwnersIdx = availablePoints.select(key);
+          }
+          else
+          {
+            featureOwnersIdx = static_cast<size_t>(rg.genrand_res53() * m_TotalPackingPoints);
+          }
+          column = static_cast<int64_t>(featureOwnersIdx % m_PackingPoints[0]);
+          row = static_cast<int64_t>(featureOwnersIdx / m_PackingPoints[0]) % m_PackingPoints[1];
+          plane = static_cast<int64_t>(featureOwnersIdx / (m_PackingPoints[0] * m_PackingPoints[1]));
+          xc = static_cast<float>((column * m_PackingRes[0]) + (m_PackingRes[0] * 0.5));
+          yc = static_cast<float>((row * m_PackingRes[1]) + (m_PackingRes[1] * 0.5));
+          zc = static_cast<float>((plane * m_PackingRes[2]) + (m_PackingRes[2] * 0.5));
         }
+        // NUDGE - odd iterations move one feature to a spot close to its current centroid
         else
         {
-          randomfeature++;
+          xshift = static_cast<float>(((2.0f * (rg.genrand_res53() - 0.5f)) * (2.0f * m_PackingRes[0])));
+          yshift = static_cast<float>(((2.0f * (rg.genrand_res53() - 0.5f)) * (2.0f * m_PackingRes[1])));
+          zshift = static_cast<float>(((2.0f * (rg.genrand_res53() - 0.5f)) * (2.0f * m_PackingRes[2])));
+          xc = ((oldxc + xshift) < m_SizeX && (oldxc + xshift) > 0) ? oldxc + xshift : oldxc;
+          yc = ((oldyc + yshift) < m_SizeY && (oldyc + yshift) > 0) ? oldyc + yshift : oldyc;
+          zc = ((oldzc + zshift) < m_SizeZ && (oldzc + zshift) > 0) ? oldzc + zshift : oldzc;
         }
-        if(static_cast<size_t>(randomfeature) >= totalFeatures)
+
+        MoveCandidate candidate;
+        candidate.feature = randomfeature;
+        candidate.oldCentroid[0] = oldxc;
+        candidate.oldCentroid[1] = oldyc;
+        candidate.oldCentroid[2] = oldzc;
+        candidate.newCentroid[0] = xc;
+        candidate.newCentroid[1] = yc;
+        candidate.newCentroid[2] = zc;
+        int64_t boxes[2][6];
+        const float* centroids[2] = {candidate.oldCentroid, candidate.newCentroid};
+        for(size_t b = 0; b < 2; b++)
         {
-          randomfeature = m_FirstPrimaryFeature;
+          for(size_t a = 0; a < 3; a++)
+          {
+            int64_t center = static_cast<int64_t>((centroids[b][a] - (m_HalfPackingRes[a])) * m_OneOverPackingRes[a]);
+            boxes[b][2 * a] = center + footprintOffsets[6 * randomfeature + 2 * a];
+            boxes[b][2 * a + 1] = center + footprintOffsets[6 * randomfeature + 2 * a + 1];
+          }
+        }
+        if(moveBlocks.claim(boxes))
+        {
+          candidates.push_back(std::move(candidate));
         }
-        count++;
-      }
-      m_Seed++;
-      oldxc = m_Centroids[3 * randomfeature];
-      oldyc = m_Centroids[3 * randomfeature + 1];
-      oldzc = m_Centroids[3 * randomfeature + 2];
-      xshift = static_cast<float>(((2.0f * (rg.genrand_res53() - 0.5f)) * (2.0f * m_PackingRes[0])));
-      yshift = static_cast<float>(((2.0f * (rg.genrand_res53() - 0.5f)) * (2.0f * m_PackingRes[1])));
-      zshift = static_cast<float>(((2.0f * (rg.genrand_res53() - 0.5f)) * (2.0f * m_PackingRes[2])));
-      if((oldxc + xshift) < m_SizeX && (oldxc + xshift) > 0)
-      {
-        xc = oldxc + xshift;
-      }
-      else
-      {
-        xc = oldxc;
       }
-      if((oldyc + yshift) < m_SizeY && (oldyc + yshift) > 0)
+
+      PackPrimaryPhasesMoveBatchImpl batchImpl(this, candidates, featureOwners, exclusionOwners);
+#ifdef SIMPL_USE_PARALLEL_ALGORITHMS
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, candidates.size(), 1), batchImpl, tbb::auto_partitioner());
+#else
+      batchImpl.convert(0, candidates.size());
+#endif
+
+      // Commit the accepted moves in proposal order, which keeps the result independent of the thread scheduling.
+      // Each one updates the neighbor grid, the filling and neighborhood errors and the available points like an
+      // accepted serial move. A rejected serial move leaves the neighbor grid holding the same Features per cell and
+      // the neighborhood error untouched, so rejected candidates need no bookkeeping here.
+      for(MoveCandidate& candidate : candidates)
       {
-        yc = oldyc + yshift;
+        if(!candidate.accepted)
+        {
+          continue;
+        }
+        updateNeighborGridCell(candidate.feature);
+        m_OldFillingError = m_FillingError;
+        m_FillingError = (m_FillingError * float(m_TotalPackingPoints) + float(candidate.fillingChange)) / float(m_TotalPackingPoints);
+        m_CurrentNeighborhoodError = checkNeighborhoodError(-1000, candidate.feature);
+        m_OldNeighborhoodError = m_CurrentNeighborhoodError;
+        m_PointsToRemove.swap(candidate.pointsToRemove);
+        m_PointsToAdd.swap(candidate.pointsToAdd);
+        updateAvailablePoints(availablePoints);
+        acceptedmoves++;
       }
-      else
+    }
+  }
+  else
+  {
+    for(int32_t iteration = 0; iteration < totalAdjustments; ++iteration)
+    {
+      uint64_t currentMillis = QDateTime::currentMSecsSinceEpoch();
+      if(currentMillis - millis > 1000)
       {
-        yc = oldyc;
+        QString ss = QObject::tr("Swapping/Moving/Adding/Removing Features Iteration %1/%2").arg(iteration).arg(totalAdjustments);
+        timeDiff = ((float)iteration / (float)(currentMillis - startMillis));
+        estimatedTime = (float)(totalAdjustments - iteration) / timeDiff;
+
+        ss += QObject::tr(" || Est. Time Remain: %1 || Iterations/Sec: %2").arg(DREAM3D::convertMillisToHrsMinSecs(estimatedTime)).arg(timeDiff * 1000);
+        notifyStatusMessage(ss);
+
+        millis = QDateTime::currentMSecsSinceEpoch();
+        lastIteration = iteration;
       }
-      if((oldzc + zshift) < m_SizeZ && (oldzc + zshift) > 0)
+
+      if(getCancel())
       {
-        zc = oldzc + zshift;
+        return;
       }
-      else
+
+      int32_t option = iteration % 2;
+
+      if(writeErrorFile && iteration % 25 == 0)
       {
-        zc = oldzc;
+        outFile << iteration << " " << m_FillingError << "  " << m_TotalPackingPoints << "  " << m_AvailablePointsCount << " " << totalFeatures << " " << acceptedmoves << "\n";
       }
-      m_OldFillingError = m_FillingError;
-      m_FillingError = checkFillingError(-1000, static_cast<int32_t>(randomfeature), featureOwnersPtr, exclusionOwnersPtr);
-      moveFeature(randomfeature, xc, yc, zc);
-      m_FillingError = checkFillingError(static_cast<int32_t>(randomfeature), -1000, featureOwnersPtr, exclusionOwnersPtr);
-      m_CurrentNeighborhoodError = checkNeighborhoodError(-1000, randomfeature);
-      //      change2 = (currentneighborhooderror * currentneighborhooderror) - (oldneighborhooderror * oldneighborhooderror);
-      //      if(fillingerror <= oldfillingerror && currentneighborhooderror >= oldneighborhooderror)
-      if(m_FillingError <= m_OldFillingError)
+
+      // JUMP - this option moves one feature to a random spot in the volume
+      if(option == 0)
       {
-        m_OldNeighborhoodError = m_CurrentNeighborhoodError;
-        updateAvailablePoints(availablePoints, availablePointsInv);
-        acceptedmoves++;
+        randomfeature = m_FirstPrimaryFeature + int32_t(rg.genrand_res53() * (totalFeatures - m_FirstPrimaryFeature));
+        good = false;
+        count = 0;
+        while(!good && count < static_cast<int32_t>((totalFeatures - m_FirstPrimaryFeature)))
+        {
+          xc = m_Centroids[3 * randomfeature];
+          yc = m_Centroids[3 * randomfeature + 1];
+          zc = m_Centroids[3 * randomfeature + 2];
+          column = static_cast<int64_t>((xc - (m_HalfPackingRes[0])) * m_OneOverPackingRes[0]);
+          row = static_cast<int64_t>((yc - (m_HalfPackingRes[1])) * m_OneOverPackingRes[1]);
+          plane = static_cast<int64_t>((zc - (m_HalfPackingRes[2])) * m_OneOverPackingRes[2]);
+          featureOwnersIdx = (m_PackingPoints[0] * m_PackingPoints[1] * plane) + (m_PackingPoints[0] * row) + column;
+          if(featureOwners[featureOwnersIdx] > 1)
+          {
+            good = true;
+          }
+          else
+          {
+            randomfeature++;
+          }
+          if(static_cast<size_t>(randomfeature) >= totalFeatures)
+          {
+            randomfeature = m_FirstPrimaryFeature;
+          }
+          count++;
+        }
+        m_Seed++;
+
+        if(m_AvailablePointsCount > 0)
+        {
+          key = static_cast<size_t>(rg.genrand_res53() * (m_AvailablePointsCount - 1));
+          featureOwnersIdx = availablePoints.select(key);
+        }
+        else
+        {
+          featureOwnersIdx = static_cast<size_t>(rg.genrand_res53() * m_TotalPackingPoints);
+        }
+
+        // find the column row and plane of that point
+        column = static_cast<int64_t>(featureOwnersIdx % m_PackingPoints[0]);
+        row = static_cast<int64_t>(featureOwnersIdx / m_PackingPoints[0]) % m_PackingPoints[1];
+        plane = static_cast<int64_t>(featureOwnersIdx / (m_PackingPoints[0] * m_PackingPoints[1]));
+        xc = static_cast<float>((column * m_PackingRes[0]) + (m_PackingRes[0] * 0.5));
+        yc = static_cast<float>((row * m_PackingRes[1]) + (m_PackingRes[1] * 0.5));
+        zc = static_cast<float>((plane * m_PackingRes[2]) + (m_PackingRes[2] * 0.5));
+        oldxc = m_Centroids[3 * randomfeature];
+        oldyc = m_Centroids[3 * randomfeature + 1];
+        oldzc = m_Centroids[3 * randomfeature + 2];
+        m_OldFillingError = m_FillingError;
+        m_FillingError = checkFillingError(-1000, static_cast<int32_t>(randomfeature), featureOwnersPtr, exclusionOwnersPtr);
+        moveFeature(randomfeature, xc, yc, zc);
+        m_FillingError = checkFillingError(static_cast<int32_t>(randomfeature), -1000, featureOwnersPtr, exclusionOwnersPtr);
+        if(m_FillingError <= m_OldFillingError)
+        {
+          m_CurrentNeighborhoodError = checkNeighborhoodError(-1000, randomfeature);
+          m_OldNeighborhoodError = m_CurrentNeighborhoodError;
+          updateAvailablePoints(availablePoints);
+          acceptedmoves++;
+        }
+        else if(m_FillingError > m_OldFillingError)
+        {
+          m_FillingError = checkFillingError(-1000, static_cast<int32_t>(randomfeature), featureOwnersPtr, exclusionOwnersPtr);
+          moveFeature(randomfeature, oldxc, oldyc, oldzc);
+          m_FillingError = checkFillingError(static_cast<int32_t>(randomfeature), -1000, featureOwnersPtr, exclusionOwnersPtr);
+          m_PointsToRemove.clear();
+          m_PointsToAdd.clear();
+        }
       }
-      //      else if(fillingerror > oldfillingerror || currentneighborhooderror < oldneighborhooderror)
-      else if(m_FillingError > m_OldFillingError)
+
+      // NUDGE - this option moves one feature to a spot close to its current centroid
+      if(option == 1)
       {
-        m_FillingError = checkFillingError(-1000, static_cast<int>(randomfeature), featureOwnersPtr, exclusionOwnersPtr);
-        moveFeature(randomfeature, oldxc, oldyc, oldzc);
-        m_FillingError = checkFillingError(static_cast<int>(randomfeature), -1000, featureOwnersPtr, exclusionOwnersPtr);
-        m_PointsToRemove.clear();
-        m_PointsToAdd.clear();
+        randomfeature = m_FirstPrimaryFeature + int32_t(rg.genrand_res53() * (totalFeatures - m_FirstPrimaryFeature));
+        good = false;
+        count = 0;
+        while(!good && count < static_cast<int32_t>((totalFeatures - m_FirstPrimaryFeature)))
+        {
+          xc = m_Centroids[3 * randomfeature];
+          yc = m_Centroids[3 * randomfeature + 1];
+          zc = m_Centroids[3 * randomfeature + 2];
+          column = static_cast<int64_t>((xc - (m_HalfPackingRes[0])) * m_OneOverPackingRes[0]);
+          row = static_cast<int64_t>((yc - (m_HalfPackingRes[1])) * m_OneOverPackingRes[1]);
+          plane = static_cast<int64_t>((zc - (m_HalfPackingRes[2])) * m_OneOverPackingRes[2]);
+          featureOwnersIdx = (m_PackingPoints[0] * m_PackingPoints[1] * plane) + (m_PackingPoints[0] * row) + column;
+          if(featureOwners[featureOwnersIdx] > 1)
+          {
+            good = true;
+          }
+          else
+          {
+            randomfeature++;
+          }
+          if(static_cast<size_t>(randomfeature) >= totalFeatures)
+          {
+            randomfeature = m_FirstPrimaryFeature;
+          }
+          count++;
+        }
+        m_Seed++;
+        oldxc = m_Centroids[3 * randomfeature];
+        oldyc = m_Centroids[3 * randomfeature + 1];
+        oldzc = m_Centroids[3 * randomfeature + 2];
+        xshift = static_cast<float>(((2.0f * (rg.genrand_res53() - 0.5f)) * (2.0f * m_PackingRes[0])));
+        yshift = static_cast<float>(((2.0f * (rg.genrand_res53() - 0.5f)) * (2.0f * m_PackingRes[1])));
+        zshift = static_cast<float>(((2.0f * (rg.genrand_res53() - 0.5f)) * (2.0f * m_PackingRes[2])));
+        if((oldxc + xshift) < m_SizeX && (oldxc + xshift) > 0)
+        {
+          xc = oldxc + xshift;
+        }
+        else
+        {
+          xc = oldxc;
+        }
+        if((oldyc + yshift) < m_SizeY && (oldyc + yshift) > 0)
+        {
+          yc = oldyc + yshift;
+        }
+        else
+        {
+          yc = oldyc;
+        }
+        if((oldzc + zshift) < m_SizeZ && (oldzc + zshift) > 0)
+        {
+          zc = oldzc + zshift;
+        }
+        else
+        {
+          zc = oldzc;
+        }
+        m_OldFillingError = m_FillingError;
+        m_FillingError = checkFillingError(-1000, static_cast<int32_t>(randomfeature), featureOwnersPtr, exclusionOwnersPtr);
+        moveFeature(randomfeature, xc, yc, zc);
+        m_FillingError = checkFillingError(static_cast<int32_t>(randomfeature), -1000, featureOwnersPtr, exclusionOwnersPtr);
+        //      change2 = (currentneighborhooderror * currentneighborhooderror) - (oldneighborhooderror * oldneighborhooderror);
+        //      if(fillingerror <= oldfillingerror && currentneighborhooderror >= oldneighborhooderror)
+        if(m_FillingError <= m_OldFillingError)
+        {
+          m_CurrentNeighborhoodError = checkNeighborhoodError(-1000, randomfeature);
+          m_OldNeighborhoodError = m_CurrentNeighborhoodError;
+          updateAvailablePoints(availablePoints);
+          acceptedmoves++;
+        }
+        //      else if(fillingerror > oldfillingerror || currentneighborhooderror < oldneighborhooderror)
+        else if(m_FillingError > m_OldFillingError)
+        {
+          m_FillingError = checkFillingError(-1000, static_cast<int>(randomfeature), featureOwnersPtr, exclusionOwnersPtr);
+          moveFeature(randomfeature, oldxc, oldyc, oldzc);
+          m_FillingError = checkFillingError(static_cast<int>(randomfeature), -1000, featureOwnersPtr, exclusionOwnersPtr);
+          m_PointsToRemove.clear();
+          m_PointsToAdd.clear();
+        }
       }
     }
   }
@@ -1916,6 +2377,15 @@ void PackPrimaryPhases::transferAttributes(int32_t gnum, Feature_t* feature)
 //
 // -----------------------------------------------------------------------------
 void PackPrimaryPhases::moveFeature(size_t gnum, float xc, float yc, float zc)
+{
+  moveFeatureLists(gnum, xc, yc, zc);
+  updateNeighborGridCell(gnum);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PackPrimaryPhases::moveFeatureLists(size_t gnum, float xc, float yc, float zc)
 {
   int64_t occolumn = 0, ocrow = 0, ocplane = 0;
   int64_t nccolumn = 0, ncrow = 0, ncplane = 0;
@@ -1953,8 +2423,6 @@ void PackPrimaryPhases::moveFeature(size_t gnum, float xc, float yc, float zc)
 // -----------------------------------------------------------------------------
 void PackPrimaryPhases::determineNeighbors(size_t gnum, bool add)
 {
-  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getOutputCellAttributeMatrixPath().getDataContainerName());
-
   float x = 0.0f, y = 0.0f, z = 0.0f;
   float xn = 0.0f, yn = 0.0f, zn = 0.0f;
   float dia = 0.0f, dia2 = 0.0f;
@@ -1963,7 +2431,6 @@ void PackPrimaryPhases::determineNeighbors(size_t gnum, bool add)
   y = m_Centroids[3 * gnum + 1];
   z = m_Centroids[3 * gnum + 2];
   dia = m_EquivalentDiameters[gnum];
-  size_t totalFeatures = m->getAttributeMatrix(m_OutputCellFeatureAttributeMatrixName)->getNumberOfTuples();
   int32_t increment = 0;
   if(add)
   {
@@ -1973,22 +2440,45 @@ void PackPrimaryPhases::determineNeighbors(size_t gnum, bool add)
   {
     increment = -1;
   }
-  for(size_t n = m_FirstPrimaryFeature; n < totalFeatures; n++)
+
+  // Both tests below fail for any Feature further away than the largest equivalent diameter, so only the
+  // grid cells within that reach of the centroid have to be visited. The reach is padded slightly to absorb round off.
+  float reach = std::max(dia, m_NeighborGridReach) * 1.01f;
+  int64_t minCell[3] = {0, 0, 0};
+  int64_t maxCell[3] = {0, 0, 0};
+  float center[3] = {x, y, z};
+  for(size_t a = 0; a < 3; a++)
   {
-    xn = m_Centroids[3 * n];
-    yn = m_Centroids[3 * n + 1];
-    zn = m_Centroids[3 * n + 2];
-    dia2 = m_EquivalentDiameters[n];
-    dx = fabs(x - xn);
-    dy = fabs(y - yn);
-    dz = fabs(z - zn);
-    if(dx < dia && dy < dia && dz < dia)
-    {
-      m_Neighborhoods[gnum] = m_Neighborhoods[gnum] + increment;
-    }
-    if(dx < dia2 && dy < dia2 && dz < dia2)
+    minCell[a] = neighborGridCoordinate(center[a] - reach, m_OneOverNeighborGridCellSize[a], m_NeighborGridDims[a]);
+    maxCell[a] = neighborGridCoordinate(center[a] + reach, m_OneOverNeighborGridCellSize[a], m_NeighborGridDims[a]);
+  }
+
+  for(int64_t plane = minCell[2]; plane <= maxCell[2]; plane++)
+  {
+    for(int64_t row = minCell[1]; row <= maxCell[1]; row++)
     {
-      m_Neighborhoods[n] = m_Neighborhoods[n] + increment;
+      for(int64_t column = minCell[0]; column <= maxCell[0]; column++)
+      {
+        const std::vector<int32_t>& cell = m_NeighborGridCells[(plane * m_NeighborGridDims[1] + row) * m_NeighborGridDims[0] + column];
+        for(const int32_t& n : cell)
+        {
+          xn = m_Centroids[3 * n];
+          yn = m_Centroids[3 * n + 1];
+          zn = m_Centroids[3 * n + 2];
+          dia2 = m_EquivalentDiameters[n];
+          dx = fabs(x - xn);
+          dy = fabs(y - yn);
+          dz = fabs(z - zn);
+          if(dx < dia && dy < dia && dz < dia)
+          {
+            updateNeighborhood(gnum, increment);
+          }
+          if(dx < dia2 && dy < dia2 && dz < dia2)
+          {
+            updateNeighborhood(n, increment);
+          }
+        }
+      }
     }
   }
 }
@@ -1999,17 +2489,10 @@ void PackPrimaryPhases::determineNeighbors(size_t gnum, bool add)
 float PackPrimaryPhases::checkNeighborhoodError(int32_t gadd, int32_t gremove)
 {
   // Optimized Code
-  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getOutputCellAttributeMatrixPath().getDataContainerName());
-
-  StatsDataArray& statsDataArray = *(m_StatsDataArray.lock().get());
-
   float neighborerror = 0.0f;
   float bhattdist = 0.0f;
-  float dia = 0.0f;
-  int32_t nnum = 0;
   size_t diabin = 0;
   size_t nnumbin = 0;
-  int32_t index = 0;
   int32_t phase = 0;
 
   using VectOfVectFloat_t = std::vector<std::vector<float>>;
@@ -2017,20 +2500,10 @@ float PackPrimaryPhases::checkNeighborhoodError(int32_t gadd, int32_t gremove)
   for(size_t iter = 0; iter < numPhases; ++iter)
   {
     phase = m_PrimaryPhases[iter];
-    PrimaryStatsData::Pointer pp = std::dynamic_pointer_cast<PrimaryStatsData>(statsDataArray[phase]);
     VectOfVectFloat_t& curSimNeighborDist = m_SimNeighborDist[iter];
     size_t curSImNeighborDist_Size = curSimNeighborDist.size();
     float oneOverNeighborDistStep = 1.0f / m_NeighborDistStep[iter];
 
-    std::vector<int32_t> count(curSImNeighborDist_Size, 0);
-    for(size_t i = 0; i < curSImNeighborDist_Size; i++)
-    {
-      curSimNeighborDist[i].resize(40);
-      for(size_t j = 0; j < 40; j++)
-      {
-        curSimNeighborDist[i][j] = 0;
-      }
-    }
     if(gadd > 0 && m_FeaturePhases[gadd] == phase)
     {
       determineNeighbors(gadd, true);
@@ -2040,63 +2513,30 @@ float PackPrimaryPhases::checkNeighborhoodError(int32_t gadd, int32_t gremove)
       determineNeighbors(gremove, false);
     }
 
-    float maxFeatureDia = pp->getMaxFeatureDiameter();
-    float minFeatureDia = pp->getMinFeatureDiameter();
-    float oneOverBinStepSize = 1.0f / pp->getBinStepSize();
-
-    size_t totalFeatures = m->getAttributeMatrix(m_OutputCellFeatureAttributeMatrixName)->getNumberOfTuples();
-    for(size_t i = m_FirstPrimaryFeature; i < totalFeatures; i++)
+    // The histogram already counts every Feature of this phase with its current neighborhood, so only gremove
+    // has to be taken out and gadd counted once more
+    const std::vector<std::vector<int32_t>>& histogram = m_NeighborhoodHistograms[iter];
+    std::vector<int32_t> count(curSImNeighborDist_Size, 0);
+    for(size_t i = 0; i < curSImNeighborDist_Size; i++)
     {
-      nnum = 0;
-      index = static_cast<int32_t>(i);
-      if(index != gremove && m_FeaturePhases[index] == phase)
+      curSimNeighborDist[i].resize(40);
+      for(size_t j = 0; j < 40; j++)
       {
-        dia = m_EquivalentDiameters[index];
-        if(dia > maxFeatureDia)
-        {
-          dia = maxFeatureDia;
-        }
-        if(dia < minFeatureDia)
-        {
-          dia = minFeatureDia;
-        }
-        diabin = static_cast<size_t>(((dia - minFeatureDia) * oneOverBinStepSize));
-        if(diabin >= curSImNeighborDist_Size)
-        {
-          diabin = curSImNeighborDist_Size - 1;
-        }
-        nnum = m_Neighborhoods[index];
-        nnumbin = static_cast<size_t>(nnum * oneOverNeighborDistStep);
-        if(nnumbin >= 40)
-        {
-          nnumbin = 39;
-        }
-        curSimNeighborDist[diabin][nnumbin]++;
-        count[diabin]++;
+        curSimNeighborDist[i][j] = static_cast<float>(histogram[i][j]);
+        count[i] += histogram[i][j];
       }
     }
+    if(gremove > 0 && m_FeaturePhases[gremove] == phase)
+    {
+      diabin = m_NeighborhoodDiaBins[gremove];
+      nnumbin = neighborhoodBin(m_Neighborhoods[gremove], oneOverNeighborDistStep);
+      curSimNeighborDist[diabin][nnumbin]--;
+      count[diabin]--;
+    }
     if(gadd > 0 && m_FeaturePhases[gadd] == phase)
     {
-      dia = m_EquivalentDiameters[gadd];
-      if(dia > maxFeatureDia)
-      {
-        dia = maxFeatureDia;
-      }
-      if(dia < minFeatureDia)
-      {
-        dia = minFeatureDia;
-      }
-      diabin = static_cast<size_t>(((dia - minFeatureDia) * oneOverBinStepSize));
-      if(diabin >= curSImNeighborDist_Size)
-      {
-        diabin = curSImNeighborDist_Size - 1;
-      }
-      nnum = m_Neighborhoods[gadd];
-      nnumbin = static_cast<size_t>(nnum * oneOverNeighborDistStep);
-      if(nnumbin >= 40)
-      {
-        nnumbin = 39;
-      }
+      diabin = m_NeighborhoodDiaBins[gadd];
+      nnumbin = neighborhoodBin(m_Neighborhoods[gadd], oneOverNeighborDistStep);
       curSimNeighborDist[diabin][nnumbin]++;
       count[diabin]++;
     }
@@ -2146,6 +2586,148 @@ float PackPrimaryPhases::checkNeighborhoodError(int32_t gadd, int32_t gremove)
   return neighborerror;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PackPrimaryPhases::initializeNeighborGrid(size_t totalFeatures)
+{
+  // determineNeighbors never looks further than the largest equivalent diameter, which makes it a natural cell size.
+  // The cell size is kept above the average volume per Feature so the grid never has many more cells than Features.
+  float maxDia = 0.0f;
+  for(size_t i = m_FirstPrimaryFeature; i < totalFeatures; i++)
+  {
+    maxDia = std::max(maxDia, m_EquivalentDiameters[i]);
+  }
+  m_NeighborGridReach = maxDia;
+  size_t numFeatures = std::max<size_t>(totalFeatures - std::min<size_t>(totalFeatures, m_FirstPrimaryFeature), 1);
+  float cellSize = std::max(maxDia, std::cbrt(m_TotalVol / static_cast<float>(numFeatures)));
+
+  float size[3] = {m_SizeX, m_SizeY, m_SizeZ};
+  for(size_t a = 0; a < 3; a++)
+  {
+    m_NeighborGridDims[a] = 1;
+    if(cellSize > 0.0f)
+    {
+      m_NeighborGridDims[a] = std::max<int64_t>(static_cast<int64_t>(size[a] / cellSize), 1);
+    }
+    m_OneOverNeighborGridCellSize[a] = static_cast<float>(m_NeighborGridDims[a]) / size[a];
+  }
+
+  m_NeighborGridCells.clear();
+  m_NeighborGridCells.resize(static_cast<size_t>(m_NeighborGridDims[0] * m_NeighborGridDims[1] * m_NeighborGridDims[2]));
+  m_NeighborGridCellIndex.assign(totalFeatures, -1);
+  m_NeighborGridSlot.assign(totalFeatures, 0);
+  for(size_t i = m_FirstPrimaryFeature; i < totalFeatures; i++)
+  {
+    updateNeighborGridCell(i);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PackPrimaryPhases::updateNeighborGridCell(size_t gnum)
+{
+  // Features are placed one at a time before the grid exists
+  if(gnum >= m_NeighborGridCellIndex.size())
+  {
+    return;
+  }
+
+  int64_t column = neighborGridCoordinate(m_Centroids[3 * gnum], m_OneOverNeighborGridCellSize[0], m_NeighborGridDims[0]);
+  int64_t row = neighborGridCoordinate(m_Centroids[3 * gnum + 1], m_OneOverNeighborGridCellSize[1], m_NeighborGridDims[1]);
+  int64_t plane = neighborGridCoordinate(m_Centroids[3 * gnum + 2], m_OneOverNeighborGridCellSize[2], m_NeighborGridDims[2]);
+  int64_t cellIndex = (plane * m_NeighborGridDims[1] + row) * m_NeighborGridDims[0] + column;
+  int64_t oldCellIndex = m_NeighborGridCellIndex[gnum];
+  if(cellIndex == oldCellIndex)
+  {
+    return;
+  }
+
+  if(oldCellIndex >= 0)
+  {
+    // swap the last Feature of the old cell into the slot this Feature leaves
+    std::vector<int32_t>& oldCell = m_NeighborGridCells[oldCellIndex];
+    size_t slot = m_NeighborGridSlot[gnum];
+    int32_t last = oldCell.back();
+    oldCell[slot] = last;
+    m_NeighborGridSlot[last] = slot;
+    oldCell.pop_back();
+  }
+
+  std::vector<int32_t>& cell = m_NeighborGridCells[cellIndex];
+  m_NeighborGridCellIndex[gnum] = cellIndex;
+  m_NeighborGridSlot[gnum] = cell.size();
+  cell.push_back(static_cast<int32_t>(gnum));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PackPrimaryPhases::initializeNeighborhoodHistograms(size_t totalFeatures)
+{
+  StatsDataArray& statsDataArray = *(m_StatsDataArray.lock().get());
+
+  size_t numPhases = m_SimNeighborDist.size();
+  m_NeighborhoodHistograms.resize(numPhases);
+  m_NeighborhoodPhaseIndex.assign(totalFeatures, -1);
+  m_NeighborhoodDiaBins.assign(totalFeatures, 0);
+  for(size_t iter = 0; iter < numPhases; ++iter)
+  {
+    int32_t phase = m_PrimaryPhases[iter];
+    PrimaryStatsData::Pointer pp = std::dynamic_pointer_cast<PrimaryStatsData>(statsDataArray[phase]);
+    size_t numDiaBins = m_SimNeighborDist[iter].size();
+    float oneOverNeighborDistStep = 1.0f / m_NeighborDistStep[iter];
+    float maxFeatureDia = pp->getMaxFeatureDiameter();
+    float minFeatureDia = pp->getMinFeatureDiameter();
+    float oneOverBinStepSize = 1.0f / pp->getBinStepSize();
+
+    m_NeighborhoodHistograms[iter].assign(numDiaBins, std::vector<int32_t>(40, 0));
+    for(size_t i = m_FirstPrimaryFeature; i < totalFeatures; i++)
+    {
+      if(m_FeaturePhases[i] != phase)
+      {
+        continue;
+      }
+      float dia = m_EquivalentDiameters[i];
+      if(dia > maxFeatureDia)
+      {
+        dia = maxFeatureDia;
+      }
+      if(dia < minFeatureDia)
+      {
+        dia = minFeatureDia;
+      }
+      size_t diabin = static_cast<size_t>(((dia - minFeatureDia) * oneOverBinStepSize));
+      if(diabin >= numDiaBins)
+      {
+        diabin = numDiaBins - 1;
+      }
+      m_NeighborhoodPhaseIndex[i] = static_cast<int32_t>(iter);
+      m_NeighborhoodDiaBins[i] = diabin;
+      m_NeighborhoodHistograms[iter][diabin][neighborhoodBin(m_Neighborhoods[i], oneOverNeighborDistStep)]++;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PackPrimaryPhases::updateNeighborhood(size_t gnum, int32_t increment)
+{
+  int32_t phaseIndex = m_NeighborhoodPhaseIndex[gnum];
+  if(phaseIndex < 0)
+  {
+    m_Neighborhoods[gnum] = m_Neighborhoods[gnum] + increment;
+    return;
+  }
+  float oneOverNeighborDistStep = 1.0f / m_NeighborDistStep[phaseIndex];
+  std::vector<int32_t>& diaBinCounts = m_NeighborhoodHistograms[phaseIndex][m_NeighborhoodDiaBins[gnum]];
+  diaBinCounts[neighborhoodBin(m_Neighborhoods[gnum], oneOverNeighborDistStep)]--;
+  m_Neighborhoods[gnum] = m_Neighborhoods[gnum] + increment;
+  diaBinCounts[neighborhoodBin(m_Neighborhoods[gnum], oneOverNeighborDistStep)]++;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -2291,216 +2873,117 @@ float PackPrimaryPhases::checkSizeDistError(Feature_t* feature)
 // -----------------------------------------------------------------------------
 float PackPrimaryPhases::checkFillingError(int32_t gadd, int32_t gremove, Int32ArrayType::Pointer featureOwnersPtr, Int32ArrayType::Pointer exclusionOwnersPtr)
 {
-  size_t featureOwnersIdx = 0;
   int32_t* featureOwners = featureOwnersPtr->getPointer(0);
   int32_t* exclusionOwners = exclusionOwnersPtr->getPointer(0);
 
-  m_FillingError = m_FillingError * float(m_TotalPackingPoints);
-  int64_t col = 0, row = 0, plane = 0;
-  int32_t k1 = 0, k2 = 0, k3 = 0;
+  int64_t fillingChange = 0;
   if(gadd > 0)
   {
-    k1 = 2;
-    k2 = -1;
-    k3 = 1;
-    size_t numVoxelsForCurrentGrain = m_ColumnList[gadd].size();
-    std::vector<int64_t>& cl = m_ColumnList[gadd];
-    std::vector<int64_t>& rl = m_RowList[gadd];
-    std::vector<int64_t>& pl = m_PlaneList[gadd];
-    std::vector<float>& efl = m_EllipFuncList[gadd];
-    float packquality = 0;
-    for(size_t i = 0; i < numVoxelsForCurrentGrain; i++)
-    {
-      col = cl[i];
-      row = rl[i];
-      plane = pl[i];
-      if(m_PeriodicBoundaries)
-      {
-        // Perform mod arithmetic to ensure we are within the packing points range
-        col = col % m_PackingPoints[0];
-        row = row % m_PackingPoints[1];
-        plane = plane % m_PackingPoints[2];
-
-        if(col < 0)
-        {
-          col = col + m_PackingPoints[0];
-        }
-        if(col > m_PackingPoints[0] - 1)
-        {
-          col = col - m_PackingPoints[0];
-        }
-        if(row < 0)
-        {
-          row = row + m_PackingPoints[1];
-        }
-        if(row > m_PackingPoints[1] - 1)
-        {
-          row = row - m_PackingPoints[1];
-        }
-        if(plane < 0)
-        {
-          plane = plane + m_PackingPoints[2];
-        }
-        if(plane > m_PackingPoints[2] - 1)
-        {
-          plane = plane - m_PackingPoints[2];
-        }
-        featureOwnersIdx = (m_PackingPoints[0] * m_PackingPoints[1] * plane) + (m_PackingPoints[0] * row) + col;
-        int32_t currentFeatureOwner = featureOwners[featureOwnersIdx];
-        if(efl[i] > 0.1f)
-        {
-          if(exclusionOwners[featureOwnersIdx] == 0)
-          {
-            m_PointsToRemove.push_back(featureOwnersIdx);
-          }
-          exclusionOwners[featureOwnersIdx]++;
-        }
-        m_FillingError = static_cast<float>(m_FillingError + ((k1 * currentFeatureOwner + k2)));
-        //        fillingerror = fillingerror + (multiplier * (k1 * currentFeatureOwner  + k2));
-        featureOwners[featureOwnersIdx] = currentFeatureOwner + k3;
-        packquality = static_cast<float>(packquality + ((currentFeatureOwner) * (currentFeatureOwner)));
-      }
-      else
-      {
-        if(col >= 0 && col < m_PackingPoints[0] && row >= 0 && row < m_PackingPoints[1] && plane >= 0 && plane < m_PackingPoints[2])
-        {
-          featureOwnersIdx = (m_PackingPoints[0] * m_PackingPoints[1] * plane) + (m_PackingPoints[0] * row) + col;
-          int32_t currentFeatureOwner = featureOwners[featureOwnersIdx];
-          if(exclusionOwners[featureOwnersIdx] > 0)
-          {
-          }
-          if(efl[i] > 0.1f)
-          {
-            if(exclusionOwners[featureOwnersIdx] == 0)
-            {
-              m_PointsToRemove.push_back(featureOwnersIdx);
-            }
-            exclusionOwners[featureOwnersIdx]++;
-          }
-          m_FillingError = static_cast<float>(m_FillingError + ((k1 * currentFeatureOwner + k2)));
-          //        fillingerror = fillingerror + (multiplier * (k1 * currentFeatureOwner  + k2));
-          featureOwners[featureOwnersIdx] = currentFeatureOwner + k3;
-          packquality = static_cast<float>(packquality + ((currentFeatureOwner) * (currentFeatureOwner)));
-        }
-      }
-    }
-    m_PackQualities[gadd] = static_cast<int64_t>(packquality / float(numVoxelsForCurrentGrain));
+    fillingChange += updateFeatureFootprint(gadd, true, featureOwners, exclusionOwners, m_PointsToRemove, m_PointsToAdd);
   }
   if(gremove > 0)
   {
-    k1 = -2;
-    k2 = 3;
-    k3 = -1;
-    size_t size = m_ColumnList[gremove].size();
-    std::vector<int64_t>& cl = m_ColumnList[gremove];
-    std::vector<int64_t>& rl = m_RowList[gremove];
-    std::vector<int64_t>& pl = m_PlaneList[gremove];
-    std::vector<float>& efl = m_EllipFuncList[gremove];
-    for(size_t i = 0; i < size; i++)
-    {
-      col = cl[i];
-      row = rl[i];
-      plane = pl[i];
-      if(m_PeriodicBoundaries)
-      {
-        // Perform mod arithmetic to ensure we are within the packing points range
-        col = col % m_PackingPoints[0];
-        row = row % m_PackingPoints[1];
-        plane = plane % m_PackingPoints[2];
-
-        if(col < 0)
-        {
-          col = col + m_PackingPoints[0];
-        }
-        if(col > m_PackingPoints[0] - 1)
-        {
-          col = col - m_PackingPoints[0];
-        }
-        if(row < 0)
-        {
-          row = row + m_PackingPoints[1];
-        }
-        if(row > m_PackingPoints[1] - 1)
-        {
-          row = row - m_PackingPoints[1];
-        }
-        if(plane < 0)
-        {
-          plane = plane + m_PackingPoints[2];
-        }
-        if(plane > m_PackingPoints[2] - 1)
-        {
-          plane = plane - m_PackingPoints[2];
-        }
-        featureOwnersIdx = (m_PackingPoints[0] * m_PackingPoints[1] * plane) + (m_PackingPoints[0] * row) + col;
-        int32_t currentFeatureOwner = featureOwners[featureOwnersIdx];
-        if(efl[i] > 0.1f)
+    fillingChange += updateFeatureFootprint(gremove, false, featureOwners, exclusionOwners, m_PointsToRemove, m_PointsToAdd);
+  }
+  m_FillingError = (m_FillingError * float(m_TotalPackingPoints) + float(fillingChange)) / float(m_TotalPackingPoints);
+  return m_FillingError;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int64_t PackPrimaryPhases::updateFeatureFootprint(int32_t gnum, bool add, int32_t* featureOwners, int32_t* exclusionOwners, std::vector<size_t>& pointsToRemove, std::vector<size_t>& pointsToAdd)
+{
+  // Only the Feature and its packing points are written, so the moves of a batch can call this concurrently. The
+  // filling error change is returned instead of being applied, see checkFillingError.
+  size_t featureOwnersIdx = 0;
+  int64_t fillingChange = 0;
+  size_t numVoxelsForCurrentGrain = m_ColumnList[gnum].size();
+  std::vector<int64_t>& cl = m_ColumnList[gnum];
+  std::vector<int64_t>& rl = m_RowList[gnum];
+  std::vector<int64_t>& pl = m_PlaneList[gnum];
+  std::vector<float>& efl = m_EllipFuncList[gnum];
+  float packquality = 0;
+  for(size_t i = 0; i < numVoxelsForCurrentGrain; i++)
+  {
+    if(!packingPointIndex(cl[i], rl[i], pl[i], m_PackingPoints, m_PeriodicBoundaries, featureOwnersIdx))
+    {
+      continue;
+    }
+    int32_t currentFeatureOwner = featureOwners[featureOwnersIdx];
+    if(add)
+    {
+      if(efl[i] > 0.1f)
+      {
+        if(exclusionOwners[featureOwnersIdx] == 0)
         {
-          exclusionOwners[featureOwnersIdx]--;
-          if(exclusionOwners[featureOwnersIdx] == 0)
-          {
-            m_PointsToAdd.push_back(featureOwnersIdx);
-          }
+          pointsToRemove.push_back(featureOwnersIdx);
         }
-        m_FillingError = static_cast<float>(m_FillingError + ((k1 * currentFeatureOwner + k2)));
-        //        fillingerror = fillingerror + (multiplier * (k1 * currentFeatureOwner  + k2));
-        featureOwners[featureOwnersIdx] = currentFeatureOwner + k3;
+        exclusionOwners[featureOwnersIdx]++;
       }
-      else
+      fillingChange += 2 * currentFeatureOwner - 1;
+      featureOwners[featureOwnersIdx] = currentFeatureOwner + 1;
+      packquality = static_cast<float>(packquality + ((currentFeatureOwner) * (currentFeatureOwner)));
+    }
+    else
+    {
+      if(efl[i] > 0.1f)
       {
-        if(col >= 0 && col < m_PackingPoints[0] && row >= 0 && row < m_PackingPoints[1] && plane >= 0 && plane < m_PackingPoints[2])
+        exclusionOwners[featureOwnersIdx]--;
+        if(exclusionOwners[featureOwnersIdx] == 0)
         {
-          featureOwnersIdx = (m_PackingPoints[0] * m_PackingPoints[1] * plane) + (m_PackingPoints[0] * row) + col;
-          int32_t currentFeatureOwner = featureOwners[featureOwnersIdx];
-          if(efl[i] > 0.1f)
-          {
-            exclusionOwners[featureOwnersIdx]--;
-            if(exclusionOwners[featureOwnersIdx] == 0)
-            {
-              m_PointsToAdd.push_back(featureOwnersIdx);
-            }
-          }
-          m_FillingError = static_cast<float>(m_FillingError + ((k1 * currentFeatureOwner + k2)));
-          //          fillingerror = fillingerror + (multiplier * (k1 * currentFeatureOwner  + k2));
-          featureOwners[featureOwnersIdx] = currentFeatureOwner + k3;
+          pointsToAdd.push_back(featureOwnersIdx);
         }
       }
+      fillingChange += -2 * currentFeatureOwner + 3;
+      featureOwners[featureOwnersIdx] = currentFeatureOwner - 1;
     }
   }
-  m_FillingError = m_FillingError / float(m_TotalPackingPoints);
-  return m_FillingError;
+  if(add)
+  {
+    m_PackQualities[gnum] = static_cast<int64_t>(packquality / float(numVoxelsForCurrentGrain));
+  }
+  return fillingChange;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void PackPrimaryPhases::evaluateMoveCandidate(MoveCandidate& candidate, int32_t* featureOwners, int32_t* exclusionOwners)
+{
+  int32_t gnum = candidate.feature;
+  candidate.fillingChange = updateFeatureFootprint(gnum, false, featureOwners, exclusionOwners, candidate.pointsToRemove, candidate.pointsToAdd);
+  moveFeatureLists(gnum, candidate.newCentroid[0], candidate.newCentroid[1], candidate.newCentroid[2]);
+  candidate.fillingChange += updateFeatureFootprint(gnum, true, featureOwners, exclusionOwners, candidate.pointsToRemove, candidate.pointsToAdd);
+
+  // Same acceptance rule as the serial loop: keep the move unless it increases the filling error
+  candidate.accepted = (candidate.fillingChange <= 0);
+  if(!candidate.accepted)
+  {
+    updateFeatureFootprint(gnum, false, featureOwners, exclusionOwners, candidate.pointsToRemove, candidate.pointsToAdd);
+    moveFeatureLists(gnum, candidate.oldCentroid[0], candidate.oldCentroid[1], candidate.oldCentroid[2]);
+    updateFeatureFootprint(gnum, true, featureOwners, exclusionOwners, candidate.pointsToRemove, candidate.pointsToAdd);
+    candidate.pointsToRemove.clear();
+    candidate.pointsToAdd.clear();
+  }
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void PackPrimaryPhases::updateAvailablePoints(std::map<size_t, size_t>& availablePoints, std::map<size_t, size_t>& availablePointsInv)
+void PackPrimaryPhases::updateAvailablePoints(AvailablePointsBitmap& availablePoints)
 {
   size_t removeSize = m_PointsToRemove.size();
   size_t addSize = m_PointsToAdd.size();
-  size_t featureOwnersIdx = 0;
-  size_t key = 0, val = 0;
   for(size_t i = 0; i < removeSize; i++)
   {
-    featureOwnersIdx = m_PointsToRemove[i];
-    key = availablePoints[featureOwnersIdx];
-    //  availablePoints.erase(featureOwnersIdx);
-    val = availablePointsInv[m_AvailablePointsCount - 1];
-    //  availablePointsInv.erase(availablePointsCount-1);
-    if(key < m_AvailablePointsCount - 1)
-    {
-      availablePointsInv[key] = val;
-      availablePoints[val] = key;
-    }
-    m_AvailablePointsCount--;
+    availablePoints.erase(m_PointsToRemove[i]);
   }
   for(size_t i = 0; i < addSize; i++)
   {
-    featureOwnersIdx = m_PointsToAdd[i];
-    availablePoints[featureOwnersIdx] = m_AvailablePointsCount;
-    availablePointsInv[m_AvailablePointsCount] = featureOwnersIdx;
-    m_AvailablePointsCount++;
+    availablePoints.insert(m_PointsToAdd[i]);
   }
+  m_AvailablePointsCount = availablePoints.size();
   m_PointsToRemove.clear();
   m_PointsToAdd.clear();
 }
@@ -3836,6 +4319,42 @@ bool PackPrimaryPhases::getPeriodicBoundaries() const
   return m_PeriodicBoundaries;
 }
 
+// -----------------------------------------------------------------------------
+void PackPrimaryPhases::setUseParallelMoveBatches(bool value)
+{
+  m_UseParallelMoveBatches = value;
+}
+
+// -----------------------------------------------------------------------------
+bool PackPrimaryPhases::getUseParallelMoveBatches() const
+{
+  return m_UseParallelMoveBatches;
+}
+
+// -----------------------------------------------------------------------------
+void PackPrimaryPhases::setUseRandomSeed(bool value)
+{
+  m_UseRandomSeed = value;
+}
+
+// -----------------------------------------------------------------------------
+bool PackPrimaryPhases::getUseRandomSeed() const
+{
+  return m_UseRandomSeed;
+}
+
+// -----------------------------------------------------------------------------
+void PackPrimaryPhases::setRandomSeed(int value)
+{
+  m_RandomSeed = value;
+}
+
+// -----------------------------------------------------------------------------
+int PackPrimaryPhases::getRandomSeed() const
+{
+  return m_RandomSeed;
+}
+
 // -----------------------------------------------------------------------------
 void PackPrimaryPhases::setWriteGoalAttributes(bool value)
 {
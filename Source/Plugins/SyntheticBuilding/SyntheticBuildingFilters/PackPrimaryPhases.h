@@ -59,6 +59,7 @@ struct Feature_t
 };
 
 #include "SyntheticBuilding/SyntheticBuildingDLLExport.h"
+#include "SyntheticBuilding/SyntheticBuildingFilters/AvailablePointsBitmap.h"
 
 /**
  * @brief The PackPrimaryPhases class. See [Filter documentation](@ref packprimaryphases) for details.
@@ -93,6 +94,9 @@ class SyntheticBuilding_EXPORT PackPrimaryPhases : public AbstractFilter
   PYB11_PROPERTY(int SaveGeometricDescriptions READ getSaveGeometricDescriptions WRITE setSaveGeometricDescriptions)
   PYB11_PROPERTY(DataArrayPath NewAttributeMatrixPath READ getNewAttributeMatrixPath WRITE setNewAttributeMatrixPath)
   PYB11_PROPERTY(DataArrayPath SelectedAttributeMatrixPath READ getSelectedAttributeMatrixPath WRITE setSelectedAttributeMatrixPath)
+  PYB11_PROPERTY(bool UseParallelMoveBatches READ getUseParallelMoveBatches WRITE setUseParallelMoveBatches)
+  PYB11_PROPERTY(bool UseRandomSeed READ getUseRandomSeed WRITE setUseRandomSeed)
+  PYB11_PROPERTY(int RandomSeed READ getRandomSeed WRITE setRandomSeed)
   PYB11_END_BINDINGS()
   // End Python bindings declarations
 
@@ -322,6 +326,39 @@ public:
   bool getPeriodicBoundaries() const;
   Q_PROPERTY(bool PeriodicBoundaries READ getPeriodicBoundaries WRITE setPeriodicBoundaries)
 
+  /**
+   * @brief Setter property for UseParallelMoveBatches
+   */
+  void setUseParallelMoveBatches(bool value);
+  /**
+   * @brief Getter property for UseParallelMoveBatches
+   * @return Value of UseParallelMoveBatches
+   */
+  bool getUseParallelMoveBatches() const;
+  Q_PROPERTY(bool UseParallelMoveBatches READ getUseParallelMoveBatches WRITE setUseParallelMoveBatches)
+
+  /**
+   * @brief Setter property for UseRandomSeed
+   */
+  void setUseRandomSeed(bool value);
+  /**
+   * @brief Getter property for UseRandomSeed
+   * @return Value of UseRandomSeed
+   */
+  bool getUseRandomSeed() const;
+  Q_PROPERTY(bool UseRandomSeed READ getUseRandomSeed WRITE setUseRandomSeed)
+
+  /**
+   * @brief Setter property for RandomSeed
+   */
+  void setRandomSeed(int value);
+  /**
+   * @brief Getter property for RandomSeed
+   * @return Value of RandomSeed
+   */
+  int getRandomSeed() const;
+  Q_PROPERTY(int RandomSeed READ getRandomSeed WRITE setRandomSeed)
+
   /**
    * @brief Setter property for WriteGoalAttributes
    */
@@ -505,6 +542,15 @@ protected:
    */
   void moveFeature(size_t gnum, float xc, float yc, float zc);
 
+  /**
+   * @brief moveFeatureLists Moves a Feature's centroid and packing point lists without touching any shared state
+   * @param gnum Id for the Feature to be moved
+   * @param xc x centroid coordinate
+   * @param yc y centroid coordinate
+   * @param zc z centroid coordinate
+   */
+  void moveFeatureLists(size_t gnum, float xc, float yc, float zc);
+
   /**
    * @brief check_sizedisterror Computes the error between the current Feature size distribution
    * and the goal Feature size distribution
@@ -530,6 +576,57 @@ protected:
    */
   float checkNeighborhoodError(int32_t gadd, int32_t gremove);
 
+  /**
+   * @brief initializeNeighborGrid Bins the placed Features into a uniform grid of cells keyed by their
+   * centroids so that determineNeighbors only visits the Features close to a given Feature
+   * @param totalFeatures Number of Features in the Feature Attribute Matrix
+   */
+  void initializeNeighborGrid(size_t totalFeatures);
+
+  /**
+   * @brief updateNeighborGridCell Moves a Feature into the neighbor grid cell that holds its current centroid
+   * @param gnum Id for the Feature that was moved
+   */
+  void updateNeighborGridCell(size_t gnum);
+
+  /**
+   * @brief initializeNeighborhoodHistograms Counts the primary Features by equivalent diameter bin and
+   * neighborhood bin; the counts are kept current as the neighborhoods change
+   * @param totalFeatures Number of Features in the Feature Attribute Matrix
+   */
+  void initializeNeighborhoodHistograms(size_t totalFeatures);
+
+  /**
+   * @brief updateNeighborhood Changes the neighborhood value of a Feature and updates the neighborhood histogram
+   * @param gnum Id for the Feature whose neighborhood changes
+   * @param increment Value added to the neighborhood
+   */
+  void updateNeighborhood(size_t gnum, int32_t increment);
+
+  struct MoveCandidate;
+  friend class PackPrimaryPhasesMoveBatchImpl;
+
+  /**
+   * @brief updateFeatureFootprint Adds or removes a Feature from the packing point owner arrays
+   * @param gnum Id for the Feature
+   * @param add Whether the Feature is added or removed
+   * @param featureOwners Number of Features that own each packing point
+   * @param exclusionOwners Number of Features whose exclusion zone covers each packing point
+   * @param pointsToRemove Packing points that stopped being available
+   * @param pointsToAdd Packing points that became available
+   * @return Change of the unnormalized filling error
+   */
+  int64_t updateFeatureFootprint(int32_t gnum, bool add, int32_t* featureOwners, int32_t* exclusionOwners, std::vector<size_t>& pointsToRemove, std::vector<size_t>& pointsToAdd);
+
+  /**
+   * @brief evaluateMoveCandidate Moves one Feature of a batch and keeps the move if it does not increase the
+   * filling error, otherwise moves it back. Candidates of a batch never touch the same packing points.
+   * @param candidate Move to evaluate
+   * @param featureOwners Number of Features that own each packing point
+   * @param exclusionOwners Number of Features whose exclusion zone covers each packing point
+   */
+  void evaluateMoveCandidate(MoveCandidate& candidate, int32_t* featureOwners, int32_t* exclusionOwners);
+
   /**
    * @brief check_fillingerror Computes the percentage of unassigned or multiple assigned packing points
    * @param gadd Value that determines whether to add point Ids to be filled
@@ -541,11 +638,10 @@ protected:
   float checkFillingError(int32_t gadd, int32_t gremove, Int32ArrayType::Pointer featureOwnersPtr, Int32ArrayType::Pointer exclusionOwnersPtr);
 
   /**
-   * @brief update_availablepoints Updates the maps used to associate packing points with an "available" state
-   * @param availablePoints Map between Feature owners and number of available points
-   * @param availablePointsInv Inverse associations for the availablePoints map
+   * @brief update_availablepoints Updates the set of packing points with an "available" state
+   * @param availablePoints Set of available packing points
    */
-  void updateAvailablePoints(std::map<size_t, size_t>& availablePoints, std::map<size_t, size_t>& availablePointsInv);
+  void updateAvailablePoints(AvailablePointsBitmap& availablePoints);
 
   /**
    * @brief assign_voxels Assigns Feature Id values to voxels within the packing grid
@@ -658,6 +754,9 @@ private:
   QString m_FeatureInputFile = {};
   QString m_CsvOutputFile = {};
   bool m_PeriodicBoundaries = {};
+  bool m_UseParallelMoveBatches = {};
+  bool m_UseRandomSeed = {};
+  int m_RandomSeed = {};
   bool m_WriteGoalAttributes = {};
   int m_SaveGeometricDescriptions = {};
   DataArrayPath m_NewAttributeMatrixPath = {};
@@ -726,6 +825,19 @@ private:
   std::vector<int32_t> m_PrimaryPhases;
   std::vector<float> m_PrimaryPhaseFractions;
 
+  // Uniform grid of cells holding the Features by centroid, used to find the Features near a given Feature
+  int64_t m_NeighborGridDims[3] = {0, 0, 0};
+  float m_OneOverNeighborGridCellSize[3] = {0.0f, 0.0f, 0.0f};
+  float m_NeighborGridReach = 0.0f;
+  std::vector<std::vector<int32_t>> m_NeighborGridCells;
+  std::vector<int64_t> m_NeighborGridCellIndex;
+  std::vector<size_t> m_NeighborGridSlot;
+
+  // Number of Features of each primary phase in every [diameter bin][neighborhood bin]
+  std::vector<std::vector<std::vector<int32_t>>> m_NeighborhoodHistograms;
+  std::vector<int32_t> m_NeighborhoodPhaseIndex;
+  std::vector<size_t> m_NeighborhoodDiaBins;
+
   size_t m_AvailablePointsCount;
   float m_FillingError, m_OldFillingError;
   float m_CurrentNeighborhoodError, m_OldNeighborhoodError;
@@ -65,6 +65,7 @@ endforeach()
 # These are files that need to be compiled into DREAM3DLib but are NOT filters
 ADD_SIMPL_SUPPORT_HEADER(${${PLUGIN_NAME}_SOURCE_DIR} ${_filterGroupName} StatsGeneratorUtilities.h)
 ADD_SIMPL_SUPPORT_SOURCE(${${PLUGIN_NAME}_SOURCE_DIR} ${_filterGroupName} StatsGeneratorUtilities.cpp)
+ADD_SIMPL_SUPPORT_CLASS(${${PLUGIN_NAME}_SOURCE_DIR} ${_filterGroupName} AvailablePointsBitmap)
 
 ADD_SIMPL_SUPPORT_CLASS(${${PLUGIN_NAME}_SOURCE_DIR} ${_filterGroupName}/Presets AbstractMicrostructurePreset )
 ADD_SIMPL_SUPPORT_CLASS(${${PLUGIN_NAME}_SOURCE_DIR} ${_filterGroupName}/Presets MicrostructurePresetManager )